@@ -30,6 +30,11 @@
 // value from host to network byte order and vice versa. On BIG ENDIAN  //
 // machines this is a no op.                                            //
 //                                                                      //
+// The net2hostcpy16/32/64() routines convert a whole array of 2, 4 or  //
+// 8 byte values from network to host byte order while copying it,      //
+// using SSE2 (or SSSE3) instructions when available. The source and    //
+// the destination may be the same buffer (in place conversion).        //
+//                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
 #ifndef ROOT_Rtypes
@@ -55,6 +60,14 @@
 #include "Byteswap.h"
 #endif
 
+#if defined(R__BYTESWAP) && defined(__SSE2__) && !defined(__CINT__)
+#define R__USESSESWAP
+#include <emmintrin.h>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+#endif
+
 //______________________________________________________________________________
 inline void tobuf(char *&buf, Bool_t x)
 {
@@ -587,4 +600,113 @@ inline Long64_t  net2host(Long64_t x)  { return host2net(x); }
 inline Float_t   net2host(Float_t x)   { return host2net(x); }
 inline Double_t  net2host(Double_t x)  { return host2net(x); }
 
+#ifdef R__USESSESWAP
+//______________________________________________________________________________
+inline __m128i R__bswap16_128(__m128i v)
+{
+   return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+inline __m128i R__bswap32_128(__m128i v)
+{
+#ifdef __SSSE3__
+   return _mm_shuffle_epi8(v, _mm_set_epi8(12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3));
+#else
+   v = R__bswap16_128(v);
+   return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1);
+#endif
+}
+
+inline __m128i R__bswap64_128(__m128i v)
+{
+#ifdef __SSSE3__
+   return _mm_shuffle_epi8(v, _mm_set_epi8(8,9,10,11,12,13,14,15, 0,1,2,3,4,5,6,7));
+#else
+   v = R__bswap16_128(v);
+   return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0x1B), 0x1B);
+#endif
+}
+#endif
+
+//______________________________________________________________________________
+inline void net2hostcpy16(void *dst, const void *src, Long64_t n)
+{
+   // Copy n 2 byte values from src (network byte order) to dst (host byte
+   // order). Neither buffer needs to be aligned; dst may be equal to src.
+
+#ifdef R__BYTESWAP
+   char *d = (char *)dst;
+   const char *s = (const char *)src;
+   Long64_t i = 0;
+#ifdef R__USESSESWAP
+   for (; i + 8 <= n; i += 8, s += 16, d += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)s);
+      _mm_storeu_si128((__m128i *)d, R__bswap16_128(v));
+   }
+#endif
+   for (; i < n; ++i, s += 2, d += 2) {
+      UShort_t x;
+      memcpy(&x, s, 2);
+      x = host2net(x);
+      memcpy(d, &x, 2);
+   }
+#else
+   if (dst != src) memmove(dst, src, 2*n);
+#endif
+}
+
+//______________________________________________________________________________
+inline void net2hostcpy32(void *dst, const void *src, Long64_t n)
+{
+   // Copy n 4 byte values from src (network byte order) to dst (host byte
+   // order). Neither buffer needs to be aligned; dst may be equal to src.
+
+#ifdef R__BYTESWAP
+   char *d = (char *)dst;
+   const char *s = (const char *)src;
+   Long64_t i = 0;
+#ifdef R__USESSESWAP
+   for (; i + 4 <= n; i += 4, s += 16, d += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)s);
+      _mm_storeu_si128((__m128i *)d, R__bswap32_128(v));
+   }
+#endif
+   for (; i < n; ++i, s += 4, d += 4) {
+      UInt_t x;
+      memcpy(&x, s, 4);
+      x = host2net(x);
+      memcpy(d, &x, 4);
+   }
+#else
+   if (dst != src) memmove(dst, src, 4*n);
+#endif
+}
+
+//______________________________________________________________________________
+inline void net2hostcpy64(void *dst, const void *src, Long64_t n)
+{
+   // Copy n 8 byte values from src (network byte order) to dst (host byte
+   // order). Neither buffer needs to be aligned; dst may be equal to src.
+
+#ifdef R__BYTESWAP
+   char *d = (char *)dst;
+   const char *s = (const char *)src;
+   Long64_t i = 0;
+#ifdef R__USESSESWAP
+   for (; i + 2 <= n; i += 2, s += 16, d += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)s);
+      _mm_storeu_si128((__m128i *)d, R__bswap64_128(v));
+   }
+#endif
+   for (; i < n; ++i, s += 8, d += 8) {
+      ULong64_t x;
+      memcpy(&x, s, 8);
+      x = host2net(x);
+      memcpy(d, &x, 8);
+   }
+#else
+   if (dst != src) memmove(dst, src, 8*n);
+#endif
+}
+
 #endif
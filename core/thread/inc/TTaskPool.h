@@ -0,0 +1,120 @@
+// @(#)root/thread:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTaskPool
+#define ROOT_TTaskPool
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TTaskPool                                                            //
+//                                                                      //
+// A pool of worker threads executing short, independent tasks.         //
+// Tasks are submitted through a TTaskGroup, which allows the caller    //
+// to wait for the completion of exactly the tasks it submitted.        //
+// A thread waiting on a group helps executing the queued tasks of      //
+// that group instead of idling, so that groups can safely be nested.   //
+//                                                                      //
+// The process wide pool returned by TTaskPool::GetGlobalPool() is the  //
+// one used by the implicitly parallel parts of ROOT (basket            //
+// compression, unzipping, ...). It is disabled by default; enable it   //
+// with TTaskPool::SetGlobalPoolSize(nthreads). The pool is             //
+// reference counted by the groups using it: resizing the global pool   //
+// while groups are alive retires the old pool, which is destroyed once //
+// the last of these groups is gone.                                    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TMutex
+#include "TMutex.h"
+#endif
+#ifndef ROOT_TCondition
+#include "TCondition.h"
+#endif
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+class TThread;
+class TTaskGroup;
+
+class TTaskPool {
+
+public:
+   typedef std::function<void()> Task_t;
+
+private:
+   struct TTaskEntry {
+      Task_t      fTask;    // the work to be done
+      TTaskGroup *fGroup;   // the group to notify on completion
+   };
+
+   std::deque<TTaskEntry> fQueue;          // tasks not yet started
+   std::vector<TThread*>  fWorkers;        // worker threads
+   TMutex                 fMutex;          // protects fQueue and fStopping
+   TCondition             fWorkAvailable;  // signaled when a task is queued
+   Bool_t                 fStopping;       // true when the pool is being destroyed
+   Int_t                  fUsers;          // number of groups using the pool, protected by the global pool mutex
+   Bool_t                 fRetired;        // true once the pool is no longer the global pool
+
+   static TTaskPool      *fgGlobalPool;     // process wide pool
+   static UInt_t          fgGlobalPoolSize; // number of workers of the process wide pool
+   static std::vector<TTaskPool*> fgRetiredPools; // retired pools released by one of their own workers
+
+   TTaskPool(const TTaskPool&);            // not implemented
+   TTaskPool& operator=(const TTaskPool&); // not implemented
+
+   static void *WorkerLoop(void *arg);
+
+   static TTaskPool *AcquireGlobalPool();
+   static void       Acquire(TTaskPool *pool);
+   static void       Release(TTaskPool *pool);
+   Bool_t            IsWorkerThread() const;
+
+   friend class TTaskGroup;
+
+public:
+   TTaskPool(UInt_t nworkers);
+   virtual ~TTaskPool();
+
+   UInt_t  GetPoolSize() const { return fWorkers.size(); }
+   void    Push(const Task_t &task, TTaskGroup *group);
+   Bool_t  RunPending(TTaskGroup *group);
+
+   static TTaskPool *GetGlobalPool();
+   static UInt_t     GetGlobalPoolSize();
+   static void       SetGlobalPoolSize(UInt_t nworkers);
+};
+
+class TTaskGroup {
+
+private:
+   TTaskPool   *fPool;     // pool executing the tasks, 0 to run them inline
+   Int_t        fPending;  // number of submitted tasks not yet completed
+   TMutex       fMutex;    // protects fPending
+   TCondition   fDone;     // signaled when fPending drops to zero
+
+   TTaskGroup(const TTaskGroup&);            // not implemented
+   TTaskGroup& operator=(const TTaskGroup&); // not implemented
+
+public:
+   TTaskGroup();
+   TTaskGroup(TTaskPool *pool);
+   virtual ~TTaskGroup();
+
+   TTaskPool *GetPool() const { return fPool; }
+   Bool_t     IsParallel() const { return fPool != 0; }
+   void       Run(const TTaskPool::Task_t &task);
+   void       TaskDone();
+   void       Wait();
+};
+
+#endif
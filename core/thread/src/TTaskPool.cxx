@@ -0,0 +1,315 @@
+// @(#)root/thread:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TTaskPool                                                            //
+//                                                                      //
+// A pool of worker threads executing short, independent tasks, and     //
+// TTaskGroup, the handle used to submit tasks and wait for them.       //
+//                                                                      //
+// Example:                                                             //
+//                                                                      //
+//    TTaskPool::SetGlobalPoolSize(8);                                  //
+//    TTaskGroup group;                                                 //
+//    for (Int_t i = 0; i < n; ++i)                                     //
+//       group.Run([&result, i]() { result[i] = Compute(i); });         //
+//    group.Wait();                                                     //
+//                                                                      //
+// When no pool is available (the global pool is disabled by default)   //
+// TTaskGroup::Run executes the task immediately in the calling thread, //
+// so code written against TTaskGroup works unchanged in serial mode.   //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "TTaskPool.h"
+#include "TThread.h"
+
+TTaskPool *TTaskPool::fgGlobalPool = 0;
+UInt_t     TTaskPool::fgGlobalPoolSize = 0;
+std::vector<TTaskPool*> TTaskPool::fgRetiredPools;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Mutex protecting the creation of the global pool and the reference
+/// counts of the pools. Created on first use, after the thread factory has
+/// been set up.
+
+static TMutex *GetGlobalPoolMutex()
+{
+   static TMutex *mutex = new TMutex();
+   return mutex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a pool with nworkers threads. The threads are started immediately
+/// and wait for tasks to be pushed.
+
+TTaskPool::TTaskPool(UInt_t nworkers) : fWorkAvailable(&fMutex), fStopping(kFALSE),
+   fUsers(0), fRetired(kFALSE)
+{
+   TThread::Initialize();
+   for (UInt_t i = 0; i < nworkers; ++i) {
+      TThread *worker = new TThread("TTaskPool", &TTaskPool::WorkerLoop, this);
+      fWorkers.push_back(worker);
+      worker->Run();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor. The tasks already queued are executed before the workers
+/// are joined.
+
+TTaskPool::~TTaskPool()
+{
+   {
+      TLockGuard lock(&fMutex);
+      fStopping = kTRUE;
+      fWorkAvailable.Broadcast();
+   }
+   for (UInt_t i = 0; i < fWorkers.size(); ++i) {
+      fWorkers[i]->Join();
+      delete fWorkers[i];
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Main loop of the worker threads: pop the oldest task, run it and notify
+/// its group.
+
+void *TTaskPool::WorkerLoop(void *arg)
+{
+   TTaskPool *pool = (TTaskPool*)arg;
+   while (1) {
+      TTaskEntry entry;
+      {
+         TLockGuard lock(&pool->fMutex);
+         while (pool->fQueue.empty() && !pool->fStopping) {
+            pool->fWorkAvailable.Wait();
+         }
+         if (pool->fQueue.empty()) {
+            // Stopping and nothing left to do.
+            break;
+         }
+         entry = pool->fQueue.front();
+         pool->fQueue.pop_front();
+      }
+      entry.fTask();
+      entry.fGroup->TaskDone();
+   }
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Queue a task; group->TaskDone() will be called once it has been executed.
+
+void TTaskPool::Push(const Task_t &task, TTaskGroup *group)
+{
+   TTaskEntry entry;
+   entry.fTask = task;
+   entry.fGroup = group;
+
+   TLockGuard lock(&fMutex);
+   fQueue.push_back(entry);
+   fWorkAvailable.Signal();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Execute, in the calling thread, the oldest queued task belonging to group.
+/// Return false if no such task is queued (they might still be running).
+
+Bool_t TTaskPool::RunPending(TTaskGroup *group)
+{
+   TTaskEntry entry;
+   {
+      TLockGuard lock(&fMutex);
+      std::deque<TTaskEntry>::iterator iter = fQueue.begin();
+      while (iter != fQueue.end() && iter->fGroup != group) ++iter;
+      if (iter == fQueue.end()) return kFALSE;
+      entry = *iter;
+      fQueue.erase(iter);
+   }
+   entry.fTask();
+   entry.fGroup->TaskDone();
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the process wide pool, creating it if needed. Return 0 if the
+/// implicit parallelism is disabled, i.e. the global pool size is 0.
+/// The pool may be destroyed by the next call to SetGlobalPoolSize; use a
+/// default constructed TTaskGroup to submit tasks to it safely.
+
+TTaskPool *TTaskPool::GetGlobalPool()
+{
+   if (!fgGlobalPoolSize) return 0;
+   TLockGuard lock(GetGlobalPoolMutex());
+   if (!fgGlobalPool && fgGlobalPoolSize) {
+      fgGlobalPool = new TTaskPool(fgGlobalPoolSize);
+   }
+   return fgGlobalPool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the process wide pool (0 if disabled) and register the caller
+/// as one of its users, atomically with respect to SetGlobalPoolSize.
+
+TTaskPool *TTaskPool::AcquireGlobalPool()
+{
+   if (!fgGlobalPoolSize) return 0;
+   TLockGuard lock(GetGlobalPoolMutex());
+   if (!fgGlobalPool && fgGlobalPoolSize) {
+      fgGlobalPool = new TTaskPool(fgGlobalPoolSize);
+   }
+   if (fgGlobalPool) ++fgGlobalPool->fUsers;
+   return fgGlobalPool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Register a new user of pool.
+
+void TTaskPool::Acquire(TTaskPool *pool)
+{
+   if (!pool) return;
+   TLockGuard lock(GetGlobalPoolMutex());
+   ++pool->fUsers;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Unregister a user of pool. A retired pool is destroyed with its last
+/// user, unless that user runs in one of the workers of the pool (which
+/// can not join themselves); the pool is then destroyed by the next call
+/// to SetGlobalPoolSize.
+
+void TTaskPool::Release(TTaskPool *pool)
+{
+   if (!pool) return;
+   {
+      TLockGuard lock(GetGlobalPoolMutex());
+      if (--pool->fUsers > 0 || !pool->fRetired) return;
+      if (pool->IsWorkerThread()) {
+         fgRetiredPools.push_back(pool);
+         return;
+      }
+   }
+   delete pool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the calling thread is one of the workers of this pool.
+
+Bool_t TTaskPool::IsWorkerThread() const
+{
+   Long_t self = TThread::SelfId();
+   for (UInt_t i = 0; i < fWorkers.size(); ++i) {
+      if (fWorkers[i]->GetId() == self) return kTRUE;
+   }
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of threads of the process wide pool (0 if disabled).
+
+UInt_t TTaskPool::GetGlobalPoolSize()
+{
+   return fgGlobalPoolSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the number of threads of the process wide pool; 0 disables it.
+/// The current pool, if any, is retired: the new groups use the new pool,
+/// while the groups created before keep using the old one, which is
+/// drained and destroyed when the last of them is destroyed.
+
+void TTaskPool::SetGlobalPoolSize(UInt_t nworkers)
+{
+   std::vector<TTaskPool*> unused;
+   {
+      TLockGuard lock(GetGlobalPoolMutex());
+      unused.swap(fgRetiredPools);
+      if (fgGlobalPool && fgGlobalPool->GetPoolSize() != nworkers) {
+         fgGlobalPool->fRetired = kTRUE;
+         if (fgGlobalPool->fUsers == 0) unused.push_back(fgGlobalPool);
+         fgGlobalPool = 0;
+      }
+      fgGlobalPoolSize = nworkers;
+   }
+   for (UInt_t i = 0; i < unused.size(); ++i) {
+      delete unused[i];
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a task group submitting its tasks to the process wide pool. If
+/// it is disabled the tasks are executed immediately by Run. The pool stays
+/// alive as long as the group, even if the global pool is resized.
+
+TTaskGroup::TTaskGroup() : fPool(TTaskPool::AcquireGlobalPool()), fPending(0), fDone(&fMutex)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a task group submitting its tasks to pool. If pool is 0 the tasks
+/// are executed immediately by Run.
+
+TTaskGroup::TTaskGroup(TTaskPool *pool) : fPool(pool), fPending(0), fDone(&fMutex)
+{
+   TTaskPool::Acquire(fPool);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor, wait for all the submitted tasks.
+
+TTaskGroup::~TTaskGroup()
+{
+   Wait();
+   TTaskPool::Release(fPool);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Submit a task.
+
+void TTaskGroup::Run(const TTaskPool::Task_t &task)
+{
+   if (!fPool) {
+      task();
+      return;
+   }
+   {
+      TLockGuard lock(&fMutex);
+      ++fPending;
+   }
+   fPool->Push(task, this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Called by the pool when one of the tasks of this group is completed.
+
+void TTaskGroup::TaskDone()
+{
+   TLockGuard lock(&fMutex);
+   if (--fPending == 0) {
+      fDone.Broadcast();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the completion of all the tasks submitted so far. The calling
+/// thread executes the tasks of this group which are still queued.
+
+void TTaskGroup::Wait()
+{
+   if (!fPool) return;
+   while (fPool->RunPending(this)) { }
+
+   TLockGuard lock(&fMutex);
+   while (fPending > 0) {
+      fDone.Wait();
+   }
+}
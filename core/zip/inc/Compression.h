@@ -25,6 +25,13 @@ namespace ROOT {
    // in greater compression factors, but takes more CPU time
    // and memory when compressing.  LZMA memory usage is particularly
    // high for compression levels 8 and 9.
+   // The LZ4 algorithm gives lower compression factors than ZLIB but
+   // decompresses several times faster; it is well suited for data
+   // read many times. The Zstandard (ZSTD) algorithm usually compresses
+   // better than ZLIB while being faster both to compress and decompress.
+   // LZ4 and ZSTD are only available if ROOT was built with liblz4 and
+   // libzstd respectively; otherwise the default algorithm is used and
+   // CheckCompressionSettings issues a warning.
    //
    // The current algorithms support level 1 to 9. The higher
    // the level the greater the compression and more CPU time
@@ -34,6 +41,8 @@ namespace ROOT {
                                 kZLIB,
                                 kLZMA,
                                 kOldCompressionAlgo,
+                                kLZ4,
+                                kZSTD,
                                 // if adding new algorithm types,
                                 // keep this enum value last
                                 kUndefinedCompressionAlgorithm
@@ -41,6 +50,10 @@ namespace ROOT {
 
    int CompressionSettings(ECompressionAlgorithm algorithm,
                            int compressionLevel);
+
+   bool IsCompressionAlgorithmAvailable(ECompressionAlgorithm algorithm);
+
+   int CheckCompressionSettings(int settings);
 }
 
 #endif
@@ -10,6 +10,12 @@
  *************************************************************************/
 
 #include "Compression.h"
+#include "TError.h"
+
+extern "C" {
+#include "ZipLZ4.h"
+#include "ZipZSTD.h"
+}
 
 namespace ROOT {
 
@@ -24,4 +30,32 @@ namespace ROOT {
     if (algorithm >= ROOT::kUndefinedCompressionAlgorithm) algo = 0;
     return algo * 100 + compressionLevel;
   }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if algorithm can be used by this build of ROOT: LZ4 and ZSTD
+/// depend on optional external libraries.
+
+  bool IsCompressionAlgorithmAvailable(ECompressionAlgorithm algorithm)
+  {
+    if (algorithm == kLZ4) return R__LZ4IsAvailable();
+    if (algorithm == kZSTD) return R__ZSTDIsAvailable();
+    return algorithm < kUndefinedCompressionAlgorithm;
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return settings, with the algorithm replaced by the default one (and a
+/// warning) if it is not available in this build of ROOT.
+
+  int CheckCompressionSettings(int settings)
+  {
+    if (settings < 100) return settings;
+    ECompressionAlgorithm algorithm = (ECompressionAlgorithm)(settings / 100);
+    if (algorithm >= kUndefinedCompressionAlgorithm || IsCompressionAlgorithmAvailable(algorithm)) {
+      return settings;
+    }
+    ::Warning("CheckCompressionSettings",
+              "ROOT was built without %s support, using the default compression algorithm instead",
+              algorithm == kLZ4 ? "LZ4" : "ZSTD");
+    return settings % 100;
+  }
 }
@@ -0,0 +1,54 @@
+# Module.mk for zstd module
+# Copyright (c) 2015 Rene Brun and Fons Rademakers
+
+MODNAME      := zstd
+MODDIR       := $(ROOT_SRCDIR)/core/$(MODNAME)
+MODDIRS      := $(MODDIR)/src
+MODDIRI      := $(MODDIR)/inc
+
+ZSTDDIR      := $(MODDIR)
+ZSTDDIRS     := $(ZSTDDIR)/src
+ZSTDDIRI     := $(ZSTDDIR)/inc
+
+##### ZipZSTD, part of libCore #####
+# The support is only compiled in when ZSTDCLILIB (and ZSTDINCDIR, if the
+# headers are not in a standard location) are defined, e.g. in
+# config/Makefile.config; otherwise the algorithm is reported as unavailable.
+ZSTDH        := $(MODDIRI)/ZipZSTD.h
+ZSTDS        := $(MODDIRS)/ZipZSTD.c
+ZSTDO        := $(call stripsrc,$(ZSTDS:.c=.o))
+
+ZSTDDEP      := $(ZSTDO:.o=.d)
+
+ifneq ($(ZSTDCLILIB),)
+ZSTDLIBDIRI  := $(ZSTDINCDIR:%=-I%) -DR__HAS_ZSTD
+CORELIBEXTRA    += $(ZSTDLIBDIR) $(ZSTDCLILIB)
+STATICEXTRALIBS += $(ZSTDLIBDIR) $(ZSTDCLILIB)
+endif
+
+# used in the main Makefile
+ALLHDRS      += $(patsubst $(MODDIRI)/%.h,include/%.h,$(ZSTDH))
+
+# include all dependency files
+INCLUDEFILES += $(ZSTDDEP)
+
+##### local rules #####
+.PHONY:         all-$(MODNAME) clean-$(MODNAME) distclean-$(MODNAME)
+
+include/%.h:    $(ZSTDDIRI)/%.h
+		cp $< $@
+
+all-$(MODNAME): $(ZSTDO)
+
+clean-$(MODNAME):
+		@rm -f $(ZSTDO)
+
+clean::         clean-$(MODNAME)
+
+distclean-$(MODNAME): clean-$(MODNAME)
+		@rm -f $(ZSTDDEP)
+
+distclean::     distclean-$(MODNAME)
+
+##### extra rules ######
+$(ZSTDO): CFLAGS += $(ZSTDLIBDIRI)
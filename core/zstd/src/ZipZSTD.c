@@ -0,0 +1,117 @@
+// @(#)root/zstd:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/* Compression with the Zstandard algorithm. Zstandard usually gives a
+   better compression factor than ZLIB while being faster both when
+   compressing and decompressing. The ROOT compression levels 1 to 9 are
+   mapped onto the Zstandard levels 2 to 18.
+
+   The record header is the usual 9 bytes ROOT header with the signature
+   'Z' 'S' followed by the version of the format (currently 1).
+
+   When ROOT is built without Zstandard support (R__HAS_ZSTD not defined),
+   R__zipMultipleAlgorithm compresses with ZLIB instead and the
+   decompression fails with an error message. */
+
+#include "ZipZSTD.h"
+#include <stdio.h>
+
+#ifdef R__HAS_ZSTD
+#include "zstd.h"
+
+static const int kHeaderSize = 9;
+static const int kFormatVersion = 1;
+#endif
+
+/* Return 1 if ROOT was built with Zstandard support, 0 otherwise. */
+int R__ZSTDIsAvailable(void)
+{
+#ifdef R__HAS_ZSTD
+   return 1;
+#else
+   return 0;
+#endif
+}
+
+void R__zipZSTD(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
+{
+#ifdef R__HAS_ZSTD
+   size_t out_size;               /* compressed size */
+   unsigned in_size = (unsigned) (*srcsize);
+
+   *irep = 0;
+
+   if (*tgtsize <= kHeaderSize) {
+      return;
+   }
+
+   if (*srcsize > 0xffffff || *srcsize < 0) {
+      return;
+   }
+
+   if (cxlevel > 9) cxlevel = 9;
+   out_size = ZSTD_compress(&tgt[kHeaderSize], (size_t)(*tgtsize - kHeaderSize),
+                            src, (size_t)(*srcsize), 2 * cxlevel);
+   if (ZSTD_isError(out_size) || out_size > 0xffffff) {
+      /* No need to print an error message. We simply abandon the compression
+         the buffer cannot be compressed or compressed buffer would be larger than original buffer
+      */
+      return;
+   }
+
+   tgt[0] = 'Z';  /* Signature of Zstandard */
+   tgt[1] = 'S';
+   tgt[2] = (char) kFormatVersion;
+
+   tgt[3] = (char)(out_size & 0xff);
+   tgt[4] = (char)((out_size >> 8) & 0xff);
+   tgt[5] = (char)((out_size >> 16) & 0xff);
+
+   tgt[6] = (char)(in_size & 0xff);         /* decompressed size */
+   tgt[7] = (char)((in_size >> 8) & 0xff);
+   tgt[8] = (char)((in_size >> 16) & 0xff);
+
+   *irep = (int)out_size + kHeaderSize;
+#else
+   (void)cxlevel; (void)srcsize; (void)src; (void)tgtsize; (void)tgt;
+   *irep = 0;
+#endif
+}
+
+void R__unzipZSTD(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+#ifdef R__HAS_ZSTD
+   size_t returnStatus;
+
+   *irep = 0;
+
+   if (src[2] != kFormatVersion) {
+      fprintf(stderr,
+              "R__unzipZSTD: unsupported Zstandard format version %d\n",
+              (int)src[2]);
+      return;
+   }
+
+   returnStatus = ZSTD_decompress(tgt, (size_t)(*tgtsize),
+                                  &src[kHeaderSize], (size_t)(*srcsize - kHeaderSize));
+   if (ZSTD_isError(returnStatus)) {
+      fprintf(stderr,
+              "R__unzipZSTD: error in ZSTD_decompress: %s\n",
+              ZSTD_getErrorName(returnStatus));
+      return;
+   }
+
+   *irep = (int)returnStatus;
+#else
+   (void)srcsize; (void)src; (void)tgtsize; (void)tgt;
+   *irep = 0;
+   fprintf(stderr, "R__unzipZSTD: ROOT was built without Zstandard support\n");
+#endif
+}
@@ -141,6 +141,10 @@ private:
       return fFunc->EvalPar(x,p);
    }
 
+   /// evaluate the function at n points, given point after point,
+   /// in a single call of TF1::EvalParBatch
+   void DoEvalParBatch(unsigned int n, const double * x, const double * p, double * f) const;
+
    /// evaluate function using the cached parameter values (of TF1)
    /// re-implement for better efficiency
    double DoEval (const double* x) const { 
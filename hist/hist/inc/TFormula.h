@@ -103,9 +103,13 @@ private:
    TString           fClingName;     //! unique name passed to Cling to define the function ( double clingName(double*x, double*p) )
 
    TInterpreter::CallFuncIFacePtr_t::Generic_t fFuncPtr;   //!  function pointer
+   mutable TInterpreter::CallFuncIFacePtr_t::Generic_t fBatchFuncPtr;   //!  function pointer of the batch evaluation, compiled on first use
+
+   static Bool_t     fgBatchFastMath;       // use the VDT functions in the batch evaluation
 
    void     InputFormulaIntoCling();
    Bool_t   PrepareEvalMethod();
+   Bool_t   PrepareBatchMethod() const;
    void     FillDefaults();
    void     HandlePolN(TString &formula);
    void     HandleParametrizedFunctions(TString &formula);
@@ -169,6 +173,7 @@ public:
    Double_t       Eval(Double_t x, Double_t y , Double_t z) const;
    Double_t       Eval(Double_t x, Double_t y , Double_t z , Double_t t ) const;
    Double_t       EvalPar(const Double_t *x, const Double_t *params=0) const;
+   void           EvalParBatch(Int_t n, const Double_t *x, Double_t *result, const Double_t *params=0) const;
    TString        GetExpFormula(Option_t *option="") const;
    const TObject *GetLinearPart(Int_t i) const;
    Int_t          GetNdim() const {return fNdim;}
@@ -202,6 +207,9 @@ public:
    void           SetVariable(const TString &name, Double_t value);
    void           SetVariables(const std::pair<TString,Double_t> *vars, const Int_t size);
 
+   static Bool_t  GetBatchFastMath();
+   static void    SetBatchFastMath(Bool_t fast = kTRUE);
+
    ClassDef(TFormula,10)
 };
 #endif
@@ -69,6 +69,7 @@
 
 class TF1;
 class TH1D;
+class TH1ConcurrentFill;
 class TBrowser;
 class TDirectory;
 class TList;
@@ -97,6 +98,13 @@ public:
       kAllAxes = kXaxis | kYaxis | kZaxis
    };
 
+   // enumeration specifying how the histogram is filled by several threads (see SetConcurrentFill)
+   enum EConcurrentFill {
+      kNoConcurrentFill = 0, // the histogram is filled by a single thread
+      kAtomicFill = 1,       // each fill is applied immediately under a lock
+      kThreadBufferFill = 2  // the fills are buffered per thread and applied when a buffer is full or on read
+   };
+
 protected:
     Int_t         fNcells;          //number of bins(1D), cells (2D) +U/Overflows
     TAxis         fXaxis;           //X axis descriptor
@@ -123,6 +131,7 @@ protected:
     Double_t     *fIntegral;        //!Integral of bins used by GetRandom
     TVirtualHistPainter *fPainter;  //!pointer to histogram painter
     EBinErrorOpt  fBinStatErrOpt;   //option for bin statistical errors
+    TH1ConcurrentFill *fConcurrentFill; //!state of the concurrent fill mode, 0 if not enabled
     static Int_t  fgBufferSize;     //!default buffer size for automatic histograms
     static Bool_t fgAddDirectory;   //!flag to add histograms to the directory
     static Bool_t fgStatOverflows;  //!flag to use under/overflows in statistics
@@ -138,8 +147,11 @@ private:
    TH1(const TH1&);
    TH1& operator=(const TH1&); // Not implemented
 
+   friend class TH1ConcurrentFill;
 
 protected:
+   enum { kFillNBlock = 256 };  // number of entries whose bins are computed at once by FillN
+
    TH1();
    TH1(const char *name,const char *title,Int_t nbinsx,Double_t xlow,Double_t xup);
    TH1(const char *name,const char *title,Int_t nbinsx,const Float_t *xbins);
@@ -155,6 +167,10 @@ protected:
 
    virtual void     DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride=1);
 
+   Bool_t           ConcurrentFill(Int_t ncoord, Double_t w, Double_t x, Double_t y=0, Double_t z=0, Double_t t=0);
+   Bool_t           ConcurrentFillN(Int_t ncoord, Int_t ntimes, const Double_t *w, const Double_t *x, const Double_t *y, Int_t stride);
+   Bool_t           ConcurrentFillEmpty(Int_t &nentries);
+
    static bool CheckAxisLimits(const TAxis* a1, const TAxis* a2);
    static bool CheckBinLimits(const TAxis* a1, const TAxis* a2);
    static bool CheckBinLabels(const TAxis* a1, const TAxis* a2);
@@ -237,6 +253,7 @@ public:
    Int_t            GetBufferLength() const {return fBuffer ? (Int_t)fBuffer[0] : 0;}
    Int_t            GetBufferSize  () const {return fBufferSize;}
    const   Double_t *GetBuffer() const {return fBuffer;}
+   EConcurrentFill  GetConcurrentFill() const;
    static  Int_t    GetDefaultBufferSize();
    virtual Double_t *GetIntegral();
    TH1             *GetCumulative(Bool_t forward = kTRUE, const char* suffix = "_cumulative") const;
@@ -373,6 +390,7 @@ public:
    virtual void     SetBinErrorOption(EBinErrorOpt type) { fBinStatErrOpt = type; }
    virtual void     SetBuffer(Int_t buffersize, Option_t *option="");
    virtual UInt_t   SetCanExtend(UInt_t extendBitMask);
+   void             SetConcurrentFill(EConcurrentFill mode = kThreadBufferFill);
    virtual void     SetContent(const Double_t *content);
    virtual void     SetContour(Int_t nlevels, const Double_t *levels=0);
    virtual void     SetContourLevel(Int_t level, Double_t value);
@@ -404,6 +404,36 @@ Int_t TAxis::FindFixBin(Double_t x) const
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Find the bins of the n values x[0], x[stride], ... x[(n-1)*stride] and store
+/// them in bins. Each bin is the one returned by FindFixBin. For fix bins the
+/// loop has no branch, so that the compiler can vectorize it; variable bins
+/// are found by binary search.
+
+void TAxis::FindFixBins(Int_t n, const Double_t *x, Int_t *bins, Int_t stride) const
+{
+   const Int_t    nbins = fNbins;
+   const Double_t xmin  = fXmin;
+   const Double_t xmax  = fXmax;
+   if (!fXbins.fN) {
+      const Double_t width = xmax - xmin;
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t xi = x[i*stride];
+         const Bool_t inside = (xi >= xmin) && (xi < xmax);   // false for NaN
+         // the values out of range are not converted, the int could overflow
+         const Int_t bin = 1 + int(inside ? nbins*(xi-xmin)/width : 0.);
+         bins[i] = inside ? bin : (xi < xmin ? 0 : nbins+1);
+      }
+   } else {
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t xi = x[i*stride];
+         if (xi < xmin)          bins[i] = 0;
+         else if (!(xi < xmax))  bins[i] = nbins+1;
+         else                    bins[i] = 1 + TMath::BinarySearch(fXbins.fN,fXbins.fArray,xi);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return label for bin
 
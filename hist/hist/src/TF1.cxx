@@ -1196,6 +1196,40 @@ Double_t TF1::EvalPar(const Double_t *x, const Double_t *params)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the function at n points with the parameters params (the
+/// current parameters if params is 0) and store the n values in result.
+/// The coordinates are given variable after variable: the value of the
+/// coordinate idim of the point i is x[idim*n + i].
+///
+/// The functions defined by a formula are evaluated with
+/// TFormula::EvalParBatch, in a single call to a vectorizable loop;
+/// the other functions are evaluated point by point with EvalPar.
+
+void TF1::EvalParBatch(Int_t n, const Double_t *x, Double_t *result, const Double_t *params)
+{
+   if (n <= 0) return;
+   fgCurrent = this;
+
+   if (fType == 0) {
+      assert(fFormula);
+      fFormula->EvalParBatch(n, x, result, params);
+      if (fNormalized && fNormIntegral != 0) {
+         for (Int_t i = 0; i < n; ++i) result[i] /= fNormIntegral;
+      }
+      return;
+   }
+
+   Int_t ndim = GetNdim();
+   std::vector<Double_t> point(ndim > 0 ? ndim : 1);
+   if (fMethodCall) InitArgs(&point[0], params ? params : GetParameters());
+   for (Int_t i = 0; i < n; ++i) {
+      for (Int_t idim = 0; idim < ndim; ++idim) point[idim] = x[idim*n + i];
+      result[i] = EvalPar(&point[0], params);
+   }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
 ///
@@ -144,6 +144,10 @@ static const TString gNamePrefix = "TFormula__";
 // static map of function pointers and expressions
 //static std::unordered_map<std::string,  TInterpreter::CallFuncIFacePtr_t::Generic_t> gClingFunctions = std::unordered_map<TString,  TInterpreter::CallFuncIFacePtr_t::Generic_t>();
 static std::unordered_map<std::string,  void *> gClingFunctions = std::unordered_map<std::string,  void * >();
+// static map of the batch function pointers, the key is the code of the batch function
+static std::unordered_map<std::string,  void *> gClingBatchFunctions = std::unordered_map<std::string,  void * >();
+
+Bool_t TFormula::fgBatchFastMath = kFALSE;
 
 Bool_t TFormula::IsOperator(const char c)
 {
@@ -249,6 +253,7 @@ TFormula::TFormula()
    fClingInitialized = false;
    fAllParametersSetted = false;
    fMethod = 0;
+   fBatchFuncPtr = 0;
    fNdim = 0;
    fNpar = 0;
    fNumber = 0;
@@ -322,6 +327,7 @@ TFormula::TFormula(const char *name, const char *formula, bool addToGlobList)
    fReadyToExecute = false;
    fClingInitialized = false;
    fMethod = 0;
+   fBatchFuncPtr = 0;
    fNdim = 0;
    fNpar = 0;
    fNumber = 0;
@@ -357,6 +363,7 @@ TFormula::TFormula(const TFormula &formula) : TNamed(formula.GetName(),formula.G
    fReadyToExecute = false;
    fClingInitialized = false;
    fMethod = 0;
+   fBatchFuncPtr = 0;
    fNdim = formula.GetNdim();
    fNpar = formula.GetNpar();
    fNumber = formula.GetNumber();
@@ -483,6 +490,7 @@ void TFormula::Copy(TObject &obj) const
    }
 
    fnew.fFuncPtr = fFuncPtr;
+   fnew.fBatchFuncPtr = fBatchFuncPtr;
 
 }
 
@@ -498,6 +506,7 @@ void TFormula::Clear(Option_t * )
 
    if(fMethod) fMethod->Delete();
    fMethod = nullptr;
+   fBatchFuncPtr = nullptr;
 
    fClingVariables.clear();
    fClingParameters.clear();
@@ -1689,6 +1698,8 @@ void TFormula::ProcessFormula(TString &formula)
          fClingName = TString::Format("%s__id%zu",gNamePrefix.Data(),(unsigned long) hasher(inputFormula) );
 
          fClingInput = TString::Format("Double_t %s(%s){ return %s ; }", fClingName.Data(),argumentsPrototype.Data(),inputFormula.c_str());
+         // the batch function, if any, is the one of the previous expression
+         fBatchFuncPtr = nullptr;
 
          // this is not needed (maybe can be re-added in case of recompilation of identical expressions
          // // check in case of a change if need to re-initialize
@@ -2444,6 +2455,124 @@ Double_t TFormula::DoEval(const double * x, const double * params) const
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Compile with Cling the function evaluating the formula on several points,
+/// used by EvalParBatch. The expression is evaluated in a loop over the
+/// points which the compiler can vectorize; when SetBatchFastMath is set
+/// TMath::Exp, Log, Sin and Cos are replaced by their VDT approximations.
+/// The function is compiled only when EvalParBatch is called. The check and
+/// the compilation are done under gInterpreterMutex, so that several threads
+/// evaluating the same formula compile it once.
+/// Return false if the function could not be compiled.
+
+Bool_t TFormula::PrepareBatchMethod() const
+{
+   R__LOCKGUARD2(gInterpreterMutex);
+
+   if (fBatchFuncPtr) return true;
+   if (!fReadyToExecute || !fClingInitialized || fNdim <= 0) return false;
+
+   TString expression = GetExpFormula("CLING");
+
+   Bool_t fastMath = fgBatchFastMath;
+   if (fastMath) {
+      static Bool_t hasVdt = gInterpreter->Declare("#include \"vdt/vdtMath.h\"");
+      if (!hasVdt) {
+         Warning("PrepareBatchMethod","VDT is not available, the batch evaluation uses TMath");
+         fgBatchFastMath = fastMath = kFALSE;
+      }
+   }
+   if (fastMath) {
+      expression.ReplaceAll("TMath::Exp(","vdt::fast_exp(");
+      expression.ReplaceAll("TMath::Log(","vdt::fast_log(");
+      expression.ReplaceAll("TMath::Sin(","vdt::fast_sin(");
+      expression.ReplaceAll("TMath::Cos(","vdt::fast_cos(");
+   }
+
+   // the points are given variable after variable: x[ivar*n + i]
+   TString vars = "xx[i]";
+   for (Int_t ivar = 1; ivar < fNdim; ++ivar) vars += TString::Format(",xx[%d*n+i]",ivar);
+
+   TString batchName = TString::Format("%s__batch%d%s",fClingName.Data(),fNdim,(fastMath ? "_vdt" : ""));
+   TString batchInput = TString::Format("void %s(Int_t n, Double_t *xx, Double_t *p, Double_t *res){ "
+                                        "for (Int_t i = 0; i < n; ++i) { Double_t x[%d] = { %s }; res[i] = %s; } }",
+                                        batchName.Data(), fNdim, vars.Data(), expression.Data());
+
+   auto funcit = gClingBatchFunctions.find(std::string(batchInput.Data()));
+   if (funcit != gClingBatchFunctions.end()) {
+      fBatchFuncPtr = (TInterpreter::CallFuncIFacePtr_t::Generic_t) funcit->second;
+      return true;
+   }
+
+   if (!gInterpreter->Declare(batchInput)) {
+      Error("PrepareBatchMethod","Can't compile the batch function of %s",GetExpFormula().Data());
+      return false;
+   }
+   TMethodCall method;
+   method.InitWithPrototype(batchName,"Int_t,Double_t*,Double_t*,Double_t*");
+   if (!method.IsValid()) {
+      Error("PrepareBatchMethod","Can't find %s function prototype",batchName.Data());
+      return false;
+   }
+   TInterpreter::CallFuncIFacePtr_t faceptr = gCling->CallFunc_IFacePtr(method.GetCallFunc());
+   fBatchFuncPtr = faceptr.fGeneric;
+   gClingBatchFunctions.insert(std::make_pair(std::string(batchInput.Data()), (void*) fBatchFuncPtr));
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula at n points with the parameters params (the current
+/// parameters if params is 0) and store the n values in result.
+/// The coordinates are given variable after variable: the value of the
+/// variable ivar for the point i is x[ivar*n + i].
+///
+/// The formula is evaluated in a single call by a function compiled on the
+/// first use, whose loop over the points can be vectorized. This is much
+/// faster than calling EvalPar for each point. If the function cannot be
+/// compiled the points are evaluated one by one.
+
+void TFormula::EvalParBatch(Int_t n, const Double_t *x, Double_t *result, const Double_t *params) const
+{
+   if (n <= 0) return;
+   if (!PrepareBatchMethod()) {
+      std::vector<Double_t> point(fNdim > 0 ? fNdim : 1);
+      for (Int_t i = 0; i < n; ++i) {
+         for (Int_t ivar = 0; ivar < fNdim; ++ivar) point[ivar] = x[ivar*n + i];
+         result[i] = DoEval((fNdim > 0 ? &point[0] : nullptr), params);
+      }
+      return;
+   }
+
+   void* args[4];
+   double * vars = const_cast<double*>(x);
+   double * pars = (params) ? const_cast<double*>(params) : const_cast<double*>(fClingParameters.data());
+   args[0] = &n;
+   args[1] = &vars;
+   args[2] = &pars;
+   args[3] = &result;
+   (*fBatchFuncPtr)(0, 4, args, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the batch evaluation uses the VDT fast math functions.
+
+Bool_t TFormula::GetBatchFastMath()
+{
+   return fgBatchFastMath;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Use (fast = true) the VDT approximations of exp, log, sin and cos in the
+/// batch evaluation (EvalParBatch) of the formulas. They are vectorizable and
+/// accurate to a few units in the last place, but do not handle all the
+/// special values like TMath. Apply to the formulas whose batch function is
+/// compiled afterwards, i.e. not yet evaluated with EvalParBatch.
+
+void TFormula::SetBatchFastMath(Bool_t fast)
+{
+   fgBatchFastMath = fast;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// return the expression formula
 /// If option = "P" replace the parameter names with their values
@@ -14,6 +14,10 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <sstream>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <vector>
 
 #include "Riostream.h"
 #include "TROOT.h"
@@ -39,6 +43,7 @@
 #include "TVirtualHistPainter.h"
 #include "TVirtualFFT.h"
 #include "TSystem.h"
+#include "ThreadLocalStorage.h"
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -307,6 +312,29 @@ All histogram classes are derived from the base class TH1
      capacity (127 or 32767). Histograms of all types may have positive
      or/and negative bin contents.
 
+<h4>Filling histograms from several threads</h4>
+
+     By default an histogram must be filled by one thread at a time. The
+     function TH1::SetConcurrentFill enables the concurrent filling of the
+     histograms and profiles of 1, 2 and 3 dimensions with the numeric
+     Fill and FillN functions:
+<pre>
+       h->SetConcurrentFill(TH1::kThreadBufferFill); // or TH1::kAtomicFill
+       // ... any number of threads call h->Fill(x) ...
+       h->GetBinContent(bin); // applies the pending entries
+</pre>
+     With TH1::kAtomicFill each entry is applied immediately under a lock
+     held by the histogram; this is the best choice when the histogram is
+     rarely filled. With TH1::kThreadBufferFill each thread accumulates its
+     entries in its own buffer, which is applied to the histogram when it
+     is full or when the histogram is read (GetBinContent, GetEntries,
+     Write, Add, ...), like the entries of the histogram buffer.
+     In both modes the Fill functions return -2 (-3 for TH2 and TH3), as
+     when a buffer is in use; the statistics and the sum of squares of
+     weights are filled as usual. The histogram must not be read while
+     other threads are filling it, and the Fill functions taking a bin
+     label, which may add bins to the axes, are not covered.
+
 <h4>Rebinning</h4>
 
      At any time, an histogram can be rebinned via TH1::Rebin. This function
@@ -546,6 +574,232 @@ class DifferentAxisLimits: public std::exception {};
 class DifferentBinLimits: public std::exception {};
 class DifferentLabels: public std::exception {};
 
+////////////////////////////////////////////////////////////////////////////////
+/// State of the concurrent fill mode of an histogram (see TH1::SetConcurrentFill).
+///
+/// The fills are applied to the histogram by swapping a block of entries,
+/// stored with the layout of TH1::fBuffer, in place of the histogram buffer
+/// and calling BufferEmpty. This is done under fMutex, with the thread local
+/// ReplayedHistogram() pointing to the histogram so that the Fill functions
+/// called by BufferEmpty, as well as BufferEmpty itself, take their usual path.
+/// In the kThreadBufferFill mode, each thread appends its entries to its own
+/// shard, identified by a process wide thread slot (see TH1ThreadSlot); the
+/// spin lock of a shard is only contended when the histogram is read while the
+/// thread is filling.
+
+class TH1ConcurrentFill {
+
+public:
+   enum {
+      kMaxShards     = 256,   // threads beyond this number fill under the lock
+      kShardEntries  = 1000   // number of entries of a shard before it is applied
+   };
+
+private:
+   struct TShard {
+      std::atomic_flag       fLock;    // protects fBuffer
+      std::vector<Double_t>  fBuffer;  // pending entries, same layout as TH1::fBuffer
+      TShard() { fLock.clear(); }
+      void Lock() { while (fLock.test_and_set(std::memory_order_acquire)) { } }
+      void Unlock() { fLock.clear(std::memory_order_release); }
+   };
+
+   TH1::EConcurrentFill  fMode;                // the concurrent fill mode
+   std::mutex            fMutex;               // serializes the changes of the histogram
+   std::atomic<TShard*>  fShards[kMaxShards];  // the shard of each thread slot, created on first use
+   std::atomic<Int_t>    fNShards;             // one more than the highest slot in use
+
+   TH1ConcurrentFill(const TH1ConcurrentFill&);            // not implemented
+   TH1ConcurrentFill& operator=(const TH1ConcurrentFill&); // not implemented
+
+   TShard *GetShard();
+   void    Replay(TH1 *h, Double_t *buffer, Int_t size);
+
+public:
+   TH1ConcurrentFill(TH1::EConcurrentFill mode);
+   ~TH1ConcurrentFill();
+
+   static const TH1 *&ReplayedHistogram();
+
+   TH1::EConcurrentFill GetMode() const { return fMode; }
+   Int_t   Empty(TH1 *h);
+   void    Fill(TH1 *h, const Double_t *entry, Int_t stride);
+   void    FillN(TH1 *h, Double_t *buffer, Int_t size);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process wide slot of a thread in the kThreadBufferFill mode, held in a
+/// thread local object: the slot is taken on the first fill of the thread and
+/// given back when the thread exits, so that the threads created later reuse
+/// the slots of the finished ones. The lowest free slot is taken first.
+/// Threads beyond TH1ConcurrentFill::kMaxShards running at the same time get
+/// no slot and fill under the lock of the histogram.
+
+class TH1ThreadSlot {
+
+private:
+   Int_t fSlot;   // the slot of the thread, -1 if none
+
+   static std::mutex &Mutex() { static std::mutex mutex; return mutex; }
+   static std::set<Int_t> &FreeSlots() { static std::set<Int_t> slots; return slots; }
+   static Int_t &NextSlot() { static Int_t next = 0; return next; }
+
+   TH1ThreadSlot(const TH1ThreadSlot&);            // not implemented
+   TH1ThreadSlot& operator=(const TH1ThreadSlot&); // not implemented
+
+public:
+   TH1ThreadSlot() : fSlot(-1)
+   {
+      std::lock_guard<std::mutex> lock(Mutex());
+      std::set<Int_t> &free = FreeSlots();
+      if (!free.empty()) {
+         fSlot = *free.begin();
+         free.erase(free.begin());
+      } else if (NextSlot() < TH1ConcurrentFill::kMaxShards) {
+         fSlot = NextSlot()++;
+      }
+   }
+   ~TH1ThreadSlot()
+   {
+      if (fSlot < 0) return;
+      std::lock_guard<std::mutex> lock(Mutex());
+      FreeSlots().insert(fSlot);
+   }
+   Int_t Get() const { return fSlot; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+
+TH1ConcurrentFill::TH1ConcurrentFill(TH1::EConcurrentFill mode) : fMode(mode), fNShards(0)
+{
+   for (Int_t i = 0; i < kMaxShards; ++i) fShards[i] = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor, the entries not yet applied are dropped.
+
+TH1ConcurrentFill::~TH1ConcurrentFill()
+{
+   for (Int_t i = 0; i < fNShards; ++i) delete fShards[i].load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a reference to the thread local pointer to the histogram whose
+/// entries are being applied by the calling thread, 0 if none.
+
+const TH1 *&TH1ConcurrentFill::ReplayedHistogram()
+{
+   TTHREAD_TLS(const TH1*) replayed(0);
+   return replayed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the shard of the calling thread, 0 if all the shards are used by
+/// other threads. A shard may still hold entries of a finished thread which
+/// had the same slot; they are applied with the new ones.
+
+TH1ConcurrentFill::TShard *TH1ConcurrentFill::GetShard()
+{
+   TTHREAD_TLS_DECL(TH1ThreadSlot, threadSlot);
+   Int_t slot = threadSlot.Get();
+   if (slot < 0) return 0;
+
+   TShard *shard = fShards[slot].load(std::memory_order_acquire);
+   if (!shard) {
+      // Only the calling thread creates the shard of its slot.
+      shard = new TShard;
+      fShards[slot].store(shard, std::memory_order_release);
+      Int_t nshards = fNShards.load();
+      while (nshards < slot + 1 && !fNShards.compare_exchange_weak(nshards, slot + 1)) { }
+   }
+   return shard;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Apply the entries of buffer to the histogram. Must be called with fMutex held.
+
+void TH1ConcurrentFill::Replay(TH1 *h, Double_t *buffer, Int_t size)
+{
+   const TH1 *&replayed = ReplayedHistogram();
+   const TH1 *previous = replayed;
+   replayed = h;
+   Double_t *keep = h->fBuffer;
+   Int_t keepSize = h->fBufferSize;
+   h->fBuffer = buffer;
+   h->fBufferSize = size;
+   h->BufferEmpty(0);
+   h->fBuffer = keep;
+   h->fBufferSize = keepSize;
+   replayed = previous;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Apply the entries pending in all the shards, return their number.
+
+Int_t TH1ConcurrentFill::Empty(TH1 *h)
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   Int_t nentries = 0;
+   Int_t nshards = fNShards.load();
+   for (Int_t i = 0; i < nshards; ++i) {
+      TShard *shard = fShards[i].load(std::memory_order_acquire);
+      if (!shard) continue;
+      std::vector<Double_t> pending;
+      shard->Lock();
+      pending.swap(shard->fBuffer);
+      shard->Unlock();
+      if (pending.empty()) continue;
+      nentries += (Int_t)pending[0];
+      Replay(h, &pending[0], pending.size());
+   }
+   return nentries;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram with one entry made of the stride values (w, x[, y[, z[, t]]]).
+
+void TH1ConcurrentFill::Fill(TH1 *h, const Double_t *entry, Int_t stride)
+{
+   TShard *shard = (fMode == TH1::kThreadBufferFill) ? GetShard() : 0;
+   if (!shard) {
+      Double_t buffer[6];
+      buffer[0] = 1;
+      for (Int_t i = 0; i < stride; ++i) buffer[i+1] = entry[i];
+      std::lock_guard<std::mutex> lock(fMutex);
+      Replay(h, buffer, stride + 1);
+      return;
+   }
+
+   std::vector<Double_t> full;
+   shard->Lock();
+   std::vector<Double_t> &buffer = shard->fBuffer;
+   if (buffer.empty()) {
+      buffer.reserve(1 + kShardEntries*stride);
+      buffer.push_back(0);
+   }
+   buffer.insert(buffer.end(), entry, entry + stride);
+   buffer[0] += 1;
+   if (buffer[0] >= kShardEntries) full.swap(buffer);
+   shard->Unlock();
+
+   if (!full.empty()) {
+      // Apply the shard outside of its lock: the lock order is fMutex, then the shards.
+      std::lock_guard<std::mutex> lock(fMutex);
+      Replay(h, &full[0], full.size());
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram with all the entries of buffer, in one step.
+
+void TH1ConcurrentFill::FillN(TH1 *h, Double_t *buffer, Int_t size)
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   Replay(h, buffer, size);
+}
+
+
 ClassImp(TH1)
 
 
@@ -567,6 +821,7 @@ TH1::TH1(): TNamed(), TAttLine(), TAttFill(), TAttMarker()
    fBufferSize    = 0;
    fBuffer        = 0;
    fBinStatErrOpt = kNormal;
+   fConcurrentFill = 0;
    fXaxis.SetName("xaxis");
    fYaxis.SetName("yaxis");
    fZaxis.SetName("zaxis");
@@ -589,6 +844,8 @@ TH1::~TH1()
    fIntegral = 0;
    delete[] fBuffer;
    fBuffer = 0;
+   delete fConcurrentFill;
+   fConcurrentFill = 0;
    if (fFunctions) {
       fFunctions->SetBit(kInvalidObject);
       TObject* obj = 0;
@@ -700,7 +957,7 @@ TH1::TH1(const char *name,const char *title,Int_t nbins,const Double_t *xbins)
 /// Copy constructor.
 /// The list of functions is not copied. (Use Clone if needed)
 
-TH1::TH1(const TH1 &h) : TNamed(), TAttLine(), TAttFill(), TAttMarker()
+TH1::TH1(const TH1 &h) : TNamed(), TAttLine(), TAttFill(), TAttMarker(), fConcurrentFill(0)
 {
    ((TH1&)h).Copy(*this);
 }
@@ -741,6 +998,7 @@ void TH1::Build()
    fBufferSize    = 0;
    fBuffer        = 0;
    fBinStatErrOpt = kNormal;
+   fConcurrentFill = 0;
    fXaxis.SetName("xaxis");
    fYaxis.SetName("yaxis");
    fZaxis.SetName("zaxis");
@@ -1253,6 +1511,9 @@ void TH1::AddDirectory(Bool_t add)
 
 Int_t TH1::BufferEmpty(Int_t action)
 {
+   Int_t nconcurrent = 0;
+   if (fConcurrentFill && ConcurrentFillEmpty(nconcurrent)) return nconcurrent;
+
    // do we need to compute the bin size?
    if (!fBuffer) return 0;
    Int_t nbentries = (Int_t)fBuffer[0];
@@ -2486,6 +2747,54 @@ TH1 *TH1::GetCumulative(Bool_t forward, const char* suffix) const
    return hintegrated;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill one entry in concurrent fill mode: ncoord is the number of coordinates
+/// (x, y, z, t) of the entry, which is stored with the layout of fBuffer.
+/// Return kFALSE if the calling thread is the one applying the concurrent
+/// entries to this histogram, in which case the caller must fill it directly.
+
+Bool_t TH1::ConcurrentFill(Int_t ncoord, Double_t w, Double_t x, Double_t y, Double_t z, Double_t t)
+{
+   if (TH1ConcurrentFill::ReplayedHistogram() == this) return kFALSE;
+   Double_t entry[5] = {w, x, y, z, t};
+   fConcurrentFill->Fill(this, entry, ncoord+1);
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill ntimes entries in concurrent fill mode, with ncoord (1 or 2) coordinates
+/// taken from x and y. The entries are applied at once, under the lock of the
+/// histogram. Return kFALSE if the caller must fill the histogram directly.
+
+Bool_t TH1::ConcurrentFillN(Int_t ncoord, Int_t ntimes, const Double_t *w, const Double_t *x, const Double_t *y, Int_t stride)
+{
+   if (TH1ConcurrentFill::ReplayedHistogram() == this) return kFALSE;
+   if (ntimes <= 0) return kTRUE;
+   std::vector<Double_t> buffer(1 + ntimes*(ncoord+1));
+   buffer[0] = ntimes;
+   Double_t *entry = &buffer[1];
+   for (Int_t i = 0; i < ntimes*stride; i += stride) {
+      *entry++ = w ? w[i] : 1.;
+      *entry++ = x[i];
+      if (ncoord > 1) *entry++ = y[i];
+   }
+   fConcurrentFill->FillN(this, &buffer[0], buffer.size());
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Called by BufferEmpty in concurrent fill mode: apply the entries pending
+/// in the per thread buffers and set nentries to their number.
+/// Return kFALSE if the calling thread is the one applying the concurrent
+/// entries to this histogram, in which case BufferEmpty must proceed as usual.
+
+Bool_t TH1::ConcurrentFillEmpty(Int_t &nentries)
+{
+   if (TH1ConcurrentFill::ReplayedHistogram() == this) return kFALSE;
+   nentries = fConcurrentFill->Empty(this);
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Copy this histogram structure to newth1.
 ///
@@ -2505,6 +2814,10 @@ void TH1::Copy(TObject &obj) const
       ((TH1&)obj).fDirectory->Remove(&obj);
       ((TH1&)obj).fDirectory = 0;
    }
+   if (((TH1&)obj).fConcurrentFill) {
+      delete ((TH1&)obj).fConcurrentFill;
+      ((TH1&)obj).fConcurrentFill = 0;
+   }
    TNamed::Copy(obj);
    ((TH1&)obj).fDimension = fDimension;
    ((TH1&)obj).fNormFactor= fNormFactor;
@@ -2512,14 +2825,16 @@ void TH1::Copy(TObject &obj) const
    ((TH1&)obj).fBarOffset = fBarOffset;
    ((TH1&)obj).fBarWidth  = fBarWidth;
    ((TH1&)obj).fOption    = fOption;
-   ((TH1&)obj).fBufferSize= fBufferSize;
+   // the pending concurrent fills are applied, the copy is not in concurrent fill mode
+   if (fConcurrentFill) const_cast<TH1*>(this)->BufferEmpty();
+   ((TH1&)obj).fBufferSize= fConcurrentFill ? 0 : fBufferSize;
    // copy the Buffer
    // delete first a previously existing buffer
    if (((TH1&)obj).fBuffer != 0)  {
       delete []  ((TH1&)obj).fBuffer;
       ((TH1&)obj).fBuffer = 0;
    }
-   if (fBuffer) {
+   if (fBuffer && !fConcurrentFill) {
       Double_t *buf = new Double_t[fBufferSize];
       for (Int_t i=0;i<fBufferSize;i++) buf[i] = fBuffer[i];
       // obj.fBuffer has been deleted before
@@ -3170,6 +3485,7 @@ TH1* TH1::FFT(TH1* h_output, Option_t *option)
 
 Int_t TH1::Fill(Double_t x)
 {
+   if (fConcurrentFill && ConcurrentFill(1,1,x)) return -2;
    if (fBuffer)  return BufferFill(x,1);
 
    Int_t bin;
@@ -3203,7 +3519,7 @@ Int_t TH1::Fill(Double_t x)
 
 Int_t TH1::Fill(Double_t x, Double_t w)
 {
-
+   if (fConcurrentFill && ConcurrentFill(1,w,x)) return -2;
    if (fBuffer) return BufferFill(x,w);
 
    Int_t bin;
@@ -3273,9 +3589,14 @@ Int_t TH1::Fill(const char *namex, Double_t w)
 ///    weights is automatically triggered and the sum of the squares of weights is incremented
 ///    by w^2 in the bin corresponding to x.
 ///    if w is NULL each entry is assumed a weight=1
+///
+///    Unless the axis can be extended, the bins are computed by blocks of entries
+///    with TAxis::FindFixBins, which is much faster than a call to TAxis::FindBin
+///    per entry. The result is identical to filling the entries one by one.
 
 void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
 {
+   if (fConcurrentFill && ConcurrentFillN(1,ntimes,w,x,0,stride)) return;
    //If a buffer is activated, fill buffer
    if (fBuffer) {
       ntimes *= stride;
@@ -3300,27 +3621,42 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
 
 void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
 {
-   Int_t bin,i;
+   Int_t bin,i,j;
 
    fEntries += ntimes;
    Double_t ww = 1;
-   Int_t nbins   = fXaxis.GetNbins();
-   ntimes *= stride;
-   for (i=0;i<ntimes;i+=stride) {
-      bin =fXaxis.FindBin(x[i]);
-      if (bin <0) continue;
-      if (w) ww = w[i];
-      if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
-      if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
-      AddBinContent(bin, ww);
-      if (bin == 0 || bin > nbins) {
-         if (!fgStatOverflows) continue;
+   // The bins of a block of entries are computed at once by TAxis::FindFixBins,
+   // unless an entry can extend the axis, which changes the bins of the others.
+   // The entries are then added one by one, in order, as by Fill.
+   const Bool_t fixAxis = !fXaxis.CanExtend();
+   Int_t bins[kFillNBlock];
+   Int_t nblock;
+   for (Int_t first=0;first<ntimes;first+=nblock) {
+      if (fixAxis) {
+         nblock = TMath::Min(ntimes-first, (Int_t)kFillNBlock);
+         fXaxis.FindFixBins(nblock, &x[first*stride], bins, stride);
+      } else {
+         nblock = 1;
+         bins[0] = fXaxis.FindBin(x[first*stride]);
+      }
+      Int_t nbins = fXaxis.GetNbins();
+      for (j=0;j<nblock;j++) {
+         i = (first+j)*stride;
+         bin = bins[j];
+         if (bin <0) continue;
+         if (w) ww = w[i];
+         if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin, ww);
+         if (bin == 0 || bin > nbins) {
+            if (!fgStatOverflows) continue;
+         }
+         Double_t z= ww;
+         fTsumw   += z;
+         fTsumw2  += z*z;
+         fTsumwx  += z*x[i];
+         fTsumwx2 += z*x[i]*x[i];
       }
-      Double_t z= ww;
-      fTsumw   += z;
-      fTsumw2  += z*z;
-      fTsumwx  += z*x[i];
-      fTsumwx2 += z*x[i]*x[i];
    }
 }
 
@@ -4064,6 +4400,7 @@ Bool_t TH1::GetDefaultSumw2()
 
 Double_t TH1::GetEntries() const
 {
+   if (fConcurrentFill) const_cast<TH1*>(this)->BufferEmpty();
    if (fBuffer) {
       Int_t nentries = (Int_t) fBuffer[0];
       if (nentries > 0) return nentries;
@@ -6564,6 +6901,19 @@ void TH1::Streamer(TBuffer &b)
       b.CheckByteCount(R__s, R__c, TH1::IsA());
 
    } else {
+      if (fConcurrentFill) {
+         // apply the pending concurrent fills, the empty buffer used to detect
+         // the reads is not written
+         BufferEmpty();
+         Double_t *buffer = fBuffer;
+         Int_t keep = fBufferSize;
+         fBuffer = 0;
+         fBufferSize = 0;
+         b.WriteClassBuffer(TH1::Class(),this);
+         fBuffer = buffer;
+         fBufferSize = keep;
+         return;
+      }
       b.WriteClassBuffer(TH1::Class(),this);
    }
 }
@@ -7773,6 +8123,60 @@ Double_t TH1::KolmogorovTest(const TH1 *h2, Option_t *option) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the concurrent fill mode of this histogram (see SetConcurrentFill).
+
+TH1::EConcurrentFill TH1::GetConcurrentFill() const
+{
+   return fConcurrentFill ? fConcurrentFill->GetMode() : kNoConcurrentFill;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Allow several threads to fill this histogram at the same time with the
+/// numeric Fill and FillN functions:
+///
+///   - mode = kAtomicFill: each entry is applied immediately, under a lock
+///     held by the histogram. Best when the histogram is rarely filled.
+///   - mode = kThreadBufferFill: each thread stores its entries in its own
+///     buffer, applied under the lock when it is full (1000 entries) or when
+///     the histogram is read (GetBinContent, GetEntries, Write, ...), like
+///     the buffer set by SetBuffer. Best for histograms filled at high rate.
+///   - mode = kNoConcurrentFill: the pending entries are applied and the
+///     histogram returns to the single thread mode.
+///
+/// The mode must be changed while no thread is filling the histogram, and
+/// the histogram must not be read while it is being filled. Any buffer
+/// set by SetBuffer is emptied and deleted: the axis limits of an histogram
+/// with automatic bins are computed from the first block of entries applied.
+/// The Fill functions taking bin labels and the classes with their own Fill
+/// functions (e.g. TH2Poly, TH1K) do not support the concurrent fill mode.
+
+void TH1::SetConcurrentFill(EConcurrentFill mode)
+{
+   if (mode == GetConcurrentFill()) return;
+
+   if (fConcurrentFill) {
+      BufferEmpty();
+      delete fConcurrentFill;
+      fConcurrentFill = 0;
+      delete [] fBuffer;
+      fBuffer = 0;
+      fBufferSize = 0;
+   }
+   if (mode == kNoConcurrentFill) return;
+
+   if (fBuffer) BufferEmpty(1);
+   fConcurrentFill = new TH1ConcurrentFill(mode);
+   if (mode == kThreadBufferFill) {
+      // An empty buffer, so that the functions reading the histogram call
+      // BufferEmpty, which applies the entries of the threads.
+      fBufferSize = 1;
+      fBuffer = new Double_t[fBufferSize];
+      fBuffer[0] = 0;
+   }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Replace bin contents by the contents of array content
 
@@ -7843,6 +8247,10 @@ Double_t TH1::GetContourLevelPad(Int_t level) const
 
 void TH1::SetBuffer(Int_t buffersize, Option_t * /*option*/)
 {
+   if (fConcurrentFill) {
+      Error("SetBuffer", "a buffer cannot be used in concurrent fill mode");
+      return;
+   }
    if (fBuffer) {
       BufferEmpty();
       delete [] fBuffer;
@@ -163,6 +163,9 @@ TH2::~TH2()
 
 Int_t TH2::BufferEmpty(Int_t action)
 {
+   Int_t nconcurrent = 0;
+   if (fConcurrentFill && ConcurrentFillEmpty(nconcurrent)) return nconcurrent;
+
    // do we need to compute the bin size?
    if (!fBuffer) return 0;
    Int_t nbentries = (Int_t)fBuffer[0];
@@ -298,6 +301,7 @@ Int_t TH2::Fill(Double_t )
 
 Int_t TH2::Fill(Double_t x,Double_t y)
 {
+   if (fConcurrentFill && ConcurrentFill(2,1,x,y)) return -3;
    if (fBuffer) return BufferFill(x,y,1);
 
    Int_t binx, biny, bin;
@@ -342,6 +346,7 @@ Int_t TH2::Fill(Double_t x,Double_t y)
 
 Int_t TH2::Fill(Double_t x, Double_t y, Double_t w)
 {
+   if (fConcurrentFill && ConcurrentFill(2,w,x,y)) return -3;
    if (fBuffer) return BufferFill(x,y,w);
 
    Int_t binx, biny, bin;
@@ -512,11 +517,13 @@ Int_t TH2::Fill(Double_t x, const char *namey, Double_t w)
 ///   weights is automatically triggered and the sum of the squares of weights is incremented
 ///   by w[i]^2 in the bin corresponding to x[i],y[i].
 ///  If w is NULL each entry is assumed a weight=1
+///  The bins of the entries are computed by blocks, see TH1::FillN.
 ///
 /// NB: function only valid for a TH2x object
 
 void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
 {
+   if (fConcurrentFill && ConcurrentFillN(2,ntimes,w,x,y,stride)) return;
    Int_t binx, biny, bin, i;
    ntimes *= stride;
    Int_t ifirst = 0;
@@ -536,31 +543,48 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
          return;
    }
 
+   // The bins of a block of entries are computed at once by TAxis::FindFixBins,
+   // unless an entry can extend an axis (see TH1::DoFillN).
+   const Bool_t fixAxes = !fXaxis.CanExtend() && !fYaxis.CanExtend();
+   Int_t binsx[kFillNBlock], binsy[kFillNBlock];
+   Int_t nblock, j;
    Double_t ww = 1;
-   for (i=ifirst;i<ntimes;i+=stride) {
-      fEntries++;
-      binx = fXaxis.FindBin(x[i]);
-      biny = fYaxis.FindBin(y[i]);
-      if (binx <0 || biny <0) continue;
-      bin  = biny*(fXaxis.GetNbins()+2) + binx;
-      if (w) ww = w[i];
-      if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
-      if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
-      AddBinContent(bin,ww);
-      if (binx == 0 || binx > fXaxis.GetNbins()) {
-         if (!fgStatOverflows) continue;
+   for (Int_t first=ifirst;first<ntimes;first+=nblock*stride) {
+      if (fixAxes) {
+         nblock = TMath::Min((ntimes-first+stride-1)/stride, (Int_t)kFillNBlock);
+         fXaxis.FindFixBins(nblock, &x[first], binsx, stride);
+         fYaxis.FindFixBins(nblock, &y[first], binsy, stride);
+      } else {
+         nblock = 1;
+         binsx[0] = fXaxis.FindBin(x[first]);
+         binsy[0] = fYaxis.FindBin(y[first]);
       }
-      if (biny == 0 || biny > fYaxis.GetNbins()) {
-         if (!fgStatOverflows) continue;
+      for (j=0;j<nblock;j++) {
+         i = first + j*stride;
+         fEntries++;
+         binx = binsx[j];
+         biny = binsy[j];
+         if (binx <0 || biny <0) continue;
+         bin  = biny*(fXaxis.GetNbins()+2) + binx;
+         if (w) ww = w[i];
+         if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+         if (binx == 0 || binx > fXaxis.GetNbins()) {
+            if (!fgStatOverflows) continue;
+         }
+         if (biny == 0 || biny > fYaxis.GetNbins()) {
+            if (!fgStatOverflows) continue;
+         }
+         Double_t z= ww; //(ww > 0 ? ww : -ww);
+         fTsumw   += z;
+         fTsumw2  += z*z;
+         fTsumwx  += z*x[i];
+         fTsumwx2 += z*x[i]*x[i];
+         fTsumwy  += z*y[i];
+         fTsumwy2 += z*y[i]*y[i];
+         fTsumwxy += z*x[i]*y[i];
       }
-      Double_t z= ww; //(ww > 0 ? ww : -ww);
-      fTsumw   += z;
-      fTsumw2  += z*z;
-      fTsumwx  += z*x[i];
-      fTsumwx2 += z*x[i]*x[i];
-      fTsumwy  += z*y[i];
-      fTsumwy2 += z*y[i]*y[i];
-      fTsumwxy += z*x[i]*y[i];
    }
 }
 
@@ -162,6 +162,9 @@ void TH3::Copy(TObject &obj) const
 
 Int_t TH3::BufferEmpty(Int_t action)
 {
+   Int_t nconcurrent = 0;
+   if (fConcurrentFill && ConcurrentFillEmpty(nconcurrent)) return nconcurrent;
+
    // do we need to compute the bin size?
    if (!fBuffer) return 0;
    Int_t nbentries = (Int_t)fBuffer[0];
@@ -278,6 +281,7 @@ Int_t TH3::Fill(Double_t )
 
 Int_t TH3::Fill(Double_t x, Double_t y, Double_t z)
 {
+   if (fConcurrentFill && ConcurrentFill(3,1,x,y,z)) return -3;
    if (fBuffer) return BufferFill(x,y,z,1);
 
    Int_t binx, biny, binz, bin;
@@ -326,6 +330,7 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z)
 
 Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
 {
+   if (fConcurrentFill && ConcurrentFill(3,w,x,y,z)) return -3;
    if (fBuffer) return BufferFill(x,y,z,w);
 
    Int_t binx, biny, binz, bin;
@@ -362,6 +367,93 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 3-D histogram with an array of values and weights.
+///
+/// ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+/// x:       array of x values to be histogrammed
+/// y:       array of y values to be histogrammed
+/// z:       array of z values to be histogrammed
+/// w:       array of weights
+/// stride:  step size through arrays x, y, z and w
+///
+/// If w is NULL each entry is assumed a weight=1.
+/// The bins of the entries are computed by blocks, see TH1::FillN.
+
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t binx, biny, binz, bin, i;
+   ntimes *= stride;
+   Int_t ifirst = 0;
+
+   // In concurrent fill mode or if a buffer is activated, fill entry by entry
+   // (note that this function must not be called from TH3::BufferEmpty).
+   // TH3::Fill is called explicitly: the Fill(x,y,z,w) of a derived class,
+   // e.g. TProfile3D, can have another meaning.
+   if (fConcurrentFill || fBuffer) {
+      for (i=0;i<ntimes;i+=stride) {
+         if (!fConcurrentFill && !fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         TH3::Fill(x[i],y[i],z[i],w ? w[i] : 1.);
+      }
+      if (i < ntimes)
+         ifirst = i;
+      else
+         return;
+   }
+
+   const Bool_t fixAxes = !fXaxis.CanExtend() && !fYaxis.CanExtend() && !fZaxis.CanExtend();
+   Int_t binsx[kFillNBlock], binsy[kFillNBlock], binsz[kFillNBlock];
+   Int_t nblock, j;
+   Double_t ww = 1;
+   for (Int_t first=ifirst;first<ntimes;first+=nblock*stride) {
+      if (fixAxes) {
+         nblock = TMath::Min((ntimes-first+stride-1)/stride, (Int_t)kFillNBlock);
+         fXaxis.FindFixBins(nblock, &x[first], binsx, stride);
+         fYaxis.FindFixBins(nblock, &y[first], binsy, stride);
+         fZaxis.FindFixBins(nblock, &z[first], binsz, stride);
+      } else {
+         nblock = 1;
+         binsx[0] = fXaxis.FindBin(x[first]);
+         binsy[0] = fYaxis.FindBin(y[first]);
+         binsz[0] = fZaxis.FindBin(z[first]);
+      }
+      for (j=0;j<nblock;j++) {
+         i = first + j*stride;
+         fEntries++;
+         binx = binsx[j];
+         biny = binsy[j];
+         binz = binsz[j];
+         if (binx <0 || biny <0 || binz<0) continue;
+         bin  =  binx + (fXaxis.GetNbins()+2)*(biny + (fYaxis.GetNbins()+2)*binz);
+         if (w) ww = w[i];
+         if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+         if (binx == 0 || binx > fXaxis.GetNbins()) {
+            if (!fgStatOverflows) continue;
+         }
+         if (biny == 0 || biny > fYaxis.GetNbins()) {
+            if (!fgStatOverflows) continue;
+         }
+         if (binz == 0 || binz > fZaxis.GetNbins()) {
+            if (!fgStatOverflows) continue;
+         }
+         fTsumw   += ww;
+         fTsumw2  += ww*ww;
+         fTsumwx  += ww*x[i];
+         fTsumwx2 += ww*x[i]*x[i];
+         fTsumwy  += ww*y[i];
+         fTsumwy2 += ww*y[i]*y[i];
+         fTsumwxy += ww*x[i]*y[i];
+         fTsumwz  += ww*z[i];
+         fTsumwz2 += ww*z[i]*z[i];
+         fTsumwxz += ww*x[i]*z[i];
+         fTsumwyz += ww*y[i]*z[i];
+      }
+   }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Increment cell defined by namex,namey,namez by a weight w
 ///
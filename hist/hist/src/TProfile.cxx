@@ -335,6 +335,9 @@ void TProfile::Approximate(Bool_t approx)
 
 Int_t TProfile::BufferEmpty(Int_t action)
 {
+   Int_t nconcurrent = 0;
+   if (fConcurrentFill && ConcurrentFillEmpty(nconcurrent)) return nconcurrent;
+
    // do we need to compute the bin size?
    if (!fBuffer) return 0;
    Int_t nbentries = (Int_t)fBuffer[0];
@@ -650,6 +653,7 @@ Bool_t TProfile::Divide(const TH1 *h1, const TH1 *h2, Double_t c1, Double_t c2,
 
 Int_t TProfile::Fill(Double_t x, Double_t y)
 {
+   if (fConcurrentFill && ConcurrentFill(2,1,x,y)) return -2;
    if (fBuffer) return BufferFill(x,y,1);
 
    Int_t bin;
@@ -711,6 +715,7 @@ Int_t TProfile::Fill(const char *namex, Double_t y)
 
 Int_t TProfile::Fill(Double_t x, Double_t y, Double_t w)
 {
+   if (fConcurrentFill && ConcurrentFill(2,w,x,y)) return -2;
    if (fBuffer) return BufferFill(x,y,w);
 
    Int_t bin;
@@ -778,6 +783,7 @@ Int_t TProfile::Fill(const char *namex, Double_t y, Double_t w)
 
 void TProfile::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
 {
+   if (fConcurrentFill && ConcurrentFillN(2,ntimes,w,x,y,stride)) return;
    Int_t bin,i;
    ntimes *= stride;
    Int_t ifirst = 0; 
@@ -1687,6 +1693,10 @@ void TProfile::SetBinsLength(Int_t n)
 
 void TProfile::SetBuffer(Int_t buffersize, Option_t *)
 {
+   if (fConcurrentFill) {
+      Error("SetBuffer", "a buffer cannot be used in concurrent fill mode");
+      return;
+   }
    if (fBuffer) {
       BufferEmpty();
       delete [] fBuffer;
@@ -276,6 +276,9 @@ void TProfile2D::Approximate(Bool_t approx)
 
 Int_t TProfile2D::BufferEmpty(Int_t action)
 {
+   Int_t nconcurrent = 0;
+   if (fConcurrentFill && ConcurrentFillEmpty(nconcurrent)) return nconcurrent;
+
    // do we need to compute the bin size?
    if (!fBuffer) return 0;
    Int_t nbentries = (Int_t)fBuffer[0];
@@ -596,6 +599,7 @@ Bool_t TProfile2D::Divide(const TH1 *h1, const TH1 *h2, Double_t c1, Double_t c2
 
 Int_t TProfile2D::Fill(Double_t x, Double_t y, Double_t z)
 {
+   if (fConcurrentFill && ConcurrentFill(3,1,x,y,z)) return -2;
    if (fBuffer) return BufferFill(x,y,z,1);
 
    Int_t bin,binx,biny;
@@ -750,6 +754,7 @@ Int_t TProfile2D::Fill(const char *namex, Double_t y, Double_t z)
 
 Int_t TProfile2D::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
 {
+   if (fConcurrentFill && ConcurrentFill(3,w,x,y,z)) return -2;
    if (fBuffer) return BufferFill(x,y,z,w);
 
    Int_t bin,binx,biny;
@@ -1877,6 +1882,10 @@ void TProfile2D::SetBinsLength(Int_t n)
 
 void TProfile2D::SetBuffer(Int_t buffersize, Option_t *)
 {
+   if (fConcurrentFill) {
+      Error("SetBuffer", "a buffer cannot be used in concurrent fill mode");
+      return;
+   }
    if (fBuffer) {
       BufferEmpty();
       delete [] fBuffer;
@@ -242,6 +242,9 @@ void TProfile3D::Approximate(Bool_t approx)
 
 Int_t TProfile3D::BufferEmpty(Int_t action)
 {
+   Int_t nconcurrent = 0;
+   if (fConcurrentFill && ConcurrentFillEmpty(nconcurrent)) return nconcurrent;
+
    // do we need to compute the bin size?
    if (!fBuffer) return 0;
    Int_t nbentries = (Int_t)fBuffer[0];
@@ -589,6 +592,7 @@ Bool_t TProfile3D::Divide(const TH1 *h1, const TH1 *h2, Double_t c1, Double_t c2
 
 Int_t TProfile3D::Fill(Double_t x, Double_t y, Double_t z, Double_t t)
 {
+   if (fConcurrentFill && ConcurrentFill(4,1,x,y,z,t)) return -2;
    if (fBuffer) return BufferFill(x,y,z,t,1);
 
    Int_t bin,binx,biny,binz;
@@ -639,6 +643,7 @@ Int_t TProfile3D::Fill(Double_t x, Double_t y, Double_t z, Double_t t)
 
 Int_t TProfile3D::Fill(Double_t x, Double_t y, Double_t z, Double_t t, Double_t w)
 {
+   if (fConcurrentFill && ConcurrentFill(4,w,x,y,z,t)) return -2;
    if (fBuffer) return BufferFill(x,y,z,t,w);
 
    Int_t bin,binx,biny,binz;
@@ -1440,6 +1445,10 @@ void TProfile3D::SetBinsLength(Int_t n)
 
 void TProfile3D::SetBuffer(Int_t buffersize, Option_t *)
 {
+   if (fConcurrentFill) {
+      Error("SetBuffer", "a buffer cannot be used in concurrent fill mode");
+      return;
+   }
    if (fBuffer) {
       BufferEmpty();
       delete [] fBuffer;
@@ -15,6 +15,7 @@
 #include "TClass.h"   // needed to copy the TF1 pointer
 
 #include <cmath>
+#include <vector>
 
 
 namespace ROOT {
@@ -235,6 +236,20 @@ double WrappedMultiTF1::DoParameterDerivative(const double * x, const double * p
    }
 }
 
+void WrappedMultiTF1::DoEvalParBatch(unsigned int n, const double * x, const double * p, double * f) const {
+   // evaluate the function at n points with TF1::EvalParBatch, which expects
+   // the coordinates variable after variable instead of point after point
+   if (fDim != (unsigned int) fFunc->GetNdim()) {
+      for (unsigned int i = 0; i < n; ++i) f[i] = DoEvalPar(x + i*fDim, p);
+      return;
+   }
+   std::vector<double> xvar(n * fDim);
+   for (unsigned int i = 0; i < n; ++i) {
+      for (unsigned int j = 0; j < fDim; ++j) xvar[j*n + i] = x[i*fDim + j];
+   }
+   fFunc->EvalParBatch(n, (n > 0) ? &xvar.front() : 0, f, p);
+}
+
 void WrappedMultiTF1::SetDerivPrecision(double eps) { fgEps = eps; }
 
 double WrappedMultiTF1::GetDerivPrecision( ) { return fgEps; }
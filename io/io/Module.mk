@@ -27,6 +27,11 @@ IODEP        := $(IOO:.o=.d) $(IODO:.o=.d)
 IOLIB        := $(LPATH)/libRIO.$(SOEXT)
 IOMAP        := $(IOLIB:.$(SOEXT)=.rootmap)
 
+# POSIX AIO used for the asynchronous reads of local files
+ifeq ($(PLATFORM),linux)
+IOLIBEXTRA   += -lrt
+endif
+
 # used in the main Makefile
 ALLHDRS      += $(patsubst $(MODDIRI)/%.h,include/%.h,$(IOH))
 ALLLIBS      += $(IOLIB)
@@ -41,6 +41,8 @@ class TFileCacheWrite;
 class TProcessID;
 class TStopwatch;
 class TFilePrefetch;
+class TFileAsyncReads;
+class TFileAsyncWrites;
 
 class TFile : public TDirectoryFile {
   friend class TDirectoryFile;
@@ -92,6 +94,11 @@ protected:
    Bool_t           fInitDone : 1;   //!True if the file has been initialized
    Bool_t           fMustFlush : 1;  //!True if the file buffers must be flushed
    Bool_t           fIsPcmFile : 1;  //!True if the file is a ROOT pcm file.
+   Bool_t           fMapStale : 1;   //!True if the file was reopened for writing since it was mapped
+   char            *fMapAddr;        //!Address at which the file is memory mapped, 0 if not mapped
+   Long64_t         fMapSize;        //!Number of bytes of the file which are mapped
+   TFileAsyncReads *fAsyncReads;     //!Blocks being read asynchronously (see ReadBufferAsync)
+   TFileAsyncWrites *fAsyncWrites;   //!Blocks queued for the writer thread (see WriteBufferAsync)
    TFileOpenHandle *fAsyncHandle;    //!For proper automatic cleanup
    EAsyncOpenStatus fAsyncOpenStatus; //!Status of an asynchronous open request
    TUrl             fUrl;            //!URL of file
@@ -112,11 +119,20 @@ protected:
    static std::atomic<Long64_t>  fgFileCounter;           //Counter for all opened files
    static std::atomic<Int_t>     fgReadCalls;             //Number of bytes read from all TFile objects
    static Int_t     fgReadaheadSize;         //Readahead buffer size
+   static Long64_t  fgAsyncWriteSize;        //Maximum number of bytes queued by WriteBufferAsync
    static Bool_t    fgReadInfo;              //if true (default) ReadStreamerInfo is called when opening a file
    virtual EAsyncOpenStatus GetAsyncOpenStatus() { return fAsyncOpenStatus; }
    virtual void  Init(Bool_t create);
    Bool_t        FlushWriteCache();
    Int_t         ReadBufferViaCache(char *buf, Int_t len);
+   Bool_t        ReadBufferViaMap(char *buf, Int_t len);
+   Int_t         ReadBufferViaAsync(char *buf, Long64_t pos, Int_t len);
+   Bool_t        SubmitAsyncReads(Long64_t *pos, Int_t *len, Int_t nbuf);
+   void          ResetAsyncReads();
+   Bool_t        FlushAsyncWrites();
+   void          StopAsyncWrites();
+   void          MapFile();
+   void          UnmapFile();
    Int_t         WriteBufferViaCache(const char *buf, Int_t len);
 
    // Creating projects
@@ -208,6 +224,7 @@ public:
    virtual Int_t       GetNbytesInfo() const {return fNbytesInfo;}
    virtual Int_t       GetNbytesFree() const {return fNbytesFree;}
    virtual TString     GetNewUrl() { return ""; }
+   char               *GetMappedBuffer(Long64_t pos, Int_t len) const;
    Long64_t            GetRelOffset() const { return fOffset - fArchiveOffset; }
    virtual Long64_t    GetSeekFree() const {return fSeekFree;}
    virtual Long64_t    GetSeekInfo() const {return fSeekInfo;}
@@ -217,6 +234,7 @@ public:
    virtual void        IncrementProcessIDs() { fNProcessIDs++; }
    virtual Bool_t      IsArchive() const { return fIsArchive; }
            Bool_t      IsBinary() const { return TestBit(kBinaryFile); }
+           Bool_t      IsMapped() const { return fMapAddr && !fMapStale; }
            Bool_t      IsRaw() const { return !fIsRootFile; }
    virtual Bool_t      IsOpen() const;
    virtual void        ls(Option_t *option="") const;
@@ -251,6 +269,7 @@ public:
    virtual Int_t       Sizeof() const;
    void                SumBuffer(Int_t bufsize);
    virtual Bool_t      WriteBuffer(const char *buf, Int_t len);
+   virtual Bool_t      WriteBufferAsync(const char *buf, Long64_t pos, Int_t len);
    virtual Int_t       Write(const char *name=0, Int_t opt=0, Int_t bufsiz=0);
    virtual Int_t       Write(const char *name=0, Int_t opt=0, Int_t bufsiz=0) const;
    virtual void        WriteFree();
@@ -277,11 +296,13 @@ public:
    static Long64_t     GetFileBytesWritten();
    static Int_t        GetFileReadCalls();
    static Int_t        GetReadaheadSize();
+   static Long64_t     GetAsyncWriteSize();
 
    static void         SetFileBytesRead(Long64_t bytes = 0);
    static void         SetFileBytesWritten(Long64_t bytes = 0);
    static void         SetFileReadCalls(Int_t readcalls = 0);
    static void         SetReadaheadSize(Int_t bufsize = 256000);
+   static void         SetAsyncWriteSize(Long64_t bytes = 64000000);
    static void         SetReadStreamerInfo(Bool_t readinfo=kTRUE);
    static Bool_t       GetReadStreamerInfo();
 
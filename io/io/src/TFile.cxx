@@ -70,6 +70,7 @@
 #include <sys/stat.h>
 #ifndef WIN32
 #   include <unistd.h>
+#   include <sys/mman.h>
 #else
 #   define ssize_t int
 #   include <io.h>
@@ -118,6 +119,16 @@
 #include "TSchemaRuleSet.h"
 #include "TThreadSlots.h"
 #include "TGlobal.h"
+#include "TMutex.h"
+#include "TCondition.h"
+#include "TThread.h"
+#include <deque>
+
+#if defined(R__LINUX) && !defined(R__WINGCC)
+#define R__USEAIO
+#include <aio.h>
+#include <vector>
+#endif
 
 using std::sqrt;
 
@@ -126,6 +137,7 @@ std::atomic<Long64_t> TFile::fgBytesWrite{0};
 std::atomic<Long64_t> TFile::fgFileCounter{0};
 std::atomic<Int_t>    TFile::fgReadCalls{0};
 Int_t    TFile::fgReadaheadSize = 256000;
+Long64_t TFile::fgAsyncWriteSize = 64000000;
 Bool_t   TFile::fgReadInfo = kTRUE;
 TList   *TFile::fgAsyncOpenRequests = 0;
 TString  TFile::fgCacheFileDir;
@@ -179,6 +191,11 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
    fInitDone        = kFALSE;
    fMustFlush       = kTRUE;
    fIsPcmFile       = kFALSE;
+   fMapStale        = kFALSE;
+   fMapAddr         = 0;
+   fMapSize         = 0;
+   fAsyncReads      = 0;
+   fAsyncWrites     = 0;
    fAsyncHandle     = 0;
    fAsyncOpenStatus = kAOSNotAsync;
    SetBit(kBinaryFile, kTRUE);
@@ -241,6 +258,13 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
 /// This is convenient because the many remote file access plugins allow
 /// easy access to/from the many different mass storage systems.
 ///
+/// A local file opened for reading can be memory mapped with:
+///    file.root?mmap
+/// or for all the files by setting "TFile.Mmap: yes" in the system.rootrc
+/// file. The records are then read directly from the mapped pages instead
+/// of via read system calls; in particular the TTree baskets are unzipped
+/// straight from the mapped pages, or used in place if not compressed.
+///
 /// The title of the file (ftitle) will be shown by the ROOT browsers.
 ///
 /// A ROOT file (like a Unix file system) may contain objects and
@@ -277,6 +301,10 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
 /// will build an integer which will set the compression to use
 /// the LZMA algorithm and compression level 1.  These are defined
 /// in the header file Compression.h.
+/// The available algorithms are kZLIB (the default), kLZMA, kLZ4 (fast
+/// decompression, lower compression factor), kZSTD (better compression
+/// factor than ZLIB at higher speed) and kOldCompressionAlgo; kLZ4 and
+/// kZSTD are only supported if ROOT was built with liblz4 and libzstd.
 ///
 /// Note that the compression settings may be changed at any time.
 /// The new compression settings will only apply to branches created
@@ -331,6 +359,16 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    if (strstr(fUrl.GetOptions(), "filetype=pcm"))
       fIsPcmFile = kTRUE;
 
+   // the file is memory mapped only once opened for reading (see MapFile)
+   fMapStale = kFALSE;
+   fMapAddr  = 0;
+   fMapSize  = 0;
+
+   // no asynchronous reads nor writes yet (see ReadBufferAsync and
+   // WriteBufferAsync)
+   fAsyncReads  = 0;
+   fAsyncWrites = 0;
+
    // Init initialization control flag
    fInitDone   = kFALSE;
    fMustFlush  = kTRUE;
@@ -346,7 +384,7 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    fVersion      = gROOT->GetVersionInt();  //ROOT version in integer format
    fUnits        = 4;
    fOption       = option;
-   fCompress     = compress;
+   fCompress     = ROOT::CheckCompressionSettings(compress);
    fWritten      = 0;
    fSumBuffer    = 0;
    fSum2Buffer   = 0;
@@ -495,6 +533,10 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
          goto zombie;
       }
       fWritable = kFALSE;
+
+      // if option contains mmap, or TFile.Mmap is set, memory map the file
+      if (strstr(fUrl.GetOptions(), "mmap") || gEnv->GetValue("TFile.Mmap", 0))
+         MapFile();
    }
 
    Init(create);
@@ -881,10 +923,15 @@ void TFile::Close(Option_t *option)
 
    if (!IsOpen()) return;
 
+   // The buffers still queued for the writer thread are written first.
+   StopAsyncWrites();
+
    if (fIsArchive || !fIsRootFile) {
       FlushWriteCache();
+      ResetAsyncReads();
       SysClose(fD);
       fD = -1;
+      UnmapFile();
 
       if (gMonitoringWriter)
          gMonitoringWriter->SendFileCloseEvent(this);
@@ -937,10 +984,12 @@ void TFile::Close(Option_t *option)
       fFree->Delete();
    }
 
+   ResetAsyncReads();
    if (IsOpen()) {
       SysClose(fD);
       fD = -1;
    }
+   UnmapFile();
 
    fWritable = kFALSE;
 
@@ -1051,6 +1100,7 @@ void TFile::DrawMap(const char *keys, Option_t *option)
 void TFile::Flush()
 {
    if (IsOpen() && fWritable) {
+      FlushAsyncWrites();
       FlushWriteCache();
       if (SysSync(fD) < 0) {
          // Write the system error only once for this file
@@ -1349,6 +1399,8 @@ void TFile::MakeFree(Long64_t first, Long64_t last)
 {
    TFree *f1      = (TFree*)fFree->First();
    if (!f1) return;
+   // A pending write to the freed segment must not land after it is reused.
+   if (fAsyncWrites) FlushAsyncWrites();
    TFree *newfree = f1->AddFree(fFree,first,last);
    if(!newfree) return;
    Long64_t nfirst = newfree->GetFirst();
@@ -1506,16 +1558,30 @@ Bool_t TFile::ReadBuffer(char *buf, Long64_t pos, Int_t len)
 
       SetOffset(pos);
 
+      // the block might still be queued for the writer thread
+      if (fAsyncWrites) FlushAsyncWrites();
+
       Int_t st;
       Double_t start = 0;
       if (gPerfStats != 0) start = TTimeStamp();
 
+      // the blocks read asynchronously were requested by the cache, look
+      // for them first to avoid going through the cache again
+      if ((st = ReadBufferViaAsync(buf, pos, len))) {
+         if (st == 2)
+            return kTRUE;
+         return kFALSE;
+      }
+
       if ((st = ReadBufferViaCache(buf, len))) {
          if (st == 2)
             return kTRUE;
          return kFALSE;
       }
 
+      if (ReadBufferViaMap(buf, len))
+         return kFALSE;
+
       Seek(pos);
       ssize_t siz;
 
@@ -1554,6 +1620,9 @@ Bool_t TFile::ReadBuffer(char *buf, Int_t len)
 {
    if (IsOpen()) {
 
+      // the block might still be queued for the writer thread
+      if (fAsyncWrites) FlushAsyncWrites();
+
       Int_t st;
       if ((st = ReadBufferViaCache(buf, len))) {
          if (st == 2)
@@ -1561,6 +1630,13 @@ Bool_t TFile::ReadBuffer(char *buf, Int_t len)
          return kFALSE;
       }
 
+      if (ReadBufferViaMap(buf, len))
+         return kFALSE;
+      if (IsMapped()) {
+         // the reads via the map do not move the file pointer
+         Seek(GetRelOffset());
+      }
+
       ssize_t siz;
       Double_t start = 0;
 
@@ -1602,8 +1678,17 @@ Bool_t TFile::ReadBuffer(char *buf, Int_t len)
 
 Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
 {
+   // the blocks might still be queued for the writer thread
+   if (fAsyncWrites) FlushAsyncWrites();
+
    // called with buf=0, from TFileCacheRead to pass list of readahead buffers
    if (!buf) {
+      // no block: forget the blocks requested so far
+      if (!nbuf) ResetAsyncReads();
+#ifdef R__USEAIO
+      if (IsA() == TFile::Class())
+         return SubmitAsyncReads(pos, len, nbuf);
+#endif
       for (Int_t j = 0; j < nbuf; j++) {
          if (ReadBufferAsync(pos[j], len[j])) {
              return kTRUE;
@@ -1616,6 +1701,16 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
    Bool_t result = kTRUE;
    TFileCacheRead *old = fCacheRead;
    fCacheRead = 0;
+   if (IsMapped()) {
+      // No need to read ahead, copy the blocks straight from the mapped file.
+      for (Int_t i = 0; i < nbuf; i++) {
+         result = ReadBuffer(&buf[k], pos[i], len[i]);
+         if (result) break;
+         k += len[i];
+      }
+      fCacheRead = old;
+      return result;
+   }
    Long64_t curbegin = pos[0];
    Long64_t cur;
    char *buf2 = 0;
@@ -1696,6 +1791,35 @@ Int_t TFile::ReadBufferViaCache(char *buf, Int_t len)
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read a buffer at the current offset from the memory mapped file.
+/// Returns kFALSE if the file is not mapped or the requested block is not
+/// entirely in the mapped region, kTRUE if the block has been copied.
+
+Bool_t TFile::ReadBufferViaMap(char *buf, Int_t len)
+{
+   char *mapped = GetMappedBuffer(GetRelOffset(), len);
+   if (!mapped) return kFALSE;
+
+   Double_t start = 0;
+   if (gPerfStats != 0) start = TTimeStamp();
+
+   memcpy(buf, mapped, len);
+   fOffset += len;
+
+   fBytesRead  += len;
+   fgBytesRead += len;
+   fReadCalls++;
+   fgReadCalls++;
+
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendFileReadProgress(this);
+   if (gPerfStats != 0) {
+      gPerfStats->FileReadEvent(this, len, start);
+   }
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read the FREE linked list.
 /// Every file has a linked list (fFree) of free segments.
@@ -1933,6 +2057,8 @@ Int_t TFile::ReOpen(Option_t *mode)
 
       // flush data still in the pipeline and close the file
       if (IsOpen() && IsWritable()) {
+         StopAsyncWrites();
+
          WriteStreamerInfo();
 
          // save directory key list and header
@@ -1952,6 +2078,7 @@ Int_t TFile::ReOpen(Option_t *mode)
             SafeDelete(fFree);
          }
 
+         ResetAsyncReads();
          SysClose(fD);
          fD = -1;
 
@@ -1974,8 +2101,13 @@ Int_t TFile::ReOpen(Option_t *mode)
    } else {
       // switch to UPDATE mode
 
+      // the mapped pages might not reflect what is going to be written; they
+      // are kept until Close since baskets might still be using them
+      fMapStale = kTRUE;
+
       // close readonly file
       if (IsOpen()) {
+         ResetAsyncReads();
          SysClose(fD);
          fD = -1;
       }
@@ -2024,6 +2156,60 @@ void TFile::SetOffset(Long64_t offset, ERelativeTo pos)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the len bytes at offset pos of the memory mapped file,
+/// or 0 if the file is not mapped or the block is not entirely mapped (e.g.
+/// it was written after the file was opened).
+/// The pages are mapped copy-on-write: the caller may modify the returned
+/// buffer in place, the modifications are never written to the file. The
+/// buffer is valid until the file is closed.
+
+char *TFile::GetMappedBuffer(Long64_t pos, Int_t len) const
+{
+   if (!IsMapped() || pos < 0 || len < 0) return 0;
+   pos += fArchiveOffset;
+   if (pos + len > fMapSize) return 0;
+   return fMapAddr + pos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Memory map the whole file, opened for reading. If the mapping fails the
+/// file is read as usual.
+
+void TFile::MapFile()
+{
+#ifndef WIN32
+   Long_t id, flags, modtime;
+   Long64_t size = 0;
+   if (SysStat(fD, &id, &size, &flags, &modtime) || size <= 0)
+      return;
+   void *addr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fD, 0);
+   if (addr == MAP_FAILED) {
+      SysError("MapFile", "cannot memory map file %s, reading it via read calls", GetName());
+      return;
+   }
+   fMapAddr  = (char *)addr;
+   fMapSize  = size;
+   fMapStale = kFALSE;
+#else
+   Warning("MapFile", "memory mapped files are not supported on this platform");
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove the memory mapping of the file, if any. The buffers returned by
+/// GetMappedBuffer are no longer valid.
+
+void TFile::UnmapFile()
+{
+#ifndef WIN32
+   if (fMapAddr) munmap(fMapAddr, fMapSize);
+#endif
+   fMapAddr  = 0;
+   fMapSize  = 0;
+   fMapStale = kFALSE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Seek to a specific position in the file. Pos it either kBeg, kCur or kEnd.
 
@@ -2067,6 +2253,7 @@ void TFile::SetCompressionAlgorithm(Int_t algorithm)
       int level = fCompress % 100;
       fCompress = 100 * algorithm + level;
    }
+   fCompress = ROOT::CheckCompressionSettings(fCompress);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2104,6 +2291,11 @@ void TFile::SetCompressionLevel(Int_t level)
 /// will build an integer which will set the compression to use
 /// the LZMA algorithm and compression level 1.  These are defined
 /// in the header file Compression.h.
+/// The available algorithms are kZLIB (the default), kLZMA, kLZ4 (fast
+/// decompression, lower compression factor), kZSTD (better compression
+/// factor than ZLIB at higher speed) and kOldCompressionAlgo; kLZ4 and
+/// kZSTD are only supported if ROOT was built with liblz4 and libzstd;
+/// otherwise the default algorithm is used and a warning is issued.
 ///
 /// Note that the compression settings may be changed at any time.
 /// The new compression settings will only apply to branches created
@@ -2112,7 +2304,7 @@ void TFile::SetCompressionLevel(Int_t level)
 
 void TFile::SetCompressionSettings(Int_t settings)
 {
-   fCompress = settings;
+   fCompress = ROOT::CheckCompressionSettings(settings);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4309,6 +4501,23 @@ Int_t TFile::GetReadaheadSize()
 //______________________________________________________________________________
 void TFile::SetReadaheadSize(Int_t bytes) { fgReadaheadSize = bytes; }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Static function returning the maximum number of bytes queued for the
+/// writer thread of a file (see WriteBufferAsync).
+
+Long64_t TFile::GetAsyncWriteSize()
+{
+   return fgAsyncWriteSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Static function setting the maximum number of bytes queued for the writer
+/// thread of a file (see WriteBufferAsync). When the queue is full,
+/// WriteBufferAsync waits for the writer thread to catch up. A value of 0
+/// disables the asynchronous writes.
+
+void TFile::SetAsyncWriteSize(Long64_t bytes) { fgAsyncWriteSize = bytes; }
+
 //______________________________________________________________________________
 void TFile::SetFileBytesRead(Long64_t bytes) { fgBytesRead = bytes; }
 
@@ -4908,6 +5117,22 @@ Bool_t TFile::ReadBufferAsync(Long64_t offset, Int_t len)
    }
    return (result != 0);
 }
+#elif defined(R__USEAIO)
+Bool_t TFile::ReadBufferAsync(Long64_t offset, Int_t len)
+{
+   // Start reading the specified byte range asynchronously with POSIX AIO;
+   // the block is then returned by ReadBuffer as soon as it is available.
+   // A zero length only probes whether asynchronous reads are supported.
+
+   // Shortcut to avoid having to implement dummy ReadBufferAsync() in all
+   // I/O plugins. Override ReadBufferAsync() in plugins if async is supported.
+   if (IsA() != TFile::Class() || IsMapped())
+      return kTRUE;
+   if (len == 0)
+      return kFALSE;
+
+   return SubmitAsyncReads(&offset, &len, 1);
+}
 #else
 Bool_t TFile::ReadBufferAsync(Long64_t, Int_t)
 {
@@ -4917,6 +5142,377 @@ Bool_t TFile::ReadBufferAsync(Long64_t, Int_t)
 }
 #endif
 
+#ifdef R__USEAIO
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TFileAsyncReads                                                      //
+//                                                                      //
+// The blocks submitted with POSIX AIO by TFile::ReadBufferAsync and    //
+// TFile::ReadBuffers(0, ...). All the blocks are in flight at the same //
+// time and complete in any order; TFile::ReadBuffer only waits for the //
+// block it needs.                                                      //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+class TFileAsyncReads {
+public:
+   struct TBlock {
+      struct aiocb fCb;     // AIO control block, fCb.aio_buf is the block buffer
+      Long64_t     fPos;    // position of the block, relative to the archive offset
+      Int_t        fLen;    // length of the block
+      Int_t        fStatus; // 0 in flight, 1 read, -1 to be read synchronously
+   };
+
+   std::vector<TBlock*> fBlocks;  // blocks in the order they were submitted
+   UInt_t               fCurrent; // block where the last lookup succeeded
+
+   TFileAsyncReads() : fCurrent(0) { }
+};
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// Submit the reading of the nbuf blocks described by pos and len with POSIX
+/// AIO, without waiting for them. Returns kTRUE in case of failure, in which
+/// case the blocks have to be read synchronously.
+
+Bool_t TFile::SubmitAsyncReads(Long64_t *pos, Int_t *len, Int_t nbuf)
+{
+#ifdef R__USEAIO
+   if (!IsOpen() || IsMapped()) return kTRUE;
+   if (nbuf <= 0) return kFALSE;
+   if (!fAsyncReads) fAsyncReads = new TFileAsyncReads;
+
+   Double_t start = 0;
+   if (gPerfStats != 0) start = TTimeStamp();
+
+   Long64_t total = 0;
+   for (Int_t i = 0; i < nbuf; i++) {
+      TFileAsyncReads::TBlock *block = new TFileAsyncReads::TBlock;
+      memset(&block->fCb, 0, sizeof(block->fCb));
+      block->fCb.aio_fildes     = fD;
+      block->fCb.aio_offset     = pos[i] + fArchiveOffset;
+      block->fCb.aio_buf        = new char[len[i]];
+      block->fCb.aio_nbytes     = len[i];
+      block->fCb.aio_sigevent.sigev_notify = SIGEV_NONE;
+      block->fPos    = pos[i];
+      block->fLen    = len[i];
+      block->fStatus = 0;
+      fAsyncReads->fBlocks.push_back(block);
+      total += len[i];
+
+      // Unlike with lio_listio, a failed submission tells exactly which
+      // request was not queued: this block is read synchronously when needed.
+      if (aio_read(&block->fCb))
+         block->fStatus = -1;
+   }
+
+   fBytesRead  += total;
+   fgBytesRead += total;
+   fReadCalls++;
+   fgReadCalls++;
+   if (gPerfStats != 0) {
+      gPerfStats->FileReadEvent(this, total, start);
+   }
+   return kFALSE;
+#else
+   (void) pos; (void) len; (void) nbuf;
+   return kTRUE;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read a buffer from the blocks submitted by SubmitAsyncReads, waiting for
+/// the block containing it to be read if needed. Returns 0 if the buffer
+/// is not in any of the submitted blocks, 1 in case of success and 2 in
+/// case of failure.
+
+Int_t TFile::ReadBufferViaAsync(char *buf, Long64_t pos, Int_t len)
+{
+#ifdef R__USEAIO
+   if (!fAsyncReads || fAsyncReads->fBlocks.empty()) return 0;
+
+   // The blocks are usually requested in the order they were submitted.
+   std::vector<TFileAsyncReads::TBlock*> &blocks = fAsyncReads->fBlocks;
+   UInt_t n = blocks.size();
+   TFileAsyncReads::TBlock *block = 0;
+   for (UInt_t i = 0; i < n; i++) {
+      UInt_t j = (fAsyncReads->fCurrent + i) % n;
+      if (blocks[j]->fPos <= pos && pos + len <= blocks[j]->fPos + blocks[j]->fLen) {
+         block = blocks[j];
+         fAsyncReads->fCurrent = j;
+         break;
+      }
+   }
+   if (!block) return 0;
+
+   char *data = (char *)block->fCb.aio_buf;
+   if (block->fStatus == 0) {
+      Int_t err;
+      while ((err = aio_error(&block->fCb)) == EINPROGRESS) {
+         const struct aiocb *wait[1] = { &block->fCb };
+         if (aio_suspend(wait, 1, 0) && GetErrno() != EINTR && GetErrno() != EAGAIN) {
+            // The request can not be waited for: cancel it, the block is
+            // then read synchronously.
+            aio_cancel(fD, &block->fCb);
+         }
+         ResetErrno();
+      }
+      ssize_t siz = aio_return(&block->fCb);
+      block->fStatus = (err == 0 && siz == block->fLen) ? 1 : -1;
+   }
+   if (block->fStatus < 0) {
+      // The asynchronous read failed, try again synchronously.
+      Seek(block->fPos);
+      ssize_t siz;
+      while ((siz = SysRead(fD, data, block->fLen)) < 0 && GetErrno() == EINTR)
+         ResetErrno();
+      if (siz != block->fLen) {
+         SysError("ReadBuffer", "error reading from file %s", GetName());
+         return 2;
+      }
+      block->fStatus = 1;
+   }
+
+   memcpy(buf, data + (pos - block->fPos), len);
+   SetOffset(pos + len);
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendFileReadProgress(this);
+   return 1;
+#else
+   (void) buf; (void) pos; (void) len;
+   return 0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Forget the blocks submitted by SubmitAsyncReads, cancelling or waiting
+/// for the ones still in flight.
+
+void TFile::ResetAsyncReads()
+{
+#ifdef R__USEAIO
+   if (!fAsyncReads) return;
+   std::vector<TFileAsyncReads::TBlock*> &blocks = fAsyncReads->fBlocks;
+   for (UInt_t i = 0; i < blocks.size(); i++) {
+      TFileAsyncReads::TBlock *block = blocks[i];
+      if (block->fStatus == 0) {
+         if (aio_cancel(fD, &block->fCb) == AIO_NOTCANCELED) {
+            while (aio_error(&block->fCb) == EINPROGRESS) {
+               const struct aiocb *wait[1] = { &block->fCb };
+               aio_suspend(wait, 1, 0);
+            }
+         }
+         aio_return(&block->fCb);
+      }
+      delete [] (char *)block->fCb.aio_buf;
+      delete block;
+   }
+   delete fAsyncReads;
+   fAsyncReads = 0;
+#endif
+}
+
+#ifndef WIN32
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TFileAsyncWrites                                                     //
+//                                                                      //
+// The buffers queued by TFile::WriteBufferAsync and the thread writing //
+// them. The space of each buffer has already been allocated in the     //
+// file, so the writer thread uses pwrite and never moves the file      //
+// pointer used by the synchronous reads and writes of the TFile.       //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+class TFileAsyncWrites {
+public:
+   struct TBlock {
+      char     *fBuf;   // copy of the buffer to write
+      Long64_t  fPos;   // absolute position of the buffer in the file
+      Int_t     fLen;   // length of the buffer
+   };
+
+   Int_t              fD;              // descriptor of the file, owned by the TFile
+   std::deque<TBlock> fQueue;          // blocks not written yet, the first one might be being written
+   Long64_t           fPending;        // number of bytes in fQueue
+   Int_t              fErrno;          // errno of the first failed write, 0 if none
+   Bool_t             fStopping;       // true when the writer thread must exit
+   TMutex             fMutex;          // protects the members above
+   TCondition         fWorkAvailable;  // signaled when a block is queued or fStopping is set
+   TCondition         fWritten;        // signaled when a block has been written
+   TThread           *fThread;         // the writer thread
+
+   TFileAsyncWrites(Int_t fd) : fD(fd), fPending(0), fErrno(0), fStopping(kFALSE),
+                                fWorkAvailable(&fMutex), fWritten(&fMutex)
+   {
+      fThread = new TThread("TFileAsyncWrites", &TFileAsyncWrites::WriterLoop, this);
+      fThread->Run();
+   }
+
+   ~TFileAsyncWrites()
+   {
+      {
+         TLockGuard lock(&fMutex);
+         fStopping = kTRUE;
+         fWorkAvailable.Signal();
+      }
+      fThread->Join();
+      delete fThread;
+   }
+
+   static void *WriterLoop(void *arg);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Main loop of the writer thread: write the oldest queued block, then
+/// remove it from the queue. Once a write failed the remaining blocks are
+/// dropped.
+
+void *TFileAsyncWrites::WriterLoop(void *arg)
+{
+   TFileAsyncWrites *writes = (TFileAsyncWrites *)arg;
+   while (1) {
+      TBlock block;
+      Int_t err;
+      {
+         TLockGuard lock(&writes->fMutex);
+         while (writes->fQueue.empty() && !writes->fStopping) {
+            writes->fWorkAvailable.Wait();
+         }
+         if (writes->fQueue.empty()) {
+            // Stopping and nothing left to write.
+            break;
+         }
+         block = writes->fQueue.front();
+         err = writes->fErrno;
+      }
+      Int_t done = 0;
+      while (!err && done < block.fLen) {
+         ssize_t siz = ::pwrite(writes->fD, block.fBuf + done, block.fLen - done, block.fPos + done);
+         if (siz < 0) {
+            if (errno != EINTR) err = errno;
+         } else if (siz == 0) {
+            err = EIO;
+         } else {
+            done += siz;
+         }
+      }
+      delete [] block.fBuf;
+      {
+         TLockGuard lock(&writes->fMutex);
+         writes->fQueue.pop_front();
+         writes->fPending -= block.fLen;
+         if (err && !writes->fErrno) writes->fErrno = err;
+         writes->fWritten.Broadcast();
+      }
+   }
+   return 0;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// Queue a buffer to be written at the position pos, relative to the
+/// beginning of the file, by the writer thread of this file, which is
+/// started on the first call. The buffer is copied and can be reused as soon
+/// as this function returns. The space [pos, pos+len) must already have been
+/// allocated in the file (see TKey::Create), and must not be written by any
+/// other means until FlushAsyncWrites is called; reads, Flush, MakeFree and
+/// Close call FlushAsyncWrites.
+///
+/// To bound the memory used, the call waits for the writer thread when
+/// more than GetAsyncWriteSize() bytes are already queued.
+///
+/// Returns kTRUE if the buffer was not queued, either because asynchronous
+/// writes are not supported for this file or because an earlier write
+/// failed; the buffer must then be written with WriteBuffer.
+
+Bool_t TFile::WriteBufferAsync(const char *buf, Long64_t pos, Int_t len)
+{
+#ifndef WIN32
+   // Only the local files use the file descriptor fD directly.
+   if (!IsOpen() || !fWritable || IsA() != TFile::Class() || fgAsyncWriteSize <= 0)
+      return kTRUE;
+   if (!fAsyncWrites) fAsyncWrites = new TFileAsyncWrites(fD);
+
+   TFileAsyncWrites::TBlock block;
+   block.fBuf = new char[len];
+   block.fPos = pos + fArchiveOffset;
+   block.fLen = len;
+   memcpy(block.fBuf, buf, len);
+
+   Int_t err;
+   {
+      TLockGuard lock(&fAsyncWrites->fMutex);
+      while (fAsyncWrites->fPending > 0 && fAsyncWrites->fPending + len > fgAsyncWriteSize
+             && !fAsyncWrites->fErrno) {
+         fAsyncWrites->fWritten.Wait();
+      }
+      err = fAsyncWrites->fErrno;
+      if (!err) {
+         fAsyncWrites->fQueue.push_back(block);
+         fAsyncWrites->fPending += len;
+         fAsyncWrites->fWorkAvailable.Signal();
+      }
+   }
+   if (err) {
+      delete [] block.fBuf;
+      FlushAsyncWrites();
+      return kTRUE;
+   }
+
+   fBytesWrite  += len;
+   fgBytesWrite += len;
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendFileWriteProgress(this);
+   return kFALSE;
+#else
+   (void) buf; (void) pos; (void) len;
+   return kTRUE;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the writer thread to write all the buffers queued by
+/// WriteBufferAsync. Returns kTRUE if one of the writes failed, in which case
+/// the file is no longer writable.
+
+Bool_t TFile::FlushAsyncWrites()
+{
+#ifndef WIN32
+   if (!fAsyncWrites) return kFALSE;
+   Int_t err;
+   {
+      TLockGuard lock(&fAsyncWrites->fMutex);
+      while (fAsyncWrites->fPending > 0) {
+         fAsyncWrites->fWritten.Wait();
+      }
+      err = fAsyncWrites->fErrno;
+      // Report the error only once.
+      fAsyncWrites->fErrno = 0;
+   }
+   if (err) {
+      // Write the system error only once for this file
+      SetBit(kWriteError); SetWritable(kFALSE);
+      Error("WriteBufferAsync", "error writing to file %s: %s", GetName(), strerror(err));
+      return kTRUE;
+   }
+#endif
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the buffers queued by WriteBufferAsync and stop the writer thread.
+
+void TFile::StopAsyncWrites()
+{
+#ifndef WIN32
+   if (!fAsyncWrites) return;
+   FlushAsyncWrites();
+   delete fAsyncWrites;
+   fAsyncWrites = 0;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Max number of bytes to prefetch. By default this is 75% of the
 /// read cache size. But specific TFile implementations may need to change it
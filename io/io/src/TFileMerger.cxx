@@ -40,6 +40,9 @@
 #include "TClassRef.h"
 #include "TROOT.h"
 #include "TMemFile.h"
+#include "TTaskPool.h"
+
+#include <vector>
 
 #ifdef WIN32
 // For _getmaxstdio
@@ -90,7 +93,7 @@ static Int_t R__GetSystemMaxOpenedFiles()
 TFileMerger::TFileMerger(Bool_t isLocal, Bool_t histoOneGo)
             : fOutputFile(0), fFastMethod(kTRUE), fNoTrees(kFALSE), fExplicitCompLevel(kFALSE), fCompressionChange(kFALSE),
               fPrintLevel(0), fMsgPrefix("TFileMerger"), fMaxOpenedFiles( R__GetSystemMaxOpenedFiles() ),
-              fLocal(isLocal), fHistoOneGo(histoOneGo), fObjectNames()
+              fLocal(isLocal), fHistoOneGo(histoOneGo), fObjectNames(), fNJobs(1)
 {
    fFileList = new TList;
 
@@ -826,6 +829,14 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
 
    Bool_t result = kTRUE;
    Int_t type = in_type;
+
+   // Reduce the inputs to one temporary file per group of inputs first.
+   TList tmpfiles;
+   tmpfiles.SetOwner(kTRUE);
+   if (fNJobs > 1) {
+      result = MergeGroups(in_type, tmpfiles);
+   }
+
    while (result && fFileList->GetEntries()>0) {
       result = MergeRecursive(fOutputFile, fFileList, type);
 
@@ -871,9 +882,142 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
       fOutputFile->ResetBit(kMustCleanup);
       SafeDelete(fOutputFile);
    }
+   TIter nexttmp(&tmpfiles);
+   TObjString *tmpname;
+   while ((tmpname = (TObjString*) nexttmp())) {
+      gSystem->Unlink(tmpname->GetName());
+   }
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// First step of the parallel merge (see SetNJobs): split the input files in
+/// up to fNJobs groups of consecutive files and merge each group into a
+/// temporary file, with one task per group of a TTaskPool with one thread
+/// per group.
+/// Each group is merged with PartialMerge by its own TFileMerger, which takes
+/// over the input files of the group; the tasks do not share any TFile.
+/// On return fFileList contains the temporary files, in the order of the
+/// groups, to be merged into the output file by the caller, and tmpfiles
+/// contains their names. Nothing is done if there are not enough input files
+/// to form two groups of at least two files.
+/// Return kFALSE if one of the groups could not be merged.
+
+Bool_t TFileMerger::MergeGroups(Int_t type, TList &tmpfiles)
+{
+   if (!fOutputFile) {
+      Error("MergeGroups", "no output file was set");
+      return kFALSE;
+   }
+
+   std::vector<TObject*> inputs;
+   TIter nextfile(fFileList);
+   TObject *input;
+   while ((input = nextfile())) inputs.push_back(input);
+   TIter nexturl(fExcessFiles);
+   while ((input = nexturl())) inputs.push_back(input);
+
+   Int_t ngroups = TMath::Min(fNJobs, (Int_t)inputs.size() / 2);
+   if (ngroups < 2) {
+      return kTRUE;
+   }
+   Int_t groupsize = (inputs.size() + ngroups - 1) / ngroups;
+   ngroups = (inputs.size() + groupsize - 1) / groupsize;
+
+   if (fPrintLevel > 0) {
+      Printf("%s Merging %d files in %d groups of up to %d files", fMsgPrefix.Data(),
+             (Int_t)inputs.size(), ngroups, groupsize);
+   }
+
+   // The mergers and their output files are set up by this thread, only
+   // the merges themselves are done by the tasks.
+   Bool_t result = kTRUE;
+   std::vector<TFileMerger*> mergers;
+   for (Int_t g = 0; g < ngroups; ++g) {
+      TUUID uuid;
+      TString tmpname;
+      tmpname.Form("%s/ROOTMERGE-%s.root", gSystem->TempDirectory(), uuid.AsString());
+
+      TFileMerger *merger = new TFileMerger(kFALSE, fHistoOneGo);
+      merger->SetMsgPrefix(TString::Format("%s [%d]", fMsgPrefix.Data(), g));
+      merger->fFastMethod = fFastMethod;
+      merger->fNoTrees = fNoTrees;
+      merger->fObjectNames = fObjectNames;
+      merger->fMaxOpenedFiles = TMath::Max(2, fMaxOpenedFiles / ngroups);
+      mergers.push_back(merger);
+      if (!merger->OutputFile(tmpname, "RECREATE", fOutputFile->GetCompressionSettings())) {
+         result = kFALSE;
+      }
+      tmpfiles.Add(new TObjString(tmpname));
+
+      for (UInt_t i = g * groupsize; i < inputs.size() && i < (UInt_t)(g + 1) * groupsize; ++i) {
+         if (inputs[i]->InheritsFrom(TFile::Class())) {
+            // Already opened (and possibly copied locally) by AddFile.
+            TFile *file = (TFile*)inputs[i];
+            merger->AddFile(file, file->TestBit(kCanDelete), kFALSE);
+         } else {
+            merger->fLocal = fLocal;
+            if (!merger->AddFile(inputs[i]->GetName(), inputs[i]->TestBit(kCpProgress))) {
+               result = kFALSE;
+            }
+         }
+      }
+      merger->fLocal = fLocal;
+      merger->fPrintLevel = fPrintLevel;
+   }
+   // The input files now belong to the mergers of the groups.
+   fFileList->Clear("nodelete");
+   fExcessFiles->Clear();
+
+   if (result) {
+      std::vector<char> status(ngroups, kFALSE);
+      // A pool of its own, so that the number of groups merged at the same
+      // time does not depend on the size of the global pool.
+      TTaskPool pool(ngroups);
+      {
+         TTaskGroup group(&pool);
+         Int_t grouptype = type & ~kIncremental;
+         for (Int_t g = 0; g < ngroups; ++g) {
+            TFileMerger *merger = mergers[g];
+            char *groupstatus = &status[g];
+            group.Run([merger, groupstatus, grouptype]() {
+               *groupstatus = merger->PartialMerge(grouptype);
+            });
+         }
+         group.Wait();
+      }
+      for (Int_t g = 0; g < ngroups; ++g) {
+         if (!status[g]) {
+            Error("MergeGroups", "could not merge the group %d of input files", g);
+            result = kFALSE;
+         }
+      }
+   }
+   for (Int_t g = 0; g < ngroups; ++g) {
+      delete mergers[g];
+   }
+   if (!result) {
+      return kFALSE;
+   }
+
+   // The temporary files are all written with the compression settings of
+   // the output file.
+   fCompressionChange = kFALSE;
+   TIter nexttmp(&tmpfiles);
+   TObjString *tmpname;
+   while ((tmpname = (TObjString*) nexttmp())) {
+      TFile *file = TFile::Open(tmpname->GetName(), "READ");
+      if (!file || file->IsZombie()) {
+         Error("MergeGroups", "cannot open the temporary file %s", tmpname->GetName());
+         delete file;
+         return kFALSE;
+      }
+      file->SetBit(kCanDelete);
+      fFileList->Add(file);
+   }
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Open up to fMaxOpenedFiles of the excess files.
 
@@ -950,6 +1094,24 @@ void TFileMerger::SetMaxOpenedFiles(Int_t newmax)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the maximum number of groups of input files merged in parallel.
+/// With njobs > 1 PartialMerge reduces the input files in two steps: the
+/// files are split in up to njobs groups of consecutive files, which are
+/// merged concurrently into temporary files (in gSystem->TempDirectory()),
+/// then the temporary files are merged into the output file. The order of
+/// the entries of the merged trees is the same as in a sequential merge.
+/// The groups are merged by a TTaskPool of up to njobs threads created for
+/// the merge, independently of the global pool. The merge of the objects of
+/// each group requires ROOT to be set up for multi-threading, which
+/// TTaskPool does by calling TThread::Initialize().
+/// The default, 1, merges all the inputs sequentially into the output file.
+
+void TFileMerger::SetNJobs(Int_t njobs)
+{
+   fNJobs = njobs > 1 ? njobs : 1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the prefix to be used when printing informational message.
 
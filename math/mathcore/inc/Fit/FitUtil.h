@@ -40,6 +40,33 @@ namespace FitUtil {
    typedef  ROOT::Math::IParamMultiFunction IModelFunction;
    typedef  ROOT::Math::IParamMultiGradFunction IGradModelFunction;
 
+   /**
+      execution policy for the evaluation of the fit method functions over the data points
+      (see SetExecutionPolicy)
+   */
+   enum EExecutionPolicy {
+      kSerial = 0,                  // the points are evaluated one after the other
+      kMultiThread = 1,             // chunks of points are evaluated by several threads
+      kVectorized = 2,              // the model is evaluated on blocks of points with EvalBatch
+      kMultiThreadVectorized = 3    // both kMultiThread and kVectorized
+   };
+
+   /**
+       set the execution policy used by the Chi2 and likelihood functions (and their gradients)
+       and the number of threads used by the multi-thread policies (0 means the number of cores)
+   */
+   void SetExecutionPolicy(EExecutionPolicy policy, unsigned int nthreads = 0);
+
+   /**
+       return the current execution policy
+   */
+   EExecutionPolicy GetExecutionPolicy();
+
+   /**
+       return the number of threads used by the multi-thread execution policies
+   */
+   unsigned int GetNThreads();
+
    /** Chi2 Functions */
 
    /**
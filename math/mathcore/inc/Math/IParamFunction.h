@@ -125,6 +125,17 @@ public:
       return DoEvalPar(x, p);
    }
 
+   /**
+      Evaluate the function at n points for the given parameters p.
+      x contains the coordinates of the points one after the other (NDim() values per point)
+      and the n function values are stored in f.
+      Use the virtual function DoEvalParBatch to implement it, by default it evaluates
+      the points one by one with DoEvalPar
+   */
+   void EvalBatch(unsigned int n, const double * x, const double * p, double * f) const {
+      DoEvalParBatch(n, x, p, f);
+   }
+
    using BaseFunc::operator();
 
 
@@ -136,6 +147,16 @@ private:
    */
    virtual double DoEvalPar(const double * x, const double * p) const = 0;
 
+   /**
+      Implementation of the evaluation at several points (see EvalBatch).
+      Derived classes can re-implement it to evaluate the points at once,
+      for example with vectorized code
+   */
+   virtual void DoEvalParBatch(unsigned int n, const double * x, const double * p, double * f) const {
+      unsigned int ndim = NDim();
+      for (unsigned int i = 0; i < n; ++i) f[i] = DoEvalPar(x + i*ndim, p);
+   }
+
    /**
       Implement the ROOT::Math::IBaseFunctionMultiDim interface DoEval(x) using the cached parameter values
    */
@@ -30,6 +30,9 @@
 #include <cmath>
 #include <cassert>
 #include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
 //#include <memory>
 
 //#define DEBUG
@@ -325,8 +328,150 @@ namespace ROOT {
 
 
 
+         // execution policy of the evaluation of the fit method functions
+         EExecutionPolicy gExecutionPolicy = kSerial;
+         unsigned int gNThreads = 0;
+
+         // minimum number of points evaluated by a thread
+         const unsigned int kMinPointsPerThread = 1000;
+         // number of points evaluated at once by IParamMultiFunction::EvalBatch
+         const unsigned int kBatchSize = 256;
+
+         // evaluate kernel(func, begin, end, res) on chunks of the n data points and
+         // sum in res the nres values computed by the kernel for each chunk.
+         // With the multi-thread policy the chunks are evaluated by different threads.
+         // The chunk boundaries depend only on n and on the number of threads and the
+         // partial results are added in the chunk order, so the result does not
+         // depend on the scheduling of the threads. With a single chunk the kernel
+         // fills directly res, and the result is identical to the serial loop.
+         // Each additional thread evaluates its own clone of the model function,
+         // whose parameters are set to p before the threads are started, so that
+         // no thread modifies the function used by another one. The gradient
+         // evaluation changes the parameters of functions whose clones share them
+         // with the original (e.g. the TF1 wrappers), in that case (gradient = true)
+         // a single thread is used.
+         template <class Func, class Kernel>
+         void EvaluateChunks(const Func & func, const double * p, unsigned int n, unsigned int nres,
+                             const Kernel & kernel, double * res, bool gradient = false) {
+            std::fill(res, res + nres, 0.);
+            unsigned int nthreads = (gExecutionPolicy & kMultiThread) ? gNThreads : 1;
+            if (nthreads > n / kMinPointsPerThread) nthreads = n / kMinPointsPerThread;
+            std::vector<Func *> clones;
+            for (unsigned int t = 1; t < nthreads; ++t) {
+               Func * clone = dynamic_cast<Func *>( func.Clone() );
+               if (clone == 0 || (gradient && clone->Parameters() == func.Parameters() ) ) {
+                  delete clone;
+                  nthreads = 1;
+                  break;
+               }
+               clone->SetParameters(p);
+               clones.push_back(clone);
+            }
+            if (nthreads <= 1) {
+               for (unsigned int t = 0; t < clones.size(); ++t) delete clones[t];
+               kernel(func, 0, n, res);
+               return;
+            }
+            std::vector<double> partial(nres * nthreads, 0.);
+            std::vector<std::thread> threads;
+            for (unsigned int t = 1; t < nthreads; ++t) {
+               unsigned int begin = (unsigned int) ( (unsigned long long) n * t / nthreads);
+               unsigned int end = (unsigned int) ( (unsigned long long) n * (t+1) / nthreads);
+               threads.push_back( std::thread( std::cref(kernel), std::cref(*clones[t-1]), begin, end, &partial[t * nres] ) );
+            }
+            kernel(func, 0, (unsigned int) ( (unsigned long long) n / nthreads), &partial[0]);
+            for (unsigned int t = 0; t < threads.size(); ++t) threads[t].join();
+            for (unsigned int t = 0; t < clones.size(); ++t) delete clones[t];
+            for (unsigned int t = 0; t < nthreads; ++t) {
+               for (unsigned int j = 0; j < nres; ++j) res[j] += partial[t * nres + j];
+            }
+         }
+
+         // evaluate the model function on blocks of consecutive points with
+         // IParamMultiFunction::EvalBatch and return the value at point i.
+         // Used with the vectorized policy when the function is evaluated at the
+         // point coordinates (no bin integral or bin volume)
+         template <class Data>
+         class BatchEvaluator {
+         public:
+            BatchEvaluator(const IModelFunction & func, const Data & data, const double * p, unsigned int end) :
+               fFunc(func), fData(data), fParams(p), fNDim(data.NDim()), fFirst(0), fLast(0), fEnd(end)
+            {}
+
+            double operator() (unsigned int i) {
+               if (i < fFirst || i >= fLast) Evaluate(i);
+               return fValues[i - fFirst];
+            }
+
+         private:
+
+            void Evaluate(unsigned int first) {
+               fFirst = first;
+               fLast = std::min(first + kBatchSize, fEnd);
+               unsigned int nb = fLast - fFirst;
+               fCoords.resize(nb * fNDim);
+               fValues.resize(nb);
+               for (unsigned int j = 0; j < nb; ++j) {
+                  const double * x = fData.Coords(fFirst + j);
+                  std::copy(x, x + fNDim, &fCoords[j * fNDim]);
+               }
+               fFunc.EvalBatch(nb, &fCoords.front(), fParams, &fValues.front());
+            }
+
+            const IModelFunction & fFunc;
+            const Data & fData;
+            const double * fParams;
+            unsigned int fNDim;
+            unsigned int fFirst;        // first point of the evaluated block
+            unsigned int fLast;         // end of the evaluated block
+            unsigned int fEnd;          // end of the range of points
+            std::vector<double> fCoords;
+            std::vector<double> fValues;
+         };
+
       } // end namespace  FitUtil
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the execution policy used to evaluate the fit method functions
+/// (Chi2, log-likelihood, Poisson log-likelihood and their gradients):
+///   - kSerial: the points are evaluated one after the other (default)
+///   - kMultiThread: the points are split in contiguous chunks evaluated in
+///     parallel by nthreads threads (the number of cores if nthreads is 0).
+///     The chunks and the order of the sums depend only on the number of
+///     points and of threads, so the result is reproducible.
+///   - kVectorized: when the model is evaluated at the point coordinates
+///     (no bin integral or bin volume), it is evaluated on blocks of points
+///     with IParamMultiFunction::EvalBatch, which the function can implement
+///     with SIMD instructions.
+///   - kMultiThreadVectorized: both.
+/// With the multi-thread policies each additional thread evaluates a clone of
+/// the model function (see IBaseFunctionMultiDim::Clone) with the parameters
+/// set before the threads start, and the functions must not share a state
+/// modified by their evaluation. The gradients of the functions whose clones
+/// share the parameters with the original, as the TF1 wrappers, which change
+/// the TF1 parameters to compute them, are evaluated with a single thread.
+
+void FitUtil::SetExecutionPolicy(EExecutionPolicy policy, unsigned int nthreads) {
+   if (nthreads == 0) nthreads = std::thread::hardware_concurrency();
+   FitUtil::gExecutionPolicy = policy;
+   FitUtil::gNThreads = std::max(nthreads, 1u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the execution policy of the fit method functions.
+
+FitUtil::EExecutionPolicy FitUtil::GetExecutionPolicy() {
+   return FitUtil::gExecutionPolicy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of threads used by the multi-thread execution policies.
+
+unsigned int FitUtil::GetNThreads() {
+   return FitUtil::gNThreads;
+}
+
+
 
 
 //___________________________________________________________________________________________________________________________
@@ -341,7 +486,6 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
    unsigned int n = data.Size();
 
-   double chi2 = 0;
    nPoints = 0; // count the effective non-zero points
    // set parameters of the function to cache integral value
 #ifdef USE_PARAMCACHE
@@ -356,6 +500,7 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
    bool useBinIntegral = fitOpt.fIntegral && data.HasBinEdges();
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
    bool useExpErrors = (fitOpt.fExpErrors);
+   bool useBatch = (gExecutionPolicy & kVectorized) && !useBinIntegral && !useBinVolume;
 
 #ifdef DEBUG
    std::cout << "\n\nFit data size = " << n << std::endl;
@@ -365,97 +510,111 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
    std::cout << "use all error=1 " << fitOpt.fErrors1 << std::endl;
 #endif
 
-#ifdef USE_PARAMCACHE
-   IntegralEvaluator<> igEval( func, 0, useBinIntegral); 
-#else
-   IntegralEvaluator<> igEval( func, p, useBinIntegral); 
-#endif
    double maxResValue = std::numeric_limits<double>::max() /n;
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
    (const_cast<IModelFunction &>(func)).SetParameters(p);
-   for (unsigned int i = 0; i < n; ++ i) {
 
-      double y = 0, invError = 1.;
+   // evaluate the chi2 of the points [begin, end)
+   auto evalChunk = [&](const IModelFunction & fn, unsigned int begin, unsigned int end, double * res) {
 
-      // in case of no error in y invError=1 is returned
-      const double * x1 = data.GetPoint(i,y, invError);
+#ifdef USE_PARAMCACHE
+      IntegralEvaluator<> igEval( fn, 0, useBinIntegral); 
+#else
+      IntegralEvaluator<> igEval( fn, p, useBinIntegral); 
+#endif
+      BatchEvaluator<BinData> batchEval( fn, data, p, end);
+      std::vector<double> xc;
+      if (useBinVolume) xc.resize(data.NDim() );
+      double chi2 = 0;
+
+      for (unsigned int i = begin; i < end; ++ i) {
+
+         double y = 0, invError = 1.;
+
+         // in case of no error in y invError=1 is returned
+         const double * x1 = data.GetPoint(i,y, invError);
 
-      double fval = 0;
+         double fval = 0;
 
-      double binVolume = 1.0;
-        if (useBinVolume) {
-         unsigned int ndim = data.NDim();
-         const double * x2 = data.BinUpEdge(i);
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+         double binVolume = 1.0;
+           if (useBinVolume) {
+            unsigned int ndim = data.NDim();
+            const double * x2 = data.BinUpEdge(i);
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral) {
+         if (useBatch) {
+            fval = batchEval( i );
+         }
+         else if (!useBinIntegral) {
 #ifdef USE_PARAMCACHE
-         fval = func ( x );
+            fval = fn ( x );
 #else
-         fval = func ( x, p );
+            fval = fn ( x, p );
 #endif
-      }
-      else {
-         // calculate integral normalized by bin volume
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, data.BinUpEdge(i)) ;
-      }
-      // normalize result if requested according to bin volume
-      if (useBinVolume) fval *= binVolume;
-
-      // expected errors
-      if (useExpErrors) {
-         // we need first to check if a weight factor needs to be applied
-         // weight = sumw2/sumw = error**2/content
-         double invWeight = y * invError * invError;
-         if (invError == 0) invWeight = (data.SumOfError2() > 0) ? data.SumOfContent()/ data.SumOfError2() : 1.0;
-         // compute expected error  as f(x) / weight
-         double invError2 = (fval > 0) ? invWeight / fval : 0.0;
-         invError = std::sqrt(invError2);
-      }
+         }
+         else {
+            // calculate integral normalized by bin volume
+            // need to set function and parameters here in case loop is parallelized
+            fval = igEval( x1, data.BinUpEdge(i)) ;
+         }
+         // normalize result if requested according to bin volume
+         if (useBinVolume) fval *= binVolume;
+
+         // expected errors
+         if (useExpErrors) {
+            // we need first to check if a weight factor needs to be applied
+            // weight = sumw2/sumw = error**2/content
+            double invWeight = y * invError * invError;
+            if (invError == 0) invWeight = (data.SumOfError2() > 0) ? data.SumOfContent()/ data.SumOfError2() : 1.0;
+            // compute expected error  as f(x) / weight
+            double invError2 = (fval > 0) ? invWeight / fval : 0.0;
+            invError = std::sqrt(invError2);
+         }
 
 //#define DEBUG
 #ifdef DEBUG
-      std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
-      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << " bin volume " << binVolume << " ref " << wrefVolume << std::endl;
+         std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
+         for (unsigned int ipar = 0; ipar < fn.NPar(); ++ipar)
+            std::cout << p[ipar] << "\t";
+         std::cout << "\tfval = " << fval << " bin volume " << binVolume << " ref " << wrefVolume << std::endl;
 #endif
 //#undef DEBUG
 
 
-      if (invError > 0) {
-         nPoints++;
+         if (invError > 0) {
 
-         double tmp = ( y -fval )* invError;
-         double resval = tmp * tmp;
+            double tmp = ( y -fval )* invError;
+            double resval = tmp * tmp;
 
 
-         // avoid inifinity or nan in chi2 values due to wrong function values
-         if ( resval < maxResValue )
-            chi2 += resval;
-         else {
-            //nRejected++;
-            chi2 += maxResValue;
+            // avoid inifinity or nan in chi2 values due to wrong function values
+            if ( resval < maxResValue )
+               chi2 += resval;
+            else {
+               //nRejected++;
+               chi2 += maxResValue;
+            }
          }
-      }
 
 
-   }
+      }
+      res[0] = chi2;
+   };
+
+   double chi2 = 0;
+   EvaluateChunks(func, p, n, 1, evalChunk, &chi2);
    nPoints=n;
 
 #ifdef DEBUG
@@ -706,8 +865,6 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
       MATH_ERROR_MSG("FitUtil::EvaluateChi2Residual","Error on the coordinates are not used in calculating Chi2 gradient");            return; // it will assert otherwise later in GetPoint
    }
 
-   unsigned int nRejected = 0;
-
    const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f);
    assert (fg != 0); // must be called by a gradient function
 
@@ -725,98 +882,108 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
 
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
-   IntegralEvaluator<> igEval( func, p, useBinIntegral);
-
    //int nRejected = 0;
    // set values of parameters
 
    unsigned int npar = func.NPar();
    //   assert (npar == NDim() );  // npar MUST be  Chi2 dimension
-   std::vector<double> gradFunc( npar );
-   // set all vector values to zero
-   std::vector<double> g( npar);
 
-   for (unsigned int i = 0; i < n; ++ i) {
+   // evaluate the gradient of the points [begin, end) in res[0..npar-1]
+   // and the number of rejected points in res[npar]
+   auto evalChunk = [&](const IGradModelFunction & fn, unsigned int begin, unsigned int end, double * res) {
+
+      IntegralEvaluator<> igEval( fn, p, useBinIntegral);
+      std::vector<double> xc;
+      if (useBinVolume) xc.resize(data.NDim() );
+      std::vector<double> gradFunc( npar );
+      double * g = res;
+      unsigned int nRejected = 0;
 
+      for (unsigned int i = begin; i < end; ++ i) {
 
-      double y, invError = 0;
-      const double * x1 = data.GetPoint(i,y, invError);
 
-      double fval = 0;
-      const double * x2 = 0;
+         double y, invError = 0;
+         const double * x1 = data.GetPoint(i,y, invError);
 
-      double binVolume = 1;
-      if (useBinVolume) {
-         unsigned int ndim = data.NDim();
-         x2 = data.BinUpEdge(i);
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+         double fval = 0;
+         const double * x2 = 0;
+
+         double binVolume = 1;
+         if (useBinVolume) {
+            unsigned int ndim = data.NDim();
+            x2 = data.BinUpEdge(i);
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral ) {
-         fval = func ( x, p );
-         func.ParameterGradient(  x , p, &gradFunc[0] );
-      }
-      else {
-         x2 = data.BinUpEdge(i);
-         // calculate normalized integral and gradient (divided by bin volume)
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, x2 ) ;
-         CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]);
-      }
-      if (useBinVolume) fval *= binVolume;
+         if (!useBinIntegral ) {
+            fval = fn ( x, p );
+            fn.ParameterGradient(  x , p, &gradFunc[0] );
+         }
+         else {
+            x2 = data.BinUpEdge(i);
+            // calculate normalized integral and gradient (divided by bin volume)
+            // need to set function and parameters here in case loop is parallelized
+            fval = igEval( x1, x2 ) ;
+            CalculateGradientIntegral( fn, x1, x2, p, &gradFunc[0]);
+         }
+         if (useBinVolume) fval *= binVolume;
 
 #ifdef DEBUG
-      std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
-      for (unsigned int ipar = 0; ipar < npar; ++ipar)
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << std::endl;
+         std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
+         for (unsigned int ipar = 0; ipar < npar; ++ipar)
+            std::cout << p[ipar] << "\t";
+         std::cout << "\tfval = " << fval << std::endl;
 #endif
-      if ( !CheckValue(fval) ) {
-         nRejected++;
-         continue;
-      }
+         if ( !CheckValue(fval) ) {
+            nRejected++;
+            continue;
+         }
+
+         // loop on the parameters
+         unsigned int ipar = 0;
+         for ( ; ipar < npar ; ++ipar) {
 
-      // loop on the parameters
-      unsigned int ipar = 0;
-      for ( ; ipar < npar ; ++ipar) {
+            // correct gradient for bin volumes
+            if (useBinVolume) gradFunc[ipar] *= binVolume;
+
+            // avoid singularity in the function (infinity and nan ) in the chi2 sum
+            // eventually add possibility of excluding some points (like singularity)
+            double dfval = gradFunc[ipar];
+            if ( !CheckValue(dfval) ) {
+                  break; // exit loop on parameters
+            }
 
-         // correct gradient for bin volumes
-         if (useBinVolume) gradFunc[ipar] *= binVolume;
+            // calculate derivative point contribution
+            double tmp = - 2.0 * ( y -fval )* invError * invError * gradFunc[ipar];
+            g[ipar] += tmp;
 
-         // avoid singularity in the function (infinity and nan ) in the chi2 sum
-         // eventually add possibility of excluding some points (like singularity)
-         double dfval = gradFunc[ipar];
-         if ( !CheckValue(dfval) ) {
-               break; // exit loop on parameters
          }
 
-         // calculate derivative point contribution
-         double tmp = - 2.0 * ( y -fval )* invError * invError * gradFunc[ipar];
-         g[ipar] += tmp;
+         if ( ipar < npar ) {
+             // case loop was broken for an overflow in the gradient calculation
+            nRejected++;
+            continue;
+         }
 
-      }
 
-      if ( ipar < npar ) {
-          // case loop was broken for an overflow in the gradient calculation
-         nRejected++;
-         continue;
       }
+      res[npar] = nRejected;
+   };
 
-
-   }
+   std::vector<double> g( npar + 1);
+   EvaluateChunks(func, p, n, npar + 1, evalChunk, &g[0], true);
+   unsigned int nRejected = (unsigned int) g[npar];
 
    // correct the number of points
    nPoints = n;
@@ -827,7 +994,7 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    }
 
    // copy result
-   std::copy(g.begin(), g.end(), grad);
+   std::copy(g.begin(), g.begin() + npar, grad);
 
 }
 
@@ -899,7 +1066,6 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
    std::cout << "func pointer is " << typeid(func).name() << std::endl;
 #endif
 
-   double logl = 0;
    //unsigned int nRejected = 0;
 
    // set parameters of the function to cache integral value
@@ -919,44 +1085,67 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
       norm = igEval.Integral(&xmin[0],&xmax[0]);
    }
 
-   // needed to compue effective global weight in case of extended likelihood
-   double sumW = 0;
-   double sumW2 = 0;
+   bool useBatch = (gExecutionPolicy & kVectorized);
 
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x = data.Coords(i);
+   // evaluate the log-likelihood of the points [begin, end) in res[0]
+   // and the sum of weights and of weight squares in res[1] and res[2]
+   auto evalChunk = [&](const IModelFunction & fn, unsigned int begin, unsigned int end, double * res) {
+
+      BatchEvaluator<UnBinData> batchEval( fn, data, p, end);
+      double logl = 0;
+      // needed to compue effective global weight in case of extended likelihood
+      double sumW = 0;
+      double sumW2 = 0;
+
+      for (unsigned int i = begin; i < end; ++ i) {
+         const double * x = data.Coords(i);
+         double fval = 0;
+         if (useBatch)
+            fval = batchEval( i );
+         else {
 #ifdef USE_PARAMCACHE
-       double fval = func ( x );
+            fval = fn ( x );
 #else
-       double fval = func ( x, p );
+            fval = fn ( x, p );
 #endif
-      if (normalizeFunc) fval = fval / norm;
+         }
+         if (normalizeFunc) fval = fval / norm;
 
 #ifdef DEBUG
-      std::cout << "x [ " << data.NDim() << " ] = ";
-      for (unsigned int j = 0; j < data.NDim(); ++j)
-         std::cout << x[j] << "\t";
-      std::cout << "\tpar = [ " << func.NPar() << " ] =  ";
-      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << std::endl;
+         std::cout << "x [ " << data.NDim() << " ] = ";
+         for (unsigned int j = 0; j < data.NDim(); ++j)
+            std::cout << x[j] << "\t";
+         std::cout << "\tpar = [ " << fn.NPar() << " ] =  ";
+         for (unsigned int ipar = 0; ipar < fn.NPar(); ++ipar)
+            std::cout << p[ipar] << "\t";
+         std::cout << "\tfval = " << fval << std::endl;
 #endif
-      // function EvalLog protects against negative or too small values of fval
-      double logval =  ROOT::Math::Util::EvalLog( fval);
-      if (iWeight > 0) {
-         double weight = data.Weight(i);
-         logval *= weight;
-         if (iWeight ==2) {
-            logval *= weight; // use square of weights in likelihood
-            if (extended) {
-               // needed sum of weights and sum of weight square if likelkihood is extended
-               sumW += weight;
-               sumW2 += weight*weight;
+         // function EvalLog protects against negative or too small values of fval
+         double logval =  ROOT::Math::Util::EvalLog( fval);
+         if (iWeight > 0) {
+            double weight = data.Weight(i);
+            logval *= weight;
+            if (iWeight ==2) {
+               logval *= weight; // use square of weights in likelihood
+               if (extended) {
+                  // needed sum of weights and sum of weight square if likelkihood is extended
+                  sumW += weight;
+                  sumW2 += weight*weight;
+               }
             }
          }
+         logl += logval;
       }
-      logl += logval;
-   }
+      res[0] = logl;
+      res[1] = sumW;
+      res[2] = sumW2;
+   };
+
+   double sums[3];
+   EvaluateChunks(func, p, n, 3, evalChunk, sums);
+   double logl = sums[0];
+   double sumW = sums[1];
+   double sumW2 = sums[2];
 
    if (extended) {
       // add Poisson extended term
@@ -1024,30 +1213,37 @@ void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & d
    //int nRejected = 0;
 
    unsigned int npar = func.NPar();
-   std::vector<double> gradFunc( npar );
-   std::vector<double> g( npar);
 
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x = data.Coords(i);
-      double fval = func ( x , p);
-      func.ParameterGradient( x, p, &gradFunc[0] );
-      for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
-         if (fval > 0)
-            g[kpar] -= 1./fval * gradFunc[ kpar ];
-         else if (gradFunc [ kpar] != 0) {
-            const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
-            const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
-            double gg = kdmax1 * gradFunc[ kpar ];
-            if ( gg > 0) gg = std::min( gg, kdmax2);
-            else gg = std::max(gg, - kdmax2);
-            g[kpar] -= gg;
+   // evaluate the gradient of the points [begin, end)
+   auto evalChunk = [&](const IGradModelFunction & fn, unsigned int begin, unsigned int end, double * g) {
+
+      std::vector<double> gradFunc( npar );
+
+      for (unsigned int i = begin; i < end; ++ i) {
+         const double * x = data.Coords(i);
+         double fval = fn ( x , p);
+         fn.ParameterGradient( x, p, &gradFunc[0] );
+         for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
+            if (fval > 0)
+               g[kpar] -= 1./fval * gradFunc[ kpar ];
+            else if (gradFunc [ kpar] != 0) {
+               const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
+               const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
+               double gg = kdmax1 * gradFunc[ kpar ];
+               if ( gg > 0) gg = std::min( gg, kdmax2);
+               else gg = std::max(gg, - kdmax2);
+               g[kpar] -= gg;
+            }
+            // if func derivative is zero term is also zero so do not add in g[kpar]
          }
-         // if func derivative is zero term is also zero so do not add in g[kpar]
       }
+   };
+
+   std::vector<double> g( npar);
+   EvaluateChunks(func, p, n, npar, evalChunk, &g[0], true);
 
-    // copy result
+   // copy result
    std::copy(g.begin(), g.end(), grad);
-   }
 }
 //_________________________________________________________________________________________________
 // for binned log likelihood functions
@@ -1183,8 +1379,6 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    (const_cast<IModelFunction &>(func)).SetParameters(p);
 #endif
    
-   double nloglike = 0;  // negative loglikelihood 
-   nPoints = 0;  // npoints
 
 
    // get fit option and check case of using integral of bins
@@ -1192,13 +1386,12 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    bool useBinIntegral = fitOpt.fIntegral && data.HasBinEdges();
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
    bool useW2 = (iWeight == 2);
+   bool useBatch = (gExecutionPolicy & kVectorized) && !useBinIntegral && !useBinVolume;
    
    // normalize if needed by a reference volume value
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
 #ifdef DEBUG
@@ -1208,112 +1401,132 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
              << useBinVolume << " useW2 " << useW2 << " wrefVolume = " << wrefVolume << std::endl;
 #endif
 
+   // evaluate the negative log-likelihood of the points [begin, end) in res[0]
+   // and the number of points with non-zero content in res[1]
+   auto evalChunk = [&](const IModelFunction & fn, unsigned int begin, unsigned int end, double * res) {
+
 #ifdef USE_PARAMCACHE
-   IntegralEvaluator<> igEval( func, 0, useBinIntegral); 
+      IntegralEvaluator<> igEval( fn, 0, useBinIntegral); 
 #else
-   IntegralEvaluator<> igEval( func, p, useBinIntegral); 
+      IntegralEvaluator<> igEval( fn, p, useBinIntegral); 
 #endif
-   // double nuTot = 0; // total number of expected events (needed for non-extended fits)
-   // double wTot = 0; // sum of all weights
-   // double w2Tot = 0; // sum of weight squared  (these are needed for useW2)
-
-
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x1 = data.Coords(i);
-      double y = data.Value(i);
-
-      double fval = 0;
-      double binVolume = 1.0;
-
-      if (useBinVolume) {
-         unsigned int ndim = data.NDim();
-         const double * x2 = data.BinUpEdge(i);
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+      BatchEvaluator<BinData> batchEval( fn, data, p, end);
+      std::vector<double> xc;
+      if (useBinVolume) xc.resize(data.NDim() );
+      double nloglike = 0;  // negative loglikelihood 
+      unsigned int nPointsChunk = 0;
+      // double nuTot = 0; // total number of expected events (needed for non-extended fits)
+      // double wTot = 0; // sum of all weights
+      // double w2Tot = 0; // sum of weight squared  (these are needed for useW2)
+
+
+      for (unsigned int i = begin; i < end; ++ i) {
+         const double * x1 = data.Coords(i);
+         double y = data.Value(i);
+
+         double fval = 0;
+         double binVolume = 1.0;
+
+         if (useBinVolume) {
+            unsigned int ndim = data.NDim();
+            const double * x2 = data.BinUpEdge(i);
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral) {
+         if (useBatch) {
+            fval = batchEval( i );
+         }
+         else if (!useBinIntegral) {
 #ifdef USE_PARAMCACHE
-         fval = func ( x );
+            fval = fn ( x );
 #else
-         fval = func ( x, p );
+            fval = fn ( x, p );
 #endif
-      }
-      else {
-         // calculate integral (normalized by bin volume)
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, data.BinUpEdge(i)) ;
-      }
-      if (useBinVolume) fval *= binVolume;
+         }
+         else {
+            // calculate integral (normalized by bin volume)
+            // need to set function and parameters here in case loop is parallelized
+            fval = igEval( x1, data.BinUpEdge(i)) ;
+         }
+         if (useBinVolume) fval *= binVolume;
 
 
 
 #ifdef DEBUG
-      int NSAMPLE = 100;
-      if (i%NSAMPLE == 0) {
-         std::cout << "evt " << i << " x1 = [ ";
-         for (unsigned int j=0; j < func.NDim(); ++j) std::cout << x[j] << " , ";
-         std::cout << "]  ";
-         if (fitOpt.fIntegral) {
-            std::cout << "x2 = [ ";
-            for (unsigned int j=0; j < func.NDim(); ++j) std::cout << data.BinUpEdge(i)[j] << " , ";
-            std::cout << "] ";
+         int NSAMPLE = 100;
+         if (i%NSAMPLE == 0) {
+            std::cout << "evt " << i << " x1 = [ ";
+            for (unsigned int j=0; j < fn.NDim(); ++j) std::cout << x[j] << " , ";
+            std::cout << "]  ";
+            if (fitOpt.fIntegral) {
+               std::cout << "x2 = [ ";
+               for (unsigned int j=0; j < fn.NDim(); ++j) std::cout << data.BinUpEdge(i)[j] << " , ";
+               std::cout << "] ";
+            }
+            std::cout << "  y = " << y << " fval = " << fval << std::endl;
          }
-         std::cout << "  y = " << y << " fval = " << fval << std::endl;
-      }
 #endif
 
 
-      // EvalLog protects against 0 values of fval but don't want to add in the -log sum
-      // negative values of fval
-      fval = std::max(fval, 0.0);
-
-
-      double tmp = 0;
-      if (useW2) {
-         // apply weight correction . Effective weight is error^2/ y
-         // and expected events in bins is fval/weight
-         // can apply correction only when y is not zero otherwise weight is undefined
-         // (in case of weighted likelihood I don't care about the constant term due to
-         // the saturated model)
-         if (y != 0) {
-            double error = data.Error(i);
-            double weight = (error*error)/y;  // this is the bin effective weight
-            if (extended) {
-               tmp = fval * weight;
-               // wTot  += weight;
-               // w2Tot += weight*weight;
+         // EvalLog protects against 0 values of fval but don't want to add in the -log sum
+         // negative values of fval
+         fval = std::max(fval, 0.0);
+
+
+         double tmp = 0;
+         if (useW2) {
+            // apply weight correction . Effective weight is error^2/ y
+            // and expected events in bins is fval/weight
+            // can apply correction only when y is not zero otherwise weight is undefined
+            // (in case of weighted likelihood I don't care about the constant term due to
+            // the saturated model)
+            if (y != 0) {
+               double error = data.Error(i);
+               double weight = (error*error)/y;  // this is the bin effective weight
+               if (extended) {
+                  tmp = fval * weight;
+                  // wTot  += weight;
+                  // w2Tot += weight*weight;
+               }
+               tmp -= weight * y * ROOT::Math::Util::EvalLog( fval);
+            }
+
+            //  need to compute total weight and weight-square
+            // if (extended ) {
+            //    nuTot += fval;
+            // }
+
+         }
+         else {
+            // standard case no weights or iWeight=1
+            // this is needed for Poisson likelihood (which are extened and not for multinomial)
+            // the formula below  include constant term due to likelihood of saturated model (f(x) = y)
+            // (same formula as in Baker-Cousins paper, page 439 except a factor of 2
+            if (extended) tmp = fval -y ;
+            if (y >  0) {
+               tmp +=  y *  (ROOT::Math::Util::EvalLog( y) - ROOT::Math::Util::EvalLog(fval));
+               nPointsChunk++;
             }
-            tmp -= weight * y * ROOT::Math::Util::EvalLog( fval);
          }
 
-         //  need to compute total weight and weight-square
-         // if (extended ) {
-         //    nuTot += fval;
-         // }
 
+         nloglike +=  tmp;
       }
-      else {
-         // standard case no weights or iWeight=1
-         // this is needed for Poisson likelihood (which are extened and not for multinomial)
-         // the formula below  include constant term due to likelihood of saturated model (f(x) = y)
-         // (same formula as in Baker-Cousins paper, page 439 except a factor of 2
-         if (extended) tmp = fval -y ;
-         if (y >  0) {
-            tmp +=  y *  (ROOT::Math::Util::EvalLog( y) - ROOT::Math::Util::EvalLog(fval));
-            nPoints++;
-         }
-      }
+      res[0] = nloglike;
+      res[1] = nPointsChunk;
+   };
 
-
-      nloglike +=  tmp;
-   }
+   double sums[2];
+   EvaluateChunks(func, p, n, 2, evalChunk, sums);
+   double nloglike = sums[0];  // negative loglikelihood 
+   nPoints = (unsigned int) sums[1];
 
    // if (notExtended) {
    //    // not extended : remove from the Likelihood the global Poisson term
@@ -1353,73 +1566,79 @@ void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinDat
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
 
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
-   IntegralEvaluator<> igEval( func, p, useBinIntegral);
-
    unsigned int npar = func.NPar();
-   std::vector<double> gradFunc( npar );
-   std::vector<double> g( npar);
 
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x1 = data.Coords(i);
-      double y = data.Value(i);
-      double fval = 0;
-      const double * x2 = 0;
-
-      double binVolume = 1.0;
-      if (useBinVolume) {
-         x2 = data.BinUpEdge(i);
-         unsigned int ndim = data.NDim();
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+   // evaluate the gradient of the points [begin, end)
+   auto evalChunk = [&](const IGradModelFunction & fn, unsigned int begin, unsigned int end, double * g) {
+
+      IntegralEvaluator<> igEval( fn, p, useBinIntegral);
+      std::vector<double> xc;
+      if (useBinVolume) xc.resize(data.NDim() );
+      std::vector<double> gradFunc( npar );
+
+      for (unsigned int i = begin; i < end; ++ i) {
+         const double * x1 = data.Coords(i);
+         double y = data.Value(i);
+         double fval = 0;
+         const double * x2 = 0;
+
+         double binVolume = 1.0;
+         if (useBinVolume) {
+            x2 = data.BinUpEdge(i);
+            unsigned int ndim = data.NDim();
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral) {
-         fval = func ( x, p );
-         func.ParameterGradient(  x , p, &gradFunc[0] );
-      }
-      else {
-         // calculate integral (normalized by bin volume)
-         // need to set function and parameters here in case loop is parallelized
-         x2 = data.BinUpEdge(i);
-         fval = igEval( x1, x2) ;
-         CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]);
-      }
-      if (useBinVolume) fval *= binVolume;
-
-      // correct the gradient
-      for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
-
-         // correct gradient for bin volumes
-         if (useBinVolume) gradFunc[kpar] *= binVolume;
-
-         // df/dp * (1.  - y/f )
-         if (fval > 0)
-            g[kpar] += gradFunc[ kpar ] * ( 1. - y/fval );
-         else if (gradFunc [ kpar] != 0) {
-            const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
-            const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
-            double gg = kdmax1 * gradFunc[ kpar ];
-            if ( gg > 0) gg = std::min( gg, kdmax2);
-            else gg = std::max(gg, - kdmax2);
-            g[kpar] -= gg;
+         if (!useBinIntegral) {
+            fval = fn ( x, p );
+            fn.ParameterGradient(  x , p, &gradFunc[0] );
+         }
+         else {
+            // calculate integral (normalized by bin volume)
+            // need to set function and parameters here in case loop is parallelized
+            x2 = data.BinUpEdge(i);
+            fval = igEval( x1, x2) ;
+            CalculateGradientIntegral( fn, x1, x2, p, &gradFunc[0]);
+         }
+         if (useBinVolume) fval *= binVolume;
+
+         // correct the gradient
+         for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
+
+            // correct gradient for bin volumes
+            if (useBinVolume) gradFunc[kpar] *= binVolume;
+
+            // df/dp * (1.  - y/f )
+            if (fval > 0)
+               g[kpar] += gradFunc[ kpar ] * ( 1. - y/fval );
+            else if (gradFunc [ kpar] != 0) {
+               const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
+               const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
+               double gg = kdmax1 * gradFunc[ kpar ];
+               if ( gg > 0) gg = std::min( gg, kdmax2);
+               else gg = std::max(gg, - kdmax2);
+               g[kpar] -= gg;
+            }
          }
       }
+   };
 
-      // copy result
-      std::copy(g.begin(), g.end(), grad);
-   }
+   std::vector<double> g( npar);
+   EvaluateChunks(func, p, n, npar, evalChunk, &g[0], true);
+
+   // copy result
+   std::copy(g.begin(), g.end(), grad);
 }
 
 }
@@ -8,12 +8,14 @@
 #include "TSystem.h"
 #include "TRandom3.h"
 #include "TROOT.h"
+#include "TMath.h"
 #include "TVirtualFitter.h"
 
 #include "Fit/BinData.h"
 #include "Fit/UnBinData.h"
 #include "HFitInterface.h"
 #include "Fit/Fitter.h"
+#include "Fit/FitUtil.h"
 
 #include "Math/WrappedMultiTF1.h"
 #include "Math/WrappedParamFunction.h"
@@ -913,6 +915,81 @@ int testGraphFit() {
    return iret;
 }
 
+double gausFunc(const double * x, const double * p) {
+   double t = (x[0] - p[1]) / p[2];
+   return p[0] * std::exp(-0.5 * t * t);
+}
+
+double gausPdf(const double * x, const double * p) {
+   double t = (x[0] - p[0]) / p[1];
+   return std::exp(-0.5 * t * t) / ( std::sqrt(2. * TMath::Pi()) * p[1] );
+}
+
+// fit data with the model function f using each execution policy of the
+// fit method functions and compare the results with those of the serial fit
+template<class Data>
+int fitWithPolicies(ROOT::Fit::Fitter & fitter, ROOT::Math::IParamMultiFunction & f, const Data & d,
+                    bool likelihood, std::string name) {
+
+   int iret = 0;
+   std::vector<double> p0(f.Parameters(), f.Parameters() + f.NPar() );
+   std::vector<double> pref;
+   double fref = 0;
+   for (int policy = ROOT::Fit::FitUtil::kSerial; policy <= ROOT::Fit::FitUtil::kMultiThreadVectorized; ++policy) {
+      ROOT::Fit::FitUtil::SetExecutionPolicy( ROOT::Fit::FitUtil::EExecutionPolicy(policy), 4);
+      f.SetParameters(&p0[0]);
+      fitter.SetFunction(f);
+      bool ret = (likelihood) ? fitter.LikelihoodFit(d) : fitter.Fit(d);
+      if (!ret) {
+         std::cout << name << " fit with execution policy " << policy << " failed " << std::endl;
+         iret |= 1;
+         continue;
+      }
+      const ROOT::Fit::FitResult & result = fitter.Result();
+      if (policy == ROOT::Fit::FitUtil::kSerial) {
+         pref = result.Parameters();
+         fref = result.MinFcnValue();
+         continue;
+      }
+      // without threads the points are evaluated in the same order as in the serial fit
+      double tol = (policy & ROOT::Fit::FitUtil::kMultiThread) ? 1.E-6 : 1.E-14;
+      iret |= compareResult(result.MinFcnValue(), fref, name + " minimum", tol);
+      for (unsigned int ipar = 0; ipar < pref.size(); ++ipar)
+         iret |= compareResult(result.Parameter(ipar), pref[ipar], name + " parameter", tol);
+   }
+   ROOT::Fit::FitUtil::SetExecutionPolicy( ROOT::Fit::FitUtil::kSerial);
+   return iret;
+}
+
+int testParallelFit() {
+
+   int iret = 0;
+
+   TRandom3 rndm(111);
+   TH1D * h1 = new TH1D("hpf","parallel fit histo",8000,-5.,5.);
+   for (int i = 0; i < 400000; ++i) h1->Fill( rndm.Gaus(0.5, 1.2) );
+
+   double p[3] = { 100., 0., 1. };
+   ROOT::Math::WrappedParamFunction<> f( &gausFunc, 1, 3, p);
+
+   ROOT::Fit::BinData d;
+   ROOT::Fit::FillData(d,h1);
+
+   ROOT::Fit::Fitter fitter;
+   iret |= fitWithPolicies(fitter, f, d, false, "Chi2");
+   iret |= fitWithPolicies(fitter, f, d, true, "Poisson likelihood");
+
+   int n = 20000;
+   ROOT::Fit::UnBinData ud(n);
+   for (int i = 0; i < n; ++i) ud.Add( rndm.Gaus(0.5, 1.2) );
+   double ppdf[2] = { 0., 1. };
+   ROOT::Math::WrappedParamFunction<> pdf( &gausPdf, 1, 2, ppdf);
+   iret |= fitWithPolicies(fitter, pdf, ud, true, "Unbinned likelihood");
+
+   delete h1;
+   return iret;
+}
+
 
 template<typename Test>
 int testFit(Test t, std::string name) {
@@ -934,6 +1011,7 @@ int main() {
    iret |= testFit( testHisto2DFit, "Histogram2D Gradient Fit");
    iret |= testFit( testUnBin1DFit, "Unbin 1D Fit");
    iret |= testFit( testGraphFit, "Graph 1D Fit");
+   iret |= testFit( testParallelFit, "Parallel and Vectorized Fit");
 
    std::cout << "\n******************************\n";
    if (iret) std::cerr << "\n\t testFit FAILED !!!!!!!!!!!!!!!! \n";
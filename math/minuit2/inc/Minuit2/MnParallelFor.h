@@ -0,0 +1,75 @@
+// @(#)root/minuit2:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2005 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Minuit2_MnParallelFor
+#define ROOT_Minuit2_MnParallelFor
+
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+//_________________________________________________________________________
+/**
+    Execute func(i, ithread) for all the indices i in [begin, end) using
+    nthreads threads (the calling thread and nthreads-1 new ones); ithread
+    is the index, in [0, nthreads), of the thread executing the call, which
+    can be used to access a work space per thread.
+    The indices are distributed dynamically to the threads, so func must not
+    depend on the order of the calls: the results have to be stored per
+    index and combined afterwards in the index order, which makes them
+    independent of the number of threads.
+    With nthreads <= 1 the indices are processed in order by the calling
+    thread. An exception thrown by func is rethrown in the calling thread
+    once all the threads are finished.
+ */
+
+template <class Func>
+void MnParallelFor(unsigned int begin, unsigned int end, unsigned int nthreads, const Func & func) {
+
+   if (end <= begin) return;
+   if (nthreads > end - begin) nthreads = end - begin;
+   if (nthreads <= 1) {
+      for (unsigned int i = begin; i < end; ++i) func(i, 0);
+      return;
+   }
+
+   std::atomic<unsigned int> next(begin);
+   std::vector<std::exception_ptr> errors(nthreads);
+
+   auto work = [&](unsigned int ithread) {
+      try {
+         for (unsigned int i = next++; i < end; i = next++) func(i, ithread);
+      }
+      catch (...) {
+         errors[ithread] = std::current_exception();
+         // stop the other threads as soon as they finish their current index
+         next = end;
+      }
+   };
+
+   std::vector<std::thread> threads;
+   for (unsigned int ithread = 1; ithread < nthreads; ++ithread)
+      threads.push_back(std::thread(work, ithread));
+   work(0);
+   for (unsigned int ithread = 0; ithread < threads.size(); ++ithread) threads[ithread].join();
+
+   for (unsigned int ithread = 0; ithread < nthreads; ++ithread) {
+      if (errors[ithread]) std::rethrow_exception(errors[ithread]);
+   }
+}
+
+  }  // namespace Minuit2
+
+}  // namespace ROOT
+
+#endif  // ROOT_Minuit2_MnParallelFor
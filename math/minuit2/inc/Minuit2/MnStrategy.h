@@ -49,6 +49,9 @@ public:
 
    int StorageLevel() const { return fStoreLevel; }
 
+   // number of threads used to compute the numerical gradient and the Hessian
+   unsigned int NThreads() const { return fNThreads; }
+
    bool IsLow() const {return fStrategy == 0;}
    bool IsMedium() const {return fStrategy == 1;}
    bool IsHigh() const {return fStrategy >= 2;}
@@ -69,6 +72,13 @@ public:
    // set storage level of iteration quantities
    // 0 = store only last iterations 1 = full storage (default)
    void SetStorageLevel(unsigned int level) { fStoreLevel = level; }
+
+   // set the number of threads computing concurrently the components of the
+   // numerical gradient and the elements of the Hessian (default is 1).
+   // The FCN must then be thread safe. The results do not depend on the
+   // number of threads. A number smaller than 1 is reported as an error
+   // and 1 is used
+   void SetNThreads(int n);
 private:
 
    unsigned int fStrategy;
@@ -81,6 +91,7 @@ private:
    double fHessTlrG2;
    unsigned int fHessGradNCyc;
    int fStoreLevel;
+   unsigned int fNThreads;
 };
 
   }  // namespace Minuit2
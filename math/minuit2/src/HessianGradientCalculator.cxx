@@ -25,6 +25,7 @@
 #endif
 
 #include "Minuit2/MPIProcess.h"
+#include "Minuit2/MnParallelFor.h"
 
 namespace ROOT {
 
@@ -90,7 +91,13 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
    unsigned int startElementIndex = mpiproc.StartElementIndex();
    unsigned int endElementIndex = mpiproc.EndElementIndex();
 
-   for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
+   // the components are independent: they can be computed concurrently,
+   // each thread using its own copy of the parameters
+   unsigned int nthreads = Strategy().NThreads();
+   std::vector<MnAlgebraicVector> xthreads(nthreads, x);
+
+   MnParallelFor(startElementIndex, endElementIndex, nthreads, [&](unsigned int i, unsigned int ithread) {
+      MnAlgebraicVector & x = xthreads[ithread];
       double xtf = x(i);
       double dmin = 4.*Precision().Eps2()*(xtf + Precision().Eps2());
       double epspri = Precision().Eps2() + fabs(grd(i)*Precision().Eps2());
@@ -135,7 +142,7 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
       std::cout << "HGC Param : " << i << "\t new g1 = " << grd(i) << " gstep = " << d << " dgrd = " << dgrd(i) << std::endl;
 #endif
 
-   }
+   });
 
    mpiproc.SyncVector(grd);
    mpiproc.SyncVector(gstep);
@@ -452,6 +452,11 @@ bool Minuit2Minimizer::Minimize() {
       strategy.SetHessianStepTolerance(hessStepTol);
       strategy.SetHessianG2Tolerance(hessStepTol);
 
+      // number of threads computing the numerical gradient and the Hessian
+      int nThreads = strategy.NThreads();
+      minuit2Opt->GetValue("NThreads",nThreads);
+      strategy.SetNThreads(nThreads);
+
       int storageLevel = 1;
       bool ret = minuit2Opt->GetValue("StorageLevel",storageLevel);
       if (ret) SetStorageLevel(storageLevel);
@@ -1037,7 +1042,15 @@ bool Minuit2Minimizer::Hesse( ) {
    // set the precision if needed
    if (Precision() > 0) fState.SetPrecision(Precision());
 
-   ROOT::Minuit2::MnHesse hesse( strategy );
+   ROOT::Minuit2::MnStrategy hesseStrategy(strategy);
+   ROOT::Math::IOptions * minuit2Opt = ROOT::Math::MinimizerOptions::FindDefault("Minuit2");
+   if (minuit2Opt) {
+      int nThreads = 1;
+      minuit2Opt->GetValue("NThreads",nThreads);
+      hesseStrategy.SetNThreads(nThreads);
+   }
+
+   ROOT::Minuit2::MnHesse hesse( hesseStrategy );
 
 
    // case when function minimum exists
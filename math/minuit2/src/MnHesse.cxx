@@ -29,6 +29,7 @@
 #endif
 
 #include "Minuit2/MPIProcess.h"
+#include "Minuit2/MnParallelFor.h"
 
 namespace ROOT {
 
@@ -130,9 +131,13 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
 #endif
 
 
-   for(unsigned int i = 0; i < n; i++) {
+   // compute the diagonal element i: update g2(i), grd(i), gst(i), dirin(i) and yy(i)
+   // using xw as work space (restored at the end) and add the number of function calls
+   // to ncall. Return false if the second derivative is zero.
+   // The elements are independent and can be computed concurrently
+   auto computeDiagonal = [&](unsigned int i, MnAlgebraicVector & xw, unsigned int & ncall) -> bool {
 
-      double xtf = x(i);
+      double xtf = xw(i);
       double dmin = 8.*prec.Eps2()*(fabs(xtf) + prec.Eps2());
       double d = fabs(gst(i));
       if(d < dmin) d = dmin;
@@ -147,20 +152,21 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
          double fs1 = 0.;
          double fs2 = 0.;
          for(unsigned int multpy = 0; multpy < 5; multpy++) {
-            x(i) = xtf + d;
-            fs1 = mfcn(x);
-            x(i) = xtf - d;
-            fs2 = mfcn(x);
-            x(i) = xtf;
+            xw(i) = xtf + d;
+            fs1 = mfcn(xw);
+            xw(i) = xtf - d;
+            fs2 = mfcn(xw);
+            xw(i) = xtf;
+            ncall += 2;
             sag = 0.5*(fs1+fs2-2.*amin);
 
 #ifdef DEBUG
             std::cout << "cycle " << icyc << " mul " << multpy << "\t sag = " << sag << " d = " << d << std::endl;
 #endif
             //  Now as F77 Minuit - check taht sag is not zero
-            if (sag != 0) goto L30; // break
+            if (sag != 0) break;
             if(trafo.Parameter(i).HasLimits()) {
-               if(d > 0.5) goto L26;
+               if(d > 0.5) break;
                d *= 10.;
                if(d > 0.5) d = 0.51;
                continue;
@@ -168,27 +174,9 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
             d *= 10.;
          }
 
-L26:
-#ifdef WARNINGMSG
-
-         // get parameter name for i
-         // (need separate scope for avoiding compl error when declaring name)
-         {
-            const char * name = trafo.Name( trafo.ExtOfInt(i));
-            MN_INFO_VAL2("MnHesse: 2nd derivative zero for Parameter ", name);
-            MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
-         }
-#endif
-
-         for(unsigned int j = 0; j < n; j++) {
-            double tmp = g2(j) < prec.Eps2() ? 1. : 1./g2(j);
-            vhmat(j,j) = tmp < prec.Eps2() ? 1. : tmp;
-         }
-
-         return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
+         if (sag == 0) return false;
 
-L30:
-            double g2bfor = g2(i);
+         double g2bfor = g2(i);
          g2(i) = 2.*sag/(d*d);
          grd(i) = (fs1-fs2)/(2.*d);
          gst(i) = d;
@@ -211,8 +199,59 @@ L30:
          d = std::min(d, 10.*dlast);
          d = std::max(d, 0.1*dlast);
       }
+      return true;
+   };
+
+   // diagonal matrix returned when the computation fails at the parameter ilast,
+   // made of the second derivatives computed up to ilast and of the initial ones after
+   MnAlgebraicVector g2init = g2;
+   auto diagonalMatrix = [&](unsigned int ilast) {
+      MnAlgebraicSymMatrix diag(n);
+      for(unsigned int j = 0; j < n; j++) {
+         double g2j = (j <= ilast) ? g2(j) : g2init(j);
+         double tmp = g2j < prec.Eps2() ? 1. : 1./g2j;
+         diag(j,j) = tmp < prec.Eps2() ? 1. : tmp;
+      }
+      return diag;
+   };
+
+   // with several threads (see MnStrategy::SetNThreads) all the diagonal elements are
+   // computed first, each thread using its own copy of the parameters; they are then
+   // checked in order, as in the serial computation, so that the result does not
+   // depend on the number of threads.
+   // A diagonal element takes at most 10 calls per cycle: the elements are computed
+   // concurrently only if the call limit cannot be reached by the diagonal, otherwise
+   // the serial computation stops at the same parameter as without threads
+   unsigned int nthreads = fStrategy.NThreads();
+   std::vector<MnAlgebraicVector> xthreads(nthreads, x);
+   std::vector<unsigned int> diagCalls(n, 0);
+   std::vector<char> diagValid(n, 1);
+   // the calls of the diagonal elements are added below, parameter after parameter
+   unsigned int ncall = mfcn.NumOfCalls();
+   bool parallelDiagonal = nthreads > 1 && ncall + 10*Ncycles()*n <= maxcalls;
+   if (parallelDiagonal) {
+      MnParallelFor(0, n, nthreads, [&](unsigned int i, unsigned int ithread) {
+         diagValid[i] = computeDiagonal(i, xthreads[ithread], diagCalls[i]);
+      });
+   }
+
+   for(unsigned int i = 0; i < n; i++) {
+
+      if (!parallelDiagonal) diagValid[i] = computeDiagonal(i, xthreads[0], diagCalls[i]);
+      ncall += diagCalls[i];
+
+      if (!diagValid[i]) {
+#ifdef WARNINGMSG
+         const char * name = trafo.Name( trafo.ExtOfInt(i));
+         MN_INFO_VAL2("MnHesse: 2nd derivative zero for Parameter ", name);
+         MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
+#endif
+         // the calls of the parameters after i, computed concurrently, are not counted
+         return MinimumState(st.Parameters(), MinimumError(diagonalMatrix(i), MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), ncall);
+      }
+
       vhmat(i,i) = g2(i);
-      if(mfcn.NumOfCalls()  > maxcalls) {
+      if(ncall > maxcalls) {
 
 #ifdef WARNINGMSG
          //std::cout<<"maxcalls " << maxcalls << " " << mfcn.NumOfCalls() << "  " <<   st.NFcn() << std::endl;
@@ -220,12 +259,7 @@ L30:
          MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
 #endif
 
-         for(unsigned int j = 0; j < n; j++) {
-            double tmp = g2(j) < prec.Eps2() ? 1. : 1./g2(j);
-            vhmat(j,j) = tmp < prec.Eps2() ? 1. : tmp;
-         }
-
-         return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
+         return MinimumState(st.Parameters(), MinimumError(diagonalMatrix(i), MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), ncall);
       }
 
    }
@@ -244,37 +278,33 @@ L30:
    }
 
    //off-diagonal Elements
-   // initial starting values
+   // the elements (i,j) with j > i are numbered row after row; each process
+   // computes a range of them, and its threads the rows of this range.
+   // Each element is computed at the point x + dirin(i) + dirin(j), independently
+   // of the others
    MPIProcess mpiprocOffDiagonal(n*(n-1)/2,0);
    unsigned int startParIndexOffDiagonal = mpiprocOffDiagonal.StartElementIndex();
    unsigned int endParIndexOffDiagonal = mpiprocOffDiagonal.EndElementIndex();
 
-   unsigned int offsetVect = 0;
-   for (unsigned int in = 0; in<startParIndexOffDiagonal; in++)
-      if ((in+offsetVect)%(n-1)==0) offsetVect += (in+offsetVect)/(n-1);
+   MnParallelFor(0, (n > 0) ? n-1 : 0, nthreads, [&](unsigned int i, unsigned int ithread) {
+      MnAlgebraicVector & xw = xthreads[ithread];
+      // index of the element (i,i+1)
+      unsigned int rowStart = i*(n-1) - i*(i-1)/2;
+      for (unsigned int j = i+1; j < n; j++) {
+         unsigned int in = rowStart + (j-i-1);
+         if (in < startParIndexOffDiagonal || in >= endParIndexOffDiagonal) continue;
 
-   for (unsigned int in = startParIndexOffDiagonal;
-        in<endParIndexOffDiagonal; in++) {
+         xw(i) = x(i) + dirin(i);
+         xw(j) = x(j) + dirin(j);
 
-      int i = (in+offsetVect)/(n-1);
-      if ((in+offsetVect)%(n-1)==0) offsetVect += i;
-      int j = (in+offsetVect)%(n-1)+1;
+         double fs1 = mfcn(xw);
+         double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
+         vhmat(i,j) = elem;
 
-      if ((i+1)==j || in==startParIndexOffDiagonal)
-         x(i) += dirin(i);
-
-      x(j) += dirin(j);
-
-      double fs1 = mfcn(x);
-      double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
-      vhmat(i,j) = elem;
-
-      x(j) -= dirin(j);
-
-      if (j%(n-1)==0 || in==endParIndexOffDiagonal-1)
-         x(i) -= dirin(i);
-
-   }
+         xw(i) = x(i);
+         xw(j) = x(j);
+      }
+   });
 
    mpiprocOffDiagonal.SyncSymMatrixOffDiagonal(vhmat);
 
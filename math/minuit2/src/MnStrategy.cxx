@@ -8,6 +8,7 @@
  **********************************************************************/
 
 #include "Minuit2/MnStrategy.h"
+#include "Minuit2/MnPrint.h"
 
 namespace ROOT {
 
@@ -15,13 +16,13 @@ namespace ROOT {
 
 
 
-      MnStrategy::MnStrategy() : fStoreLevel(1) {
+      MnStrategy::MnStrategy() : fStoreLevel(1), fNThreads(1) {
    //default strategy
    SetMediumStrategy();
 }
 
 
-      MnStrategy::MnStrategy(unsigned int stra) : fStoreLevel(1) {
+      MnStrategy::MnStrategy(unsigned int stra) : fStoreLevel(1), fNThreads(1) {
    //user defined strategy (0, 1, >=2)
    if(stra == 0) SetLowStrategy();
    else if(stra == 1) SetMediumStrategy();
@@ -64,6 +65,15 @@ void MnStrategy::SetHighStrategy() {
    SetHessianGradientNCycles(6);
 }
 
+void MnStrategy::SetNThreads(int n) {
+   // set the number of threads computing the numerical gradient and the Hessian
+   if (n < 1) {
+      MN_ERROR_MSG2("MnStrategy::SetNThreads","the number of threads must be at least 1, 1 thread is used");
+      n = 1;
+   }
+   fNThreads = n;
+}
+
    }  // namespace Minuit2
 
 }  // namespace ROOT
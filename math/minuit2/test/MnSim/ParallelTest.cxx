@@ -13,12 +13,16 @@
 #include "Minuit2/MnUserParameterState.h"
 #include "Minuit2/MnPrint.h"
 #include "Minuit2/MnMigrad.h"
+#include "Minuit2/MnHesse.h"
+#include "Minuit2/MnStrategy.h"
 #include "Minuit2/MnMinos.h"
 #include "Minuit2/MnPlot.h"
 #include "Minuit2/MinosError.h"
 #include "Minuit2/FCNBase.h"
 #include <cmath>
 #include <iostream>
+#include <string>
+#include <algorithm>
 
 // example of a multi dimensional fit where parallelization can be used
 // to speed up the result
@@ -27,6 +31,9 @@
 // The default number of dimension is 20 (fit in 40 parameters) on 1000 data events.
 // One can change the dimension and the number of events by doing:
 // ./test_Minuit2_Parallel    ndim  nevents
+// The fit is then repeated computing the numerical gradient and the Hessian
+// with 1, 2 and 7 threads (MnStrategy::SetNThreads), which must give the same
+// results bit by bit
 
 using namespace ROOT::Minuit2;
 
@@ -70,11 +77,9 @@ struct LogLikeFCN  : public FCNBase {
    const Data & fData;
 };
 
-int doFit(int ndim, int ndata) {
-
-  // generate the data (1000 data points) in 100 dimension
+void generateData(Data & data, int ndim) {
 
-  Data data(ndata);
+  int ndata = data.size();
   std::vector< double> event(ndim);
 
   std::vector<double> mean(ndim);
@@ -92,6 +97,14 @@ int doFit(int ndim, int ndata) {
      }
     data[i] = event;
   }
+}
+
+int doFit(int ndim, int ndata) {
+
+  // generate the data (1000 data points) in 100 dimension
+
+  Data data(ndata);
+  generateData(data, ndim);
 
   // create FCN function
   LogLikeFCN fcn(data);
@@ -144,6 +157,44 @@ int doFit(int ndim, int ndata) {
   return 0;
 }
 
+// fit with MnStrategy(2) computing the numerical gradient and the Hessian with
+// 1, 2 and 7 threads and check that the results are identical
+int testThreads(int ndim, int ndata) {
+
+  Data data(ndata);
+  generateData(data, ndim);
+  LogLikeFCN fcn(data);
+
+  MnUserParameters upar;
+  for (int k = 0; k < ndim; ++k) {
+     upar.Add(std::string("mean") + std::to_string(k), 0., 0.1);
+     upar.Add(std::string("sigma") + std::to_string(k), 1., 0.1);
+  }
+
+  const unsigned int nthreads[3] = { 1, 2, 7 };
+  MnUserParameterState ref;
+  int iret = 0;
+  for (int t = 0; t < 3; ++t) {
+     MnStrategy strategy(2);
+     strategy.SetNThreads(nthreads[t]);
+     MnMigrad migrad(fcn, MnUserParameterState(upar), strategy);
+     FunctionMinimum min = migrad();
+     MnHesse hesse(strategy);
+     hesse(fcn, min);
+     const MnUserParameterState & state = min.UserState();
+     if (t == 0) {
+        ref = state;
+        continue;
+     }
+     bool identical = (state.Fval() == ref.Fval() && state.Edm() == ref.Edm() && state.NFcn() == ref.NFcn() &&
+                       state.Params() == ref.Params() && state.Errors() == ref.Errors() &&
+                       state.Covariance().Data() == ref.Covariance().Data() );
+     std::cout << "fit with " << nthreads[t] << " threads: " << (identical ? "OK" : "FAILED") << std::endl;
+     if (!identical) iret = 1;
+  }
+  return iret;
+}
+
 int main(int argc, char **argv) {
    int ndim = default_ndim;
    int ndata = default_ndata;
@@ -155,4 +206,7 @@ int main(int argc, char **argv) {
    }
    std::cout << "do fit of " << ndim << " dimensional data on " << ndata << " events " << std::endl;
    doFit(ndim,ndata);
+
+   // smaller fit for the comparison of the threads
+   return testThreads(std::min(ndim, 10), ndata);
 }
@@ -46,6 +46,7 @@ protected:
   RooRealProxy sigma ;
   
   Double_t evaluate() const ;
+  virtual Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& store) const ;
 
 private:
 
@@ -46,6 +46,7 @@ protected:
   TIterator* _coefIter ;  //! do not persist
 
   Double_t evaluate() const;
+  virtual Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& store) const ;
 
   ClassDef(RooPolynomial,1) // Polynomial PDF
 };
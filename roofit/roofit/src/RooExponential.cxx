@@ -28,6 +28,8 @@
 #include <math.h>
 
 #include "RooExponential.h"
+
+#include <typeinfo>
 #include "RooRealVar.h"
 
 using namespace std;
@@ -62,6 +64,26 @@ Double_t RooExponential::evaluate() const{
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate()
+
+Bool_t RooExponential::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& store) const
+{
+  // Only for this class: a derived class overriding evaluate() is evaluated event by event
+  if (typeid(*this)!=typeid(RooExponential)) return kFALSE ;
+
+  std::vector<Double_t> xBuf, cBuf ;
+  const Double_t* xVal = x.arg().getValBatch(begin,nEvents,store,xBuf,x.nset()) ;
+  const Double_t* cVal = c.arg().getValBatch(begin,nEvents,store,cBuf,c.nset()) ;
+  if (!xVal || !cVal) return kFALSE ;
+
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    output[i] = exp(cVal[i]*xVal[i]) ;
+  }
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooExponential::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
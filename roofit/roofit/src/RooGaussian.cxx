@@ -28,6 +28,8 @@
 #include <math.h>
 
 #include "RooGaussian.h"
+
+#include <typeinfo>
 #include "RooAbsReal.h"
 #include "RooRealVar.h"
 #include "RooRandom.h"
@@ -77,6 +79,30 @@ Double_t RooGaussian::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate()
+
+Bool_t RooGaussian::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& store) const
+{
+  // Only for this class: a derived class overriding evaluate() is evaluated event by event
+  if (typeid(*this)!=typeid(RooGaussian)) return kFALSE ;
+
+  std::vector<Double_t> xBuf, meanBuf, sigmaBuf ;
+  const Double_t* xVal = x.arg().getValBatch(begin,nEvents,store,xBuf,x.nset()) ;
+  const Double_t* meanVal = mean.arg().getValBatch(begin,nEvents,store,meanBuf,mean.nset()) ;
+  const Double_t* sigmaVal = sigma.arg().getValBatch(begin,nEvents,store,sigmaBuf,sigma.nset()) ;
+  if (!xVal || !meanVal || !sigmaVal) return kFALSE ;
+
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    Double_t arg = xVal[i] - meanVal[i] ;
+    Double_t sig = sigmaVal[i] ;
+    output[i] = exp(-0.5*arg*arg/(sig*sig)) ;
+  }
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// calculate and return the negative log-likelihood of the Poisson                                                                                                                                    
 
@@ -34,6 +34,8 @@
 #include "TMath.h"
 
 #include "RooPolynomial.h"
+
+#include <typeinfo>
 #include "RooAbsReal.h"
 #include "RooRealVar.h"
 #include "RooArgList.h"
@@ -152,6 +154,39 @@ Double_t RooPolynomial::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate()
+
+Bool_t RooPolynomial::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& store) const
+{
+  // Only for this class: a derived class overriding evaluate() is evaluated event by event
+  if (typeid(*this)!=typeid(RooPolynomial)) return kFALSE ;
+
+  std::vector<Double_t> xBuf, coefBuf ;
+  const Double_t* xVal = _x.arg().getValBatch(begin,nEvents,store,xBuf,_x.nset()) ;
+  if (!xVal) return kFALSE ;
+
+  Int_t order(_lowestOrder) ;
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    output[i] = order<1 ? 0 : 1 ;
+  }
+
+  RooAbsReal* coef ;
+  const RooArgSet* nset = _coefList.nset() ;
+  RooFIter coefIter = _coefList.fwdIterator() ;
+  while((coef=(RooAbsReal*)coefIter.next())) {
+    const Double_t* coefVal = coef->getValBatch(begin,nEvents,store,coefBuf,nset) ;
+    if (!coefVal) return kFALSE ;
+    for (Int_t i=0 ; i<nEvents ; i++) {
+      output[i] += coefVal[i]*TMath::Power(xVal[i],order) ;
+    }
+    order++ ;
+  }
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooPolynomial::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
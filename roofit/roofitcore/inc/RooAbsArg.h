@@ -550,7 +550,7 @@ public:
 
   // Debug stuff
   static Bool_t _verboseDirty ; // Static flag controlling verbose messaging for dirty state changes
-  static Bool_t _inhibitDirty ; // Static flag controlling global inhibit of dirty state propagation
+  static Bool_t _inhibitDirty ; // Static flag set while any thread inhibits dirty state propagation
   Bool_t _deleteWatch ; //! Delete watch flag 
 
   Bool_t inhibitDirty() const ;
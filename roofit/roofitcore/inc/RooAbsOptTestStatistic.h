@@ -56,6 +56,10 @@ public:
   Bool_t isSealed() const { return _sealed ; }
   const char* sealNotice() const { return _sealNotice.Data() ; }
 
+  static void setCacheAndTrackMemoryBudget(Double_t megaBytes) ;
+  static Double_t cacheAndTrackMemoryBudget() ;
+  static Double_t cacheAndTrackMemoryUsage() ;
+
 
 protected:
 
@@ -73,6 +77,8 @@ protected:
   virtual RooArgSet requiredExtraObservables() const { return RooArgSet() ; }
   void optimizeCaching() ;
   void optimizeConstantTerms(Bool_t,Bool_t=kTRUE) ;
+  void applyCacheAndTrackBudget(RooArgSet& trackNodes) ;
+  void releaseCacheAndTrackBudget() ;
 
   RooArgSet*  _normSet ; // Pointer to set with observables used for normalization
   RooArgSet*  _funcCloneSet ; // Set owning all components of internal clone of input function
@@ -88,6 +94,10 @@ protected:
   RooAbsReal* _origFunc ; // Original function 
   RooAbsData* _origData ; // Original data 
   Bool_t      _optimized ; //!
+  Double_t    _catUsed ; //! Memory (MB) of the cache-and-track columns of this test statistic
+
+  static Double_t _catBudget ; // Memory budget (MB) of the cache-and-track columns of all test statistics, <0 means no limit
+  static Double_t _catTotalUsed ; // Memory (MB) of the cache-and-track columns of all test statistics
 
   ClassDef(RooAbsOptTestStatistic,4) // Abstract base class for optimized test statistics
 };
@@ -185,6 +185,8 @@ public:
   // Function evaluation support
   virtual Bool_t traceEvalHook(Double_t value) const ;  
   virtual Double_t getValV(const RooArgSet* set=0) const ;
+  virtual const Double_t* getValBatch(Int_t begin, Int_t nEvents, const RooVectorDataStore& store, 
+                                      std::vector<Double_t>& buffer, const RooArgSet* set=0) const ;
   virtual Double_t getLogVal(const RooArgSet* set=0) const ;
 
   Double_t getNorm(const RooArgSet& nset) const { 
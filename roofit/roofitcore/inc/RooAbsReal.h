@@ -49,6 +49,7 @@ class TH3F;
 #include <list>
 #include <string>
 #include <iostream>
+#include <vector>
 
 class RooAbsReal : public RooAbsArg {
 public:
@@ -73,6 +74,12 @@ public:
 
   virtual Double_t getValV(const RooArgSet* set=0) const ;
 
+  // Batch evaluation on a range of events of a vector data store
+  virtual const Double_t* getValBatch(Int_t begin, Int_t nEvents, const RooVectorDataStore& store, 
+                                      std::vector<Double_t>& buffer, const RooArgSet* set=0) const ;
+  static void setBatchEvaluation(Bool_t flag) ; // off by default
+  static Bool_t batchEvaluation() ;
+
   Double_t getPropagatedError(const RooFitResult& fr) ;
 
   Bool_t operator==(Double_t value) const ;
@@ -273,6 +280,9 @@ public:
   static EvalErrorIter evalErrorIter() ;
 
   static void clearEvalErrorLog() ;
+
+  struct EvalErrorLog ;
+  static void useThreadEvalErrorLog(Bool_t flag) ;
   
   virtual Bool_t isBinnedDistribution(const RooArgSet& /*obs*/) const { return kFALSE ; }
   virtual std::list<Double_t>* binBoundaries(RooAbsRealLValue& /*obs*/, Double_t /*xlo*/, Double_t /*xhi*/) const { return 0 ; }
@@ -312,6 +322,8 @@ public:
   static Bool_t hideOffset() ;
 
 protected:
+  virtual Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& store) const ;
+
   // Hook for objects with normalization-dependent parameters interperetation
   virtual void selectNormalization(const RooArgSet* depSet=0, Bool_t force=kFALSE) ;
   virtual void selectNormalizationRange(const char* rangeName=0, Bool_t force=kFALSE) ;
@@ -456,11 +468,14 @@ public:
   virtual RooPlot *plotAsymOn(RooPlot *frame, const RooAbsCategoryLValue& asymCat, PlotOpt o) const;
 
 
-private:
+protected:
+
+  // Evaluation error log of the calling thread, which is the one of the process
+  // unless the thread was given another one
+  static EvalErrorLog& evalErrorLog() ;
+  static void setEvalErrorLog(EvalErrorLog* log) ;
 
-  static ErrorLoggingMode _evalErrorMode ;
-  static std::map<const RooAbsArg*,std::pair<std::string,std::list<EvalError> > > _evalErrorList ;
-  static Int_t _evalErrorCount ;
+private:
 
   Bool_t matchArgsByName(const RooArgSet &allArgs, RooArgSet &matchedArgs, const TList &nameList) const;
 
@@ -480,6 +495,7 @@ protected:
 
   mutable RooArgSet* _lastNSet ; //!
   static Bool_t _hideOffset ; // Offset hiding flag
+  static Bool_t _batchEval ;  // Batch evaluation activation switch
 
   ClassDef(RooAbsReal,2) // Abstract real-valued variable
 };
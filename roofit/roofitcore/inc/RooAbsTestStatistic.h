@@ -60,6 +60,12 @@ public:
   Bool_t setData(RooAbsData& data, Bool_t cloneData=kTRUE) ;
 
   void enableOffsetting(Bool_t flag) ;
+
+  void setUseThreads(Bool_t flag=kTRUE) ;
+  Bool_t useThreads() const { 
+    // Return true if the partitions of the parallel calculation are evaluated by threads
+    return _useThreads ; 
+  }
   Bool_t isOffsetting() const { return _doOffset ; }
   virtual Double_t offset() const { return _offset ; }
   virtual Double_t offsetCarry() const { return _offsetCarry; }
@@ -96,9 +102,9 @@ protected:
   
   RooSetProxy _paramSet ;          // Parameters of the test statistic (=parameters of the input function)
 
-  enum GOFOpMode { SimMaster,MPMaster,Slave } ;
+  enum GOFOpMode { SimMaster,MPMaster,Slave,MTMaster } ;
   GOFOpMode operMode() const { 
-    // Return test statistic operation mode of this instance (SimMaster, MPMaster or Slave)
+    // Return test statistic operation mode of this instance (SimMaster, MPMaster, MTMaster or Slave)
     return _gofOpMode ; 
   }
 
@@ -122,6 +128,7 @@ protected:
   Bool_t initialize() ;
   void initSimMode(RooSimultaneous* pdf, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;    
   void initMPMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
+  void initMTMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
 
   mutable Bool_t _init ;          //! Is object initialized  
   GOFOpMode   _gofOpMode ;        // Operation mode of test statistic instance 
@@ -139,6 +146,12 @@ protected:
   // Parallel mode data
   Int_t          _nCPU ;      //  Number of processors to use in parallel calculation mode
   pRooRealMPFE*  _mpfeArray ; //! Array of parallel execution frond ends
+  Bool_t         _useThreads ; // Evaluate the partitions with threads instead of forked processes
+  pRooAbsTestStatistic* _mtArray ; //! Array of partitions evaluated by the threads in multi-thread mode
+  mutable Bool_t _mtWarm ;    //! First evaluation of the partitions, done serially, completed
+  struct MTWorkers ;
+  MTWorkers*     _mtWorkers ; //! Threads evaluating the partitions 1.._nCPU-1 in multi-thread mode
+  Bool_t         _mtSlice ;  //! Data of this partition holds only the events of the partition
 
   RooFit::MPSplit        _mpinterl ; // Use interleaving strategy rather than N-wise split for partioning of dataset for multiprocessor-split
   Bool_t         _doOffset ; // Apply interval value offset to control numeric precision?
@@ -146,7 +159,7 @@ protected:
   mutable Double_t _offsetCarry; //! avoids loss of precision
   mutable Double_t _evalCarry; //! carry of Kahan sum in evaluatePartition
 
-  ClassDef(RooAbsTestStatistic,2) // Abstract base class for real-valued test statistics
+  ClassDef(RooAbsTestStatistic,3) // Abstract base class for real-valued test statistics
 
 };
 
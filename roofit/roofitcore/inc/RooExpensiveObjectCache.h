@@ -41,6 +41,7 @@ public:
   void importCacheObjects(RooExpensiveObjectCache& other, const char* ownerName, Bool_t verbose=kFALSE) ;
 
   static RooExpensiveObjectCache& instance() ;
+  static void setThreadInstance(RooExpensiveObjectCache* cache) ;
 
   Int_t size() const { return _map.size() ; }
 
@@ -121,8 +121,6 @@ private:
   RooMinimizerFcn *_fcn;
   std::string _minimizerType;
 
-  static ROOT::Fit::Fitter *_theFitter ;
-
   std::vector<std::pair<std::string,int> > _statusHistory ;
 
   RooMinimizer(const RooMinimizer&) ;
@@ -28,6 +28,7 @@ public:
 
   static TRandom *randomGenerator();
   static void setRandomGenerator(TRandom* gen);
+  static void setThreadRandomGenerator(TRandom* gen);
   static Double_t uniform(TRandom *generator= randomGenerator());
   static void uniform(UInt_t dimension, Double_t vector[], TRandom *generator= randomGenerator());
   static UInt_t integer(UInt_t max, TRandom *generator= randomGenerator());
@@ -38,6 +38,7 @@ public:
 protected:
 
   static void init() ;
+  static RooArgList& constDB() ;
 
   static RooArgList* _constDB ;    // List of already instantiated constants
   static TIterator* _constDBIter ; // Iterator over constants list
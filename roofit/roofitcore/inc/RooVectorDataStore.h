@@ -75,6 +75,10 @@ public:
   virtual Double_t weight(Int_t index) const ;
   virtual Bool_t isWeighted() const { return (_wgtVar!=0||_extWgtArray!=0) ; }
 
+  // Column access for batch evaluation
+  const Double_t* getColumn(const RooAbsReal* real) const ;
+  const Double_t* getWeightColumn() const ;
+
   // Change observable name
   virtual Bool_t changeObservableName(const char* from, const char* to) ;
   
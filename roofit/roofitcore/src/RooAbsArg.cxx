@@ -60,12 +60,14 @@
 #include "RooResolutionModel.h"
 #include "RooVectorDataStore.h"
 #include "RooTreeDataStore.h"
+#include "ThreadLocalStorage.h"
 
 #include <string.h>
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
 #include <sstream>
+#include <mutex>
 
 using namespace std ;
 
@@ -78,7 +80,17 @@ ClassImp(RooAbsArg)
 
 Bool_t RooAbsArg::_verboseDirty(kFALSE) ;
 Bool_t RooAbsArg::_inhibitDirty(kFALSE) ;
-Bool_t RooAbsArg::inhibitDirty() const { return _inhibitDirty && !_localNoInhibitDirty; }
+
+namespace {
+  // Dirty inhibit mode of the calling thread. The static flag, which getVal()
+  // reads inline, is set while any thread inhibits: the other threads then
+  // only recalculate values they could have taken from their cache
+  TTHREAD_TLS(Bool_t) gThreadInhibitDirty = kFALSE ;
+  Int_t gInhibitingThreads = 0 ;
+  std::mutex gInhibitMutex ;
+}
+
+Bool_t RooAbsArg::inhibitDirty() const { return gThreadInhibitDirty && !_localNoInhibitDirty; }
 
 std::map<RooAbsArg*,TRefArray*> RooAbsArg::_ioEvoList ;
 std::stack<RooAbsArg*> RooAbsArg::_ioReadStack ;
@@ -231,12 +243,17 @@ RooAbsArg::~RooAbsArg()
 
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Control global dirty inhibit mode. When set to true no value or shape dirty
-/// flags are propagated and cache is always considered to be dirty.
+/// Control dirty inhibit mode of the calling thread. When set to true no value
+/// or shape dirty flags are propagated and cache is always considered to be dirty.
 
 void RooAbsArg::setDirtyInhibit(Bool_t flag)
 {
-  _inhibitDirty = flag ;
+  if (flag==gThreadInhibitDirty) return ;
+  gThreadInhibitDirty = flag ;
+
+  std::lock_guard<std::mutex> lock(gInhibitMutex) ;
+  gInhibitingThreads += flag ? 1 : -1 ;
+  _inhibitDirty = (gInhibitingThreads>0) ;
 }
 
 
@@ -839,7 +856,7 @@ Bool_t RooAbsArg::observableOverlaps(const RooArgSet* nset, const RooAbsArg& tes
 
 void RooAbsArg::setValueDirty(const RooAbsArg* source) const
 {
-  if (_operMode!=Auto || _inhibitDirty) return ;
+  if (_operMode!=Auto || gThreadInhibitDirty) return ;
 
   // Handle no-propagation scenarios first
   if (_clientListValue.GetSize()==0) {
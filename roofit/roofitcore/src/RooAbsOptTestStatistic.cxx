@@ -39,6 +39,8 @@
 
 #include "Riostream.h"
 #include <string.h>
+#include <vector>
+#include <algorithm>
 
 
 #include "RooAbsOptTestStatistic.h"
@@ -61,11 +63,55 @@
 #include "RooTrace.h"
 #include "RooVectorDataStore.h" 
 
+#include <mutex>
+
 using namespace std;
 
 ClassImp(RooAbsOptTestStatistic)
 ;
 
+Double_t RooAbsOptTestStatistic::_catBudget = -1 ;
+Double_t RooAbsOptTestStatistic::_catTotalUsed = 0 ;
+
+// Protects the memory used from the budget, test statistics can be optimized
+// by several threads at once, e.g. by the workers of RooStats::ToyMCSampler
+static mutex _catMutex ;
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the memory budget, in megabytes, of the per-event values stored for the
+/// nodes evaluated in cache-and-track mode (Optimize(2)). The budget is a single
+/// total shared by all the test statistics of the process, e.g. the components of
+/// a simultaneous likelihood and the partitions of a multi-threaded one: each test
+/// statistic optimized afterwards can use what the others left. When the nodes
+/// selected for tracking need more memory, the nodes depending on the fewest
+/// parameters, which are the ones recalculated least often during a minimization,
+/// are tracked first. A negative budget means no limit (default)
+
+void RooAbsOptTestStatistic::setCacheAndTrackMemoryBudget(Double_t megaBytes) 
+{
+  _catBudget = megaBytes ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the memory budget, in megabytes, of the cache-and-track columns
+
+Double_t RooAbsOptTestStatistic::cacheAndTrackMemoryBudget() 
+{
+  return _catBudget ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the memory, in megabytes, of the cache-and-track columns of all the
+/// optimized test statistics, which counts against the budget
+
+Double_t RooAbsOptTestStatistic::cacheAndTrackMemoryUsage() 
+{
+  return _catTotalUsed ;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Default Constructor
@@ -88,6 +134,7 @@ RooAbsOptTestStatistic:: RooAbsOptTestStatistic()
   _ownData = kTRUE ;
   _sealed = kFALSE ;
   _optimized = kFALSE ;
+  _catUsed = 0 ;
 }
 
 
@@ -112,7 +159,8 @@ RooAbsOptTestStatistic::RooAbsOptTestStatistic(const char *name, const char *tit
   RooAbsTestStatistic(name,title,real,indata,projDeps,rangeName, addCoefRangeName, nCPU, interleave, verbose, splitCutRange),
   _projDeps(0),
   _sealed(kFALSE), 
-  _optimized(kFALSE)
+  _optimized(kFALSE),
+  _catUsed(0)
 {
   // Don't do a thing in master mode
 
@@ -140,7 +188,7 @@ RooAbsOptTestStatistic::RooAbsOptTestStatistic(const char *name, const char *tit
 /// Copy constructor
 
 RooAbsOptTestStatistic::RooAbsOptTestStatistic(const RooAbsOptTestStatistic& other, const char* name) : 
-  RooAbsTestStatistic(other,name), _sealed(other._sealed), _sealNotice(other._sealNotice), _optimized(kFALSE)
+  RooAbsTestStatistic(other,name), _sealed(other._sealed), _sealNotice(other._sealNotice), _optimized(kFALSE), _catUsed(0)
 {
   // Don't do a thing in master mode
   if (operMode()!=Slave) {    
@@ -430,6 +478,7 @@ void RooAbsOptTestStatistic::initSlave(RooAbsReal& real, RooAbsData& indata, con
 
 RooAbsOptTestStatistic::~RooAbsOptTestStatistic()
 {
+  releaseCacheAndTrackBudget() ;
   if (operMode()==Slave) {
     delete _funcClone ;
     delete _funcObsSet ;
@@ -597,6 +646,84 @@ void RooAbsOptTestStatistic::optimizeCaching()
 
 
 
+namespace {
+  struct TrackCandidate {
+    RooAbsArg* arg ;
+    Int_t nPar ;
+    bool operator<(const TrackCandidate& other) const { return nPar<other.nPar ; }
+  } ;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reduce the given list of nodes selected for cache-and-track mode so that
+/// their per-event values fit within what remains of the memory budget set with
+/// setCacheAndTrackMemoryBudget(), and count them in the memory used by all the
+/// test statistics until releaseCacheAndTrackBudget(). A tracked node is recalculated only when
+/// one of its parameters changed, thus the nodes depending on the fewest
+/// parameters are the ones saving most evaluations and are kept first.
+/// Nodes that do not depend on any observable are never stored and are
+/// not counted
+
+void RooAbsOptTestStatistic::applyCacheAndTrackBudget(RooArgSet& trackNodes)
+{
+  releaseCacheAndTrackBudget() ;
+  if (trackNodes.getSize()==0) return ;
+
+  const RooArgSet* obs = _dataClone->get() ;
+  Double_t columnSize = _dataClone->numEntries()*sizeof(Double_t)/(1024.*1024.) ;
+
+  vector<TrackCandidate> candidates ;
+  RooFIter iter = trackNodes.fwdIterator() ;
+  RooAbsArg* arg ;
+  while((arg=iter.next())) {
+    if (!arg->dependsOn(*obs)) continue ;
+    RooArgSet* params = arg->getParameters(obs) ;
+    TrackCandidate cand ;
+    cand.arg = arg ;
+    cand.nPar = params->getSize() ;
+    candidates.push_back(cand) ;
+    delete params ;
+  }
+  stable_sort(candidates.begin(),candidates.end()) ;
+
+  lock_guard<mutex> lock(_catMutex) ;
+  Double_t used(0) ;
+  RooArgSet dropped ;
+  for (vector<TrackCandidate>::iterator citer = candidates.begin() ; citer!=candidates.end() ; ++citer) {
+    if (_catBudget<0 || _catTotalUsed+used+columnSize<=_catBudget) {
+      used += columnSize ;
+    } else {
+      dropped.add(*citer->arg) ;
+    }
+  }
+
+  if (dropped.getSize()>0) {
+    coutI(Optimization) << "RooAbsOptTestStatistic::applyCacheAndTrackBudget(" << GetName() << ") memory budget of "
+			<< _catBudget << " MB, of which " << _catTotalUsed << " MB are used by other test statistics, allows to track " 
+			<< candidates.size()-dropped.getSize() << " out of " << candidates.size() 
+			<< " nodes, the following nodes are evaluated without tracking: " << dropped << endl ;
+    trackNodes.remove(dropped) ;
+  }
+
+  _catUsed = used ;
+  _catTotalUsed += used ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the memory of the cache-and-track columns of this test statistic to
+/// the budget shared by all test statistics
+
+void RooAbsOptTestStatistic::releaseCacheAndTrackBudget()
+{
+  lock_guard<mutex> lock(_catMutex) ;
+  _catTotalUsed -= _catUsed ;
+  _catUsed = 0 ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Driver function to activate global constant term optimization.
 /// If activated constant terms are found and cached with the dataset
@@ -649,6 +776,9 @@ void RooAbsOptTestStatistic::optimizeConstantTerms(Bool_t activate, Bool_t apply
       trackNodes.remove(*constNodes) ;
       delete constNodes ;
 
+      // Keep the per-event values of the tracked nodes within the memory budget
+      applyCacheAndTrackBudget(trackNodes) ;
+
       // Set CacheAndTrack flag on all remaining nodes
       trackNodes.setAttribAll("CacheAndTrack",kTRUE) ;
     }
@@ -723,6 +853,7 @@ void RooAbsOptTestStatistic::optimizeConstantTerms(Bool_t activate, Bool_t apply
     
     // Delete the cache
     _dataClone->resetCache() ;
+    releaseCacheAndTrackBudget() ;
     
     // Reactivate all tree branches
     _dataClone->setArgStatus(*_dataClone->get(),kTRUE) ;
@@ -152,6 +152,7 @@
 #include "RooChi2Var.h"
 #include "RooMinimizer.h"
 #include "RooRealIntegral.h"
+#include "RooVectorDataStore.h"
 #include "Math/CholeskyDecomp.h"
 #include <string>
 
@@ -307,6 +308,70 @@ Double_t RooAbsPdf::getValV(const RooArgSet* nset) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the values of this p.d.f, normalized over the observables 'nset', for the
+/// nEvents events of the vector data store starting at event 'begin', or a null
+/// pointer if they cannot be computed in a batch (see RooAbsReal::getValBatch()).
+/// The normalization integral is computed once for all the events, so it must not
+/// depend on their observables. The batches containing events for which getValV()
+/// would report an evaluation error are not computed, so that the caller evaluates
+/// them one by one and the errors are reported as usual.
+
+const Double_t* RooAbsPdf::getValBatch(Int_t begin, Int_t nEvents, const RooVectorDataStore& store, 
+                                       std::vector<Double_t>& buffer, const RooArgSet* nset) const
+{
+  const Double_t* column = store.getColumn(this) ;
+  if (column) {
+    return column + begin ;
+  }
+  if (nEvents<=0) {
+    return 0 ;
+  }
+
+  buffer.resize(nEvents) ;
+  Double_t* output = &buffer[0] ;
+  Bool_t ok(kFALSE) ;
+  Double_t normVal(1) ;
+
+  if (!nset) {
+    RooArgSet* tmp = _normSet ;
+    _normSet = 0 ;
+    ok = evaluateBatch(output,begin,nEvents,store) ;
+    _normSet = tmp ;
+  } else {
+    if (nset!=_normSet || _norm==0) {
+      syncNormalization(nset) ;
+    }
+    if (!_norm->dependsOnValue(*store.get())) {
+      normVal = _norm->getVal() ;
+      ok = normVal>0 && evaluateBatch(output,begin,nEvents,store) ;
+    }
+  }
+
+  for (Int_t i=0 ; ok && i<nEvents ; i++) {
+    if (TMath::IsNaN(output[i]) || output[i]<0) {
+      ok = kFALSE ;
+    }
+  }
+
+  if (!ok) {
+    if (!dependsOnValue(*store.get())) {
+      buffer.assign(nEvents,getVal(nset)) ;
+      return &buffer[0] ;
+    }
+    return 0 ;
+  }
+
+  if (nset) {
+    for (Int_t i=0 ; i<nEvents ; i++) {
+      output[i] /= normVal ;
+    }
+  }
+  return output ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Analytical integral with normalization (see RooAbsReal::analyticalIntegralWN() for further information)
 ///
@@ -730,6 +795,11 @@ Double_t RooAbsPdf::extendedTerm(Double_t observed, const RooArgSet* nset) const
 ///                                    Strategy 3 = RooFit::Hybrid --> Follow strategy 0 for all RooSimultaneous components, except those with less than
 ///                                                 30 dataset entries, for which strategy 2 is followed.
 ///
+/// NumThreads(int num, int strat)  -- Parallelize NLL calculation on num threads of this process instead of num forked processes,
+///                                    with the same partitioning strategies as NumCPU. Each thread has its own copy of the data and
+///                                    of the p.d.f; the p.d.f must be thread safe once its first evaluation, done serially, is completed.
+///                                    Takes precedence over NumCPU
+///
 /// Optimize(Bool_t flag)           -- Activate constant term optimization (on by default)
 /// SplitRange(Bool_t flag)         -- Use separate fit ranges in a simultaneous fit. Actual range name for each
 ///                                    subsample is assumed to by rangeName_{indexState} where indexState
@@ -785,6 +855,8 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   pc.defineInt("ext","Extended",0,2) ;
   pc.defineInt("numcpu","NumCPU",0,1) ;
   pc.defineInt("interleave","NumCPU",1,0) ;
+  pc.defineInt("numthreads","NumThreads",0,0) ;
+  pc.defineInt("threadInterleave","NumThreads",1,0) ;
   pc.defineInt("verbose","Verbose",0,0) ;
   pc.defineInt("optConst","Optimize",0,0) ;
   pc.defineInt("cloneData","CloneData",2,0) ;
@@ -811,6 +883,11 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   Int_t ext      = pc.getInt("ext") ;
   Int_t numcpu   = pc.getInt("numcpu") ;
   RooFit::MPSplit interl = (RooFit::MPSplit) pc.getInt("interleave") ;
+  Int_t numthreads = pc.getInt("numthreads") ;
+  if (numthreads>1) {
+    numcpu = numthreads ;
+    interl = (RooFit::MPSplit) pc.getInt("threadInterleave") ;
+  }
 
   Int_t splitr   = pc.getInt("splitRange") ;
   Bool_t verbose = pc.getInt("verbose") ;
@@ -895,7 +972,9 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
     // Simple case: default range, or single restricted range
     //cout<<"FK: Data test 1: "<<data.sumEntries()<<endl;
 
-    nll = new RooNLLVar(baseName.c_str(),"-log(likelihood)",*this,data,projDeps,ext,rangeName,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+    RooNLLVar* nllVar = new RooNLLVar(baseName.c_str(),"-log(likelihood)",*this,data,projDeps,ext,rangeName,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+    if (numthreads>1) nllVar->setUseThreads() ;
+    nll = nllVar ;
 
   } else {
     // Composite case: multiple ranges
@@ -905,7 +984,8 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
     strlcpy(buf,rangeName,bufSize) ;
     char* token = strtok(buf,",") ;
     while(token) {
-      RooAbsReal* nllComp = new RooNLLVar(Form("%s_%s",baseName.c_str(),token),"-log(likelihood)",*this,data,projDeps,ext,token,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+      RooNLLVar* nllComp = new RooNLLVar(Form("%s_%s",baseName.c_str(),token),"-log(likelihood)",*this,data,projDeps,ext,token,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+      if (numthreads>1) nllComp->setUseThreads() ;
       nllList.add(*nllComp) ;
       token = strtok(0,",") ;
     }
@@ -993,6 +1073,9 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
 ///                                    Strategy 3 = RooFit::Hybrid --> Follow strategy 0 for all RooSimultaneous components, except those with less than
 ///                                                 30 dataset entries, for which strategy 2 is followed.
 ///
+/// NumThreads(int num, int strat)  -- Parallelize NLL calculation on num threads of this process instead of num forked processes,
+///                                    see createNLL()
+///
 /// SplitRange(Bool_t flag)         -- Use separate fit ranges in a simultaneous fit. Actual range name for each
 ///                                    subsample is assumed to by rangeName_{indexState} where indexState
 ///                                    is the state of the master index category of the simultaneous fit
@@ -1079,7 +1162,7 @@ RooFitResult* RooAbsPdf::fitTo(RooAbsData& data, const RooLinkedList& cmdList)
   RooCmdConfig pc(Form("RooAbsPdf::fitTo(%s)",GetName())) ;
 
   RooLinkedList fitCmdList(cmdList) ;
-  RooLinkedList nllCmdList = pc.filterCmdList(fitCmdList,"ProjectedObservables,Extended,Range,RangeWithName,SumCoefRange,NumCPU,SplitRange,Constrained,Constrain,ExternalConstraints,CloneData,GlobalObservables,GlobalObservablesTag,OffsetLikelihood") ;
+  RooLinkedList nllCmdList = pc.filterCmdList(fitCmdList,"ProjectedObservables,Extended,Range,RangeWithName,SumCoefRange,NumCPU,NumThreads,SplitRange,Constrained,Constrain,ExternalConstraints,CloneData,GlobalObservables,GlobalObservablesTag,OffsetLikelihood") ;
 
   pc.defineString("fitOpt","FitOptions",0,"") ;
   pc.defineInt("optConst","Optimize",0,2) ;
@@ -100,7 +100,9 @@
 #include "TF3.h"
 #include "TMatrixD.h"
 #include "TVector.h"
+#include "ThreadLocalStorage.h"
 
+#include <mutex>
 #include <sstream>
 
 using namespace std ;
@@ -111,13 +113,30 @@ ClassImp(RooAbsReal)
 Bool_t RooAbsReal::_cacheCheck(kFALSE) ;
 Bool_t RooAbsReal::_globalSelectComp = kFALSE ;
 Bool_t RooAbsReal::_hideOffset = kTRUE ;
+Bool_t RooAbsReal::_batchEval = kFALSE ;
 
 void RooAbsReal::setHideOffset(Bool_t flag) { _hideOffset = flag ; }
 Bool_t RooAbsReal::hideOffset() { return _hideOffset ; }
 
-RooAbsReal::ErrorLoggingMode RooAbsReal::_evalErrorMode = RooAbsReal::PrintErrors ;
-Int_t RooAbsReal::_evalErrorCount = 0 ;
-map<const RooAbsArg*,pair<string,list<RooAbsReal::EvalError> > > RooAbsReal::_evalErrorList ;
+void RooAbsReal::setBatchEvaluation(Bool_t flag) { _batchEval = flag ; }
+Bool_t RooAbsReal::batchEvaluation() { return _batchEval ; }
+
+struct RooAbsReal::EvalErrorLog {
+  EvalErrorLog(ErrorLoggingMode mode) : _mode(mode), _count(0), _inLog(kFALSE) {}
+  ErrorLoggingMode _mode ;
+  map<const RooAbsArg*,pair<string,list<EvalError> > > _list ;
+  Int_t _count ;
+  Bool_t _inLog ; // Set while an error is logged, to drop errors raised in the meantime
+  // A log is filled by all the threads evaluating the partitions of a multi-thread test statistic
+  recursive_mutex _mutex ;
+} ;
+
+namespace {
+  // Log of the calling thread given with RooAbsReal::setEvalErrorLog(), if any,
+  // and the one created for it by RooAbsReal::useThreadEvalErrorLog()
+  TTHREAD_TLS(RooAbsReal::EvalErrorLog*) gThreadEvalErrorLog = 0 ;
+  TTHREAD_TLS(RooAbsReal::EvalErrorLog*) gOwnEvalErrorLog = 0 ;
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -263,11 +282,65 @@ Double_t RooAbsReal::getValV(const RooArgSet* nset) const
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the values of this function for the nEvents events of the vector data
+/// store starting at event 'begin', or a null pointer if they cannot be computed
+/// in a batch, in which case the caller has to load and evaluate each event. The
+/// returned array points either into the data store, for observables and nodes
+/// cached by the constant term optimization, or into 'buffer'. The batch is computed
+/// by evaluateBatch(); fundamentals and functions that do not depend on the
+/// observables of the store, such as the parameters, have the same value for all
+/// the events.
+
+const Double_t* RooAbsReal::getValBatch(Int_t begin, Int_t nEvents, const RooVectorDataStore& store, 
+                                        std::vector<Double_t>& buffer, const RooArgSet* nset) const
+{
+  const Double_t* column = store.getColumn(this) ;
+  if (column) {
+    return column + begin ;
+  }
+
+  if (isFundamental()) {
+    buffer.assign(nEvents,getVal(nset)) ;
+    return nEvents>0 ? &buffer[0] : 0 ;
+  }
+
+  buffer.resize(nEvents) ;
+  if (nEvents>0 && evaluateBatch(&buffer[0],begin,nEvents,store)) {
+    return &buffer[0] ;
+  }
+
+  if (!dependsOnValue(*store.get())) {
+    buffer.assign(nEvents,getVal(nset)) ;
+    return nEvents>0 ? &buffer[0] : 0 ;
+  }
+
+  return 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the unnormalized values of this function, as evaluate() does, for the
+/// nEvents events of the vector data store starting at event 'begin'. The values
+/// of the servers are obtained with getValBatch(). Return false if the batch
+/// cannot be computed; this default implementation does not support batches.
+/// Batches are opt-in per class: the implementations return false when the object
+/// is of a derived class, which then has to override this method as well to have
+/// its own evaluate() computed on batches.
+
+Bool_t RooAbsReal::evaluateBatch(Double_t* /*output*/, Int_t /*begin*/, Int_t /*nEvents*/, const RooVectorDataStore& /*store*/) const
+{
+  return kFALSE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooAbsReal::numEvalErrorItems() 
 { 
-  return _evalErrorList.size() ; 
+  return evalErrorLog()._list.size() ; 
 }
 
 
@@ -275,7 +348,7 @@ Int_t RooAbsReal::numEvalErrorItems()
 
 RooAbsReal::EvalErrorIter RooAbsReal::evalErrorIter() 
 { 
-  return _evalErrorList.begin() ; 
+  return evalErrorLog()._list.begin() ; 
 } 
 
 
@@ -3574,21 +3647,22 @@ Double_t RooAbsReal::maxVal(Int_t /*code*/) const
 
 void RooAbsReal::logEvalError(const RooAbsReal* originator, const char* origName, const char* message, const char* serverValueString) 
 {
-  if (_evalErrorMode==Ignore) {
+  EvalErrorLog& log = evalErrorLog() ;
+  if (log._mode==Ignore) {
     return ;
   }
 
-  if (_evalErrorMode==CountErrors) {
-    _evalErrorCount++ ;
+  lock_guard<recursive_mutex> lock(log._mutex) ;
+
+  if (log._mode==CountErrors) {
+    log._count++ ;
     return ;
   }
 
-  static Bool_t inLogEvalError = kFALSE ;  
-
-  if (inLogEvalError) {
+  if (log._inLog) {
     return ;
   }
-  inLogEvalError = kTRUE ;
+  log._inLog = kTRUE ;
 
   EvalError ee ;
   ee.setMessage(message) ;
@@ -3597,18 +3671,18 @@ void RooAbsReal::logEvalError(const RooAbsReal* originator, const char* origName
     ee.setServerValues(serverValueString) ;
   } 
 
-  if (_evalErrorMode==PrintErrors) {
+  if (log._mode==PrintErrors) {
    oocoutE((TObject*)0,Eval) << "RooAbsReal::logEvalError(" << "<STATIC>" << ") evaluation error, " << endl 
 		   << " origin       : " << origName << endl 
 		   << " message      : " << ee._msg << endl
 		   << " server values: " << ee._srvval << endl ;
-  } else if (_evalErrorMode==CollectErrors) {
-    _evalErrorList[originator].first = origName ;
-    _evalErrorList[originator].second.push_back(ee) ;
+  } else if (log._mode==CollectErrors) {
+    log._list[originator].first = origName ;
+    log._list[originator].second.push_back(ee) ;
   }
 
 
-  inLogEvalError = kFALSE ;
+  log._inLog = kFALSE ;
 }
 
 
@@ -3629,21 +3703,22 @@ void RooAbsReal::logEvalError(const RooAbsReal* originator, const char* origName
 
 void RooAbsReal::logEvalError(const char* message, const char* serverValueString) const
 {
-  if (_evalErrorMode==Ignore) {
+  EvalErrorLog& log = evalErrorLog() ;
+  if (log._mode==Ignore) {
     return ;
   }
 
-  if (_evalErrorMode==CountErrors) {
-    _evalErrorCount++ ;
+  lock_guard<recursive_mutex> lock(log._mutex) ;
+
+  if (log._mode==CountErrors) {
+    log._count++ ;
     return ;
   }
 
-  static Bool_t inLogEvalError = kFALSE ;  
-
-  if (inLogEvalError) {
+  if (log._inLog) {
     return ;
   }
-  inLogEvalError = kTRUE ;
+  log._inLog = kTRUE ;
 
   EvalError ee ;
   ee.setMessage(message) ;
@@ -3671,17 +3746,17 @@ void RooAbsReal::logEvalError(const char* message, const char* serverValueString
   ostringstream oss2 ;
   printStream(oss2,kName|kClassName|kArgs,kInline)  ;
 
-  if (_evalErrorMode==PrintErrors) {
+  if (log._mode==PrintErrors) {
    coutE(Eval) << "RooAbsReal::logEvalError(" << GetName() << ") evaluation error, " << endl 
 	       << " origin       : " << oss2.str() << endl 
 	       << " message      : " << ee._msg << endl
 	       << " server values: " << ee._srvval << endl ;
-  } else if (_evalErrorMode==CollectErrors) {
-    _evalErrorList[this].first = oss2.str().c_str() ;
-    _evalErrorList[this].second.push_back(ee) ;
+  } else if (log._mode==CollectErrors) {
+    log._list[this].first = oss2.str().c_str() ;
+    log._list[this].second.push_back(ee) ;
   }
 
-  inLogEvalError = kFALSE ;
+  log._inLog = kFALSE ;
   //coutE(Tracing) << "RooAbsReal::logEvalError(" << GetName() << ") message = " << message << endl ;
 }
 
@@ -3693,17 +3768,61 @@ void RooAbsReal::logEvalError(const char* message, const char* serverValueString
 
 void RooAbsReal::clearEvalErrorLog() 
 {
-  if (_evalErrorMode==PrintErrors) {
+  EvalErrorLog& log = evalErrorLog() ;
+  if (log._mode==PrintErrors) {
     return ;
-  } else if (_evalErrorMode==CollectErrors) {
-    _evalErrorList.clear() ;
+  } else if (log._mode==CollectErrors) {
+    log._list.clear() ;
   } else {
-    _evalErrorCount = 0 ;
+    log._count = 0 ;
   }
 }
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Give the calling thread an evaluation error log of its own, which starts
+/// in the logging mode of the log it used so far, or, if flag is false,
+/// make it use the log of the process again. Threads running independent
+/// fits, like the workers of RooStats::ToyMCSampler, need their own log:
+/// the minimizer counts and clears the errors of the log during the fit.
+/// The threads evaluating the partitions of a multi-thread test statistic
+/// use the log of the thread that created the test statistic
+
+void RooAbsReal::useThreadEvalErrorLog(Bool_t flag) 
+{
+  EvalErrorLog* own = flag ? new EvalErrorLog(evalErrorLog()._mode) : 0 ;
+  delete gOwnEvalErrorLog ;
+  gOwnEvalErrorLog = own ;
+  gThreadEvalErrorLog = own ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the evaluation error log of the calling thread
+
+RooAbsReal::EvalErrorLog& RooAbsReal::evalErrorLog() 
+{
+  if (gThreadEvalErrorLog) return *gThreadEvalErrorLog ;
+  // Never deleted, errors can still be logged while the process exits
+  static EvalErrorLog* processLog = new EvalErrorLog(PrintErrors) ;
+  return *processLog ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make the calling thread log its evaluation errors in the given log,
+/// which is not owned, or in the log of the process if it is 0
+
+void RooAbsReal::setEvalErrorLog(EvalErrorLog* log) 
+{
+  gThreadEvalErrorLog = log ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Print all outstanding logged evaluation error on the given ostream. If maxPerNode
 /// is zero, only the number of errors for each source (object with unique name) is listed.
@@ -3713,15 +3832,16 @@ void RooAbsReal::clearEvalErrorLog()
 
 void RooAbsReal::printEvalErrors(ostream& os, Int_t maxPerNode) 
 {
-  if (_evalErrorMode == CountErrors) {
-    os << _evalErrorCount << " errors counted" << endl ;
+  EvalErrorLog& log = evalErrorLog() ;
+  if (log._mode == CountErrors) {
+    os << log._count << " errors counted" << endl ;
   }
 
   if (maxPerNode<0) return ;
 
-  map<const RooAbsArg*,pair<string,list<EvalError> > >::iterator iter = _evalErrorList.begin() ;
+  map<const RooAbsArg*,pair<string,list<EvalError> > >::iterator iter = log._list.begin() ;
 
-  for(;iter!=_evalErrorList.end() ; ++iter) {
+  for(;iter!=log._list.end() ; ++iter) {
     if (maxPerNode==0) {
 
       // Only print node name with total number of errors
@@ -3755,13 +3875,14 @@ void RooAbsReal::printEvalErrors(ostream& os, Int_t maxPerNode)
 
 Int_t RooAbsReal::numEvalErrors()
 {
-  if (_evalErrorMode==CountErrors) {
-    return _evalErrorCount ;
+  EvalErrorLog& log = evalErrorLog() ;
+  if (log._mode==CountErrors) {
+    return log._count ;
   }
 
   Int_t ntot(0) ;
-  map<const RooAbsArg*,pair<string,list<EvalError> > >::iterator iter = _evalErrorList.begin() ;
-  for(;iter!=_evalErrorList.end() ; ++iter) {
+  map<const RooAbsArg*,pair<string,list<EvalError> > >::iterator iter = log._list.begin() ;
+  for(;iter!=log._list.end() ; ++iter) {
     ntot += iter->second.second.size() ;
   }
   return ntot ;
@@ -4708,7 +4829,7 @@ RooFitResult* RooAbsReal::chi2FitDriver(RooAbsReal& fcn, RooLinkedList& cmdList)
 
 RooAbsReal::ErrorLoggingMode RooAbsReal::evalErrorLoggingMode() 
 { 
-  return _evalErrorMode ; 
+  return evalErrorLog()._mode ; 
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4722,7 +4843,7 @@ RooAbsReal::ErrorLoggingMode RooAbsReal::evalErrorLoggingMode()
 
 void RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::ErrorLoggingMode m) 
 { 
-  _evalErrorMode =  m; 
+  evalErrorLog()._mode =  m; 
 }
 
 
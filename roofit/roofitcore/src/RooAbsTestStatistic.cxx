@@ -29,7 +29,9 @@
 // organizes multi-processor parallel calculation of test statistic
 // values. For the latter, the test statistic value is calculated in
 // partitions in parallel executing processes and a posteriori
-// combined in the main thread.
+// combined in the main thread. With setUseThreads() the partitions
+// are instead evaluated by threads of the current process, each on
+// its own clone of the function and of the data.
 // END_HTML
 //
 
@@ -41,17 +43,25 @@
 #include "RooAbsPdf.h"
 #include "RooSimultaneous.h"
 #include "RooAbsData.h"
+#include "RooDataSet.h"
+#include "RooGlobalFunc.h"
 #include "RooArgSet.h"
 #include "RooRealVar.h"
 #include "RooNLLVar.h"
 #include "RooRealMPFE.h"
 #include "RooErrorHandler.h"
 #include "RooMsgService.h"
+#include "RooExpensiveObjectCache.h"
 #include "TTimeStamp.h"
 #include "RooProdPdf.h"
 #include "RooRealSumPdf.h"
 
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
@@ -59,6 +69,98 @@ ClassImp(RooAbsTestStatistic)
 ;
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Threads of a multi-thread test statistic. They are started with the partitions
+/// and wait until run() asks them to evaluate their partition (1.._nCPU-1) while
+/// the calling thread evaluates the partition 0.
+
+struct RooAbsTestStatistic::MTWorkers {
+
+  MTWorkers(const RooAbsTestStatistic& master) : _master(master), _generation(0), _pending(0), _stop(kFALSE),
+    _errors(master._nCPU), _errorLog(&evalErrorLog())
+  {
+    for (Int_t i = 1; i < _master._nCPU; ++i) _threads.push_back(thread(&MTWorkers::loop,this,i)) ;
+  }
+
+  ~MTWorkers()
+  {
+    {
+      lock_guard<mutex> lock(_mutex) ;
+      _stop = kTRUE ;
+    }
+    _start.notify_all() ;
+    for (UInt_t i = 0; i < _threads.size(); ++i) _threads[i].join() ;
+  }
+
+  // Evaluate all the partitions and return when they are done. An exception thrown
+  // by the evaluation of a partition is rethrown here, in the partition order
+  void run()
+  {
+    {
+      lock_guard<mutex> lock(_mutex) ;
+      ++_generation ;
+      _pending = _threads.size() ;
+    }
+    _start.notify_all() ;
+    evaluate(0) ;
+    {
+      unique_lock<mutex> lock(_mutex) ;
+      _done.wait(lock,[this]{ return _pending==0 ; }) ;
+    }
+    for (UInt_t i = 0; i < _errors.size(); ++i) {
+      if (_errors[i]) {
+	exception_ptr error = _errors[i] ;
+	for (UInt_t j = 0; j < _errors.size(); ++j) _errors[j] = exception_ptr() ;
+	rethrow_exception(error) ;
+      }
+    }
+  }
+
+private:
+
+  void evaluate(Int_t i)
+  {
+    try {
+      _master._mtArray[i]->getValV() ;
+    } catch (...) {
+      _errors[i] = current_exception() ;
+    }
+  }
+
+  void loop(Int_t i)
+  {
+    // Log the evaluation errors where the calling thread finds them, and keep
+    // the expensive objects of the partition apart from those of the others
+    setEvalErrorLog(_errorLog) ;
+    RooExpensiveObjectCache cache ;
+    RooExpensiveObjectCache::setThreadInstance(&cache) ;
+
+    UInt_t generation = 0 ;
+    unique_lock<mutex> lock(_mutex) ;
+    while (true) {
+      _start.wait(lock,[this,generation]{ return _stop || _generation!=generation ; }) ;
+      if (_stop) return ;
+      generation = _generation ;
+      lock.unlock() ;
+      evaluate(i) ;
+      lock.lock() ;
+      if (--_pending==0) _done.notify_one() ;
+    }
+  }
+
+  const RooAbsTestStatistic& _master ;
+  mutex _mutex ;
+  condition_variable _start ;       // signals a new evaluation (or the end) to the threads
+  condition_variable _done ;        // signals the end of the evaluation of the partitions
+  UInt_t _generation ;              // number of the current evaluation
+  UInt_t _pending ;                 // number of partitions of the current evaluation still running
+  Bool_t _stop ;
+  vector<exception_ptr> _errors ;   // exception thrown by the evaluation of each partition
+  EvalErrorLog* _errorLog ;         // evaluation error log of the thread that created the workers
+  vector<thread> _threads ;
+} ;
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor
 
@@ -66,7 +168,7 @@ RooAbsTestStatistic::RooAbsTestStatistic() :
   _func(0), _data(0), _projDeps(0), _splitRange(0), _simCount(0),
   _verbose(kFALSE), _init(kFALSE), _gofOpMode(Slave), _nEvents(0), _setNum(0),
   _numSets(0), _extSet(0), _nGof(0), _gofArray(0), _nCPU(1), _mpfeArray(0),
-  _mpinterl(RooFit::BulkPartition), _doOffset(kFALSE), _offset(0),
+  _useThreads(kFALSE), _mtArray(0), _mtWarm(kFALSE), _mtWorkers(0), _mtSlice(kFALSE), _mpinterl(RooFit::BulkPartition), _doOffset(kFALSE), _offset(0),
   _offsetCarry(0), _evalCarry(0)
 {
 }
@@ -104,6 +206,11 @@ RooAbsTestStatistic::RooAbsTestStatistic(const char *name, const char *title, Ro
   _gofArray(0),
   _nCPU(nCPU),
   _mpfeArray(0),
+  _useThreads(kFALSE),
+  _mtArray(0),
+  _mtWarm(kFALSE),
+  _mtWorkers(0),
+  _mtSlice(kFALSE),
   _mpinterl(interleave),
   _doOffset(kFALSE),
   _offset(0),
@@ -163,6 +270,11 @@ RooAbsTestStatistic::RooAbsTestStatistic(const RooAbsTestStatistic& other, const
   _gofSplitMode(other._gofSplitMode),
   _nCPU(other._nCPU),
   _mpfeArray(0),
+  _useThreads(other._useThreads),
+  _mtArray(0),
+  _mtWarm(kFALSE),
+  _mtWorkers(0),
+  _mtSlice(other._mtSlice),
   _mpinterl(other._mpinterl),
   _doOffset(other._doOffset),
   _offset(other._offset),
@@ -178,7 +290,7 @@ RooAbsTestStatistic::RooAbsTestStatistic(const RooAbsTestStatistic& other, const
       _nCPU=1 ;
     }
       
-    _gofOpMode = MPMaster ;
+    _gofOpMode = _useThreads ? MTMaster : MPMaster ;
 
   } else {
 
@@ -213,6 +325,12 @@ RooAbsTestStatistic::~RooAbsTestStatistic()
     delete[] _mpfeArray ;
   }
 
+  if (MTMaster == _gofOpMode && _init) {
+    delete _mtWorkers ;
+    for (Int_t i = 0; i < _nCPU; ++i) delete _mtArray[i];
+    delete[] _mtArray ;
+  }
+
   if (SimMaster == _gofOpMode && _init) {
     for (Int_t i = 0; i < _nGof; ++i) delete _gofArray[i];
     delete[] _gofArray ;
@@ -229,7 +347,7 @@ RooAbsTestStatistic::~RooAbsTestStatistic()
 /// is calculated from on a RooSimultaneous, the test statistic calculation
 /// is performed separately on each simultaneous p.d.f component and associated
 /// data and then combined. If the test statistic calculation is parallelized
-/// partitions are calculated in nCPU processes and a posteriori combined.
+/// partitions are calculated in nCPU processes (or threads) and a posteriori combined.
 
 Double_t RooAbsTestStatistic::evaluate() const
 {
@@ -289,12 +407,40 @@ Double_t RooAbsTestStatistic::evaluate() const
     _evalCarry = carry;
     return ret ;
 
+  } else if (MTMaster == _gofOpMode) {
+
+    if (!_mtWarm) {
+      // The first evaluation creates the caches of the partitions (normalization
+      // integrals, ...), which is not thread safe: do it in this thread
+      for (Int_t i = 0; i < _nCPU; ++i) _mtArray[i]->getValV();
+      _mtWarm = kTRUE ;
+    } else {
+      // Evaluate partition 0 in this thread and the others in the worker threads
+      _mtWorkers->run() ;
+    }
+
+    // Combine the partitions in a fixed order, independent of the thread scheduling
+    Double_t sum(0), carry = 0.;
+    for (Int_t i = 0; i < _nCPU; ++i) {
+      Double_t y = _mtArray[i]->getValV();
+      carry += _mtArray[i]->getCarry();
+      y -= carry;
+      const Double_t t = sum + y;
+      carry = (t - sum) - y;
+      sum = t;
+    }
+
+    Double_t ret = sum ;
+    _evalCarry = carry;
+    return ret ;
+
   } else {
 
     // Evaluate as straight FUNC
     Int_t nFirst(0), nLast(_nEvents), nStep(1) ;
     
-    switch (_mpinterl) {
+    // A partition holding only its own events evaluates all of them
+    switch (_mtSlice ? RooFit::SimComponents : _mpinterl) {
     case RooFit::BulkPartition:
       nFirst = _nEvents * _setNum / _numSets ;
       nLast  = _nEvents * (_setNum+1) / _numSets ;
@@ -344,6 +490,8 @@ Bool_t RooAbsTestStatistic::initialize()
   
   if (MPMaster == _gofOpMode) {
     initMPMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
+  } else if (MTMaster == _gofOpMode) {
+    initMTMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
   } else if (SimMaster == _gofOpMode) {
     initSimMode((RooSimultaneous*)_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
   }
@@ -373,6 +521,13 @@ Bool_t RooAbsTestStatistic::redirectServersHook(const RooAbsCollection& newServe
 // 	cout << "redirecting servers on " << _mpfeArray[i]->GetName() << endl;
       }
     }
+  } else if (MTMaster == _gofOpMode && _mtArray) {
+    // Forward to partitions
+    for (Int_t i = 0; i < _nCPU; ++i) {
+      if (_mtArray[i]) {
+	_mtArray[i]->recursiveRedirectServers(newServerList,mustReplaceAll,nameChange);
+      }
+    }
   }
   return kFALSE;
 }
@@ -423,6 +578,13 @@ void RooAbsTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool_t
     for (Int_t i = 0; i < _nCPU; ++i) {
       _mpfeArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
     }
+  } else if (MTMaster == _gofOpMode) {
+    for (Int_t i = 0; i < _nCPU; ++i) {
+      _mtArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
+    }
+    // The caches may have been rebuilt, evaluate serially again once
+    _mtWarm = kFALSE ;
+    setValueDirty() ;
   }
 }
 
@@ -480,6 +642,44 @@ void RooAbsTestStatistic::initMPMode(RooAbsReal* real, RooAbsData* data, const R
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Initialize multi-thread calculation mode. Create one component test statistic per
+/// partition, each with its own clone of the function and of the events it evaluates,
+/// sharing the parameters of this instance. The threads evaluating the partitions in evaluate()
+/// are started here and kept until the test statistic is deleted.
+
+void RooAbsTestStatistic::initMTMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName)
+{
+  // With an unbinned dataset split in bulk and no fit range a partition only needs its
+  // own contiguous block of events, and is given a copy of that block rather than of the
+  // whole dataset. The last partition, which adds the extended term from the sum of all
+  // weights, keeps the full data. The blocks and their order are those of the full data,
+  // so the result does not change.
+  const Bool_t slice = _mpinterl==RooFit::BulkPartition && dynamic_cast<RooDataSet*>(data) && !(rangeName && strlen(rangeName)) ;
+
+  _mtArray = new pRooAbsTestStatistic[_nCPU];
+
+  for (Int_t i = 0; i < _nCPU; ++i) {
+    RooAbsData* partData = data ;
+    if (slice && i<_nCPU-1) {
+      partData = data->reduce(RooFit::EventRange(_nEvents*i/_nCPU,_nEvents*(i+1)/_nCPU)) ;
+    }
+    RooAbsTestStatistic* gof = create(Form("%s_GOF%d",GetName(),i),Form("%s_GOF%d",GetTitle(),i),*real,*partData,*projDeps,rangeName,addCoefRangeName,1,_mpinterl,_verbose,_splitRange);
+    gof->recursiveRedirectServers(_paramSet);
+    gof->setMPSet(i,_nCPU);
+    gof->_mtSlice = (partData != data) ;
+    // The partition keeps its own clone of the data, in whose observables the events
+    // are loaded, so the threads do not share them
+    if (partData != data) delete partData ;
+    _mtArray[i] = gof;
+  }
+  _mtWarm = kFALSE ;
+  _mtWorkers = new MTWorkers(*this) ;
+  coutI(Eval) << "RooAbsTestStatistic::initMTMode: created " << _nCPU << " partitions evaluated by threads." << endl;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Initialize simultaneous p.d.f processing mode. Strip simultaneous
 /// p.d.f into individual components, split dataset in subset
@@ -666,6 +866,11 @@ Bool_t RooAbsTestStatistic::setData(RooAbsData& indata, Bool_t cloneData)
     coutF(DataHandling) << "RooAbsTestStatistic::setData(" << GetName() << ") FATAL: setData() is not supported in multi-processor mode" << endl;
     throw string("RooAbsTestStatistic::setData is not supported in MPMaster mode");
     break;
+  case MTMaster:
+    // Not supported
+    coutF(DataHandling) << "RooAbsTestStatistic::setData(" << GetName() << ") FATAL: setData() is not supported in multi-thread mode" << endl;
+    throw string("RooAbsTestStatistic::setData is not supported in MTMaster mode");
+    break;
   }
 
   return kTRUE;
@@ -702,7 +907,39 @@ void RooAbsTestStatistic::enableOffsetting(Bool_t flag)
       _mpfeArray[i]->enableOffsetting(flag);
     }
     break;
+  case MTMaster:
+    _doOffset = flag;
+    for (Int_t i = 0; i < _nCPU; ++i) {
+      _mtArray[i]->enableOffsetting(flag);
+    }
+    setValueDirty() ;
+    break;
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the partitions of a parallel (nCPU>1) test statistic with threads of
+/// the current process rather than with forked server processes. Each partition
+/// has its own clone of the function and of the data and only the parameters are
+/// shared; the first evaluation, which creates the caches of the function clones,
+/// is done serially. The evaluation of the function must be thread safe once these
+/// caches exist. Must be called before the test statistic is initialized, i.e.
+/// before its first evaluation.
+
+void RooAbsTestStatistic::setUseThreads(Bool_t flag)
+{
+  if (_init) {
+    coutE(Eval) << "RooAbsTestStatistic::setUseThreads(" << GetName() << ") ERROR: test statistic is already initialized, ignoring request" << endl ;
+    return ;
+  }
+  if (MPMaster != _gofOpMode && MTMaster != _gofOpMode) {
+    coutW(Eval) << "RooAbsTestStatistic::setUseThreads(" << GetName() << ") WARNING: test statistic is not calculated in parallel, ignoring request" << endl ;
+    return ;
   }
+  _useThreads = flag ;
+  _gofOpMode = flag ? MTMaster : MPMaster ;
 }
 
 
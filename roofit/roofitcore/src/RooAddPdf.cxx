@@ -54,6 +54,8 @@
 #include "TIterator.h"
 #include "TList.h"
 #include "RooAddPdf.h"
+
+#include <typeinfo>
 #include "RooDataSet.h"
 #include "RooRealProxy.h"
 #include "RooPlot.h"
@@ -66,6 +68,7 @@
 #include "RooGlobalFunc.h"
 #include "RooRealIntegral.h"
 #include "RooTrace.h"
+#include "RooVectorDataStore.h"
 
 #include "Riostream.h"
 #include <algorithm>
@@ -851,6 +854,75 @@ Double_t RooAddPdf::evaluate() const
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate(): sum the batches of the component p.d.f.s weighted
+/// by the coefficients. The coefficients are computed once for all the events, so
+/// the batch is not supported if they or their projection integrals depend on the
+/// observables of the store.
+
+Bool_t RooAddPdf::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& store) const
+{
+  // Only for this class: a derived class overriding evaluate() is evaluated event by event
+  if (typeid(*this)!=typeid(RooAddPdf)) return kFALSE ;
+
+  const RooArgSet* nset = _normSet ; 
+
+  if (nset==0 || nset->getSize()==0) {
+    if (_refCoefNorm.getSize()!=0) {
+      nset = &_refCoefNorm ;
+    }
+  }
+
+  CacheElem* cache = getProjCache(nset) ;
+
+  const RooArgSet& obs = *store.get() ;
+  const RooArgList* coefTerms[6] = { &_coefList, &cache->_suppNormList, &cache->_projList, &cache->_suppProjList,
+				     &cache->_refRangeProjList, &cache->_rangeProjList } ;
+  for (Int_t j=0 ; j<6 ; j++) {
+    RooFIter ti = coefTerms[j]->fwdIterator() ;
+    RooAbsArg* term ;
+    while((term = ti.next())) {
+      if (term->dependsOnValue(obs)) {
+	return kFALSE ;
+      }
+    }
+  }
+
+  updateCoefficients(*cache,nset) ;
+
+  for (Int_t k=0 ; k<nEvents ; k++) {
+    output[k] = 0 ;
+  }
+
+  std::vector<Double_t> buffer ;
+  RooAbsPdf* pdf ;
+  Int_t i(0) ;
+  RooFIter pi = _pdfList.fwdIterator() ;
+  while((pdf = (RooAbsPdf*)pi.next())) {
+    if (pdf->isSelectedComp()) {
+      const Double_t* pdfVal = pdf->getValBatch(begin,nEvents,store,buffer,nset) ;
+      if (!pdfVal) {
+	return kFALSE ;
+      }
+      if (cache->_needSupNorm) {
+	Double_t snormVal = ((RooAbsReal*)cache->_suppNormList.at(i))->getVal() ;
+	for (Int_t k=0 ; k<nEvents ; k++) {
+	  output[k] += pdfVal[k]*_coefCache[i]/snormVal ;
+	}
+      } else {
+	for (Int_t k=0 ; k<nEvents ; k++) {
+	  output[k] += pdfVal[k]*_coefCache[i] ;
+	}
+      }
+    }
+    i++ ;
+  }
+
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset error counter to given value, limiting the number
 /// of future error messages for this pdf to 'resetValue'
@@ -45,6 +45,7 @@
 #include <iomanip>
 #include <fstream>
 #include <list>
+#include <mutex>
 #include "TClass.h"
 #include "RooArgSet.h"
 #include "RooStreamParser.h"
@@ -78,11 +79,16 @@ struct POOLDATA
 
 static std::list<POOLDATA> _memPoolList ;
 
+// Protects the memory pool: RooArgSets are created and deleted by all the threads
+// working with RooFit objects, e.g. the workers of RooStats::ToyMCSampler
+static std::recursive_mutex _memPoolMutex ;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Clear memoery pool on exit to avoid reported memory leaks
 
 void RooArgSet::cleanup()
 {
+  std::lock_guard<std::recursive_mutex> lock(_memPoolMutex) ;
   std::list<POOLDATA>::iterator iter = _memPoolList.begin() ;
   while(iter!=_memPoolList.end()) {
     free(iter->_base) ;
@@ -105,6 +111,7 @@ void RooArgSet::cleanup()
 void* RooArgSet::operator new (size_t bytes)
 {
   //cout << " RooArgSet::operator new(" << bytes << ")" << endl ;
+  std::lock_guard<std::recursive_mutex> lock(_memPoolMutex) ;
 
   if (!_poolBegin || _poolCur+(sizeof(RooArgSet)) >= _poolEnd) {
 
@@ -180,6 +187,7 @@ void* RooArgSet::operator new (size_t bytes, void* ptr) noexcept
 
 void RooArgSet::operator delete (void* ptr)
 {
+  std::lock_guard<std::recursive_mutex> lock(_memPoolMutex) ;
   // Decrease use count in pool that ptr is on
   for (std::list<POOLDATA>::iterator poolIter =  _memPoolList.begin() ; poolIter!=_memPoolList.end() ; ++poolIter) {
     if ((char*)ptr > (char*)poolIter->_base && (char*)ptr < (char*)poolIter->_base + POOLSIZE) {
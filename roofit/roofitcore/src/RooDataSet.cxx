@@ -28,6 +28,7 @@
 #include "Riostream.h"
 #include "Riostream.h"
 #include <fstream>
+#include <mutex>
 #include "TTree.h"
 #include "TH2.h"
 #include "TDirectory.h"
@@ -75,11 +76,16 @@ struct POOLDATA
 
 static std::list<POOLDATA> _memPoolList ;
 
+// Protects the memory pool: RooDataSets are created and deleted by all the threads
+// working with RooFit objects, e.g. the workers of RooStats::ToyMCSampler
+static std::recursive_mutex _memPoolMutex ;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Clear memoery pool on exit to avoid reported memory leaks
 
 void RooDataSet::cleanup()
 {
+  std::lock_guard<std::recursive_mutex> lock(_memPoolMutex) ;
   std::list<POOLDATA>::iterator iter = _memPoolList.begin() ;
   while(iter!=_memPoolList.end()) {
     free(iter->_base) ;
@@ -102,6 +108,7 @@ void RooDataSet::cleanup()
 void* RooDataSet::operator new (size_t bytes)
 {
   //cout << " RooDataSet::operator new(" << bytes << ")" << endl ;
+  std::lock_guard<std::recursive_mutex> lock(_memPoolMutex) ;
 
   if (!_poolBegin || _poolCur+(sizeof(RooDataSet)) >= _poolEnd) {
 
@@ -163,6 +170,7 @@ void* RooDataSet::operator new (size_t bytes)
 
 void RooDataSet::operator delete (void* ptr)
 {
+  std::lock_guard<std::recursive_mutex> lock(_memPoolMutex) ;
   // Decrease use count in pool that ptr is on
   for (std::list<POOLDATA>::iterator poolIter =  _memPoolList.begin() ; poolIter!=_memPoolList.end() ; ++poolIter) {
     if ((char*)ptr > (char*)poolIter->_base && (char*)ptr < (char*)poolIter->_base + POOLSIZE) {
@@ -36,6 +36,7 @@
 #include "RooMsgService.h"
 #include <iostream>
 #include <math.h>
+#include "ThreadLocalStorage.h"
 using namespace std ;
 
 #include "RooExpensiveObjectCache.h"
@@ -46,6 +47,11 @@ ClassImp(RooExpensiveObjectCache::ExpensiveObject)
 
 RooExpensiveObjectCache* RooExpensiveObjectCache::_instance = 0 ;
 
+namespace {
+  // Cache of the calling thread set with setThreadInstance(), if any
+  TTHREAD_TLS(RooExpensiveObjectCache*) gThreadInstance = 0 ;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor
@@ -84,10 +90,12 @@ RooExpensiveObjectCache::~RooExpensiveObjectCache()
 
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Return reference to singleton instance 
+/// Return reference to singleton instance, or to the cache of the calling
+/// thread if it was given one with setThreadInstance()
 
 RooExpensiveObjectCache& RooExpensiveObjectCache::instance() 
 {
+  if (gThreadInstance) return *gThreadInstance ;
   if (!_instance) {
     _instance = new RooExpensiveObjectCache() ;    
     RooSentinel::activate() ;    
@@ -97,6 +105,20 @@ RooExpensiveObjectCache& RooExpensiveObjectCache::instance()
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Make instance() return the given cache in the calling thread, or the
+/// singleton again if 0 is given. Threads working on their own copies of
+/// the objects, like the workers of RooStats::ToyMCSampler, need their own
+/// cache, as registerObject() deletes the object stored under the same name.
+/// The cache is not owned.
+
+void RooExpensiveObjectCache::setThreadInstance(RooExpensiveObjectCache* cache) 
+{
+  gThreadInstance = cache ;
+}
+
+
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Static function called by RooSentinel atexit() handler to cleanup at end of program
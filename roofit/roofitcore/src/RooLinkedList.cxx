@@ -27,6 +27,7 @@
 //
 
 #include <algorithm>
+#include <mutex>
 
 #include "RooFit.h"
 #include "Riostream.h"
@@ -252,11 +253,16 @@ namespace RooLinkedListImplDetails {
 
 RooLinkedList::Pool* RooLinkedList::_pool = 0;
 
+// Protects the element pool, which is shared by the lists of all the threads
+// working with RooFit objects, e.g. the workers of RooStats::ToyMCSampler
+static std::mutex _poolMutex ;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 RooLinkedList::RooLinkedList(Int_t htsize) : 
   _hashThresh(htsize), _size(0), _first(0), _last(0), _htableName(0), _htableLink(0), _useNptr(kTRUE)
 {
+  std::lock_guard<std::mutex> lock(_poolMutex) ;
   if (!_pool) _pool = new Pool;
   _pool->acquire();
 }
@@ -269,8 +275,11 @@ RooLinkedList::RooLinkedList(const RooLinkedList& other) :
   _name(other._name), 
   _useNptr(other._useNptr)
 {
-  if (!_pool) _pool = new Pool;
-  _pool->acquire();
+  {
+    std::lock_guard<std::mutex> lock(_poolMutex) ;
+    if (!_pool) _pool = new Pool;
+    _pool->acquire();
+  }
   if (other._htableName) _htableName = new RooHashTable(other._htableName->size()) ;
   if (other._htableLink) _htableLink = new RooHashTable(other._htableLink->size(),RooHashTable::Pointer) ;
   for (RooLinkedListElem* elem = other._first; elem; elem = elem->_next) {
@@ -283,7 +292,11 @@ RooLinkedList::RooLinkedList(const RooLinkedList& other) :
 
 RooLinkedListElem* RooLinkedList::createElement(TObject* obj, RooLinkedListElem* elem) 
 {
-  RooLinkedListElem* ret = _pool->pop_free_elem();
+  RooLinkedListElem* ret ;
+  {
+    std::lock_guard<std::mutex> lock(_poolMutex) ;
+    ret = _pool->pop_free_elem();
+  }
   ret->init(obj, elem);
   return ret ;
 }
@@ -293,6 +306,7 @@ RooLinkedListElem* RooLinkedList::createElement(TObject* obj, RooLinkedListElem*
 void RooLinkedList::deleteElement(RooLinkedListElem* elem) 
 {  
   elem->release() ;
+  std::lock_guard<std::mutex> lock(_poolMutex) ;
   _pool->push_free_elem(elem);
   //delete elem ;
 }
@@ -370,6 +384,7 @@ RooLinkedList::~RooLinkedList()
   }
   
   Clear() ;
+  std::lock_guard<std::mutex> lock(_poolMutex) ;
   if (_pool->release()) {
     delete _pool;
     _pool = 0;
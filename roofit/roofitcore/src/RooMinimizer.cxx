@@ -36,6 +36,11 @@
 // <p>
 // Various methods are available to control verbosity, profiling,
 // automatic PDF optimization.
+// <p>
+// The fitter is kept per thread, so a RooMinimizer is used in the thread
+// that constructed it. TMinuit and Fumili keep global state: their fits
+// run one after the other across threads, use Minuit2 to minimize in
+// several threads in parallel.
 // END_HTML
 //
 
@@ -48,6 +53,7 @@
 
 #include <fstream>
 #include <iomanip>
+#include <mutex>
 
 #include "TH1.h"
 #include "TH2.h"
@@ -56,6 +62,7 @@
 #include "TStopwatch.h"
 #include "TDirectory.h"
 #include "TMatrixDSym.h"
+#include "ThreadLocalStorage.h"
 
 #include "RooArgSet.h"
 #include "RooArgList.h"
@@ -82,13 +89,34 @@ using namespace std;
 ClassImp(RooMinimizer)
 ;
 
-ROOT::Fit::Fitter *RooMinimizer::_theFitter = 0 ;
+namespace {
+  // Fitter of the last RooMinimizer constructed in the calling thread: threads
+  // running independent fits, like the workers of RooStats::ToyMCSampler, each
+  // keep their own
+  TTHREAD_TLS(ROOT::Fit::Fitter*) _theFitter = 0 ;
+
+  // TMinuit and TFumili keep their state in global instances: fits with them
+  // run one after the other when several threads minimize at the same time
+  recursive_mutex _globalMinimizerMutex ;
+
+  unique_lock<recursive_mutex> lockGlobalMinimizer(const string& type)
+  {
+    TString t(type.c_str()) ;
+    t.ToLower() ;
+    if (t=="minuit" || t=="tminuit" || t=="fumili") {
+      return unique_lock<recursive_mutex>(_globalMinimizerMutex) ;
+    }
+    return unique_lock<recursive_mutex>() ;
+  }
+}
 
 
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Cleanup method called by atexit handler installed by RooSentinel
-/// to delete all global heap objects when the program is terminated
+/// to delete all global heap objects when the program is terminated.
+/// The fitter is kept per thread: a thread that has minimized calls
+/// this before it exits to delete its own
 
 void RooMinimizer::cleanup()
 {
@@ -314,6 +342,7 @@ RooFitResult* RooMinimizer::fit(const char* options)
 
 Int_t RooMinimizer::minimize(const char* type, const char* alg)
 {
+  unique_lock<recursive_mutex> lock = lockGlobalMinimizer(type ? type : "") ;
   _fcn->Synchronize(_theFitter->Config().ParamsSettings(),
 		    _optConst,_verbose) ;
 
@@ -345,6 +374,7 @@ Int_t RooMinimizer::minimize(const char* type, const char* alg)
 
 Int_t RooMinimizer::migrad()
 {
+  unique_lock<recursive_mutex> lock = lockGlobalMinimizer(_minimizerType) ;
   _fcn->Synchronize(_theFitter->Config().ParamsSettings(),
 		    _optConst,_verbose) ;
   profileStart() ;
@@ -374,6 +404,7 @@ Int_t RooMinimizer::migrad()
 
 Int_t RooMinimizer::hesse()
 {
+  unique_lock<recursive_mutex> lock = lockGlobalMinimizer(_minimizerType) ;
   if (_theFitter->GetMinimizer()==0) {
     coutW(Minimization) << "RooMinimizer::hesse: Error, run Migrad before Hesse!"
 			<< endl ;
@@ -411,6 +442,7 @@ Int_t RooMinimizer::hesse()
 
 Int_t RooMinimizer::minos()
 {
+  unique_lock<recursive_mutex> lock = lockGlobalMinimizer(_minimizerType) ;
   if (_theFitter->GetMinimizer()==0) {
     coutW(Minimization) << "RooMinimizer::minos: Error, run Migrad before Minos!"
 			<< endl ;
@@ -449,6 +481,7 @@ Int_t RooMinimizer::minos()
 
 Int_t RooMinimizer::minos(const RooArgSet& minosParamList)
 {
+  unique_lock<recursive_mutex> lock = lockGlobalMinimizer(_minimizerType) ;
   if (_theFitter->GetMinimizer()==0) {
     coutW(Minimization) << "RooMinimizer::minos: Error, run Migrad before Minos!"
 			<< endl ;
@@ -508,6 +541,7 @@ Int_t RooMinimizer::minos(const RooArgSet& minosParamList)
 
 Int_t RooMinimizer::seek()
 {
+  unique_lock<recursive_mutex> lock = lockGlobalMinimizer(_minimizerType) ;
   _fcn->Synchronize(_theFitter->Config().ParamsSettings(),
 		    _optConst,_verbose) ;
   profileStart() ;
@@ -537,6 +571,7 @@ Int_t RooMinimizer::seek()
 
 Int_t RooMinimizer::simplex()
 {
+  unique_lock<recursive_mutex> lock = lockGlobalMinimizer(_minimizerType) ;
   _fcn->Synchronize(_theFitter->Config().ParamsSettings(),
 		    _optConst,_verbose) ;
   profileStart() ;
@@ -566,6 +601,7 @@ Int_t RooMinimizer::simplex()
 
 Int_t RooMinimizer::improve()
 {
+  unique_lock<recursive_mutex> lock = lockGlobalMinimizer(_minimizerType) ;
   _fcn->Synchronize(_theFitter->Config().ParamsSettings(),
 		    _optConst,_verbose) ;
   profileStart() ;
@@ -666,7 +702,7 @@ RooFitResult* RooMinimizer::save(const char* userName, const char* userTitle)
   fitRes->setInitParList(saveFloatInitList) ;
 
   fitRes->setStatus(_status) ;
-  fitRes->setCovQual(_theFitter->GetMinimizer()->CovMatrixStatus()) ;
+  fitRes->setCovQual(_theFitter->Result().CovMatrixStatus()) ;
   fitRes->setMinNLL(_theFitter->Result().MinFcnValue()) ;
   fitRes->setNumInvalidNLL(_fcn->GetNumInvalidNLL()) ;
   fitRes->setEDM(_theFitter->Result().Edm()) ;
@@ -741,6 +777,8 @@ RooPlot* RooMinimizer::contour(RooRealVar& var1, RooRealVar& var2,
   }
 
   
+  unique_lock<recursive_mutex> lock = lockGlobalMinimizer(_minimizerType) ;
+
   // remember our original value of ERRDEF  
   Double_t errdef= _theFitter->GetMinimizer()->ErrorDef();
 
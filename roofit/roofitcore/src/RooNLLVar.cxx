@@ -27,6 +27,7 @@
 //
 
 #include <algorithm>
+#include <typeinfo>
 
 #include "RooFit.h"
 #include "Riostream.h"
@@ -38,6 +39,8 @@
 #include "RooCmdConfig.h"
 #include "RooMsgService.h"
 #include "RooAbsDataStore.h"
+#include "RooDataSet.h"
+#include "RooVectorDataStore.h"
 #include "RooRealMPFE.h"
 #include "RooRealSumPdf.h"
 #include "RooRealVar.h"
@@ -224,6 +227,10 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
   } else if ( _gofOpMode==MPMaster) {
     for (Int_t i=0 ; i<_nCPU ; i++)
       _mpfeArray[i]->applyNLLWeightSquared(flag);
+  } else if ( _gofOpMode==MTMaster) {
+    for (Int_t i=0 ; i<_nCPU ; i++)
+      ((RooNLLVar*)_mtArray[i])->applyWeightSquared(flag);
+    setValueDirty();
   } else if ( _gofOpMode==SimMaster) {
     for (Int_t i=0 ; i<_nGof ; i++)
       ((RooNLLVar*)_gofArray[i])->applyWeightSquared(flag);
@@ -303,18 +310,67 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
   } else {
 
+    // With a vector data store and the batch evaluation enabled (see
+    // RooAbsReal::setBatchEvaluation()) the p.d.f is evaluated on blocks of events at
+    // once if it supports it (see RooAbsReal::getValBatch()). The events whose
+    // probability needs the special handling of getLogVal() are loaded and evaluated
+    // one by one.
+    const Int_t batchSize(1024) ;
+    RooVectorDataStore* vstore(0) ;
+    if (stepSize==1 && RooAbsReal::batchEvaluation() && dynamic_cast<RooDataSet*>(_dataClone)) {
+      vstore = dynamic_cast<RooVectorDataStore*>(_dataClone->store()) ;
+    }
+    // The weights are read from the weight column of the store only for a RooDataSet
+    // itself, whose events are all valid and whose weightSquared() is the square of
+    // the weight. Otherwise, or for the squared weights, the event is loaded to ask
+    // the data for valid(), weight() and weightSquared(), as in the scalar loop.
+    const Bool_t loadEvents = _weightSq || typeid(*_dataClone)!=typeid(RooDataSet) ;
+    const Double_t* batchWeights = vstore ? vstore->getWeightColumn() : 0 ;
+    if (vstore && vstore->isWeighted() && !batchWeights) {
+      // Weights not available as a column, evaluate event by event
+      vstore = 0 ;
+    }
+    const Double_t* batchProbs(0) ;
+    std::vector<Double_t> batchBuffer ;
+    Int_t batchBegin(firstEvent), batchEnd(firstEvent) ;
+
     for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
+
+      if (vstore && i==batchEnd) {
+	batchBegin = i ;
+	batchEnd = std::min(i+batchSize,lastEvent) ;
+	batchProbs = pdfClone->getValBatch(batchBegin,batchEnd-batchBegin,*vstore,batchBuffer,_normSet) ;
+      }
+
+      Double_t eventWeight, term ;
+      Double_t prob = batchProbs ? batchProbs[i-batchBegin] : 0 ;
+      if (prob>0 && prob<=1e6) {
+
+	if (loadEvents) {
+	  _dataClone->get(i) ;
+	  if (!_dataClone->valid()) continue;
+	  eventWeight = _dataClone->weight();
+	  if (0. == eventWeight * eventWeight) continue ;
+	  if (_weightSq) eventWeight = _dataClone->weightSquared() ;
+	} else {
+	  eventWeight = batchWeights ? batchWeights[i] : 1.0 ;
+	  if (0. == eventWeight * eventWeight) continue ;
+	}
+
+	term = -eventWeight * log(prob) ;
+
+      } else {
             
-      _dataClone->get(i) ;
+	_dataClone->get(i) ;
       
-      if (!_dataClone->valid()) continue;
-      
-      Double_t eventWeight = _dataClone->weight();
-      if (0. == eventWeight * eventWeight) continue ;
-      if (_weightSq) eventWeight = _dataClone->weightSquared() ;
+	if (!_dataClone->valid()) continue;
       
-      Double_t term = -eventWeight * pdfClone->getLogVal(_normSet);
+	eventWeight = _dataClone->weight();
+	if (0. == eventWeight * eventWeight) continue ;
+	if (_weightSq) eventWeight = _dataClone->weightSquared() ;
       
+	term = -eventWeight * pdfClone->getLogVal(_normSet);
+      }
       
       Double_t y = eventWeight - sumWeightCarry;
       Double_t t = sumWeight + y;
@@ -30,6 +30,7 @@
 #include "RooNameReg.h"
 #include "RooNameReg.h"
 #include <iostream>
+#include <mutex>
 using namespace std ;
 
 ClassImp(RooNameReg)
@@ -37,6 +38,10 @@ ClassImp(RooNameReg)
 
 RooNameReg* RooNameReg::_instance = 0 ;
 
+// Protects the registry, which is filled by all the threads creating RooFit
+// objects, e.g. the workers of RooStats::ToyMCSampler
+static std::mutex _regMutex ;
+
 
 RooNameReg::RooNameReg(Int_t hashSize) : TNamed("RooNameReg","RooFit Name Registry"), _htable(hashSize) {} 
 
@@ -95,6 +100,7 @@ const TNamed* RooNameReg::constPtr(const char* inStr)
 //   cout << "RooNameReg::constPtr(inStr=" << inStr << ") _htable entries = " << _htable.entries() << endl ;
 
   // See if name is already registered ;
+  std::lock_guard<std::mutex> lock(_regMutex) ;
   TNamed* t = (TNamed*) _htable.find(inStr) ;
   if (t) return t ;
 
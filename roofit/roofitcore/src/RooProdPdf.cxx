@@ -47,6 +47,8 @@
 
 #include "TIterator.h"
 #include "RooProdPdf.h"
+
+#include <typeinfo>
 #include "RooRealProxy.h"
 #include "RooProdGenContext.h"
 #include "RooGenProdProj.h"
@@ -63,6 +65,7 @@
 #include "RooCustomizer.h"
 #include "RooRealIntegral.h"
 #include "RooTrace.h"
+#include "RooVectorDataStore.h"
 
 #include <string.h>
 #include <sstream>
@@ -546,6 +549,82 @@ Double_t RooProdPdf::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Overload getValBatch() to intercept normalization set for use in evaluateBatch()
+
+const Double_t* RooProdPdf::getValBatch(Int_t begin, Int_t nEvents, const RooVectorDataStore& store, 
+                                        std::vector<Double_t>& buffer, const RooArgSet* set) const
+{
+  _curNormSet = (RooArgSet*)set ;
+  return RooAbsPdf::getValBatch(begin,nEvents,store,buffer,set) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate(): running product of the batches of the terms, with
+/// the same cutoff for each event as calculate()
+
+Bool_t RooProdPdf::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& store) const
+{
+  // Only for this class: a derived class overriding evaluate() is evaluated event by event
+  if (typeid(*this)!=typeid(RooProdPdf)) return kFALSE ;
+
+  Int_t code ;
+  CacheElem* cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  
+  // If cache doesn't have our configuration, recalculate here
+  if (!cache) {
+    RooArgList *plist(0) ;
+    RooLinkedList *nlist(0) ;
+    getPartIntList(_curNormSet,0,plist,nlist,code) ;
+    cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  }
+
+  std::vector<Double_t> buffer ;
+
+  if (cache->_isRearranged) {
+    std::vector<Double_t> denBuffer ;
+    const Double_t* num = cache->_rearrangedNum->getValBatch(begin,nEvents,store,buffer) ;
+    const Double_t* den = num ? cache->_rearrangedDen->getValBatch(begin,nEvents,store,denBuffer) : 0 ;
+    if (!den) {
+      return kFALSE ;
+    }
+    for (Int_t k=0 ; k<nEvents ; k++) {
+      output[k] = num[k] / den[k] ;
+    }
+    return kTRUE ;
+  }
+
+  for (Int_t k=0 ; k<nEvents ; k++) {
+    output[k] = 1.0 ;
+  }
+
+  RooAbsReal* partInt ;
+  RooArgSet* normSet ;
+  RooFIter plIter = cache->_partList.fwdIterator() ;
+  RooFIter nlIter = cache->_normList.fwdIterator() ;
+  Bool_t first(kTRUE) ;
+  while((partInt = (RooAbsReal*) plIter.next())) {
+    normSet = (RooArgSet*) nlIter.next() ;
+    const Double_t* piVal = partInt->getValBatch(begin,nEvents,store,buffer,normSet->getSize()>0 ? normSet : 0) ;
+    if (!piVal) {
+      return kFALSE ;
+    }
+    for (Int_t k=0 ; k<nEvents ; k++) {
+      // Events whose product already fell below the cutoff are not updated any more
+      if (first || !(output[k]<=_cutOff)) {
+	output[k] *= piVal[k] ;
+      }
+    }
+    first = kFALSE ;
+  }
+
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Calculate running product of pdfs terms, using the supplied
 /// normalization set in 'normSetList' for each component
@@ -19,6 +19,7 @@
 // BEGIN_HTML
 // This class provides a static interface for generating random numbers.
 // By default a private copy of TRandom3 is used to generate all random numbers.
+// A thread can be given its own generator with setThreadRandomGenerator().
 // END_HTML
 //
 #include <cassert>
@@ -30,6 +31,7 @@
 #include "RooQuasiRandomGenerator.h"
 
 #include "TRandom3.h"
+#include "ThreadLocalStorage.h"
 
 using namespace std;
 
@@ -41,6 +43,11 @@ TRandom* RooRandom::_theGenerator = 0;
 RooQuasiRandomGenerator* RooRandom::_theQuasiGenerator = 0;
 RooRandom::Guard RooRandom::guard;
 
+namespace {
+  // Generator of the calling thread set with setThreadRandomGenerator(), if any
+  TTHREAD_TLS(TRandom*) gThreadGenerator = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 RooRandom::Guard::~Guard()
@@ -49,9 +56,12 @@ RooRandom::Guard::~Guard()
 ////////////////////////////////////////////////////////////////////////////////
 /// Return a pointer to a singleton random-number generator
 /// implementation. Creates the object the first time it is called.
+/// A thread given its own generator with setThreadRandomGenerator()
+/// gets that one instead.
 
 TRandom *RooRandom::randomGenerator() 
 {
+  if (gThreadGenerator) return gThreadGenerator;
   if (!_theGenerator) _theGenerator= new TRandom3();
   return _theGenerator;
 }
@@ -66,6 +76,20 @@ void RooRandom::setRandomGenerator(TRandom* gen)
   _theGenerator = gen;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the random number generator of the calling thread, which is used
+/// instead of the one of the process until this is called again with 0.
+/// Threads generating independently, like the workers of
+/// RooStats::ToyMCSampler, use it to get their own reproducible sequence
+/// without sharing the state of a generator. Takes ownership of the object
+/// passed as parameter, and deletes the previous one of the thread
+
+void RooRandom::setThreadRandomGenerator(TRandom* gen)
+{
+  if (gThreadGenerator) delete gThreadGenerator;
+  gThreadGenerator = gen;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return a pointer to a singleton quasi-random generator
 /// implementation. Creates the object the first time it is called.
@@ -32,12 +32,17 @@
 #include "RooFit.h"
 
 #include <math.h>
+#include <list>
+#include <mutex>
 #include <sstream>
+#include <thread>
 #include "RooRealConstant.h"
 #include "RooRealConstant.h"
 #include "RooConstVar.h"
 #include "RooArgList.h"
 #include "RooSentinel.h"
+#include "RooLinkedListIter.h"
+#include "ThreadLocalStorage.h"
 
 using namespace std;
 
@@ -48,6 +53,17 @@ ClassImp(RooRealConstant)
 RooArgList* RooRealConstant::_constDB = 0;
 TIterator* RooRealConstant::_constDBIter = 0;
 
+namespace {
+  // Constants of the threads other than the one that created the database.
+  // The clients of a constant register with it, thus threads building objects
+  // at the same time, like the workers of RooStats::ToyMCSampler, cannot share
+  // constants. They are deleted with the database
+  std::mutex gConstDBMutex ;
+  std::thread::id gConstDBThread ;
+  std::list<RooArgList*> gThreadConstDBs ;
+  TTHREAD_TLS(RooArgList*) gThreadConstDB = 0 ;
+}
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -55,6 +71,12 @@ TIterator* RooRealConstant::_constDBIter = 0;
 
 void RooRealConstant::cleanup() 
 {
+  std::lock_guard<std::mutex> lock(gConstDBMutex) ;
+  for (std::list<RooArgList*>::iterator iter = gThreadConstDBs.begin() ; iter!=gThreadConstDBs.end() ; ++iter) {
+    delete *iter ;
+  }
+  gThreadConstDBs.clear() ;
+  gThreadConstDB = 0 ;
   if (_constDB) {
     delete _constDB ;
     delete _constDBIter ;
@@ -72,9 +94,10 @@ void RooRealConstant::cleanup()
 RooConstVar& RooRealConstant::value(Double_t value) 
 {
   // Lookup existing constant
-  init() ;
+  RooArgList& db = constDB() ;
+  RooFIter iter = db.fwdIterator() ;
   RooConstVar* var ;
-  while((var=(RooConstVar*)_constDBIter->Next())) {
+  while((var=(RooConstVar*)iter.next())) {
     if ((var->getVal()==value) && (!var->getAttribute("REMOVAL_DUMMY"))) return *var ;
   }
 
@@ -84,7 +107,7 @@ RooConstVar& RooRealConstant::value(Double_t value)
 
   var = new RooConstVar(s.str().c_str(),s.str().c_str(),value) ;
   var->setAttribute("RooRealConstant_Factory_Object",kTRUE) ;
-  _constDB->addOwned(*var) ;
+  db.addOwned(*var) ;
 
   return *var ;
 }
@@ -98,7 +121,7 @@ RooConstVar& RooRealConstant::removalDummy()
   RooConstVar* var = new RooConstVar("REMOVAL_DUMMY","REMOVAL_DUMMY",1) ;
   var->setAttribute("RooRealConstant_Factory_Object",kTRUE) ;
   var->setAttribute("REMOVAL_DUMMY") ;
-  _constDB->addOwned(*var) ;
+  constDB().addOwned(*var) ;
 
   return *var ;
 }
@@ -118,3 +141,28 @@ void RooRealConstant::init()
     _constDBIter->Reset() ;
   }
 }
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the constants database of the calling thread: the one of the
+/// process for the thread that created it, a database of its own for any
+/// other thread
+
+RooArgList& RooRealConstant::constDB() 
+{
+  if (gThreadConstDB) return *gThreadConstDB ;
+
+  std::lock_guard<std::mutex> lock(gConstDBMutex) ;
+  if (!_constDB) {
+    init() ;
+    gConstDBThread = std::this_thread::get_id() ;
+  }
+  if (std::this_thread::get_id()==gConstDBThread) {
+    gThreadConstDB = _constDB ;
+  } else {
+    gThreadConstDB = new RooArgList("RooRealVar Constants Database") ;
+    gThreadConstDBs.push_back(gThreadConstDB) ;
+  }
+  return *gThreadConstDB ;
+}
@@ -29,6 +29,9 @@
 #include "TIterator.h"
 #include "RooMsgService.h"
 #include "Riostream.h"
+
+#include <mutex>
+
 using std::cout ;
 using std::endl ;
 
@@ -37,6 +40,10 @@ using namespace std;
 ClassImp(RooSharedPropertiesList)
 ;
 
+// Protects the lists of shared properties, which are updated by all the threads
+// creating and deleting RooFit objects, e.g. the workers of RooStats::ToyMCSampler
+static std::recursive_mutex _propMutex ;
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -82,6 +89,8 @@ RooSharedProperties* RooSharedPropertiesList::registerProperties(RooSharedProper
   }
 
 
+  std::lock_guard<std::recursive_mutex> lock(_propMutex) ;
+
   // If the reference count is non-zero, it is already in the list, so no need
   // to look it up anymore
   if (prop->inSharedList()) {
@@ -119,6 +128,7 @@ RooSharedProperties* RooSharedPropertiesList::registerProperties(RooSharedProper
 
 void RooSharedPropertiesList::unregisterProperties(RooSharedProperties* prop) 
 {
+  std::lock_guard<std::recursive_mutex> lock(_propMutex) ;
   prop->decreaseRefCount() ;
 
   if (prop->refCount()==0) {
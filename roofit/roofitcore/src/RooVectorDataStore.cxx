@@ -452,6 +452,47 @@ Bool_t RooVectorDataStore::valid() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the values of all the events of the column holding the value of 'real',
+/// i.e. of the observable or of the node cached by the constant term optimization
+/// whose value buffer is attached to this store or to its cache, or a null pointer
+/// if there is no such column.
+
+const Double_t* RooVectorDataStore::getColumn(const RooAbsReal* real) const
+{
+  for (Int_t i=0 ; i<_nReal ; i++) {
+    if ((*(_firstReal+i))->_real==real) return (*(_firstReal+i))->_vec0 ;
+  }
+  for (Int_t i=0 ; i<_nRealF ; i++) {
+    if ((*(_firstRealF+i))->_real==real) return (*(_firstRealF+i))->_vec0 ;
+  }
+  return _cache ? _cache->getColumn(real) : 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the weights of all the events, or a null pointer if the events are
+/// not weighted, i.e. all have weight 1. An error is reported, and a null pointer
+/// returned, if the events are weighted but no column holds the weight variable.
+
+const Double_t* RooVectorDataStore::getWeightColumn() const
+{
+  if (_extWgtArray) return _extWgtArray ;
+  if (!_wgtVar) return 0 ;
+  for (Int_t i=0 ; i<_nReal ; i++) {
+    if ((*(_firstReal+i))->bufArg()->namePtr()==_wgtVar->namePtr()) return (*(_firstReal+i))->_vec0 ;
+  }
+  for (Int_t i=0 ; i<_nRealF ; i++) {
+    if ((*(_firstRealF+i))->bufArg()->namePtr()==_wgtVar->namePtr()) return (*(_firstRealF+i))->_vec0 ;
+  }
+  coutE(DataHandling) << "RooVectorDataStore::getWeightColumn(" << GetName() << ") ERROR: no column holds the weight variable " 
+		      << _wgtVar->GetName() << endl ;
+  return 0 ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Interface function to TTree::Fill
 
@@ -1300,19 +1341,22 @@ void RooVectorDataStore::recalculateCache( const RooArgSet *projectedArgs, Int_t
 {
   if (!_cache) return ;
 
-  pRealVector tv[1000] ;
-  Int_t ntv(0) ;
+  // Only the tracked nodes whose parameters changed since the last call are
+  // recalculated, all others keep the values stored for each event
+  vector<pRealVector> tv ;
+  tv.reserve(_cache->_nReal) ;
 
   // Check which items need recalculation
   for (Int_t i=0 ; i<_cache->_nReal ; i++) {
     if ((*(_cache->_firstReal+i))->needRecalc() || _forcedUpdate) {
-      tv[ntv] = (*(_cache->_firstReal+i)) ;
-      tv[ntv]->_nativeReal->setOperMode(RooAbsArg::ADirty) ;
-      tv[ntv]->_nativeReal->_operMode=RooAbsArg::Auto ;
-//       cout << "recalculate: need to update " << tv[ntv]->_nativeReal->GetName() << endl ;
-      ntv++ ;
+      pRealVector rv = (*(_cache->_firstReal+i)) ;
+      rv->_nativeReal->setOperMode(RooAbsArg::ADirty) ;
+      rv->_nativeReal->_operMode=RooAbsArg::Auto ;
+//       cout << "recalculate: need to update " << rv->_nativeReal->GetName() << endl ;
+      tv.push_back(rv) ;
     }    
   }
+  Int_t ntv = tv.size() ;
   _forcedUpdate = kFALSE ;
 
   // If no recalculations are neede stop here
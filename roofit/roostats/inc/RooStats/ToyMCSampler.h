@@ -27,6 +27,16 @@ For parallel runs, ToyMCSampler can be given an instance of ProofConfig
 and then run in parallel using proof or proof-lite. Internally, it uses
 ToyMCStudy with the RooStudyManager.
 </p>
+
+<p>
+Alternatively, SetNumCPU(n) runs the toys in n threads of the current
+process, which avoids the start up of PROOF: each thread works on its own
+copy of the sampler, with its own model, test statistics and minimizers, and
+with its own random generator seeded from the current seed of RooRandom. The
+sampling distributions are merged in the order of the threads at the end.
+The fits of TMinuit run one at a time, use Minuit2 to fit in parallel. The calculators using the ToyMCSampler, such as the
+FrequentistCalculator and the HypoTestInverter, use it without changes.
+</p>
 END_HTML
 */
 //
@@ -107,6 +117,7 @@ class ToyMCSampler: public TestStatSampler {
       virtual SamplingDistribution* GetSamplingDistribution(RooArgSet& paramPoint);
       virtual RooDataSet* GetSamplingDistributions(RooArgSet& paramPoint);
       virtual RooDataSet* GetSamplingDistributionsSingleWorker(RooArgSet& paramPoint);
+      virtual RooDataSet* GetSamplingDistributionsMultiThread(RooArgSet& paramPoint);
 
       virtual SamplingDistribution* AppendSamplingDistribution(
          RooArgSet& allParameters, 
@@ -257,6 +268,10 @@ class ToyMCSampler: public TestStatSampler {
       // calling with argument or NULL deactivates proof
       void SetProofConfig(ProofConfig *pc = NULL) { fProofConfig = pc; }
 
+      // run the toys in nCPU threads of the current process (ignored when using proof)
+      void SetNumCPU(Int_t nCPU = 1) { fNumCPU = nCPU; }
+      Int_t GetNumCPU() const { return fNumCPU; }
+
       void SetProtoData(const RooDataSet* d) { fProtoData = d; }
       
    protected:
@@ -269,6 +284,9 @@ class ToyMCSampler: public TestStatSampler {
       // helper method for clearing  the cache
       virtual void ClearCache();
 
+      // helper for the copies of the sampler run by GetSamplingDistributionsMultiThread
+      void DeleteModel();
+
 
       // densities, snapshots, and test statistics to reweight to
       RooAbsPdf *fPdf; // model (can be alt or null)
@@ -302,6 +320,8 @@ class ToyMCSampler: public TestStatSampler {
       const RooDataSet *fProtoData; // in dev
       
       ProofConfig *fProofConfig;   //!
+      Int_t fNumCPU;               //! number of threads generating the toys
+      Bool_t fOwnsModel;           //! whether this copy of a sampler owns its model and test statistics
       
       mutable NuisanceParametersSampler *fNuisanceParametersSampler; //!
 
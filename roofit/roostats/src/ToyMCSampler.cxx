@@ -33,8 +33,27 @@
 #include "RooStats/RooStatsUtils.h"
 #include "RooSimultaneous.h"
 #include "RooCategory.h"
+#include "RooNumIntConfig.h"
+#include "RooNumIntFactory.h"
+#include "RooNumGenConfig.h"
+#include "RooNumGenFactory.h"
+#include "RooExpensiveObjectCache.h"
+#include "RooResolutionModel.h"
+#include "RooMinimizer.h"
+#include "RooLinkedListIter.h"
 
 #include "TMath.h"
+#include "TRandom2.h"
+#include "TRandom3.h"
+#include "TBufferFile.h"
+#include "TThread.h"
+#include "Math/Factory.h"
+#include "Math/Minimizer.h"
+#include "Math/MinimizerOptions.h"
+
+#include <exception>
+#include <set>
+#include <thread>
 
 
 using namespace RooFit;
@@ -157,6 +176,8 @@ ToyMCSampler::ToyMCSampler() : fSamplingDistName("SD"), fNToys(1)
    fProtoData = NULL;
 
    fProofConfig = NULL;
+   fNumCPU = 1;
+   fOwnsModel = kFALSE;
    fNuisanceParametersSampler = NULL;
 
    _allVars = NULL ;
@@ -196,6 +217,8 @@ ToyMCSampler::ToyMCSampler(TestStatistic &ts, Int_t ntoys) :
    fProtoData = NULL;
 
    fProofConfig = NULL;
+   fNumCPU = 1;
+   fOwnsModel = kFALSE;
    fNuisanceParametersSampler = NULL;
 
    _allVars = NULL ;
@@ -217,6 +240,8 @@ ToyMCSampler::~ToyMCSampler() {
    if(fNuisanceParametersSampler) delete fNuisanceParametersSampler;
 
    ClearCache();
+
+   if(fOwnsModel) DeleteModel();
 }
 
 
@@ -302,9 +327,13 @@ RooDataSet* ToyMCSampler::GetSamplingDistributions(RooArgSet& paramPointIn)
    // Use for serial and parallel runs.
 
    // ======= S I N G L E   R U N ? =======
-   if(!fProofConfig)
+   if(!fProofConfig && fNumCPU <= 1)
       return GetSamplingDistributionsSingleWorker(paramPointIn);
 
+   // ======= M U L T I - T H R E A D   R U N =======
+   if(!fProofConfig)
+      return GetSamplingDistributionsMultiThread(paramPointIn);
+
 
    // ======= P A R A L L E L   R U N =======
    if (!CheckConfig()){
@@ -437,6 +466,166 @@ RooDataSet* ToyMCSampler::GetSamplingDistributionsSingleWorker(RooArgSet& paramP
    return detOutAgg.GetAsDataSet(fSamplingDistName, fSamplingDistName);
 }
 
+RooDataSet* ToyMCSampler::GetSamplingDistributionsMultiThread(RooArgSet& paramPointIn)
+{
+   // Run the toys in fNumCPU threads of the current process. It is called
+   // automatically from inside GetSamplingDistributions when SetNumCPU(n)
+   // with n > 1 was called and no ProofConfig is given.
+   // Each thread runs GetSamplingDistributionsSingleWorker on its share of
+   // the toys with its own copy of the sampler, streamed like the copies
+   // shipped to the PROOF workers: its own model, test statistics, NLLs and
+   // RooMinimizers. Each thread has its own RooRandom generator, seeded from
+   // a generator seeded by RooRandom, so the result only depends on the seed
+   // of RooRandom and on the number of threads. The number of toys, the
+   // number of toys in the tails for adaptive sampling and a finite maximum
+   // number of toys are shared out among the threads, and the sampling
+   // distributions are merged in the order of the threads.
+
+   if (!CheckConfig()){
+      oocoutE((TObject*)NULL, InputArguments)
+         << "Bad COnfiguration in ToyMCSampler "
+         << endl;
+      return NULL;
+   }
+
+   Int_t nWorkers = fNumCPU;
+   if (fToysInTails <= 0 && nWorkers > fNToys) nWorkers = fNToys;
+   if (nWorkers <= 1) return GetSamplingDistributionsSingleWorker(paramPointIn);
+
+   // draw the seeds of the workers as done by ToyMCStudy for the proof workers
+   TRandom2 seedGen(RooRandom::randomGenerator()->Integer(TMath::Limits<unsigned int>::Max()));
+   std::vector<UInt_t> seeds(nWorkers);
+   for (Int_t i = 0; i < nWorkers; ++i) seeds[i] = seedGen.Integer(TMath::Limits<unsigned int>::Max());
+
+   // set up the shared state of ROOT and RooFit in this thread before the
+   // workers use it: thread safety of the core, singletons and plugins
+   TThread::Initialize();
+   RooMsgService::instance();
+   RooNumIntConfig::defaultConfig();
+   RooNumIntFactory::instance();
+   RooNumGenConfig::defaultConfig();
+   RooNumGenFactory::instance();
+   RooExpensiveObjectCache::instance();
+   RooConst(1.0);
+   RooResolutionModel::identity();
+   delete ROOT::Math::Factory::CreateMinimizer(ROOT::Math::MinimizerOptions::DefaultMinimizerType());
+   TString minimizerType = ROOT::Math::MinimizerOptions::DefaultMinimizerType();
+   minimizerType.ToLower();
+   if (minimizerType == "minuit" || minimizerType == "tminuit") {
+      oocoutI((TObject*)NULL, Generation) << "ToyMCSampler: the fits with " << ROOT::Math::MinimizerOptions::DefaultMinimizerType()
+                                          << " run one at a time, use Minuit2 to fit in all threads in parallel" << endl;
+   }
+
+   // copy the sampler with its model and the parameter point for each worker
+   TBufferFile buffer(TBuffer::kWrite);
+   buffer.WriteObjectAny(this, IsA());
+   buffer.SetReadMode();
+   std::vector<ToyMCSampler*> workers(nWorkers);
+   std::vector<RooArgSet*> points(nWorkers);
+   for (Int_t i = 0; i < nWorkers; ++i) {
+      buffer.SetBufferOffset(0);
+      buffer.ResetMap();
+      ToyMCSampler* worker = (ToyMCSampler*) buffer.ReadObjectAny(ToyMCSampler::Class());
+      worker->fOwnsModel = kTRUE;
+      worker->fNToys = fNToys / nWorkers + (i < fNToys % nWorkers ? 1 : 0);
+      worker->fToysInTails = fToysInTails / nWorkers;
+      if (!RooNumber::isInfinite(fMaxToys)) worker->fMaxToys = ceil(fMaxToys / nWorkers);
+      workers[i] = worker;
+      points[i] = (RooArgSet*) paramPointIn.snapshot();
+   }
+
+   // the test statistics lower the message level while they fit and set it
+   // back afterwards, which interleaves between the threads
+   RooFit::MsgLevel msgLevel = RooMsgService::instance().globalKillBelow();
+
+   std::vector<RooDataSet*> results(nWorkers, (RooDataSet*)NULL);
+   std::vector<std::thread> threads;
+   for (Int_t i = 0; i < nWorkers; ++i) {
+      threads.push_back(std::thread([&workers, &points, &results, &seeds, i]() {
+         RooRandom::setThreadRandomGenerator(new TRandom3(seeds[i]));
+         RooAbsReal::useThreadEvalErrorLog(kTRUE);
+         RooExpensiveObjectCache cache;
+         RooExpensiveObjectCache::setThreadInstance(&cache);
+
+         try {
+            results[i] = workers[i]->GetSamplingDistributionsSingleWorker(*points[i]);
+         } catch (std::exception& e) {
+            oocoutE((TObject*)NULL, Generation) << "ToyMCSampler: worker " << i << " failed: " << e.what() << endl;
+         }
+         delete workers[i];
+         delete points[i];
+
+         RooExpensiveObjectCache::setThreadInstance(NULL);
+         RooAbsReal::useThreadEvalErrorLog(kFALSE);
+         RooRandom::setThreadRandomGenerator(NULL);
+         RooMinimizer::cleanup();
+      }));
+   }
+   for (Int_t i = 0; i < nWorkers; ++i) threads[i].join();
+
+   RooMsgService::instance().setGlobalKillBelow(msgLevel);
+
+   // merge the sampling distributions in the order of the workers
+   RooDataSet* output = NULL;
+   Int_t nOK = 0;
+   for (Int_t i = 0; i < nWorkers; ++i) {
+      if (!results[i]) continue;
+      ++nOK;
+      if (!output) {
+         output = results[i];
+      } else {
+         output->append(*results[i]);
+         delete results[i];
+      }
+   }
+
+   if (nOK < nWorkers) {
+      oocoutW((TObject*)NULL, Generation) << "ToyMCSampler: only " << nOK << " out of " << nWorkers
+                                          << " workers returned a sampling distribution" << endl;
+   }
+   if (output) {
+      oocoutP((TObject*)NULL, Generation) << "Merged data from nworkers # " << nOK << "- merged data size is " << output->numEntries() << endl;
+   }
+
+   return output;
+}
+
+void ToyMCSampler::DeleteModel() {
+   // Delete the model, test statistics and sets of a sampler copied for a
+   // worker of GetSamplingDistributionsMultiThread, which owns them.
+
+   for (unsigned int i = 0; i < fTestStatistics.size(); ++i) delete fTestStatistics[i];
+   fTestStatistics.clear();
+   delete fProtoData;
+   fProtoData = NULL;
+
+   // the nodes of the model, the expensive object caches copied with them,
+   // and the variables of the sets that are not in the model
+   RooArgSet nodes;
+   if (fPdf) fPdf->treeNodeServerList(&nodes);
+   if (fPriorNuisance) fPriorNuisance->treeNodeServerList(&nodes);
+   std::set<RooExpensiveObjectCache*> caches;
+   RooFIter iter = nodes.fwdIterator();
+   while (RooAbsArg* node = iter.next()) {
+      if (&node->expensiveObjectCache() != &RooExpensiveObjectCache::instance()) caches.insert(&node->expensiveObjectCache());
+   }
+   const RooArgSet* sets[] = { fParametersForTestStat, fNuisancePars, fObservables, fGlobalObservables };
+   for (unsigned int i = 0; i < sizeof(sets)/sizeof(sets[0]); ++i) {
+      if (sets[i]) nodes.add(*sets[i], kTRUE);
+      delete sets[i];
+   }
+   fPdf = NULL;
+   fPriorNuisance = NULL;
+   fParametersForTestStat = NULL;
+   fNuisancePars = NULL;
+   fObservables = NULL;
+   fGlobalObservables = NULL;
+
+   nodes.takeOwnership();
+   nodes.removeAll();
+   for (std::set<RooExpensiveObjectCache*>::iterator it = caches.begin(); it != caches.end(); ++it) delete *it;
+}
+
 void ToyMCSampler::GenerateGlobalObservables(RooAbsPdf& pdf) const {
 
    
@@ -54,6 +54,7 @@ public:
    Bool_t      SetPars1();
    Bool_t      SetPars2();
    Bool_t      Eval();
+   Bool_t      EvalBatch();
    Bool_t      Stress(Int_t n = 10000);
 
    Bool_t      Parser();
@@ -292,6 +293,41 @@ Bool_t TFormulaTests::Eval()
    return successful;
 }
 
+Bool_t TFormulaTests::EvalBatch()
+{
+   // compare the batch evaluation with the evaluation point by point
+   Bool_t successful = true;
+   const Int_t n = 1000;
+   const char *formulas[3] = { "[0]*exp(-0.5*((x-[1])/[2])^2)",
+                               "x*y + sin(x) - [0]*y^2",
+                               "gaus(0) + pol1(3)*TMath::Log(x+5)" };
+   Double_t params[5] = { 2., 0.5, 1.2, 0.3, -0.1 };
+   std::vector<Double_t> x(2*n), batch(n);
+   for (Int_t i = 0; i < 2*n; ++i) x[i] = gRandom->Uniform(-3,3);
+
+   for (Int_t k = 0; k < 3; ++k) {
+      TFormula test(TString::Format("EvalBatchTest%d",k),formulas[k]);
+      Int_t ndim = test.GetNdim();
+      test.SetParameters(params);
+      for (Int_t withParams = 0; withParams < 2; ++withParams) {
+         const Double_t *p = (withParams) ? params : 0;
+         test.EvalParBatch(n,&x[0],&batch[0],p);
+         for (Int_t i = 0; i < n; ++i) {
+            Double_t point[2] = { x[i], x[n+i] };
+            Double_t result = test.EvalPar(point,p);
+            if (!TMath::AreEqualRel(result,batch[i],1.E-14))
+            {
+               printf("%s (ndim = %d) at point %d - batch:%lf\tscalar:%lf\n",formulas[k],ndim,i,batch[i],result);
+               successful = false;
+               break;
+            }
+         }
+      }
+   }
+
+   return successful;
+}
+
 Bool_t TFormulaTests::ParserNew()
 {
    //x_1- [test]^(TMath::Sin(pi*var*TMath::DegToRad())) - var1pol2(0) + gausn(0)*ylandau(0)+zexpo(10)
@@ -562,6 +598,7 @@ int main(int argc, char **argv)
 #endif
    printf("Stress test:%s\n",(test->Stress(n) ? "PASSED" : "FAILED"));
    printf("Parsing test:%s\n",(test->Parser() ? "PASSED" : "FAILED"));
+   printf("Batch evaluation test:%s\n",(test->EvalBatch() ? "PASSED" : "FAILED"));
 
    return 0;
 }
@@ -0,0 +1,150 @@
+// @(#)root/test:$Id$
+
+// Program comparing the compression algorithms supported by ROOT on the
+// Event tree (see Event.h): for each algorithm and level the tree is written
+// and read back, and the write and read throughputs (in uncompressed MBytes
+// per real time second) and the compression factor are printed.
+//
+// To run this program do:
+//    benchCompression [nevent] [ntracks]
+// The default is 200 events of 600 tracks, i.e. about 40 MBytes of data.
+//
+// The algorithms that were not enabled when ROOT was built (LZ4, ZSTD)
+// are reported as not available.
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "Riostream.h"
+#include "TROOT.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TStopwatch.h"
+#include "TSystem.h"
+#include "Compression.h"
+
+#include "Event.h"
+
+struct BenchConfig_t {
+   const char *fName;
+   Int_t       fAlgorithm;
+   Int_t       fLevel;
+};
+
+static const BenchConfig_t gConfigs[] = {
+   { "zlib",  ROOT::kZLIB,  1 },
+   { "zlib",  ROOT::kZLIB,  6 },
+   { "lzma",  ROOT::kLZMA,  1 },
+   { "lzma",  ROOT::kLZMA,  6 },
+   { "lz4",   ROOT::kLZ4,   1 },
+   { "lz4",   ROOT::kLZ4,   6 },
+   { "zstd",  ROOT::kZSTD,  1 },
+   { "zstd",  ROOT::kZSTD,  6 }
+};
+
+static const char *gFileName = "EventCompression.root";
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the Event tree with the given compression settings, return the
+/// number of uncompressed bytes filled.
+
+Long64_t WriteTree(Int_t settings, Int_t nevent, Int_t ntracks, Double_t &rtime)
+{
+   TStopwatch timer;
+   timer.Start();
+
+   TFile *file = new TFile(gFileName, "RECREATE", "", settings);
+   TTree *tree = new TTree("T", "Compression benchmark tree");
+   Event *event = new Event();
+   tree->Branch("event", &event, 16000, 99);
+
+   Long64_t nb = 0;
+   for (Int_t ev = 0; ev < nevent; ++ev) {
+      event->Build(ev, ntracks, 1);
+      nb += tree->Fill();
+   }
+   file->Write();
+   delete file;
+   delete event;
+
+   timer.Stop();
+   rtime = timer.RealTime();
+   return nb;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read back all the entries of the tree, return the number of uncompressed
+/// bytes read and set the compression factor of the file.
+
+Long64_t ReadTree(Double_t &rtime, Double_t &factor)
+{
+   TStopwatch timer;
+   timer.Start();
+
+   TFile *file = TFile::Open(gFileName);
+   if (!file || file->IsZombie()) {
+      delete file;
+      return -1;
+   }
+   TTree *tree = (TTree*)file->Get("T");
+   Event *event = 0;
+   tree->SetBranchAddress("event", &event);
+
+   Long64_t nb = 0;
+   Long64_t nentries = tree->GetEntries();
+   for (Long64_t ev = 0; ev < nentries; ++ev) {
+      Int_t nread = tree->GetEntry(ev);
+      if (nread <= 0) {
+         nb = -1;
+         break;
+      }
+      nb += nread;
+   }
+   factor = tree->GetTotBytes() / (Double_t)tree->GetZipBytes();
+   delete file;
+   delete event;
+
+   timer.Stop();
+   rtime = timer.RealTime();
+   return nb;
+}
+
+//______________________________________________________________________________
+int main(int argc, char **argv)
+{
+   Int_t nevent  = 200;
+   Int_t ntracks = 600;
+   if (argc > 1) nevent  = atoi(argv[1]);
+   if (argc > 2) ntracks = atoi(argv[2]);
+
+   gROOT->SetBatch();
+
+   printf("Compression benchmark, %d events of %d tracks\n\n", nevent, ntracks);
+   printf("%-6s %5s %14s %14s %10s\n", "algo", "level", "write MB/s", "read MB/s", "factor");
+
+   Bool_t failed = kFALSE;
+   for (UInt_t i = 0; i < sizeof(gConfigs) / sizeof(gConfigs[0]); ++i) {
+      const BenchConfig_t &config = gConfigs[i];
+      if (!ROOT::IsCompressionAlgorithmAvailable((ROOT::ECompressionAlgorithm)config.fAlgorithm)) {
+         // Not built in: the file would be written with the default algorithm.
+         printf("%-6s %5d %14s\n", config.fName, config.fLevel, "not available");
+         continue;
+      }
+      Int_t settings = ROOT::CompressionSettings((ROOT::ECompressionAlgorithm)config.fAlgorithm, config.fLevel);
+
+      Double_t wtime = 0, rtime = 0, factor = 0;
+      Long64_t nbw = WriteTree(settings, nevent, ntracks, wtime);
+      Long64_t nbr = ReadTree(rtime, factor);
+      if (nbr != nbw) {
+         printf("%-6s %5d FAILED: wrote %lld bytes, read back %lld\n", config.fName, config.fLevel, nbw, nbr);
+         failed = kTRUE;
+         continue;
+      }
+      printf("%-6s %5d %14.2f %14.2f %10.2f\n", config.fName, config.fLevel,
+             1e-6 * nbw / wtime, 1e-6 * nbr / rtime, factor);
+   }
+   gSystem->Unlink(gFileName);
+
+   return failed ? 1 : 0;
+}
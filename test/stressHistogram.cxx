@@ -91,7 +91,10 @@
 #include "TClass.h"
 
 #include "TROOT.h"
+#include "TTaskPool.h"
 #include <algorithm>
+#include <functional>
+#include <thread>
 #include <cassert>
 
 using namespace std;
@@ -6731,6 +6734,244 @@ bool testProfile2Extend() {
 
 }
 
+void fillConcurrently(int nevt, const std::function<void(int)> &fill)
+{
+   // Calls fill for the nevt events from the tasks of a pool of 4 threads,
+   // the events of the tasks being interleaved
+
+   const int ntasks = 8;
+   TTaskPool pool(4);
+   TTaskGroup group(&pool);
+   for (int t = 0; t < ntasks; ++t) {
+      group.Run([t, nevt, &fill]() {
+         for (int i = t; i < nevt; i += ntasks) fill(i);
+      });
+   }
+   group.Wait();
+}
+
+bool testH1ConcurrentFill()
+{
+   // Tests the filling of a 1D histogram by several threads, in the atomic
+   // and the thread buffer modes, against the filling by one thread
+
+   const int nevt = 10 * nEvents;
+   std::vector<double> x(nevt), w(nevt);
+   for (int i = 0; i < nevt; ++i) {
+      x[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[i] = 0.5 * (1 + i % 4);
+   }
+   TH1D* h0 = new TH1D("cf1D-h0", "h0-Title", numberOfBins, minRange, maxRange);
+   h0->Sumw2();
+   for (int i = 0; i < nevt; ++i) h0->Fill(x[i], w[i]);
+
+   int ret = 0;
+   const TH1::EConcurrentFill modes[2] = { TH1::kAtomicFill, TH1::kThreadBufferFill };
+   for (int m = 0; m < 2; ++m) {
+      TH1D* h1 = new TH1D("cf1D-h1", "h1-Title", numberOfBins, minRange, maxRange);
+      h1->Sumw2();
+      h1->SetConcurrentFill(modes[m]);
+      fillConcurrently(nevt, [&](int i) { h1->Fill(x[i], w[i]); });
+      ret |= equals("Concurrent Fill Hist 1D", h0, h1, cmpOptStats, 1E-13);
+   }
+   delete h0;
+   return ret;
+}
+
+bool testH2ConcurrentFill()
+{
+   // Tests the filling of a 2D histogram by several threads, in the atomic
+   // and the thread buffer modes, against the filling by one thread
+
+   const int nevt = 10 * nEvents;
+   std::vector<double> x(nevt), y(nevt), w(nevt);
+   for (int i = 0; i < nevt; ++i) {
+      x[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      y[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[i] = 0.5 * (1 + i % 4);
+   }
+   TH2D* h0 = new TH2D("cf2D-h0", "h0-Title", numberOfBins, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   h0->Sumw2();
+   for (int i = 0; i < nevt; ++i) h0->Fill(x[i], y[i], w[i]);
+
+   int ret = 0;
+   const TH1::EConcurrentFill modes[2] = { TH1::kAtomicFill, TH1::kThreadBufferFill };
+   for (int m = 0; m < 2; ++m) {
+      TH2D* h1 = new TH2D("cf2D-h1", "h1-Title", numberOfBins, minRange, maxRange,
+                          numberOfBins + 2, minRange, maxRange);
+      h1->Sumw2();
+      h1->SetConcurrentFill(modes[m]);
+      fillConcurrently(nevt, [&](int i) { h1->Fill(x[i], y[i], w[i]); });
+      ret |= equals("Concurrent Fill Hist 2D", h0, h1, cmpOptStats, 1E-13);
+   }
+   delete h0;
+   return ret;
+}
+
+bool testProfileConcurrentFill()
+{
+   // Tests the filling of a 1D profile by several threads, in the atomic
+   // and the thread buffer modes, against the filling by one thread
+
+   const int nevt = 10 * nEvents;
+   std::vector<double> x(nevt), y(nevt), w(nevt);
+   for (int i = 0; i < nevt; ++i) {
+      x[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      y[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[i] = 0.5 * (1 + i % 4);
+   }
+   TProfile* p0 = new TProfile("cfP-p0", "p0-Title", numberOfBins, minRange, maxRange);
+   for (int i = 0; i < nevt; ++i) p0->Fill(x[i], y[i], w[i]);
+
+   int ret = 0;
+   const TH1::EConcurrentFill modes[2] = { TH1::kAtomicFill, TH1::kThreadBufferFill };
+   for (int m = 0; m < 2; ++m) {
+      TProfile* p1 = new TProfile("cfP-p1", "p1-Title", numberOfBins, minRange, maxRange);
+      p1->SetConcurrentFill(modes[m]);
+      fillConcurrently(nevt, [&](int i) { p1->Fill(x[i], y[i], w[i]); });
+      ret |= equals("Concurrent Fill Profile 1D", p0, p1, cmpOptStats, 1E-13);
+   }
+   delete p0;
+   return ret;
+}
+
+int identical(const char* msg, TH1* h1, TH1* h2)
+{
+   // Checks that the contents, errors and statistics of h1 and h2 are the
+   // same bit for bit, and deletes h2
+
+   int differents = 0;
+   for (int bin = 0; bin < h1->GetNcells(); ++bin) {
+      differents += h1->GetBinContent(bin) != h2->GetBinContent(bin);
+      differents += h1->GetBinError(bin) != h2->GetBinError(bin);
+   }
+   double s1[TH1::kNstat];
+   double s2[TH1::kNstat];
+   h1->GetStats(s1);
+   h2->GetStats(s2);
+   for (int i = 0; i < TH1::kNstat; ++i) differents += s1[i] != s2[i];
+   differents += h1->GetEntries() != h2->GetEntries();
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << msg << ": \t" << (differents?"FAILED":"OK") << std::endl;
+   delete h2;
+   return differents;
+}
+
+bool testH1FillN()
+{
+   // Tests that FillN fills a 1D histogram exactly as Fill called for each
+   // entry, with fix and variable bins and with a stride
+
+   const int nevt = 10 * nEvents;
+   const int stride = 2;
+   std::vector<double> x(stride * nevt), w(stride * nevt);
+   for (int i = 0; i < stride * nevt; ++i) {
+      x[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[i] = r.Uniform(0.5, 2);
+   }
+   std::vector<double> xbins(numberOfBins + 1);
+   FillVariableRange(&xbins[0]);
+
+   int ret = 0;
+   for (int var = 0; var < 2; ++var) {
+      TH1D* h0 = var ? new TH1D("fn1D-h0", "h0-Title", numberOfBins, &xbins[0])
+                     : new TH1D("fn1D-h0", "h0-Title", numberOfBins, minRange, maxRange);
+      TH1D* h1 = var ? new TH1D("fn1D-h1", "h1-Title", numberOfBins, &xbins[0])
+                     : new TH1D("fn1D-h1", "h1-Title", numberOfBins, minRange, maxRange);
+      for (int i = 0; i < stride * nevt; i += stride) h0->Fill(x[i], w[i]);
+      h1->FillN(nevt, &x[0], &w[0], stride);
+      ret |= identical("FillN Hist 1D", h0, h1);
+      delete h0;
+   }
+   return ret;
+}
+
+bool testH2FillN()
+{
+   // Tests that FillN fills a 2D histogram exactly as Fill called for each
+   // entry, with a stride
+
+   const int nevt = 10 * nEvents;
+   const int stride = 3;
+   std::vector<double> x(stride * nevt), y(stride * nevt), w(stride * nevt);
+   for (int i = 0; i < stride * nevt; ++i) {
+      x[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      y[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[i] = r.Uniform(0.5, 2);
+   }
+   TH2D* h0 = new TH2D("fn2D-h0", "h0-Title", numberOfBins, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   TH2D* h1 = new TH2D("fn2D-h1", "h1-Title", numberOfBins, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   for (int i = 0; i < stride * nevt; i += stride) h0->Fill(x[i], y[i], w[i]);
+   h1->FillN(nevt, &x[0], &y[0], &w[0], stride);
+   int ret = identical("FillN Hist 2D", h0, h1);
+   delete h0;
+   return ret;
+}
+
+bool testH3FillN()
+{
+   // Tests that FillN fills a 3D histogram exactly as Fill called for each
+   // entry, with and without a buffer
+
+   const int nevt = 10 * nEvents;
+   std::vector<double> x(nevt), y(nevt), z(nevt), w(nevt);
+   for (int i = 0; i < nevt; ++i) {
+      x[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      y[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      z[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[i] = r.Uniform(0.5, 2);
+   }
+   int ret = 0;
+   for (int buffer = 0; buffer < 2; ++buffer) {
+      TH3D* h0 = new TH3D("fn3D-h0", "h0-Title", numberOfBins, minRange, maxRange,
+                          numberOfBins + 1, minRange, maxRange,
+                          numberOfBins + 2, minRange, maxRange);
+      TH3D* h1 = new TH3D("fn3D-h1", "h1-Title", numberOfBins, minRange, maxRange,
+                          numberOfBins + 1, minRange, maxRange,
+                          numberOfBins + 2, minRange, maxRange);
+      if (buffer) h1->SetBuffer(nevt / 3);
+      for (int i = 0; i < nevt; ++i) h0->Fill(x[i], y[i], z[i], w[i]);
+      h1->FillN(nevt, &x[0], &y[0], &z[0], &w[0]);
+      ret |= identical("FillN Hist 3D", h0, h1);
+      delete h0;
+   }
+   return ret;
+}
+
+bool testH1ConcurrentFillThreadSlots()
+{
+   // Tests the thread buffer mode with more short lived threads than thread
+   // slots: the slots of the finished threads, and their pending entries, are
+   // taken over by the new threads
+
+   const int nthreads = 600;
+   const int nevt = 10 * nEvents;
+   std::vector<double> x(nevt), w(nevt);
+   for (int i = 0; i < nevt; ++i) {
+      x[i] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[i] = 0.5 * (1 + i % 4);
+   }
+   TH1D* h0 = new TH1D("cfS-h0", "h0-Title", numberOfBins, minRange, maxRange);
+   h0->Sumw2();
+   for (int i = 0; i < nevt; ++i) h0->Fill(x[i], w[i]);
+
+   TH1D* h1 = new TH1D("cfS-h1", "h1-Title", numberOfBins, minRange, maxRange);
+   h1->Sumw2();
+   h1->SetConcurrentFill(TH1::kThreadBufferFill);
+   for (int t = 0; t < nthreads; t += 2) {
+      std::thread t0([&]() { for (int i = t; i < nevt; i += nthreads) h1->Fill(x[i], w[i]); });
+      std::thread t1([&]() { for (int i = t + 1; i < nevt; i += nthreads) h1->Fill(x[i], w[i]); });
+      t0.join();
+      t1.join();
+   }
+   int ret = equals("Concurrent Fill Thread Slots", h0, h1, cmpOptStats, 1E-13);
+   delete h0;
+   return ret;
+}
+
 bool testConversion1D()
 {
    const int nbins[3] = {50,11,12};
@@ -10113,9 +10354,30 @@ int stressHistogram()
                                            "FillData tests for Histograms and Sparses........................",
                                            fillDataTestPointer };
 
+   // Concurrent Fill Tests
+   const unsigned int numberOfConcurrentFill = 4;
+   pointer2Test concurrentFillTestPointer[numberOfConcurrentFill] = { testH1ConcurrentFill,
+                                                                      testH2ConcurrentFill,
+                                                                      testProfileConcurrentFill,
+                                                                      testH1ConcurrentFillThreadSlots
+   };
+   struct TTestSuite concurrentFillTestSuite = { numberOfConcurrentFill,
+                                                 "Concurrent fill tests for Histograms.............................",
+                                                 concurrentFillTestPointer };
+
+   // FillN Tests
+   const unsigned int numberOfFillN = 3;
+   pointer2Test fillNTestPointer[numberOfFillN] = { testH1FillN,
+                                                    testH2FillN,
+                                                    testH3FillN
+   };
+   struct TTestSuite fillNTestSuite = { numberOfFillN,
+                                        "FillN against Fill tests for Histograms..........................",
+                                        fillNTestPointer };
+
 
    // Combination of tests
-   const unsigned int numberOfSuits = 16;
+   const unsigned int numberOfSuits = 18;
    struct TTestSuite* testSuite[numberOfSuits];
    testSuite[ 0] = &rangeTestSuite;
    testSuite[ 1] = &rebinTestSuite;
@@ -10133,6 +10395,8 @@ int stressHistogram()
    testSuite[13] = &extendTestSuite;
    testSuite[14] = &conversionsTestSuite;
    testSuite[15] = &fillDataTestSuite;
+   testSuite[16] = &concurrentFillTestSuite;
+   testSuite[17] = &fillNTestSuite;
 
    status = 0;
    for ( unsigned int i = 0; i < numberOfSuits; ++i ) {
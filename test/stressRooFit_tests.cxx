@@ -6444,3 +6444,307 @@ public:
   }
 } ;
 
+
+
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 'PARALLEL EVALUATION' RooFit stress test #901
+//
+// Compare the likelihood evaluated by threads (NumThreads) with the
+// likelihood evaluated serially
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooPolynomial.h"
+#include "RooAddPdf.h"
+
+using namespace RooFit ;
+
+
+class TestBasic901 : public RooUnitTest
+{
+public:
+  TestBasic901(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Multi-threaded likelihood",refFile,writeRef,verbose) {} ;
+  Bool_t testCode() {
+
+  // C r e a t e   m o d e l   a n d   d a t a
+  // -----------------------------------------
+
+  RooRealVar x("x","x",-10,10) ;
+  RooRealVar m("m","m",0,-10,10) ;
+  RooRealVar s("s","s",2,0.1,10) ;
+  RooGaussian g("g","g",x,m,s) ;
+  RooPolynomial p("p","p",x) ;
+  RooRealVar f("f","f",0.4,0.,1.) ;
+  RooAddPdf sum("sum","sum",RooArgSet(g,p),f) ;
+
+  RooDataSet* data = sum.generate(x,20000) ;
+
+
+  // C o m p a r e   t h e   s e r i a l   a n d   t h r e a d e d   l i k e l i h o o d s
+  // ---------------------------------------------------------------------------------------
+
+  RooAbsReal* nll = sum.createNLL(*data) ;
+  RooAbsReal* nllBulk = sum.createNLL(*data,NumThreads(4)) ;
+  RooAbsReal* nllInterleave = sum.createNLL(*data,NumThreads(3,Interleave)) ;
+
+  // The partitions are summed in a different order than the events of the serial
+  // likelihood: compare up to the rounding
+  Bool_t ok = kTRUE ;
+  const Double_t values[3][3] = { {0,2,0.4}, {0.5,1.5,0.3}, {-1,3,0.7} } ;
+  for (Int_t i = 0; i < 3; ++i) {
+    m.setVal(values[i][0]) ;
+    s.setVal(values[i][1]) ;
+    f.setVal(values[i][2]) ;
+    Double_t ref = nll->getVal() ;
+    if (!TMath::AreEqualRel(nllBulk->getVal(),ref,1e-12) || !TMath::AreEqualRel(nllInterleave->getVal(),ref,1e-12)) {
+      cout << "TestBasic901: ERROR threaded likelihoods " << nllBulk->getVal() << " and " << nllInterleave->getVal()
+           << " differ from the serial likelihood " << ref << endl ;
+      ok = kFALSE ;
+    }
+  }
+
+  delete nllInterleave ;
+  delete nllBulk ;
+  delete nll ;
+  delete data ;
+
+  return ok ;
+  }
+} ;
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 'PARALLEL EVALUATION' RooFit stress test #902
+//
+// Compare the likelihood computed on batches of events with the
+// likelihood computed event by event
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooFormulaVar.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooPolynomial.h"
+#include "RooExponential.h"
+#include "RooAddPdf.h"
+#include "RooProdPdf.h"
+#include "TMath.h"
+
+using namespace RooFit ;
+
+
+// Gaussian modulated by a cosine that does not override evaluateBatch(): it
+// must be evaluated event by event instead of with the batch of RooGaussian
+class ModulatedGaussian902 : public RooGaussian
+{
+public:
+  ModulatedGaussian902(const char* name, const char* title, RooAbsReal& _x, RooAbsReal& _mean, RooAbsReal& _sigma) :
+    RooGaussian(name,title,_x,_mean,_sigma) {} ;
+  ModulatedGaussian902(const ModulatedGaussian902& other, const char* name=0) : RooGaussian(other,name) {} ;
+  virtual TObject* clone(const char* newname) const { return new ModulatedGaussian902(*this,newname) ; }
+protected:
+  Double_t evaluate() const { return RooGaussian::evaluate()*(1.5+0.5*cos(x)) ; }
+} ;
+
+
+class TestBasic902 : public RooUnitTest
+{
+public:
+  TestBasic902(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Batch evaluation of likelihood",refFile,writeRef,verbose) {} ;
+  Bool_t testCode() {
+
+  // C r e a t e   m o d e l s   a n d   d a t a
+  // -------------------------------------------
+
+  RooRealVar x("x","x",-10,10) ;
+  RooRealVar y("y","y",0,5) ;
+  RooRealVar m("m","m",0,-10,10) ;
+  RooRealVar s("s","s",2,0.1,10) ;
+  RooRealVar a1("a1","a1",0.01,-0.1,0.1) ;
+  RooRealVar c("c","c",-0.5,-2.,0.) ;
+  RooRealVar f("f","f",0.4,0.,1.) ;
+
+  RooGaussian g("g","g",x,m,s) ;
+  RooPolynomial p("p","p",x,a1) ;
+  RooAddPdf sum("sum","sum",RooArgSet(g,p),f) ;
+  RooExponential e("e","e",y,c) ;
+  RooProdPdf prod("prod","prod",RooArgSet(sum,e)) ;
+
+  ModulatedGaussian902 mg("mg","mg",x,m,s) ;
+  RooAddPdf msum("msum","msum",RooArgSet(mg,p),f) ;
+
+  RooDataSet* data = prod.generate(RooArgSet(x,y),10000) ;
+
+  // Weighted copy of the data
+  RooFormulaVar wFunc("w","event weight","0.5+0.05*x+0.1*y",RooArgList(x,y)) ;
+  RooRealVar* w = (RooRealVar*) data->addColumn(wFunc) ;
+  RooDataSet wdata("wdata","wdata",data,RooArgSet(x,y,*w),0,w->GetName()) ;
+
+
+  // C o m p a r e   t h e   b a t c h   a n d   s c a l a r   l i k e l i h o o d s
+  // ---------------------------------------------------------------------------------
+
+  // The last likelihood uses the squared weights, as in SumW2Error fits
+  RooAbsPdf* pdfs[4] = { &prod, &prod, &msum, &prod } ;
+  RooDataSet* datas[4] = { data, &wdata, data, &wdata } ;
+
+  Bool_t ok = kTRUE ;
+  const Double_t values[3][4] = { {0,2,0.4,-0.5}, {0.5,1.5,0.3,-0.2}, {-1,3,0.7,-1.1} } ;
+  for (Int_t j = 0; j < 4; ++j) {
+    RooAbsReal* nllScalar = pdfs[j]->createNLL(*datas[j]) ;
+    RooAbsReal* nllBatch = pdfs[j]->createNLL(*datas[j]) ;
+    if (j == 3) {
+      ((RooNLLVar*)nllScalar)->applyWeightSquared(kTRUE) ;
+      ((RooNLLVar*)nllBatch)->applyWeightSquared(kTRUE) ;
+    }
+    for (Int_t i = 0; i < 3; ++i) {
+      m.setVal(values[i][0]) ;
+      s.setVal(values[i][1]) ;
+      f.setVal(values[i][2]) ;
+      c.setVal(values[i][3]) ;
+      RooAbsReal::setBatchEvaluation(kFALSE) ;
+      Double_t ref = nllScalar->getVal() ;
+      RooAbsReal::setBatchEvaluation(kTRUE) ;
+      Double_t val = nllBatch->getVal() ;
+      // The batches use the same operations and summation order as evaluate()
+      if (!TMath::AreEqualRel(val,ref,1e-14)) {
+        cout << "TestBasic902: ERROR batch likelihood " << val << " of " << pdfs[j]->GetName() << " on " 
+             << datas[j]->GetName() << " differs from the scalar likelihood " << ref << endl ;
+        ok = kFALSE ;
+      }
+    }
+    delete nllBatch ;
+    delete nllScalar ;
+  }
+  // The batch evaluation is off by default
+  RooAbsReal::setBatchEvaluation(kFALSE) ;
+
+  delete data ;
+
+  return ok ;
+  }
+} ;
+
+
+
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 'PARALLEL EVALUATION' RooFit stress test #903
+//
+// Check that the memory budget of the cache-and-track optimization is
+// shared by all likelihoods and does not change their values
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooAddPdf.h"
+#include "RooAbsOptTestStatistic.h"
+#include "TMath.h"
+
+using namespace RooFit ;
+
+
+class TestBasic903 : public RooUnitTest
+{
+public:
+  TestBasic903(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Cache-and-track memory budget",refFile,writeRef,verbose) {} ;
+  Bool_t testCode() {
+
+  // C r e a t e   m o d e l   a n d   d a t a
+  // -----------------------------------------
+
+  RooRealVar x("x","x",-10,10) ;
+  RooRealVar m1("m1","m1",-3,-10,10) ;
+  RooRealVar m2("m2","m2",0,-10,10) ;
+  RooRealVar m3("m3","m3",3,-10,10) ;
+  RooRealVar s("s","s",1,0.1,10) ;
+  RooGaussian g1("g1","g1",x,m1,s) ;
+  RooGaussian g2("g2","g2",x,m2,s) ;
+  RooGaussian g3("g3","g3",x,m3,s) ;
+  RooRealVar f1("f1","f1",0.3,0.,1.) ;
+  RooRealVar f2("f2","f2",0.3,0.,1.) ;
+  RooAddPdf sum("sum","sum",RooArgList(g1,g2,g3),RooArgList(f1,f2)) ;
+
+  RooDataSet* data = sum.generate(x,10000) ;
+
+
+  // S h a r e   a   b u d g e t   o f   2 . 5   c o l u m n s
+  // -----------------------------------------------------------
+
+  // Each tracked Gaussian stores one value per event
+  const Double_t column = data->numEntries()*sizeof(Double_t)/(1024.*1024.) ;
+  Double_t oldBudget = RooAbsOptTestStatistic::cacheAndTrackMemoryBudget() ;
+  Double_t oldUsage = RooAbsOptTestStatistic::cacheAndTrackMemoryUsage() ;
+  RooAbsOptTestStatistic::setCacheAndTrackMemoryBudget(oldUsage+2.5*column) ;
+
+  Bool_t ok = kTRUE ;
+
+  RooAbsReal* nllRef = sum.createNLL(*data) ;
+  RooAbsReal* nll1 = sum.createNLL(*data,Optimize(2)) ;
+  if (!TMath::AreEqualRel(RooAbsOptTestStatistic::cacheAndTrackMemoryUsage()-oldUsage,2*column,1e-9)) {
+    cout << "TestBasic903: ERROR first likelihood tracks " << (RooAbsOptTestStatistic::cacheAndTrackMemoryUsage()-oldUsage)/column
+         << " columns instead of 2" << endl ;
+    ok = kFALSE ;
+  }
+
+  // The second likelihood gets what is left of the budget: nothing
+  RooAbsReal* nll2 = sum.createNLL(*data,Optimize(2)) ;
+  if (!TMath::AreEqualRel(RooAbsOptTestStatistic::cacheAndTrackMemoryUsage()-oldUsage,2*column,1e-9)) {
+    cout << "TestBasic903: ERROR second likelihood exceeds the shared budget, "
+         << (RooAbsOptTestStatistic::cacheAndTrackMemoryUsage()-oldUsage)/column << " columns are tracked" << endl ;
+    ok = kFALSE ;
+  }
+
+  const Double_t values[3][3] = { {-3,0,3}, {-2.5,0,3}, {-2.5,0.5,3} } ;
+  for (Int_t i = 0; i < 3; ++i) {
+    m1.setVal(values[i][0]) ;
+    m2.setVal(values[i][1]) ;
+    m3.setVal(values[i][2]) ;
+    Double_t ref = nllRef->getVal() ;
+    if (!TMath::AreEqualRel(nll1->getVal(),ref,1e-12) || !TMath::AreEqualRel(nll2->getVal(),ref,1e-12)) {
+      cout << "TestBasic903: ERROR optimized likelihoods " << nll1->getVal() << " and " << nll2->getVal()
+           << " differ from the reference likelihood " << ref << endl ;
+      ok = kFALSE ;
+    }
+  }
+
+  // Deleting the likelihoods returns their memory to the budget
+  delete nll2 ;
+  delete nll1 ;
+  delete nllRef ;
+  if (!TMath::AreEqualAbs(RooAbsOptTestStatistic::cacheAndTrackMemoryUsage(),oldUsage,1e-9)) {
+    cout << "TestBasic903: ERROR " << RooAbsOptTestStatistic::cacheAndTrackMemoryUsage()-oldUsage
+         << " MB of the budget are still in use after deleting the likelihoods" << endl ;
+    ok = kFALSE ;
+  }
+
+  RooAbsOptTestStatistic::setCacheAndTrackMemoryBudget(oldBudget) ;
+  delete data ;
+
+  return ok ;
+  }
+} ;
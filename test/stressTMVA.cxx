@@ -420,6 +420,56 @@ void UnitTestSuite::reset()
          tests[i]->reset();
       }
 }
+// including file tmvaut/UnitTestToys.h
+#ifndef UNITTESTTOYS_H
+#define UNITTESTTOYS_H
+
+// TMVA unit tests
+//
+// toy samples shared by the tests training methods with a factory
+
+#include "Rtypes.h"
+
+namespace TMVA {
+   class Factory;
+}
+
+namespace UnitTesting
+{
+   // adds the variables var0 and var1 and nEvents signal and background events,
+   // each used both for training and testing, and prepares the trees
+   void prepareToyFactory(TMVA::Factory* factory, Int_t nEvents, UInt_t seed);
+} // namespace UnitTesting
+#endif //
+// including file tmvaut/UnitTestToys.cxx
+
+
+#include <vector>
+
+#include "TRandom3.h"
+
+#include "TMVA/Factory.h"
+
+void UnitTesting::prepareToyFactory(TMVA::Factory* factory, Int_t nEvents, UInt_t seed)
+{
+   factory->AddVariable( "var0", "Variable 0", 'F' );
+   factory->AddVariable( "var1", "Variable 1", 'F' );
+
+   // gaussian signal on a flat background
+   std::vector<double> vars(2);
+   TRandom3 r(seed);
+   for (int i = 0; i < nEvents; i++) {
+      vars[0] = r.Gaus(1.,1.);
+      vars[1] = r.Gaus(0.,1.);
+      factory->AddSignalTrainingEvent( vars, 1. );
+      factory->AddSignalTestEvent( vars, 1. );
+      vars[0] = 4. * (r.Rndm()-0.5);
+      vars[1] = 4. * (r.Rndm()-0.5);
+      factory->AddBackgroundTrainingEvent( vars, 1. );
+      factory->AddBackgroundTestEvent( vars, 1. );
+   }
+   factory->PrepareTrainingAndTestTree( "", "", "nTrain_Signal=0:nTrain_Background=0:SplitMode=Random:NormMode=NumEvents:!V" );
+}
 // including file tmvaut/utDataSetInfo.h
 #ifndef UTDATASETINFO_H
 #define UTDATASETINFO_H
@@ -789,6 +839,50 @@ void utDataSet::testMethods()
 
    test_(dataset->HasNegativeEventWeights() == kFALSE);
 
+   // blocks of columns, across the boundary between two blocks, of events added
+   // one by one (held by the events) and of an event collection (held by the columns)
+   DataSet eventset(*datasetinfo), columnset(*datasetinfo);
+   const UInt_t nevents = DataSet::GetColumnBlockSize() + 100;
+   vector<Float_t> values(3), targets(3), spectators(1);
+   vector<Event*>* collection = new vector<Event*>;
+   for (UInt_t ievt=0; ievt<nevents; ievt++) {
+      for (UInt_t ivar=0; ivar<3; ivar++) values[ivar] = 0.5*ievt + ivar;
+      eventset.AddEvent(new Event(values, targets, spectators, ievt%3, 1. + ievt%7), Types::kTraining);
+      collection->push_back(new Event(values, targets, spectators, ievt%3, 1. + ievt%7));
+   }
+   columnset.SetEventCollection(collection, Types::kTraining);
+   test_(eventset.GetColumn(0, Types::kTraining) == 0 && !eventset.GetEvent(0, Types::kTraining)->IsColumnView());
+   test_(columnset.GetColumn(2, Types::kTraining) != 0 && columnset.GetEvent(0, Types::kTraining)->IsColumnView());
+
+   DataSet* sets[] = { &eventset, &columnset };
+   vector<Float_t>  block;
+   vector<UInt_t>   classes;
+   vector<Double_t> weights;
+   for (UInt_t iset=0; iset<2; iset++) {
+      Bool_t sameBlocks = kTRUE;
+      for (UInt_t first=0; first<nevents; first+=DataSet::GetColumnBlockSize()) {
+         const UInt_t n = TMath::Min(DataSet::GetColumnBlockSize(), nevents-first);
+         sets[iset]->GetColumnBlock(first, n, block, classes, weights, Types::kTraining);
+         test_(block.size() == 3*n && classes.size() == n && weights.size() == n);
+         for (UInt_t i=0; i<n; i++) {
+            const Event* ev = eventset.GetEvent(first+i, Types::kTraining);
+            for (UInt_t ivar=0; ivar<3; ivar++) sameBlocks &= (block[ivar*n+i] == ev->GetValue(ivar));
+            sameBlocks &= (classes[i] == ev->GetClass() && weights[i] == ev->GetWeight());
+         }
+      }
+      test_(sameBlocks);
+   }
+
+   // the views read the columns, and their copies keep them until they change a value
+   const Float_t* column1 = columnset.GetColumn(1, Types::kTraining);
+   const Event* view = columnset.GetEvent(5, Types::kTraining);
+   test_(view->GetNVariables() == 3 && view->GetValue(1) == column1[5] && view->GetValues()[2] == 0.5*5 + 2);
+   Event copy(*view);
+   test_(copy.IsColumnView() && copy.GetValue(1) == column1[5]);
+   copy.SetVal(1, -1.);
+   test_(!copy.IsColumnView() && copy.GetValue(1) == -1. && copy.GetValue(2) == view->GetValue(2));
+   test_(view->GetValue(1) == 0.5*5 + 1 && column1[5] == 0.5*5 + 1);
+
    /* function still to develop tests for:
       void      SetCurrentEvent( Long64_t ievt         ) const { fCurrentEventIdx = ievt; }
       void      SetCurrentType ( Types::ETreeType type ) const { fCurrentTreeIdx = TreeIndex(type); }
@@ -1416,6 +1510,448 @@ void utReaderMT::run()
 
 }
 
+// including file tmvaut/utDecisionTree.h
+#ifndef UTDECISIONTREE_H
+#define UTDECISIONTREE_H
+
+// TMVA unit tests
+//
+// checks that the decision trees trained with the global task pool are the
+// same as the ones trained without it, with and without pre-binning
+
+#include <string>
+#include <vector>
+
+namespace TMVA {
+   class DecisionTreeNode;
+}
+
+namespace UnitTesting
+{
+  class utDecisionTree : public UnitTest
+  {
+  public:
+    utDecisionTree(const char* theOption="");
+    virtual ~utDecisionTree();
+
+    virtual void run();
+
+  protected:
+    bool sameNodes(const TMVA::DecisionTreeNode* n1, const TMVA::DecisionTreeNode* n2);
+
+  private:
+     // disallow copy constructor and assignment
+     utDecisionTree(const utDecisionTree&);
+     utDecisionTree& operator=(const utDecisionTree&);
+  };
+} // namespace UnitTesting
+#endif //
+// including file tmvaut/utDecisionTree.cxx
+
+
+#include <string>
+#include <vector>
+
+#include "TRandom3.h"
+#include "TTaskPool.h"
+
+#include "TMVA/DecisionTree.h"
+#include "TMVA/DecisionTreeNode.h"
+#include "TMVA/GiniIndex.h"
+#include "TMVA/DataSetInfo.h"
+#include "TMVA/VariableInfo.h"
+#include "TMVA/Event.h"
+
+
+
+using namespace std;
+using namespace UnitTesting;
+using namespace TMVA;
+
+utDecisionTree::utDecisionTree(const char* /*theOption*/)
+   : UnitTest(string("DecisionTree"))
+{
+
+}
+utDecisionTree::~utDecisionTree(){ }
+
+bool utDecisionTree::sameNodes(const DecisionTreeNode* n1, const DecisionTreeNode* n2)
+{
+   if (!n1 || !n2) return n1 == n2;
+   return n1->GetSelector() == n2->GetSelector()
+      && n1->GetCutValue() == n2->GetCutValue()
+      && n1->GetCutType()  == n2->GetCutType()
+      && n1->GetNodeType() == n2->GetNodeType()
+      && n1->GetPurity()   == n2->GetPurity()
+      && sameNodes(n1->GetLeft(), n2->GetLeft())
+      && sameNodes(n1->GetRight(), n2->GetRight());
+}
+
+void utDecisionTree::run()
+{
+   // the nodes with at least 20000 events are filled in several chunks
+   const UInt_t nvar = 4, nevt = 40000;
+   float min = -5, max = 5;
+   DataSetInfo dsi("utDecisionTree");
+   for (UInt_t ivar = 0; ivar < nvar; ivar++)
+      dsi.AddVariable(VariableInfo(Form("var%u", ivar), "title", "unit", ivar, 'F', &min, min, max, kFALSE));
+
+   TRandom3 r(4357);
+   vector<const Event*> events;
+   vector<Float_t> values(nvar);
+   for (UInt_t i = 0; i < nevt; i++) {
+      UInt_t cls = i % 2;
+      for (UInt_t ivar = 0; ivar < nvar; ivar++) values[ivar] = r.Gaus(cls ? 0.3*ivar : -0.3*ivar, 1.);
+      events.push_back(new Event(values, cls, 0.5 + r.Rndm()));
+   }
+
+   GiniIndex gini;
+   const UInt_t poolSize = TTaskPool::GetGlobalPoolSize();
+   vector<DecisionTree*> trees; // without and with pre-binning, for each pool size
+   const UInt_t nThreads[] = { 0, 3 };
+   for (UInt_t i = 0; i < 2; i++) {
+      TTaskPool::SetGlobalPoolSize(nThreads[i]);
+      for (UInt_t preBinning = 0; preBinning < 2; preBinning++) {
+         DecisionTree* tree = new DecisionTree(&gini, 2.5, 20, &dsi, 0, kFALSE, 0, kFALSE, 6);
+         tree->SetPreBinning(preBinning);
+         tree->BuildTree(events);
+         trees.push_back(tree);
+      }
+   }
+   TTaskPool::SetGlobalPoolSize(poolSize);
+
+   for (UInt_t i = 2; i < trees.size(); i++) {
+      test_(trees[i]->GetNNodes() == trees[i-2]->GetNNodes());
+      test_(sameNodes(trees[i]->GetRoot(), trees[i-2]->GetRoot()));
+      bool sameResponse = true;
+      for (UInt_t iev = 0; iev < nevt; iev += 7)
+         if (trees[i]->CheckEvent(events[iev]) != trees[i-2]->CheckEvent(events[iev])) sameResponse = false;
+      test_(sameResponse);
+   }
+   // the grid of the root node is the one of the pre-binned variables
+   test_(trees[1]->GetRoot()->GetSelector() == trees[0]->GetRoot()->GetSelector());
+   test_(trees[1]->GetRoot()->GetCutValue() == trees[0]->GetRoot()->GetCutValue());
+
+   for (UInt_t i = 0; i < trees.size(); i++) delete trees[i];
+   for (UInt_t i = 0; i < events.size(); i++) delete events[i];
+}
+
+// including file tmvaut/utReaderBatch.h
+#ifndef UTREADERBATCH_H
+#define UTREADERBATCH_H
+
+// TMVA unit tests
+//
+// compares the block evaluation of the Reader with the single event one
+
+#include <string>
+
+namespace UnitTesting
+{
+  class utReaderBatch : public UnitTest
+  {
+  public:
+    utReaderBatch(const char* theOption="");
+    virtual ~utReaderBatch();
+
+    virtual void run();
+
+  private:
+     // disallow copy constructor and assignment
+     utReaderBatch(const utReaderBatch&);
+     utReaderBatch& operator=(const utReaderBatch&);
+  };
+} // namespace UnitTesting
+#endif //
+// including file tmvaut/utReaderBatch.cxx
+
+
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "TMath.h"
+#include "TRandom3.h"
+
+#include "TMVA/Reader.h"
+
+
+
+using namespace std;
+using namespace UnitTesting;
+using namespace TMVA;
+
+utReaderBatch::utReaderBatch(const char* /*theOption*/)
+   : UnitTest(string("ReaderBatch"))
+{
+
+}
+utReaderBatch::~utReaderBatch(){ }
+
+void utReaderBatch::run()
+{
+   // BDT and LD trained by utFactory on var0 and var1
+   const char* methods[] = { "BDT", "LD" };
+   const char* weights[] = { "weights/ByHand_BDT.weights.xml", "weights/TMVATest_LD.weights.xml" };
+
+   const UInt_t nvar = 2, nevt = 1000;
+   TRandom3 r(17);
+   vector<Float_t> input(nvar*nevt);
+   for (UInt_t i = 0; i < input.size(); i++) input[i] = 4.*(r.Rndm()-0.5);
+   input[5] = TMath::QuietNaN(); // var0 of event 5
+
+   for (UInt_t m = 0; m < 2; m++) {
+      float var0, var1;
+      int ievt;
+      Reader reader("!Color:Silent");
+      reader.AddVariable("var0", &var0);
+      reader.AddVariable("var1", &var1);
+      if (m == 1) reader.AddSpectator("ievt", &ievt);
+      reader.BookMVA(methods[m], weights[m]);
+
+      // per-event values
+      vector<Double_t> single(nevt);
+      for (UInt_t iev = 0; iev < nevt; iev++) {
+         var0 = input[iev];
+         var1 = input[nevt+iev];
+         single[iev] = reader.EvaluateMVA(methods[m]);
+      }
+
+      // the same events as one block
+      vector<Double_t> batch(nevt);
+      reader.EvaluateMVA(&input[0], nevt, methods[m], &batch[0]);
+      test_(batch == single);
+
+      // blocks of the events evaluated by several threads sharing the reader
+      const UInt_t nThreads = 4, nBlock = nevt/nThreads;
+      vector<Float_t> blocks(nvar*nevt);
+      for (UInt_t t = 0; t < nThreads; t++)
+         for (UInt_t ivar = 0; ivar < nvar; ivar++)
+            for (UInt_t i = 0; i < nBlock; i++)
+               blocks[t*nvar*nBlock + ivar*nBlock + i] = input[ivar*nevt + t*nBlock + i];
+      vector<Double_t> threaded(nevt);
+      vector<thread> threads;
+      for (UInt_t t = 0; t < nThreads; t++)
+         threads.emplace_back([&, t] () {
+            reader.EvaluateMVA(&blocks[t*nvar*nBlock], nBlock, methods[m], &threaded[t*nBlock]);
+         });
+      for (auto&& th : threads) th.join();
+      test_(threaded == single);
+   }
+}
+
+// including file tmvaut/utMLPDense.h
+#ifndef UTMLPDENSE_H
+#define UTMLPDENSE_H
+
+// TMVA unit tests
+//
+// compares the MLP trained with the dense backend with the one trained on the
+// neurons and synapses
+
+#include <string>
+
+namespace UnitTesting
+{
+  class utMLPDense : public UnitTest
+  {
+  public:
+    utMLPDense(const char* theOption="");
+    virtual ~utMLPDense();
+
+    virtual void run();
+
+  private:
+     // disallow copy constructor and assignment
+     utMLPDense(const utMLPDense&);
+     utMLPDense& operator=(const utMLPDense&);
+  };
+} // namespace UnitTesting
+#endif //
+// including file tmvaut/utMLPDense.cxx
+
+
+#include <string>
+
+#include "TFile.h"
+#include "TMath.h"
+
+#include "TMVA/Factory.h"
+#include "TMVA/Reader.h"
+
+
+
+using namespace std;
+using namespace UnitTesting;
+using namespace TMVA;
+
+utMLPDense::utMLPDense(const char* /*theOption*/)
+   : UnitTest(string("MLPDense"))
+{
+
+}
+utMLPDense::~utMLPDense(){ }
+
+void utMLPDense::run()
+{
+   TFile* outputFile = TFile::Open( "weights/MLPDense.root", "RECREATE" );
+   Factory* factory = new Factory( "MLPDense", outputFile,
+                                   "!V:Silent:Transformations=I:AnalysisType=Classification:!Color:!DrawProgressBar" );
+   prepareToyFactory( factory, 200, 23 );
+
+   // the batch size does not divide the 400 training events, so that the
+   // last, incomplete, batch of each epoch is carried to the next one
+   const char* titles[] = { "BP", "BPDense", "BFGS", "BFGSDense" };
+   const char* options[] = {
+      "!H:!V:RandomSeed=5:NCycles=20:TestRate=5:HiddenLayers=N+3:TrainingMethod=BP:BPMode=batch:BatchSize=30",
+      "!H:!V:RandomSeed=5:NCycles=20:TestRate=5:HiddenLayers=N+3:TrainingMethod=BP:BPMode=batch:BatchSize=30:DenseBackend:NThreads=3",
+      "!H:!V:RandomSeed=5:NCycles=20:TestRate=5:HiddenLayers=N+3:TrainingMethod=BFGS:!UseRegulator",
+      "!H:!V:RandomSeed=5:NCycles=20:TestRate=5:HiddenLayers=N+3:TrainingMethod=BFGS:!UseRegulator:DenseBackend:NThreads=3" };
+   for (UInt_t m = 0; m < 4; m++) factory->BookMethod( Types::kMLP, titles[m], options[m] );
+   factory->TrainAllMethods();
+   delete factory;
+   outputFile->Close();
+   delete outputFile;
+
+   float var0, var1;
+   Reader reader( "!Color:Silent" );
+   reader.AddVariable( "var0", &var0 );
+   reader.AddVariable( "var1", &var1 );
+   for (UInt_t m = 0; m < 4; m++) reader.BookMVA( titles[m], TString("weights/MLPDense_") + titles[m] + ".weights.xml" );
+
+   // the sums are done in another order, so the outputs agree up to rounding
+   for (int i = 0; i < 21; i++) {
+      for (int j = 0; j < 21; j++) {
+         var0 = -2. + 0.2*i;
+         var1 = -2. + 0.2*j;
+         for (UInt_t m = 0; m < 4; m += 2) {
+            Double_t neurons = reader.EvaluateMVA( titles[m] );
+            Double_t dense   = reader.EvaluateMVA( titles[m+1] );
+            test_(TMath::Abs(dense-neurons) <= 1.e-6*TMath::Max(1.,TMath::Abs(neurons)));
+         }
+      }
+   }
+}
+
+// including file tmvaut/utFactoryNumCPU.h
+#ifndef UTFACTORYNUMCPU_H
+#define UTFACTORYNUMCPU_H
+
+// TMVA unit tests
+//
+// compares the methods tested and evaluated in parallel threads (Factory
+// option NumCPU) with the ones tested and evaluated in the current thread
+
+#include <string>
+
+namespace UnitTesting
+{
+  class utFactoryNumCPU : public UnitTest
+  {
+  public:
+    utFactoryNumCPU(const char* theOption="");
+    virtual ~utFactoryNumCPU();
+
+    virtual void run();
+
+  private:
+     void train(const char* jobName, Int_t numCPU);
+
+     // disallow copy constructor and assignment
+     utFactoryNumCPU(const utFactoryNumCPU&);
+     utFactoryNumCPU& operator=(const utFactoryNumCPU&);
+  };
+} // namespace UnitTesting
+#endif //
+// including file tmvaut/utFactoryNumCPU.cxx
+
+
+#include <string>
+
+#include "TFile.h"
+#include "TH1.h"
+
+#include "TMVA/Factory.h"
+#include "TMVA/Reader.h"
+
+
+
+using namespace std;
+using namespace UnitTesting;
+using namespace TMVA;
+
+static const char* gNumCPUMethods[] = { "LD", "MLP", "BDT" };
+
+utFactoryNumCPU::utFactoryNumCPU(const char* /*theOption*/)
+   : UnitTest(string("FactoryNumCPU"))
+{
+
+}
+utFactoryNumCPU::~utFactoryNumCPU(){ }
+
+void utFactoryNumCPU::train(const char* jobName, Int_t numCPU)
+{
+   TFile* outputFile = TFile::Open( TString::Format("weights/%s.root", jobName), "RECREATE" );
+   Factory* factory = new Factory( jobName, outputFile,
+                                   TString::Format("!V:Silent:Transformations=I:AnalysisType=Classification:!Color:!DrawProgressBar:NumCPU=%d", numCPU) );
+   prepareToyFactory( factory, 300, 31 );
+
+   factory->BookMethod( Types::kLD,  "LD",  "!H:!V" );
+   factory->BookMethod( Types::kMLP, "MLP", "!H:!V:NCycles=50:HiddenLayers=N+2:TestRate=10" );
+   factory->BookMethod( Types::kBDT, "BDT", "!H:!V:NTrees=50:MaxDepth=3" );
+   factory->TrainAllMethods();
+   factory->TestAllMethods();
+   factory->EvaluateAllMethods();
+   delete factory;
+   outputFile->Close();
+   delete outputFile;
+}
+
+void utFactoryNumCPU::run()
+{
+   train( "NumCPU1", 1 );
+   train( "NumCPU3", 3 );
+
+   // the evaluation histograms of the methods tested in the threads are the same
+   TFile* outputFile1 = TFile::Open( "weights/NumCPU1.root" );
+   TFile* outputFile3 = TFile::Open( "weights/NumCPU3.root" );
+   test_(outputFile1 != 0 && outputFile3 != 0);
+   if (outputFile1 == 0 || outputFile3 == 0) { delete outputFile1; delete outputFile3; return; }
+   for (UInt_t m = 0; m < 3; m++) {
+      TString name = TString::Format("Method_%s/%s/MVA_%s_S", gNumCPUMethods[m], gNumCPUMethods[m], gNumCPUMethods[m]);
+      TH1* hist1 = dynamic_cast<TH1*>(outputFile1->Get( name ));
+      TH1* hist3 = dynamic_cast<TH1*>(outputFile3->Get( name ));
+      test_(hist1 != 0 && hist3 != 0);
+      if (hist1 == 0 || hist3 == 0) continue;
+      Bool_t sameHist = (hist1->GetNbinsX() == hist3->GetNbinsX());
+      for (Int_t bin = 0; sameHist && bin <= hist1->GetNbinsX()+1; bin++)
+         sameHist = (hist1->GetBinContent( bin ) == hist3->GetBinContent( bin ));
+      test_(sameHist);
+   }
+   delete outputFile1;
+   delete outputFile3;
+
+   // the same methods are trained
+   float var0, var1;
+   Reader reader( "!Color:Silent" );
+   reader.AddVariable( "var0", &var0 );
+   reader.AddVariable( "var1", &var1 );
+   for (UInt_t m = 0; m < 3; m++) {
+      reader.BookMVA( TString("1") + gNumCPUMethods[m], TString("weights/NumCPU1_") + gNumCPUMethods[m] + ".weights.xml" );
+      reader.BookMVA( TString("3") + gNumCPUMethods[m], TString("weights/NumCPU3_") + gNumCPUMethods[m] + ".weights.xml" );
+   }
+   Bool_t same = kTRUE;
+   for (int i = 0; i < 21; i++) {
+      for (int j = 0; j < 21; j++) {
+         var0 = -2. + 0.2*i;
+         var1 = -2. + 0.2*j;
+         for (UInt_t m = 0; m < 3; m++)
+            same &= (reader.EvaluateMVA( TString("1") + gNumCPUMethods[m] ) == reader.EvaluateMVA( TString("3") + gNumCPUMethods[m] ));
+      }
+   }
+   test_(same);
+}
+
 // including file tmvaut/utFactory.h
 #ifndef UTFACTORY_H
 #define UTFACTORY_H
@@ -3008,6 +3544,10 @@ int main(int argc, char **argv)
    TMVA_test.addTest(new utFactory);
    TMVA_test.addTest(new utReader);
    TMVA_test.addTest(new utReaderMT);
+   TMVA_test.addTest(new utReaderBatch);
+   TMVA_test.addTest(new utDecisionTree);
+   TMVA_test.addTest(new utMLPDense);
+   TMVA_test.addTest(new utFactoryNumCPU);
 
    addClassificationTests(TMVA_test, full);
    addRegressionTests(TMVA_test, full);
@@ -0,0 +1,455 @@
+// @(#)root/test:$Id$
+
+// Program checking that the multi-threaded and the bulk parts of the TTree
+// I/O give the same results as the sequential, entry by entry code. Each
+// test prints one line with OK or FAILED.
+//
+// To run this program do:
+//    stressTreeIO [nthreads]
+// The default is 4 threads of the global TTaskPool.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "TROOT.h"
+#include "TBranch.h"
+#include "TBufferFile.h"
+#include "TChain.h"
+#include "TDirectory.h"
+#include "TEnv.h"
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TH1.h"
+#include "TMutex.h"
+#include "TSystem.h"
+#include "TTaskPool.h"
+#include "TTree.h"
+#include "TTreeCache.h"
+#include "TTreeProcessor.h"
+#include "TTreeReader.h"
+#include "TTreeReaderValue.h"
+
+static Int_t gNFailed = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the title of the test.
+
+void Bprint(Int_t id, const char *title)
+{
+   const Int_t kMAX = 65;
+   char header[80];
+   snprintf(header,80,"Test %2d : %s",id,title);
+   Int_t nch = strlen(header);
+   for (Int_t i=nch;i<kMAX;i++) header[i] = '.';
+   header[kMAX] = 0;
+   header[kMAX-1] = ' ';
+   printf("%s",header);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the result of the test.
+
+void Result(Bool_t ok)
+{
+   if (ok) {
+      printf(" OK\n");
+   } else {
+      printf(" FAILED\n");
+      ++gNFailed;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write in filename a tree of nentries entries, with a small auto flush so
+/// that the tree has many clusters. If dirname is given, the tree is written
+/// in this subdirectory of the file. If async is true, the baskets are
+/// written by the writer thread of the file.
+
+void WriteTree(const char *filename, const char *dirname, const char *treename, Int_t first, Int_t nentries,
+               Bool_t async = kFALSE)
+{
+   TFile file(filename, "RECREATE");
+   TDirectory *dir = &file;
+   if (dirname) dir = file.mkdir(dirname);
+   dir->cd();
+   TTree *tree = new TTree(treename, "stressTreeIO tree");
+   tree->SetAutoFlush(-4000);
+   Int_t   i;
+   Float_t x;
+   tree->Branch("i", &i, "i/I");
+   tree->Branch("x", &x, "x/F");
+   if (async) tree->SetAsyncWriting();
+   for (Int_t ev = 0; ev < nentries; ++ev) {
+      i = first + ev;
+      x = 0.5f * i;
+      tree->Fill();
+   }
+   dir->Write();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process with TTreeProcessor a TChain whose files contain trees of
+/// different names and compare the sums with the sequential loop.
+
+void stress1()
+{
+   Bprint(1, "TTreeProcessor on a TChain of different tree names");
+
+   WriteTree("stressTreeIO_1.root", 0, "T", 0, 20000);
+   WriteTree("stressTreeIO_2.root", "dir", "T2", 20000, 15000);
+   WriteTree("stressTreeIO_3.root", 0, "T", 35000, 10000);
+
+   TChain chain("T");
+   chain.Add("stressTreeIO_1.root");
+   chain.Add("stressTreeIO_2.root/dir/T2");
+   chain.Add("stressTreeIO_3.root");
+
+   Long64_t serialN = 0;
+   Double_t serialSum = 0;
+   {
+      TTreeReader reader(&chain);
+      TTreeReaderValue<Int_t>   i(reader, "i");
+      TTreeReaderValue<Float_t> x(reader, "x");
+      while (reader.Next()) {
+         ++serialN;
+         serialSum += *i + *x;
+      }
+   }
+
+   Long64_t n = 0;
+   Double_t sum = 0;
+   TMutex mutex;
+   TTreeProcessor processor(chain);
+   processor.Process([&](TTreeReader &reader) {
+      TTreeReaderValue<Int_t>   i(reader, "i");
+      TTreeReaderValue<Float_t> x(reader, "x");
+      Long64_t localN = 0;
+      Double_t localSum = 0;
+      while (reader.Next()) {
+         ++localN;
+         localSum += *i + *x;
+      }
+      TLockGuard lock(&mutex);
+      n += localN;
+      sum += localSum;
+   });
+
+   Bool_t ok = serialN == 45000 && n == serialN && sum == serialSum &&
+               !strcmp(processor.GetTreeName(1), "dir/T2");
+   Result(ok);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the branch name of tree in bulk, starting at entry first, and
+/// compare the values with the ones read entry by entry.
+
+template <typename T>
+Bool_t CompareBulk(TTree *tree, const char *name, Long64_t first)
+{
+   TBranch *branch = tree->GetBranch(name);
+   T value;
+   branch->SetAddress(&value);
+
+   TBufferFile deserialized(TBuffer::kWrite, 1000);
+   TBufferFile serialized(TBuffer::kWrite, 1000);
+   Long64_t nentries = tree->GetEntries();
+   Long64_t entry = first;
+   while (entry < nentries) {
+      Int_t n = branch->GetEntriesDeserialized(entry, deserialized);
+      if (n <= 0) return kFALSE;
+      if (branch->GetEntriesSerialized(entry, serialized) != n) return kFALSE;
+      const T *values = (const T*)deserialized.Buffer();
+      char *raw = serialized.Buffer();
+      for (Int_t i = 0; i < n; ++i) {
+         T swapped;
+         frombuf(raw, &swapped);
+         branch->GetEntry(entry + i);
+         if (values[i] != value || swapped != value) return kFALSE;
+      }
+      entry += n;
+   }
+   branch->ResetAddress();
+   return entry == nentries;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compare the bulk reading of the branches with fixed-size leaves with the
+/// reading entry by entry.
+
+void stress2()
+{
+   Bprint(2, "Bulk reading of branches of fixed-size leaves");
+
+   {
+      TFile file("stressTreeIO_bulk.root", "RECREATE");
+      TTree *tree = new TTree("T", "stressTreeIO bulk tree");
+      Short_t  s;
+      Int_t    i;
+      Long64_t l;
+      Float_t  x;
+      Double_t d;
+      tree->Branch("s", &s, "s/S");
+      tree->Branch("i", &i, "i/I");
+      tree->Branch("l", &l, "l/L");
+      tree->Branch("x", &x, "x/F");
+      tree->Branch("d", &d, "d/D", 4000);
+      for (Int_t ev = 0; ev < 10000; ++ev) {
+         s = ev % 3000 - 1500;
+         i = ev * 7 - 20000;
+         l = 1000000007LL * ev;
+         x = 0.25f * ev;
+         d = 1.0 / (ev + 1);
+         tree->Fill();
+      }
+      file.Write();
+   }
+
+   TFile file("stressTreeIO_bulk.root");
+   TTree *tree = 0;
+   file.GetObject("T", tree);
+   Bool_t ok = tree != 0;
+   if (ok) {
+      ok = CompareBulk<Short_t>(tree, "s", 0) && CompareBulk<Int_t>(tree, "i", 0) &&
+           CompareBulk<Long64_t>(tree, "l", 0) && CompareBulk<Float_t>(tree, "x", 0) &&
+           CompareBulk<Double_t>(tree, "d", 0) && CompareBulk<Double_t>(tree, "d", 1234);
+   }
+   Result(ok);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the input files of stress3 into output, with njobs groups merged
+/// in parallel.
+
+Bool_t MergeFiles(const char *output, Int_t njobs, Int_t ninputs)
+{
+   TFileMerger merger(kFALSE);
+   merger.SetPrintLevel(0);
+   merger.SetNJobs(njobs);
+   if (!merger.OutputFile(output, "RECREATE")) return kFALSE;
+   for (Int_t f = 0; f < ninputs; ++f) {
+      if (!merger.AddFile(TString::Format("stressTreeIO_merge%d.root", f))) return kFALSE;
+   }
+   return merger.Merge();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compare the tree and the histogram of the merged files name1 and name2.
+
+Bool_t CompareMerged(const char *name1, const char *name2, Long64_t nentries)
+{
+   TFile file1(name1);
+   TFile file2(name2);
+   TTree *tree1 = 0, *tree2 = 0;
+   TH1F *h1 = 0, *h2 = 0;
+   file1.GetObject("T", tree1);
+   file2.GetObject("T", tree2);
+   file1.GetObject("h", h1);
+   file2.GetObject("h", h2);
+   if (!tree1 || !tree2 || !h1 || !h2) return kFALSE;
+   if (tree1->GetEntries() != nentries || tree2->GetEntries() != nentries) return kFALSE;
+
+   Int_t i1, i2;
+   Float_t x1, x2;
+   tree1->SetBranchAddress("i", &i1);
+   tree1->SetBranchAddress("x", &x1);
+   tree2->SetBranchAddress("i", &i2);
+   tree2->SetBranchAddress("x", &x2);
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      tree1->GetEntry(entry);
+      tree2->GetEntry(entry);
+      // The entries are in the order of the input files.
+      if (i1 != entry || i2 != i1 || x2 != x1) return kFALSE;
+   }
+
+   if (h1->GetEntries() != h2->GetEntries()) return kFALSE;
+   for (Int_t bin = 0; bin <= h1->GetNbinsX() + 1; ++bin) {
+      if (h1->GetBinContent(bin) != h2->GetBinContent(bin)) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge files with TFileMerger, sequentially and with several groups of
+/// files merged in parallel, and compare the results.
+
+void stress3()
+{
+   Bprint(3, "Parallel TFileMerger against the sequential merge");
+
+   const Int_t ninputs = 8;
+   const Int_t nentries = 3000;
+   for (Int_t f = 0; f < ninputs; ++f) {
+      TString name = TString::Format("stressTreeIO_merge%d.root", f);
+      WriteTree(name, 0, "T", f * nentries, nentries);
+      TFile file(name, "UPDATE");
+      TH1F h("h", "stressTreeIO merge", 100, 0, ninputs * nentries);
+      for (Int_t i = 0; i < nentries; ++i) h.Fill(f * nentries + i, 0.5 + f);
+      h.Write();
+   }
+
+   Bool_t ok = MergeFiles("stressTreeIO_merged1.root", 1, ninputs) &&
+               MergeFiles("stressTreeIO_merged3.root", 3, ninputs) &&
+               CompareMerged("stressTreeIO_merged1.root", "stressTreeIO_merged3.root", ninputs * nentries);
+   Result(ok);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the same tree synchronously and with the writer thread of the file,
+/// with a small queue so that the filling thread has to wait for the writer,
+/// and compare the entries read back.
+
+void stress4()
+{
+   Bprint(4, "Baskets written by the writer thread of the file");
+
+   const Int_t nentries = 100000;
+   Long64_t oldsize = TFile::GetAsyncWriteSize();
+   TFile::SetAsyncWriteSize(20000);
+   WriteTree("stressTreeIO_sync.root", 0, "T", 0, nentries);
+   WriteTree("stressTreeIO_async.root", 0, "T", 0, nentries, kTRUE);
+   TFile::SetAsyncWriteSize(oldsize);
+
+   TFile file1("stressTreeIO_sync.root");
+   TFile file2("stressTreeIO_async.root");
+   TTree *tree1 = 0, *tree2 = 0;
+   file1.GetObject("T", tree1);
+   file2.GetObject("T", tree2);
+   Bool_t ok = tree1 && tree2 && tree1->GetEntries() == nentries && tree2->GetEntries() == nentries;
+   if (ok) {
+      Int_t i1, i2;
+      Float_t x1, x2;
+      tree1->SetBranchAddress("i", &i1);
+      tree1->SetBranchAddress("x", &x1);
+      tree2->SetBranchAddress("i", &i2);
+      tree2->SetBranchAddress("x", &x2);
+      for (Long64_t entry = 0; ok && entry < nentries; ++entry) {
+         tree1->GetEntry(entry);
+         tree2->GetEntry(entry);
+         ok = i1 == entry && i2 == i1 && x2 == x1;
+      }
+   }
+   Result(ok);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Directory of the learning profiles of stress5.
+
+TString ProfileDir()
+{
+   return TString::Format("%s/stressTreeIO_profiles_%d", gSystem->TempDirectory(), gSystem->GetPid());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the branches i and, if readx is true, x of all the entries of the
+/// tree of stressTreeIO_profile.root with a TTreeCache. Return the cache
+/// state after the first entry in loaded, and whether x ended up in the
+/// cache in xcached.
+
+Bool_t ReadWithProfile(Bool_t readx, Bool_t &loaded, Bool_t &xcached)
+{
+   TFile file("stressTreeIO_profile.root");
+   TTree *tree = 0;
+   file.GetObject("T", tree);
+   if (!tree) return kFALSE;
+   tree->SetCacheSize(10000000);
+   TTreeCache *cache = dynamic_cast<TTreeCache*>(file.GetCacheRead(tree));
+   if (!cache) return kFALSE;
+
+   Int_t i;
+   Float_t x;
+   TBranch *bi = tree->GetBranch("i");
+   TBranch *bx = tree->GetBranch("x");
+   bi->SetAddress(&i);
+   bx->SetAddress(&x);
+   Bool_t ok = kTRUE;
+   for (Long64_t entry = 0; ok && entry < tree->GetEntries(); ++entry) {
+      tree->LoadTree(entry);
+      bi->GetEntry(entry);
+      if (readx) {
+         bx->GetEntry(entry);
+         ok = x == 0.5f * i;
+      }
+      ok = ok && i == entry;
+      if (entry == 0) loaded = cache->IsProfileLoaded();
+   }
+   xcached = cache->GetCachedBranches()->FindObject(bx) != 0;
+   return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Save the learning profile of a job reading the branch i, then check that
+/// a job reading the branches i and x loads this profile and still caches
+/// the branch x, missing from the profile.
+
+void stress5()
+{
+   Bprint(5, "TTreeCache learning profile hit and miss");
+
+   TString olddir = gEnv->GetValue("TTreeCache.ProfileDir", "");
+   gEnv->SetValue("TTreeCache.ProfileDir", ProfileDir());
+   WriteTree("stressTreeIO_profile.root", 0, "T", 0, 20000);
+
+   Bool_t loaded1 = kTRUE, loaded2 = kFALSE, loaded3 = kFALSE;
+   Bool_t xcached1 = kTRUE, xcached2 = kFALSE, xcached3 = kFALSE;
+   // Learn and save the profile, then hit it and add x, then hit the updated profile.
+   Bool_t ok = ReadWithProfile(kFALSE, loaded1, xcached1) &&
+               ReadWithProfile(kTRUE, loaded2, xcached2) &&
+               ReadWithProfile(kTRUE, loaded3, xcached3);
+   ok = ok && !loaded1 && !xcached1 && loaded2 && xcached2 && loaded3 && xcached3;
+
+   gEnv->SetValue("TTreeCache.ProfileDir", olddir);
+   Result(ok);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove the files written by the tests.
+
+void cleanup()
+{
+   gSystem->Unlink("stressTreeIO_1.root");
+   gSystem->Unlink("stressTreeIO_2.root");
+   gSystem->Unlink("stressTreeIO_3.root");
+   gSystem->Unlink("stressTreeIO_bulk.root");
+   for (Int_t f = 0; f < 8; ++f) {
+      gSystem->Unlink(TString::Format("stressTreeIO_merge%d.root", f));
+   }
+   gSystem->Unlink("stressTreeIO_merged1.root");
+   gSystem->Unlink("stressTreeIO_merged3.root");
+   gSystem->Unlink("stressTreeIO_sync.root");
+   gSystem->Unlink("stressTreeIO_async.root");
+   gSystem->Unlink("stressTreeIO_profile.root");
+   TString profiles = ProfileDir();
+   if (void *dir = gSystem->OpenDirectory(profiles)) {
+      while (const char *name = gSystem->GetDirEntry(dir)) {
+         if (strcmp(name, ".") && strcmp(name, ".."))
+            gSystem->Unlink(profiles + "/" + name);
+      }
+      gSystem->FreeDirectory(dir);
+      gSystem->Unlink(profiles);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+   gROOT->SetBatch();
+   Int_t nthreads = 4;
+   if (argc > 1) nthreads = atoi(argv[1]);
+   TTaskPool::SetGlobalPoolSize(nthreads);
+
+   printf("******************************************************************\n");
+   printf("*  Starting  stressTreeIO with %d threads\n", nthreads);
+   printf("******************************************************************\n");
+
+   stress1();
+   stress2();
+   stress3();
+   stress4();
+   stress5();
+
+   cleanup();
+   TTaskPool::SetGlobalPoolSize(0);
+   return gNFailed ? 1 : 0;
+}
@@ -77,7 +77,7 @@ include/TMVA/%.h: $(TMVADIRI)/TMVA/%.h
 $(TMVALIB):     $(TMVAO) $(TMVADO) $(ORDER_) $(MAINLIBS) $(TMVALIBDEP)
 		@$(MAKELIB) $(PLATFORM) $(LD) "$(LDFLAGS)" \
 		   "$(SOFLAGS)" libTMVA.$(SOEXT) $@ "$(TMVAO) $(TMVADO)" \
-		   "$(TMVALIBEXTRA)"
+		   "$(TMVALIBEXTRA) $(OSTHREADLIBDIR) $(OSTHREADLIB)"
 
 $(call pcmrule,TMVA)
 	$(noop)
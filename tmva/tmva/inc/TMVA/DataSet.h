@@ -92,12 +92,12 @@ namespace TMVA {
 
       // const getters
       const Event*    GetEvent()                        const; // returns event without transformations
-      const Event*    GetEvent        ( Long64_t ievt ) const { fCurrentEventIdx = ievt; return GetEvent(); } // returns event without transformations
+      const Event*    GetEvent        ( Long64_t ievt ) const { CurrentEventIdx() = ievt; return GetEvent(); } // returns event without transformations
       const Event*    GetTrainingEvent( Long64_t ievt ) const { return GetEvent(ievt, Types::kTraining); }
       const Event*    GetTestEvent    ( Long64_t ievt ) const { return GetEvent(ievt, Types::kTesting); }
       const Event*    GetEvent        ( Long64_t ievt, Types::ETreeType type ) const 
       {
-         fCurrentTreeIdx = TreeIndex(type); fCurrentEventIdx = ievt; return GetEvent();
+         CurrentTreeIdx() = TreeIndex(type); CurrentEventIdx() = ievt; return GetEvent();
       }
 
 
@@ -107,14 +107,26 @@ namespace TMVA {
       UInt_t    GetNTargets()     const;
       UInt_t    GetNSpectators()  const;
 
-      void      SetCurrentEvent( Long64_t ievt         ) const { fCurrentEventIdx = ievt; }
-      void      SetCurrentType ( Types::ETreeType type ) const { fCurrentTreeIdx = TreeIndex(type); }
+      void      SetCurrentEvent( Long64_t ievt         ) const { CurrentEventIdx() = ievt; }
+      void      SetCurrentType ( Types::ETreeType type ) const { CurrentTreeIdx() = TreeIndex(type); }
       Types::ETreeType GetCurrentType() const;
 
+      // gives the calling thread its own current tree type and event (see DataSet.cxx)
+      void      UseThreadPosition( Bool_t flag ) const;
+
       void                       SetEventCollection( std::vector<Event*>*, Types::ETreeType );
       const std::vector<Event*>& GetEventCollection( Types::ETreeType type = Types::kMaxTreeType ) const;
       const TTree*               GetEventCollectionAsTree();
 
+      // columns holding the variables and classes of the events of a tree type (see DataSet.cxx)
+      const Float_t* GetColumn     ( UInt_t ivar, Types::ETreeType type = Types::kMaxTreeType ) const;
+      const UInt_t*  GetClassColumn( Types::ETreeType type = Types::kMaxTreeType ) const;
+
+      // column-wise copy of a block of events of a tree type (see DataSet.cxx)
+      void      GetColumnBlock( Long64_t first, UInt_t n, std::vector<Float_t>& values, std::vector<UInt_t>& classes,
+                                std::vector<Double_t>& weights, Types::ETreeType type = Types::kMaxTreeType ) const;
+      static UInt_t GetColumnBlockSize() { return fgColumnBlockSize; }
+
       Long64_t  GetNEvtSigTest();
       Long64_t  GetNEvtBkgdTest();
       Long64_t  GetNEvtSigTrain();
@@ -148,6 +160,7 @@ namespace TMVA {
       void      InitSampling( Float_t fraction, Float_t weight, UInt_t seed = 0 );
       void      EventResult( Bool_t successful, Long64_t evtNumber = -1 );
       void      CreateSampling() const;
+      Bool_t    HasSampling( Types::ETreeType type = Types::kMaxTreeType ) const;
 
       UInt_t    TreeIndex(Types::ETreeType type) const;
 
@@ -156,6 +169,7 @@ namespace TMVA {
       // data members
       DataSet();
       void DestroyCollection( Types::ETreeType type, Bool_t deleteEvents );
+      void BuildColumns( UInt_t treeIdx );
 
       const DataSetInfo&         fdsi;                //! datasetinfo that created this dataset
 
@@ -164,8 +178,14 @@ namespace TMVA {
 
       std::vector< std::map< TString, Results* > > fResults;         //!  [train/test/...][method-identifier]
 
+      std::vector< std::vector<Float_t> > fColumns;        //! values of the variables of the events set for each tree type [train/test/...][ivar*nevents+ievt]
+      std::vector< std::vector<UInt_t> >  fClassColumns;   //! classes of these events [train/test/...][ievt]
+      std::vector<Int_t>                  fColumnIdx;      //! columns holding the events of each collection in their order, -1 if none
+
       mutable UInt_t             fCurrentTreeIdx;
       mutable Long64_t           fCurrentEventIdx;
+      UInt_t&                    CurrentTreeIdx()  const;  // fCurrentTreeIdx, or the one of the calling thread
+      Long64_t&                  CurrentEventIdx() const;  // fCurrentEventIdx, or the one of the calling thread
 
       // event sampling
       std::vector<Char_t>        fSampling;                    // random or importance sampling (not all events are taken) !! Bool_t are stored ( no std::vector<bool> taken for speed (performance) issues )
@@ -182,6 +202,8 @@ namespace TMVA {
 
       Bool_t                     fHasNegativeEventWeights;     // true if at least one signal or bkg event has negative weight
 
+      static const UInt_t        fgColumnBlockSize = 1024;     // number of events per block of GetColumnBlock
+
       mutable MsgLogger*         fLogger;   // message logger
       MsgLogger& Log() const { return *fLogger; }
       std::vector<Char_t>        fBlockBelongToTraining;       // when dividing the dataset to blocks, sets whether 
@@ -200,19 +222,19 @@ namespace TMVA {
 inline UInt_t TMVA::DataSet::TreeIndex(Types::ETreeType type) const
 {
    switch (type) {
-   case Types::kMaxTreeType : return fCurrentTreeIdx;
+   case Types::kMaxTreeType : return CurrentTreeIdx();
    case Types::kTraining : return 0;
    case Types::kTesting : return 1;
    case Types::kValidation : return 2;
    case Types::kTrainingOriginal : return 3;
-   default : return fCurrentTreeIdx;
+   default : return CurrentTreeIdx();
    }
 }
 
 //_______________________________________________________________________
 inline TMVA::Types::ETreeType TMVA::DataSet::GetCurrentType() const
 {
-   switch (fCurrentTreeIdx) {
+   switch (CurrentTreeIdx()) {
    case 0: return Types::kTraining;
    case 1: return Types::kTesting;
    case 2: return Types::kValidation;
@@ -231,6 +253,13 @@ inline Long64_t TMVA::DataSet::GetNEvents(Types::ETreeType type) const
    return GetEventCollection(type).size();
 }
 
+//_______________________________________________________________________
+inline Bool_t TMVA::DataSet::HasSampling(Types::ETreeType type) const
+{
+   Int_t treeIdx = TreeIndex(type);
+   return fSampling.size() > UInt_t(treeIdx) && fSampling.at(treeIdx);
+}
+
 //_______________________________________________________________________
 inline const std::vector<TMVA::Event*>& TMVA::DataSet::GetEventCollection( TMVA::Types::ETreeType type ) const
 {
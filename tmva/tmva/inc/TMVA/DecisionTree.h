@@ -40,6 +40,9 @@
 //                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
+#include <functional>
+#include <vector>
+
 #ifndef ROOT_TH2
 #include "TH2.h"
 #endif
@@ -200,6 +203,9 @@ namespace TMVA {
       inline void SetMinLinCorrForFisher(Double_t min){fMinLinCorrForFisher = min;}
       inline void SetUseExclusiveVars(Bool_t t=kTRUE){fUseExclusiveVars = t;}
       inline void SetNVars(Int_t n){fNvars = n;}
+      // bin the variables once per tree on the range of the whole sample (see BuildTree)
+      inline void SetPreBinning(Bool_t b=kTRUE){fPreBinning = b;}
+      inline Bool_t GetPreBinning() const {return fPreBinning;}
 
 
    private:
@@ -211,6 +217,23 @@ namespace TMVA {
       // calculates the purity S/(S+B) of a given event sample
       Double_t SamplePurity(EventList eventSample);
 
+      // histograms of the variables of a node, one variable after the other
+      struct NodeHistograms;
+
+      // building and splitting of the nodes with the pre-binned variables: rows are the
+      // indices of the events in fBinCodes and hist the histograms of the node, filled
+      // when empty
+      UInt_t BuildTree( const EventConstList & eventSample, DecisionTreeNode *node,
+                        const std::vector<UInt_t>* rows, NodeHistograms* hist );
+      Double_t TrainNodeFast( const EventConstList & eventSample, DecisionTreeNode *node,
+                              const std::vector<UInt_t>* rows, NodeHistograms* hist );
+      Bool_t PreBinVariables( const EventConstList & eventSample );
+      void FillBinnedHistograms( const EventConstList & eventSample, const std::vector<UInt_t> & rows,
+                                 NodeHistograms & hist ) const;
+      static void FillInChunks( UInt_t nevents, UInt_t nbins, Bool_t regression,
+                                const std::function<void(UInt_t,UInt_t,NodeHistograms&)> & fill,
+                                NodeHistograms & hist );
+
       UInt_t    fNvars;          // number of variables used to separate S and B
       Int_t     fNCuts;          // number of grid point in variable cut scans
       Bool_t    fUseFisherCuts;  // use multivariate splits using the Fisher criterium
@@ -249,6 +272,15 @@ namespace TMVA {
 
       DataSetInfo*  fDataSetInfo;
 
+      Bool_t    fPreBinning;     // bin the variables once per tree instead of in each node
+      std::vector<UShort_t> fBinCodes;  //! bin of each variable of the events the tree is built from
+      std::vector<Double_t> fBinMin;    //! lower edge of the grid of each pre-binned variable
+      std::vector<Double_t> fBinMax;    //! upper edge of the grid of each pre-binned variable
+      std::vector<UInt_t>   fBinCount;  //! number of bins of each pre-binned variable
+      std::vector<UInt_t>   fBinOffset; //! first bin of each pre-binned variable in the node histograms
+      static const UInt_t fgEventsPerChunk = 10000; // minimal number of events filled by one task
+      static const UInt_t fgMaxChunks = 64;         // maximal number of tasks filling the histograms of a node
+
 
       ClassDef(DecisionTree,0)               // implementation of a Decision Tree
    };
@@ -92,6 +92,7 @@ namespace TMVA {
       Float_t  GetValue( UInt_t ivar) const;
       std::vector<Float_t>& GetValues() 
       {
+          DetachColumnView(); // the caller may change the values
 	  //For a detailed explanation, please see the heading "Avoid Duplication in const and Non-const Member Function," on p. 23, in Item 3 "Use const whenever possible," in Effective C++, 3d ed by Scott Meyers, ISBN-13: 9780321334879.
 	  // http://stackoverflow.com/questions/123758/how-do-i-remove-code-duplication-between-similar-const-and-non-const-member-func
 	  return const_cast<std::vector<Float_t>&>( static_cast<const Event&>(*this).GetValues() );
@@ -116,6 +117,10 @@ namespace TMVA {
       void     SetVariableArrangement( std::vector<UInt_t>* const m ) const;
 
       void     SetDoNotBoost         () const  { fDoNotBoost = kTRUE; }
+
+      // values read from the columns of a DataSet (see DataSet::SetEventCollection)
+      void     SetColumnView( Float_t* first, Long64_t stride );
+      Bool_t   IsColumnView() const { return fColumnValues != 0; }
       static void ClearDynamicVariables() {}
 
       void     CopyVarValues( const Event& other );
@@ -125,6 +130,10 @@ namespace TMVA {
       static   void SetIgnoreNegWeightsInTraining(Bool_t);
    private:
 
+      UInt_t   GetNValues() const { return fColumnValues ? fNColumnValues : fValues.size(); }
+      Float_t  GetColumnValue( UInt_t ivar ) const { return fColumnValues[ivar*fColumnStride]; }
+      void     DetachColumnView();
+
       static   Bool_t          fgIsTraining;    // mark if we are in an actual training or "evaluation/testing" phase --> ignoreNegWeights only in actual training !
       static   Bool_t          fgIgnoreNegWeightsInTraining;
 
@@ -142,6 +151,9 @@ namespace TMVA {
       mutable Double_t               fBoostWeight;     // internal weight to be set by boosting algorithm
       Bool_t                         fDynamic;         // is set when the dynamic values are taken
       mutable Bool_t                 fDoNotBoost;       // mark event as not to be boosted (used to compensate for events with negative event weights
+      Float_t*                       fColumnValues;     // value of the first variable of the event in the columns of a DataSet, 0 if the values are in fValues
+      Long64_t                       fColumnStride;     // distance between the values of two consecutive variables in these columns
+      UInt_t                         fNColumnValues;    // number of variables of the event in these columns
    };
 }
 
@@ -256,6 +256,7 @@ namespace TMVA {
       TString                                   fOptions;         //! option string given by construction (presently only "V")
       TString                                   fTransformations; //! List of transformations to test
       Bool_t                                    fVerbose;         //! verbose mode
+      Int_t                                     fNumCPU;          //! number of threads testing and evaluating the methods in parallel
 
       MVector                                   fMethods;         //! all MVA methods
       TString                                   fJobName;         //! jobname, used as extension in weight file names
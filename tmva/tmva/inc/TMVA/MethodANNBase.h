@@ -137,6 +137,9 @@ namespace TMVA {
       // calculate the MVA value
       virtual Double_t GetMvaValue( Double_t* err = 0, Double_t* errUpper = 0 );
 
+      // calculate the MVA values of a block of events with the dense form of the network
+      virtual Bool_t   GetMvaValues( const Float_t* input, UInt_t nEvents, Double_t* output ) const;
+
       virtual const std::vector<Float_t> &GetRegressionValues();
 
       virtual const std::vector<Float_t> &GetMulticlassValues();
@@ -171,6 +174,16 @@ namespace TMVA {
       void     ForceNetworkCalculations();
       void     WaitForKeyboard();
       
+      // dense (matrix) form of the network, used to process blocks of events
+      enum EDenseActivation { kDenseNone = -1, kDenseEval = 0, kDenseSigmoid, kDenseRadial };
+      Bool_t   HasDenseNetwork() const { return !fDenseLayout.empty(); }
+      void     GetDenseWeights( std::vector<Double_t>& weights ) const;
+      void     DenseForward( const Double_t* weights, const Double_t* input, UInt_t nEvents,
+                             std::vector< std::vector<Double_t> >& values,
+                             std::vector< std::vector<Double_t> >& activations ) const;
+      Double_t DenseActivation( UInt_t layer, Double_t x ) const;
+      Double_t DenseDerivative( UInt_t layer, Double_t x ) const;
+
       // accessors
       Int_t    NumCycles()  { return fNcycles;   }
       TNeuron* GetInputNeuron (Int_t index)       { return (TNeuron*)fInputLayer->At(index); }
@@ -184,6 +197,7 @@ namespace TMVA {
       TActivation*  fIdentity;        // activation for input and output layers
       TRandom3*     frgen;            // random number generator for various uses
       TNeuronInput* fInputCalculator; // input calculator for all neurons
+      std::vector<UInt_t> fDenseLayout; //! neurons of each layer without the bias, empty if the network has no dense form
 
       std::vector<Int_t>        fRegulatorIdx;  //index to different priors from every synapses
       std::vector<Double_t>     fRegulators;    //the priors as regulator
@@ -222,6 +236,10 @@ namespace TMVA {
                       Int_t layerIndex, Int_t numLayers, Bool_t from_file = false);
       void AddPreLinks(TNeuron* neuron, TObjArray* prevLayer);
      
+      // helper functions for the dense form of the network
+      void BuildDenseLayout();
+      static EDenseActivation GetDenseActivation( TActivation* activation );
+
       // helper functions for weight initialization
       void InitWeights();
       void ForceWeights(std::vector<Double_t>* weights);
@@ -238,6 +256,8 @@ namespace TMVA {
       TObjArray*              fInputLayer;      // cache this for fast access
       std::vector<TNeuron*>   fOutputNeurons;   // cache this for fast access
       TString                 fLayerSpec;       // layout specification option
+      EDenseActivation        fDenseHidden;     //! activation of the hidden layers in the dense form
+      EDenseActivation        fDenseOutput;     //! activation of the output layer in the dense form
 
       // some static flags
       static const Bool_t fgDEBUG      = kTRUE;  // debug flag
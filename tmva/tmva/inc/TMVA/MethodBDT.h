@@ -109,6 +109,9 @@ namespace TMVA {
       // calculate the MVA value
       Double_t GetMvaValue( Double_t* err = 0, Double_t* errUpper = 0);
 
+      // calculate the MVA values of a block of events using the flattened forest
+      Bool_t   GetMvaValues( const Float_t* input, UInt_t nEvents, Double_t* output ) const;
+
       // get the actual forest size (might be less than fNTrees, the requested one, if boosting is stopped early
       UInt_t   GetNTrees() const {return fForest.size();}
    private:
@@ -204,6 +207,10 @@ namespace TMVA {
       void     GetBaggedSubSample(std::vector<const TMVA::Event*>&);
       Double_t GetWeightedQuantile(std::vector<std::pair<Double_t, Double_t> > vec, const Double_t quantile, const Double_t SumOfWeights = 0.0);
 
+      // copy the forest into the flat arrays used by GetMvaValues
+      void     BuildFlatForest();
+      Bool_t   FlattenNode(const DecisionTreeNode *node, const DecisionTree *dt, Bool_t useYesNoLeaf);
+
       std::vector<const TMVA::Event*>       fEventSample;     // the training events
       std::vector<const TMVA::Event*>       fValidationSample;// the Validation events
       std::vector<const TMVA::Event*>       fSubSample;       // subsample for bagged grad boost
@@ -232,6 +239,7 @@ namespace TMVA {
       TString                         fMinNodeSizeS;    // string containing min percentage of training events in node
 
       Int_t                           fNCuts;           // grid used in cut applied in node splitting
+      Bool_t                          fPreBinning;      // bin the variables once per tree, on the grid of the whole training sample
       Bool_t                          fUseFisherCuts;   // use multivariate splits using the Fisher criterium
       Double_t                        fMinLinCorrForFisher; // the minimum linear correlation between two variables demanded for use in fisher criterium in node splitting
       Bool_t                          fUseExclusiveVars; // individual variables already used in fisher criterium are not anymore analysed individually for node splitting
@@ -274,6 +282,12 @@ namespace TMVA {
 
       std::vector<Double_t>            fVariableImportance; // the relative importance of the different variables
 
+      // flattened copy of the forest, all the trees stored one after the other
+      std::vector<Float_t>             fFlatCut;         //! cut value of the nodes, MVA response of the leaves
+      std::vector<Int_t>               fFlatSelector;    //! variable cut on in the nodes, -1 for the leaves
+      std::vector<UInt_t>              fFlatChildren;    //! daughters of node i, [2*i] below the cut and [2*i+1] above it
+      std::vector<UInt_t>              fFlatRoots;       //! index of the root node of each tree
+
 
       void                             DeterminePreselectionCuts(const std::vector<const TMVA::Event*>& eventSample);
       Double_t                         ApplyPreselectionCuts(const Event* ev);
@@ -177,6 +177,10 @@ namespace TMVA {
       // signal/background classification response
       Double_t GetMvaValue( const TMVA::Event* const ev, Double_t* err = 0, Double_t* errUpper = 0 );
 
+      // signal/background classification response of a block of events, stored column-wise
+      // (input[ivar*nEvents+iev]); returns kFALSE if the method provides no such evaluation
+      virtual Bool_t   GetMvaValues( const Float_t* /*input*/, UInt_t /*nEvents*/, Double_t* /*output*/ ) const { return kFALSE; }
+
    protected:
       // helper function to set errors to -1
       void NoErrorCalc(Double_t* const err, Double_t* const errUpper);
@@ -601,6 +605,9 @@ namespace TMVA {
 
       Bool_t           IgnoreEventsWithNegWeightsInTraining() const { return fIgnoreNegWeightsInTraining; }
 
+      // true if the events of the current tree type can be read from the columns of the DataSet
+      Bool_t           UseDataSetColumns() const;
+
       // for signal/background
       UInt_t           fSignalClass;           // index of the Signal-class
       UInt_t           fBackgroundClass;       // index of the Background-class
@@ -47,6 +47,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <vector>
+#include <map>
 #ifndef ROOT_TString
 #include "TString.h"
 #endif
@@ -159,6 +160,14 @@ namespace TMVA {
       Double_t GetMSEErr( const Event* ev, UInt_t index = 0 );   //zjh
       Double_t GetCEErr( const Event* ev, UInt_t index = 0 );   //zjh
 
+      // dense backend: error and gradient computed by blocks of events
+      Bool_t   UseDenseBackend() const { return fDenseBackend && HasDenseNetwork(); }
+      void     GatherDenseEvents( std::vector<Int_t>& used, std::vector<Int_t>* rows = 0 );
+      void     ClearDenseEvents();
+      Double_t DenseErrorAndGradient( const std::vector<Double_t>& weights, const Int_t* index, UInt_t n,
+                                      std::vector<Double_t>* dEdw );
+      void     AdjustSynapseWeightsDense( std::vector<Double_t>& weights, const std::vector<Int_t>& batch, Bool_t adjust );
+
       // backpropagation functions
       void     BackPropagationMinimize( Int_t nEpochs );
       void     TrainOneEpoch();
@@ -219,6 +228,15 @@ namespace TMVA {
       Int_t           fBatchSize;      // batch size, only matters if in batch learning mode
       Int_t           fTestRate;       // test for overtraining performed at each #th epochs
       Bool_t          fEpochMon;       // create and fill epoch-wise monitoring histograms (makes outputfile big!)
+
+      // dense backend variables
+      Bool_t          fDenseBackend;   // compute the error and its gradient with the dense form of the network
+      Int_t           fNThreads;       // number of threads sharing the blocks of events in the dense backend
+      Int_t           fDenseType;      //! tree type of the events in the dense cache, -1 if empty
+      std::vector<Double_t> fDenseInput;  //! input variables of the events, event by event
+      std::vector<Double_t> fDenseTarget; //! desired outputs of the events, event by event
+      std::vector<Double_t> fDenseWeight; //! weights of the events
+      std::map<const Event*, Int_t> fDenseRow; //! row of each event of the data set in the dense cache
       
       // genetic algorithm variables
       Int_t           fGA_nsteps;      // GA settings: number of steps
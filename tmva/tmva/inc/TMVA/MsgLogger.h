@@ -104,6 +104,9 @@ namespace TMVA {
       static void  InhibitOutput();
       static void  EnableOutput();
 
+      // Sends the output of the loggers used by the calling thread to out instead of std::cout (0: back to std::cout)
+      static void  SetThreadOutput( std::ostream* out );
+
    private:
 
       // private utility routines
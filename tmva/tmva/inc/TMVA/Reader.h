@@ -62,6 +62,7 @@
 #include <vector>
 #include <map>
 #include <stdexcept>
+#include <mutex>
 
 namespace TMVA {
 
@@ -102,6 +103,10 @@ namespace TMVA {
       Double_t EvaluateMVA( MethodBase* method,           Double_t aux = 0 );
       Double_t EvaluateMVA( const TString& methodTag,     Double_t aux = 0 );
 
+      // returns the MVA responses of a block of events, the variables being stored column-wise
+      void     EvaluateMVA( const Float_t* input, UInt_t nEvents, const TString& methodTag,
+                            Double_t* output, Double_t aux = 0 ) const;
+
       // returns error on MVA response for given event
       // NOTE: must be called AFTER "EvaluateMVA(...)" call !
       Double_t GetMVAError() const { return fMvaEventError; }
@@ -171,6 +176,8 @@ namespace TMVA {
 
       std::vector<Float_t> fTmpEvalVec; // temporary evaluation vector (if user input is v<double>)
 
+      mutable std::recursive_mutex fEvaluateMutex; //! serializes the evaluations modifying the Reader or the methods
+
       mutable MsgLogger* fLogger;   // message logger
       MsgLogger& Log() const { return *fLogger; }
 
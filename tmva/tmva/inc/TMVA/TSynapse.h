@@ -88,6 +88,9 @@ namespace TMVA {
       // initialize the error field of the synpase to 0
       void InitDelta()           { fDelta = 0.0; fCount = 0; }
 
+      // add the error field of count updates computed elsewhere
+      void AddDelta( Double_t delta, Int_t count ) { fDelta += delta; fCount += count; }
+
       void SetDEDw(Double_t DEDw)              { fDEDw = DEDw;           }
       Double_t GetDEDw()                       { return fDEDw;           }
       Double_t GetDelta()                      { return fDelta;          }
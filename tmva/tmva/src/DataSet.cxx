@@ -29,6 +29,7 @@
 #include <cstdlib>
 #include <stdexcept>
 #include <algorithm>
+#include <mutex>
 
 #ifndef ROOT_TMVA_DataSetInfo
 #include "TMVA/DataSetInfo.h"
@@ -55,12 +56,28 @@
 #include "TMVA/Configurable.h"
 #endif
 
+#include "ThreadLocalStorage.h"
+
+namespace {
+   // DataSet whose current tree type and event are kept by the calling
+   // thread, and their values, see DataSet::UseThreadPosition
+   TTHREAD_TLS(const TMVA::DataSet*) gThreadDataSet = 0;
+   TTHREAD_TLS(UInt_t)               gThreadTreeIdx  = 0;
+   TTHREAD_TLS(Long64_t)             gThreadEventIdx = 0;
+}
+
+// protects the maps of results, filled by the methods tested in parallel
+static std::mutex gResultsMutex;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// constructor
 
 TMVA::DataSet::DataSet(const DataSetInfo& dsi) 
    : fdsi(dsi),
      fEventCollection(4,(std::vector<Event*>*)0),
+     fColumns(4),
+     fClassColumns(4),
+     fColumnIdx(4,-1),
      fCurrentTreeIdx(0),
      fCurrentEventIdx(0),
      fHasNegativeEventWeights(kFALSE),
@@ -173,19 +190,144 @@ void TMVA::DataSet::DestroyCollection(Types::ETreeType type, Bool_t deleteEvents
    }
    delete fEventCollection[i];
    fEventCollection[i]=0;
+   fColumnIdx[i] = -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// store the variables and classes of the events of the collection treeIdx
+/// column by column, in the order of the collection: the events become views
+/// onto the columns (Event::SetColumnView) instead of holding each their own
+/// values. The columns are not built if the events have not all the variables
+/// of the DataSetInfo, or if they are dynamic.
+
+void TMVA::DataSet::BuildColumns( UInt_t treeIdx )
+{
+   const std::vector<Event*>& events = *(fEventCollection.at(treeIdx));
+   const UInt_t   nvar    = fdsi.GetNVariables();
+   const Long64_t nevents = events.size();
+   fColumnIdx[treeIdx] = -1;
+   std::vector<Float_t>().swap( fColumns[treeIdx] );
+   std::vector<UInt_t>().swap( fClassColumns[treeIdx] );
+   for (Long64_t ievt=0; ievt<nevents; ievt++) {
+      if (events[ievt]->IsDynamic() || events[ievt]->GetNVariables() != nvar) return;
+   }
+
+   fColumns[treeIdx].resize( size_t(nvar)*nevents );
+   fClassColumns[treeIdx].resize( nevents );
+   for (Long64_t ievt=0; ievt<nevents; ievt++) {
+      events[ievt]->SetColumnView( &fColumns[treeIdx][ievt], nevents );
+      fClassColumns[treeIdx][ievt] = events[ievt]->GetClass();
+   }
+   fColumnIdx[treeIdx] = treeIdx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// the values of the variable ivar of the events of the given tree type, in the
+/// order of the event collection, or 0 if these events are not stored column
+/// by column (see BuildColumns); the sampling (see HasSampling) is ignored
+
+const Float_t* TMVA::DataSet::GetColumn( UInt_t ivar, Types::ETreeType type ) const
+{
+   const Int_t c = fColumnIdx.at(TreeIndex(type));
+   if (c < 0 || ivar >= fdsi.GetNVariables()) return 0;
+   return fColumns[c].data() + size_t(ivar)*fClassColumns[c].size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// the classes of the events of the given tree type, as GetColumn
+
+const UInt_t* TMVA::DataSet::GetClassColumn( Types::ETreeType type ) const
+{
+   const Int_t c = fColumnIdx.at(TreeIndex(type));
+   if (c < 0) return 0;
+   return fClassColumns[c].data();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// copy the events first, ..., first+n-1 of the given tree type, in the order
+/// of the event collection: values is filled column by column, the value of the
+/// variable ivar of the event first+i going to values[ivar*n+i], and classes
+/// and weights (Event::GetWeight) with the classes and current weights of the
+/// same events. The values and classes are copied from the columns of the
+/// DataSet (see GetColumn) when the collection is stored column by column,
+/// else the events are transposed. The weights are read from the events, since
+/// boosting changes them.
+/// Looping over the events of one variable in such a block, instead of calling
+/// GetEvent(ievt)->GetValue(ivar), lets these loops be vectorised, while the
+/// block (see GetColumnBlockSize) stays small enough to remain in the cache.
+/// The values are the untransformed ones, and the sampling (see HasSampling)
+/// is ignored.
+
+void TMVA::DataSet::GetColumnBlock( Long64_t first, UInt_t n, std::vector<Float_t>& values, std::vector<UInt_t>& classes,
+                                    std::vector<Double_t>& weights, Types::ETreeType type ) const
+{
+   const std::vector<Event*>& events = *(fEventCollection.at(TreeIndex(type)));
+   const UInt_t nvar = fdsi.GetNVariables();
+   values.resize( size_t(nvar)*n );
+   classes.resize( n );
+   weights.resize( n );
+   const UInt_t* classColumn = GetClassColumn( type );
+   if (classColumn != 0 && first+n <= Long64_t(events.size())) {
+      for (UInt_t ivar=0; ivar<nvar; ivar++)
+         std::copy( GetColumn(ivar, type)+first, GetColumn(ivar, type)+first+n, values.begin()+size_t(ivar)*n );
+      std::copy( classColumn+first, classColumn+first+n, classes.begin() );
+      for (UInt_t i=0; i<n; i++) weights[i] = events[first+i]->GetWeight();
+      return;
+   }
+   for (UInt_t i=0; i<n; i++) {
+      const Event* ev = events.at(first+i);
+      for (UInt_t ivar=0; ivar<nvar; ivar++) values[size_t(ivar)*n+i] = ev->GetValue(ivar);
+      classes[i] = ev->GetClass();
+      weights[i] = ev->GetWeight();
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 const TMVA::Event* TMVA::DataSet::GetEvent() const
 {
-   if (fSampling.size() > UInt_t(fCurrentTreeIdx) && fSampling.at(fCurrentTreeIdx)) {
-      Long64_t iEvt = fSamplingSelected.at(fCurrentTreeIdx).at( fCurrentEventIdx )->second;
-      return (*(fEventCollection.at(fCurrentTreeIdx))).at(iEvt);
+   const UInt_t treeIdx = CurrentTreeIdx();
+   if (fSampling.size() > UInt_t(treeIdx) && fSampling.at(treeIdx)) {
+      Long64_t iEvt = fSamplingSelected.at(treeIdx).at( CurrentEventIdx() )->second;
+      return (*(fEventCollection.at(treeIdx))).at(iEvt);
    }
    else {
-      return (*(fEventCollection.at(fCurrentTreeIdx))).at(fCurrentEventIdx);
+      return (*(fEventCollection.at(treeIdx))).at(CurrentEventIdx());
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// with flag set, the calling thread gets its own current tree type and event,
+/// starting from the current ones of the DataSet: SetCurrentType, SetCurrentEvent
+/// and GetEvent of this thread no longer interfere with the ones of the other
+/// threads, as for the methods tested in parallel by the Factory (option NumCPU).
+/// A thread keeps its own position in one DataSet at a time; with flag not set
+/// it shares the position of the DataSet again.
+
+void TMVA::DataSet::UseThreadPosition( Bool_t flag ) const
+{
+   if (flag) {
+      gThreadTreeIdx  = fCurrentTreeIdx;
+      gThreadEventIdx = fCurrentEventIdx;
+      gThreadDataSet  = this;
    }
+   else if (gThreadDataSet == this) gThreadDataSet = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+UInt_t& TMVA::DataSet::CurrentTreeIdx() const
+{
+   if (gThreadDataSet == this) return gThreadTreeIdx;
+   return fCurrentTreeIdx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Long64_t& TMVA::DataSet::CurrentEventIdx() const
+{
+   if (gThreadDataSet == this) return gThreadEventIdx;
+   return fCurrentEventIdx;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -219,8 +361,9 @@ UInt_t TMVA::DataSet::GetNSpectators() const
 void TMVA::DataSet::AddEvent(Event * ev, Types::ETreeType type) 
 {
    fEventCollection.at(Int_t(type))->push_back(ev);
+   fColumnIdx.at(Int_t(type)) = -1; // the event is not in the columns
    if (ev->GetWeight()<0) fHasNegativeEventWeights = kTRUE;
-   fEvtCollIt=fEventCollection.at(fCurrentTreeIdx)->begin();
+   fEvtCollIt=fEventCollection.at(CurrentTreeIdx())->begin();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -237,7 +380,8 @@ void TMVA::DataSet::SetEventCollection(std::vector<TMVA::Event*>* events, Types:
    for (std::vector<Event*>::iterator it = fEventCollection.at(t)->begin(); it < fEventCollection.at(t)->end(); it++) {
       IncrementNClassEvents( t, (*it)->GetClass() );
    }
-   fEvtCollIt=fEventCollection.at(fCurrentTreeIdx)->begin();
+   BuildColumns( t );
+   fEvtCollIt=fEventCollection.at(CurrentTreeIdx())->begin();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -258,6 +402,7 @@ TMVA::Results* TMVA::DataSet::GetResults( const TString & resultsName,
                                           Types::ETreeType type,
                                           Types::EAnalysisType analysistype ) 
 {
+   std::lock_guard<std::mutex> guard(gResultsMutex);
    UInt_t t = TreeIndex(type);
    if (t<fResults.size()) {
       const std::map< TString, Results* >& resultsForType = fResults[t];
@@ -309,6 +454,7 @@ void TMVA::DataSet::DeleteResults( const TString & resultsName,
                                    Types::ETreeType type,
                                    Types::EAnalysisType /* analysistype */ ) 
 {
+   std::lock_guard<std::mutex> guard(gResultsMutex);
    if (fResults.empty()) return;
 
    if (UInt_t(type) > fResults.size()){
@@ -344,6 +490,7 @@ void TMVA::DataSet::DivideTrainingSet( UInt_t blockNum )
       for (UInt_t i=0; i<fEventCollection[tTrn]->size(); i++)
          fEventCollection[tOrg]->push_back((*fEventCollection[tTrn])[i]);
       fClassEvents[tOrg] = fClassEvents[tTrn];
+      fColumnIdx[tOrg] = fColumnIdx[tTrn];
    }
    //reseting the event division vector
    fBlockBelongToTraining.clear();
@@ -370,6 +517,9 @@ void TMVA::DataSet::ApplyTrainingSetDivision()
       else
          fEventCollection[tVld]->push_back((*fEventCollection[tOrg])[i]);
    }
+   // the columns of the original training events still match when no block is left out
+   fColumnIdx[tTrn] = fEventCollection[tVld]->empty() ? fColumnIdx[tOrg] : -1;
+   fColumnIdx[tVld] = -1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -535,34 +685,35 @@ void TMVA::DataSet::CreateSampling() const
 
 void TMVA::DataSet::EventResult( Bool_t successful, Long64_t evtNumber )
 {
+   const UInt_t treeIdx = CurrentTreeIdx();
 
-   if (!fSampling.at(fCurrentTreeIdx)) return;
-   if (fSamplingWeight.at(fCurrentTreeIdx) > 0.99999999999) return;
+   if (!fSampling.at(treeIdx)) return;
+   if (fSamplingWeight.at(treeIdx) > 0.99999999999) return;
 
    Long64_t start = 0;
-   Long64_t stop  = fSamplingEventList.at(fCurrentTreeIdx).size() -1;
+   Long64_t stop  = fSamplingEventList.at(treeIdx).size() -1;
    if (evtNumber >= 0) {
       start = evtNumber; 
       stop  = evtNumber;
    }
    for ( Long64_t iEvt = start; iEvt <= stop; iEvt++ ){
-      if (Long64_t(fSamplingEventList.at(fCurrentTreeIdx).size()) < iEvt) {
+      if (Long64_t(fSamplingEventList.at(treeIdx).size()) < iEvt) {
          Log() << kWARNING << "event number (" << iEvt 
                << ") larger than number of sampled events (" 
-               << fSamplingEventList.at(fCurrentTreeIdx).size() << " of tree " << fCurrentTreeIdx << ")" << Endl;
+               << fSamplingEventList.at(treeIdx).size() << " of tree " << treeIdx << ")" << Endl;
          return;
       }
-      Float_t weight = fSamplingEventList.at(fCurrentTreeIdx).at( iEvt )->first;
+      Float_t weight = fSamplingEventList.at(treeIdx).at( iEvt )->first;
       if (!successful) {
-         //      weight /= (fSamplingWeight.at(fCurrentTreeIdx)/fSamplingEventList.at(fCurrentTreeIdx).size());
-         weight /= fSamplingWeight.at(fCurrentTreeIdx);
+         //      weight /= (fSamplingWeight.at(treeIdx)/fSamplingEventList.at(treeIdx).size());
+         weight /= fSamplingWeight.at(treeIdx);
          if (weight > 1.0 ) weight = 1.0;
       }
       else {
-         //      weight *= (fSamplingWeight.at(fCurrentTreeIdx)/fSamplingEventList.at(fCurrentTreeIdx).size());
-         weight *= fSamplingWeight.at(fCurrentTreeIdx);
+         //      weight *= (fSamplingWeight.at(treeIdx)/fSamplingEventList.at(treeIdx).size());
+         weight *= fSamplingWeight.at(treeIdx);
       }
-      fSamplingEventList.at(fCurrentTreeIdx).at( iEvt )->first = weight;
+      fSamplingEventList.at(treeIdx).at( iEvt )->first = weight;
    }
 }
 
@@ -66,6 +66,7 @@
 #include "TRandom3.h"
 #include "TMath.h"
 #include "TMatrix.h"
+#include "TTaskPool.h"
 
 #include "TMVA/MsgLogger.h"
 #include "TMVA/DecisionTree.h"
@@ -120,7 +121,8 @@ BinaryTree(),
    fSigClass       (0),
    fTreeID         (0),
    fAnalysisType   (Types::kClassification),
-   fDataSetInfo    (NULL)
+   fDataSetInfo    (NULL),
+   fPreBinning     (kFALSE)
 {
 }
 
@@ -157,7 +159,8 @@ TMVA::DecisionTree::DecisionTree( TMVA::SeparationBase *sepType, Float_t minSize
    fSigClass       (cls),
    fTreeID         (treeID),
    fAnalysisType   (Types::kClassification),
-   fDataSetInfo    (dataInfo)
+   fDataSetInfo    (dataInfo),
+   fPreBinning     (kFALSE)
 {
    if (sepType == NULL) { // it is interpreted as a regression tree, where
                           // currently the separation type (simple least square)
@@ -204,7 +207,8 @@ TMVA::DecisionTree::DecisionTree( const DecisionTree &d ):
    fSigClass   (d.fSigClass),
    fTreeID     (d.fTreeID),
    fAnalysisType(d.fAnalysisType),
-   fDataSetInfo    (d.fDataSetInfo)
+   fDataSetInfo    (d.fDataSetInfo),
+   fPreBinning     (d.fPreBinning)
 {
    this->SetRoot( new TMVA::DecisionTreeNode ( *((DecisionTreeNode*)(d.GetRoot())) ) );
    this->SetParentTreeInNodes();
@@ -270,12 +274,202 @@ TMVA::DecisionTree* TMVA::DecisionTree::CreateFromXML(void* node, UInt_t tmva_Ve
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// histograms of the signal and background (and regression target) weights of the
+/// events of a node, the bins of all the variables one after the other
+
+struct TMVA::DecisionTree::NodeHistograms {
+   std::vector<Double_t> fS, fB, fSUnWeighted, fBUnWeighted, fTarget, fTarget2;
+
+   Bool_t IsEmpty() const { return fS.empty(); }
+   void Reset( UInt_t nbins, Bool_t regression ) {
+      fS.assign(nbins,0); fB.assign(nbins,0);
+      fSUnWeighted.assign(nbins,0); fBUnWeighted.assign(nbins,0);
+      fTarget.assign(regression ? nbins : 0,0); fTarget2.assign(regression ? nbins : 0,0);
+   }
+   void Clear() {
+      std::vector<Double_t>().swap(fS); std::vector<Double_t>().swap(fB);
+      std::vector<Double_t>().swap(fSUnWeighted); std::vector<Double_t>().swap(fBUnWeighted);
+      std::vector<Double_t>().swap(fTarget); std::vector<Double_t>().swap(fTarget2);
+   }
+   void Add( const NodeHistograms & h ) {
+      for (UInt_t i=0; i<fS.size(); i++) {
+         fS[i] += h.fS[i]; fB[i] += h.fB[i];
+         fSUnWeighted[i] += h.fSUnWeighted[i]; fBUnWeighted[i] += h.fBUnWeighted[i];
+      }
+      for (UInt_t i=0; i<fTarget.size(); i++) {
+         fTarget[i] += h.fTarget[i]; fTarget2[i] += h.fTarget2[i];
+      }
+   }
+   // the histograms of a node are those of its parent minus those of its sibling
+   void SetDifference( const NodeHistograms & parent, const NodeHistograms & sibling ) {
+      *this = parent;
+      for (UInt_t i=0; i<fS.size(); i++) {
+         fS[i] -= sibling.fS[i]; fB[i] -= sibling.fB[i];
+         fSUnWeighted[i] -= sibling.fSUnWeighted[i]; fBUnWeighted[i] -= sibling.fBUnWeighted[i];
+      }
+      for (UInt_t i=0; i<fTarget.size(); i++) {
+         fTarget[i] -= sibling.fTarget[i]; fTarget2[i] -= sibling.fTarget2[i];
+      }
+   }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// building the decision tree by recursively calling the splitting of
 /// one (root-) node into two daughter nodes (returns the number of nodes)
+/// With SetPreBinning(), each variable is binned once for the tree, on the fNCuts+1
+/// bins grid of its range in the whole sample (which is also the grid of the root
+/// node), and the histograms of the nodes are filled from these bin codes. The
+/// histograms of the larger daughter of a node are then those of the node minus
+/// those of the smaller daughter, so that only the smaller one is filled from its
+/// events. The nodes below the root are cut on the grid of the whole sample
+/// instead of the one of their own range.
 
 UInt_t TMVA::DecisionTree::BuildTree( const std::vector<const TMVA::Event*> & eventSample,
                                       TMVA::DecisionTreeNode *node)
+{
+   if (node==NULL && fPreBinning && fNCuts > 0 && PreBinVariables(eventSample)) {
+      std::vector<UInt_t> rows(eventSample.size());
+      for (UInt_t iev=0; iev<rows.size(); iev++) rows[iev] = iev;
+      NodeHistograms hist;
+      UInt_t nNodes = this->BuildTree(eventSample, node, &rows, &hist);
+      std::vector<UShort_t>().swap(fBinCodes);
+      return nNodes;
+   }
+   return this->BuildTree(eventSample, node, 0, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// compute the grid of the variables on the range of the sample and the bin of
+/// each variable of each event; return kFALSE if the variables cannot be binned
+
+Bool_t TMVA::DecisionTree::PreBinVariables( const EventConstList & eventSample )
+{
+   UInt_t nevents = eventSample.size();
+   if (nevents == 0) return kFALSE;
+   if (fNvars==0) fNvars = eventSample[0]->GetNVariables();
+
+   // the range is kept as in the nodes (in single precision), so that the grid is
+   // the one of the root node; the events are read variable by variable, which
+   // follows the columns of the DataSet when they are views onto them
+   std::vector<Float_t> xmin(fNvars), xmax(fNvars);
+   for (UInt_t ivar=0; ivar<fNvars; ivar++) {
+      for (UInt_t iev=0; iev<nevents; iev++) {
+         const Double_t val = eventSample[iev]->GetValue(ivar);
+         if (iev==0) xmin[ivar]=xmax[ivar]=val;
+         if (val < xmin[ivar]) xmin[ivar]=val;
+         if (val > xmax[ivar]) xmax[ivar]=val;
+      }
+   }
+
+   fBinMin.resize(fNvars); fBinMax.resize(fNvars);
+   fBinCount.resize(fNvars); fBinOffset.resize(fNvars);
+   UInt_t nbinsTotal = 0;
+   for (UInt_t ivar=0; ivar<fNvars; ivar++) {
+      fBinMin[ivar] = xmin[ivar];
+      fBinMax[ivar] = xmax[ivar];
+      Double_t nbins = fNCuts+1;
+      if (fDataSetInfo->GetVariableInfo(ivar).GetVarType() == 'I') nbins = fBinMax[ivar] - fBinMin[ivar] + 1;
+      if (nbins > 65536) {
+         Log() << kWARNING << "<PreBinVariables> variable " << ivar << " would need " << nbins
+               << " bins, the tree is built without pre-binning" << Endl;
+         return kFALSE;
+      }
+      fBinCount[ivar]  = UInt_t(nbins);
+      fBinOffset[ivar] = nbinsTotal;
+      nbinsTotal += fBinCount[ivar];
+   }
+
+   // same bin as in TrainNodeFast, the last bin is nbins-1
+   fBinCodes.resize(nevents*fNvars);
+   for (UInt_t ivar=0; ivar<fNvars; ivar++) {
+      for (UInt_t iev=0; iev<nevents; iev++) {
+         Int_t iBin = 0;
+         if (fBinMax[ivar]-fBinMin[ivar] >= std::numeric_limits<double>::epsilon()) {
+            Double_t eventData = eventSample[iev]->GetValue(ivar);
+            iBin = TMath::Min(Int_t(fBinCount[ivar]-1),TMath::Max(0,int (fBinCount[ivar]*(eventData-fBinMin[ivar])/(fBinMax[ivar]-fBinMin[ivar]) ) ));
+         }
+         fBinCodes[iev*fNvars+ivar] = iBin;
+      }
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// fill the histograms of all the pre-binned variables with the events of a node
+
+void TMVA::DecisionTree::FillBinnedHistograms( const EventConstList & eventSample,
+                                               const std::vector<UInt_t> & rows,
+                                               NodeHistograms & hist ) const
+{
+   const Bool_t regression = DoRegression();
+   FillInChunks(eventSample.size(), fBinOffset.back()+fBinCount.back(), regression,
+                [&](UInt_t first, UInt_t last, NodeHistograms & h) {
+      for (UInt_t iev=first; iev<last; iev++) {
+         const TMVA::Event* ev = eventSample[iev];
+         const UShort_t* codes = &fBinCodes[rows[iev]*fNvars];
+         const Double_t eventWeight = ev->GetWeight();
+         const Bool_t isSignal = (ev->GetClass() == fSigClass);
+         const Double_t tgt = regression ? ev->GetTarget(0) : 0;
+         for (UInt_t ivar=0; ivar<fNvars; ivar++) {
+            const UInt_t k = fBinOffset[ivar]+codes[ivar];
+            if (isSignal) {
+               h.fS[k]+=eventWeight;
+               h.fSUnWeighted[k]++;
+            }
+            else {
+               h.fB[k]+=eventWeight;
+               h.fBUnWeighted[k]++;
+            }
+            if (regression) {
+               h.fTarget[k] +=eventWeight*tgt;
+               h.fTarget2[k]+=eventWeight*tgt*tgt;
+            }
+         }
+      }
+   }, hist);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// fill histograms of nbins bins with nevents events, fill(first,last,h) filling h
+/// with the events [first,last). Large nodes are split in chunks of events, filled
+/// into their own histograms by the tasks of the global TTaskPool (see
+/// TTaskPool::SetGlobalPoolSize) and added in the order of the chunks: the chunks
+/// only depend on the number of events, so the sums do not depend on the threads.
+
+void TMVA::DecisionTree::FillInChunks( UInt_t nevents, UInt_t nbins, Bool_t regression,
+                                       const std::function<void(UInt_t,UInt_t,NodeHistograms&)> & fill,
+                                       NodeHistograms & hist )
+{
+   const UInt_t nchunks = TMath::Max(1U, TMath::Min(fgMaxChunks, nevents/fgEventsPerChunk));
+   hist.Reset(nbins, regression);
+   if (nchunks == 1) {
+      fill(0, nevents, hist);
+      return;
+   }
+   std::vector<NodeHistograms> partial(nchunks);
+   {
+      TTaskGroup group;
+      for (UInt_t ichunk=1; ichunk<nchunks; ichunk++) {
+         group.Run([&, ichunk]() {
+            partial[ichunk].Reset(nbins, regression);
+            fill(ULong64_t(nevents)*ichunk/nchunks, ULong64_t(nevents)*(ichunk+1)/nchunks, partial[ichunk]);
+         });
+      }
+      partial[0].Reset(nbins, regression);
+      fill(0, ULong64_t(nevents)/nchunks, partial[0]);
+      group.Wait();
+   }
+   for (UInt_t ichunk=0; ichunk<nchunks; ichunk++) hist.Add(partial[ichunk]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// building of the node and its daughters, see BuildTree above
+
+UInt_t TMVA::DecisionTree::BuildTree( const EventConstList & eventSample,
+                                      TMVA::DecisionTreeNode *node,
+                                      const std::vector<UInt_t>* rows,
+                                      NodeHistograms* hist )
 {
    if (node==NULL) {
       //start with the root node
@@ -394,7 +588,7 @@ UInt_t TMVA::DecisionTree::BuildTree( const std::vector<const TMVA::Event*> & ev
        && ( ( s!=0 && b !=0 && !DoRegression()) || ( (s+b)!=0 && DoRegression()) ) ) {
       Double_t separationGain;
       if (fNCuts > 0){
-         separationGain = this->TrainNodeFast(eventSample, node);
+         separationGain = this->TrainNodeFast(eventSample, node, rows, hist);
       } else {
          separationGain = this->TrainNodeFull(eventSample, node);
       }
@@ -423,6 +617,7 @@ UInt_t TMVA::DecisionTree::BuildTree( const std::vector<const TMVA::Event*> & ev
 
          std::vector<const TMVA::Event*> leftSample; leftSample.reserve(nevents);
          std::vector<const TMVA::Event*> rightSample; rightSample.reserve(nevents);
+         std::vector<UInt_t> leftRows, rightRows;
 
          Double_t nRight=0, nLeft=0;
          Double_t nRightUnBoosted=0, nLeftUnBoosted=0;
@@ -430,11 +625,13 @@ UInt_t TMVA::DecisionTree::BuildTree( const std::vector<const TMVA::Event*> & ev
          for (UInt_t ie=0; ie< nevents ; ie++) {
             if (node->GoesRight(*eventSample[ie])) {
                rightSample.push_back(eventSample[ie]);
+               if (rows) rightRows.push_back((*rows)[ie]);
                nRight += eventSample[ie]->GetWeight();
                nRightUnBoosted += eventSample[ie]->GetOriginalWeight();
             }
             else {
                leftSample.push_back(eventSample[ie]);
+               if (rows) leftRows.push_back((*rows)[ie]);
                nLeft += eventSample[ie]->GetWeight();
                nLeftUnBoosted += eventSample[ie]->GetOriginalWeight();
             }
@@ -474,8 +671,27 @@ UInt_t TMVA::DecisionTree::BuildTree( const std::vector<const TMVA::Event*> & ev
          node->SetLeft(leftNode);
          node->SetRight(rightNode);
 
-         this->BuildTree(rightSample, rightNode);
-         this->BuildTree(leftSample,  leftNode );
+         if (rows) {
+            // the histograms of the daughters: the smaller one is filled from its events
+            // and the larger one is the node minus the smaller one. They are only
+            // computed here if the larger daughter can be split; the smaller one fills
+            // its own histograms otherwise, when it is trained.
+            NodeHistograms rightHist, leftHist;
+            Bool_t leftSmaller = leftSample.size() <= rightSample.size();
+            const EventConstList & largeSample = leftSmaller ? rightSample : leftSample;
+            if (!hist->IsEmpty() && largeSample.size() >= 2*fMinSize && node->GetDepth()+1 < fMaxDepth) {
+               NodeHistograms & smallHist = leftSmaller ? leftHist : rightHist;
+               FillBinnedHistograms(leftSmaller ? leftSample : rightSample, leftSmaller ? leftRows : rightRows, smallHist);
+               (leftSmaller ? rightHist : leftHist).SetDifference(*hist, smallHist);
+            }
+            hist->Clear();
+            this->BuildTree(rightSample, rightNode, &rightRows, &rightHist);
+            this->BuildTree(leftSample,  leftNode,  &leftRows,  &leftHist );
+         }
+         else {
+            this->BuildTree(rightSample, rightNode);
+            this->BuildTree(leftSample,  leftNode );
+         }
 
       }
    }
@@ -921,9 +1137,23 @@ void TMVA::DecisionTree::GetRandomisedVariables(Bool_t *useVariable, UInt_t *map
 /// in addition to the individual variables, one can also ask for a fisher
 /// discriminant being built out of (some) of the variables and used as a
 /// possible multivariate split.
+/// The histograms of the variables of large nodes are filled in chunks of events
+/// by the tasks of the global TTaskPool, see FillInChunks.
 
 Double_t TMVA::DecisionTree::TrainNodeFast( const EventConstList & eventSample,
                                             TMVA::DecisionTreeNode *node )
+{
+   return TrainNodeFast( eventSample, node, 0, 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// TrainNodeFast, with the histograms of the pre-binned variables taken from hist
+/// (filled from the bin codes of the events first if hist is empty) if rows is given
+
+Double_t TMVA::DecisionTree::TrainNodeFast( const EventConstList & eventSample,
+                                            TMVA::DecisionTreeNode *node,
+                                            const std::vector<UInt_t>* rows,
+                                            NodeHistograms* hist )
 {
    Double_t  separationGainTotal = -1, sepTmp;
    Double_t *separationGain    = new Double_t[fNvars+1];
@@ -1033,7 +1263,8 @@ Double_t TMVA::DecisionTree::TrainNodeFast( const EventConstList & eventSample,
    for (UInt_t ivar=0; ivar<cNvars; ivar++) {
       nBins[ivar] = fNCuts+1;
       if (ivar < fNvars) {
-         if (fDataSetInfo->GetVariableInfo(ivar).GetVarType() == 'I') {
+         if (rows) nBins[ivar] = fBinCount[ivar];
+         else if (fDataSetInfo->GetVariableInfo(ivar).GetVarType() == 'I') {
             nBins[ivar] = node->GetSampleMax(ivar) - node->GetSampleMin(ivar) + 1; 
          }
       }
@@ -1060,6 +1291,10 @@ Double_t TMVA::DecisionTree::TrainNodeFast( const EventConstList & eventSample,
             //  std::cout << " will set useVariable[ivar]=false"<<std::endl;
             useVariable[ivar]=kFALSE;
          }
+         if (rows) { // the grid of the pre-binned variables
+            xmin[ivar]=fBinMin[ivar];
+            xmax[ivar]=fBinMax[ivar];
+         }
          
       } else { // the fisher variable
          xmin[ivar]=999;
@@ -1132,37 +1367,75 @@ Double_t TMVA::DecisionTree::TrainNodeFast( const EventConstList & eventSample,
          nTotB+=eventWeight;
          nTotB_unWeighted++;
       }
-      
-      Int_t iBin=-1;
-      for (UInt_t ivar=0; ivar < cNvars; ivar++) {
-         // now scan trough the cuts for each varable and find which one gives
-         // the best separationGain at the current stage.
-         if ( useVariable[ivar] ) {
-            Double_t eventData;
-            if (ivar < fNvars) eventData = eventSample[iev]->GetValue(ivar); 
-            else { // the fisher variable
-               eventData = fisherCoeff[fNvars];
-               for (UInt_t jvar=0; jvar<fNvars; jvar++)
-                  eventData += fisherCoeff[jvar]*(eventSample[iev])->GetValue(jvar);
-               
-            }
-            // "maximum" is nbins-1 (the "-1" because we start counting from 0 !!
-            iBin = TMath::Min(Int_t(nBins[ivar]-1),TMath::Max(0,int (nBins[ivar]*(eventData-xmin[ivar])/(xmax[ivar]-xmin[ivar]) ) ));
-            if (eventSample[iev]->GetClass() == fSigClass) {
-               nSelS[ivar][iBin]+=eventWeight;
-               nSelS_unWeighted[ivar][iBin]++;
-            } 
-            else {
-               nSelB[ivar][iBin]+=eventWeight;
-               nSelB_unWeighted[ivar][iBin]++;
-            }
-            if (DoRegression()) {
-               target[ivar][iBin] +=eventWeight*eventSample[iev]->GetTarget(0);
-               target2[ivar][iBin]+=eventWeight*eventSample[iev]->GetTarget(0)*eventSample[iev]->GetTarget(0);
+   }
+
+   // fill the histograms of the variables which are not pre-binned from their values,
+   // the bins of variable ivar starting at offset[ivar]
+   std::vector<UInt_t> usedVars, offset(cNvars);
+   UInt_t nBinsUsed = 0;
+   for (UInt_t ivar=0; ivar < cNvars; ivar++) {
+      if ( useVariable[ivar] && (!rows || ivar >= fNvars) ) {
+         usedVars.push_back(ivar);
+         offset[ivar] = nBinsUsed;
+         nBinsUsed += nBins[ivar];
+      }
+   }
+   const Bool_t regression = DoRegression();
+   NodeHistograms valueHist;
+   if (!usedVars.empty()) {
+      FillInChunks(nevents, nBinsUsed, regression, [&](UInt_t first, UInt_t last, NodeHistograms & h) {
+         for (UInt_t iev=first; iev<last; iev++) {
+            const TMVA::Event* ev = eventSample[iev];
+            Double_t eventWeight = ev->GetWeight(); 
+            Bool_t isSignal = (ev->GetClass() == fSigClass);
+            for (UInt_t iused=0; iused < usedVars.size(); iused++) {
+               // now scan trough the cuts for each varable and find which one gives
+               // the best separationGain at the current stage.
+               UInt_t ivar = usedVars[iused];
+               Double_t eventData;
+               if (ivar < fNvars) eventData = ev->GetValue(ivar); 
+               else { // the fisher variable
+                  eventData = fisherCoeff[fNvars];
+                  for (UInt_t jvar=0; jvar<fNvars; jvar++)
+                     eventData += fisherCoeff[jvar]*ev->GetValue(jvar);
+                  
+               }
+               // "maximum" is nbins-1 (the "-1" because we start counting from 0 !!
+               Int_t iBin = TMath::Min(Int_t(nBins[ivar]-1),TMath::Max(0,int (nBins[ivar]*(eventData-xmin[ivar])/(xmax[ivar]-xmin[ivar]) ) ));
+               UInt_t k = offset[ivar]+iBin;
+               if (isSignal) {
+                  h.fS[k]+=eventWeight;
+                  h.fSUnWeighted[k]++;
+               } 
+               else {
+                  h.fB[k]+=eventWeight;
+                  h.fBUnWeighted[k]++;
+               }
+               if (regression) {
+                  h.fTarget[k] +=eventWeight*ev->GetTarget(0);
+                  h.fTarget2[k]+=eventWeight*ev->GetTarget(0)*ev->GetTarget(0);
+               }
             }
          }
+      }, valueHist);
+   }
+   if (rows && hist->IsEmpty()) FillBinnedHistograms(eventSample, *rows, *hist);
+
+   for (UInt_t ivar=0; ivar < cNvars; ivar++) {
+      if (!useVariable[ivar]) continue;
+      const NodeHistograms & h = (rows && ivar < fNvars) ? *hist : valueHist;
+      const UInt_t first = (rows && ivar < fNvars) ? fBinOffset[ivar] : offset[ivar];
+      for (UInt_t ibin=0; ibin<nBins[ivar]; ibin++) {
+         nSelS[ivar][ibin] = h.fS[first+ibin];
+         nSelB[ivar][ibin] = h.fB[first+ibin];
+         nSelS_unWeighted[ivar][ibin] = h.fSUnWeighted[first+ibin];
+         nSelB_unWeighted[ivar][ibin] = h.fBUnWeighted[first+ibin];
+         if (regression) {
+            target[ivar][ibin]  = h.fTarget[first+ibin];
+            target2[ivar][ibin] = h.fTarget2[first+ibin];
+         }
       }
-   }   
+   }
    // now turn the "histogram" into a cumulative distribution
    for (UInt_t ivar=0; ivar < cNvars; ivar++) {
       if (useVariable[ivar]) {
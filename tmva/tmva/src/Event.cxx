@@ -34,8 +34,12 @@
 #include "assert.h"
 #include <iomanip>
 #include <cassert>
+#include <mutex>
 #include "TCut.h"
 
+// protects the copies of the values of the column views made by GetValues
+static std::mutex gColumnValuesMutex;
+
 Bool_t TMVA::Event::fgIsTraining = kFALSE;
 Bool_t TMVA::Event::fgIgnoreNegWeightsInTraining = kFALSE;
 
@@ -52,7 +56,10 @@ TMVA::Event::Event()
      fWeight(1.0),
      fBoostWeight(1.0),
      fDynamic(kFALSE),
-     fDoNotBoost(kFALSE)
+     fDoNotBoost(kFALSE),
+     fColumnValues(0),
+     fColumnStride(0),
+     fNColumnValues(0)
 {
 }
 
@@ -73,7 +80,10 @@ TMVA::Event::Event( const std::vector<Float_t>& ev,
      fWeight(weight),
      fBoostWeight(boostweight),
      fDynamic(kFALSE),
-     fDoNotBoost(kFALSE)
+     fDoNotBoost(kFALSE),
+     fColumnValues(0),
+     fColumnStride(0),
+     fNColumnValues(0)
 {
 }
 
@@ -95,7 +105,10 @@ TMVA::Event::Event( const std::vector<Float_t>& ev,
      fWeight(weight),
      fBoostWeight(boostweight),
      fDynamic(kFALSE),
-     fDoNotBoost(kFALSE)
+     fDoNotBoost(kFALSE),
+     fColumnValues(0),
+     fColumnStride(0),
+     fNColumnValues(0)
 {
 }
 
@@ -115,7 +128,10 @@ TMVA::Event::Event( const std::vector<Float_t>& ev,
      fWeight(weight),
      fBoostWeight(boostweight),
      fDynamic(kFALSE),
-     fDoNotBoost(kFALSE)
+     fDoNotBoost(kFALSE),
+     fColumnValues(0),
+     fColumnStride(0),
+     fNColumnValues(0)
 {
 }
 
@@ -132,7 +148,10 @@ TMVA::Event::Event( const std::vector<Float_t*>*& evdyn, UInt_t nvar )
      fWeight(0),
      fBoostWeight(0),
      fDynamic(true),
-     fDoNotBoost(kFALSE)
+     fDoNotBoost(kFALSE),
+     fColumnValues(0),
+     fColumnStride(0),
+     fNColumnValues(0)
 {
    fValuesDynamic = (std::vector<Float_t*>*) evdyn;
 }
@@ -141,7 +160,7 @@ TMVA::Event::Event( const std::vector<Float_t*>*& evdyn, UInt_t nvar )
 /// copy constructor
 
 TMVA::Event::Event( const Event& event ) 
-   : fValues(event.fValues),
+   : fValues(event.fColumnValues ? std::vector<Float_t>() : event.fValues),
      fValuesDynamic(event.fValuesDynamic),
      fTargets(event.fTargets),
      fSpectators(event.fSpectators),
@@ -150,8 +169,12 @@ TMVA::Event::Event( const Event& event )
      fWeight(event.fWeight),
      fBoostWeight(event.fBoostWeight),
      fDynamic(event.fDynamic),
-     fDoNotBoost(kFALSE)
+     fDoNotBoost(kFALSE),
+     fColumnValues(event.fColumnValues),
+     fColumnStride(event.fColumnStride),
+     fNColumnValues(event.fNColumnValues)
 {
+   // the copy of a column view is a view onto the same columns, see SetColumnView
    if (event.fDynamic){
       fValues.clear();
       UInt_t nvar = event.GetNVariables();
@@ -197,7 +220,11 @@ void TMVA::Event::SetVariableArrangement( std::vector<UInt_t>* const m ) const {
 
 void TMVA::Event::CopyVarValues( const Event& other )
 {
-   fValues      = other.fValues;
+   if (other.fColumnValues) fValues.clear();
+   else                     fValues = other.fValues;
+   fColumnValues  = other.fColumnValues;
+   fColumnStride  = other.fColumnStride;
+   fNColumnValues = other.fNColumnValues;
    fTargets     = other.fTargets;
    fSpectators  = other.fSpectators;
    if (other.fDynamic){
@@ -232,7 +259,8 @@ Float_t TMVA::Event::GetValue( UInt_t ivar ) const
 {
    Float_t retval;
    if (fVariableArrangement==0) {
-      retval = fDynamic ? ( *((*fValuesDynamic).at(ivar)) ) : fValues.at(ivar); 
+      if (fColumnValues) retval = GetColumnValue(ivar);
+      else retval = fDynamic ? ( *((*fValuesDynamic).at(ivar)) ) : fValues.at(ivar); 
    } 
    else {
       UInt_t mapIdx = (*fVariableArrangement)[ivar];
@@ -243,7 +271,9 @@ Float_t TMVA::Event::GetValue( UInt_t ivar ) const
       }
       else{
          //retval = fValues.at(ivar);
-         retval = ( mapIdx<fValues.size() ) ? fValues[mapIdx] : fSpectators[mapIdx-fValues.size()];
+         const UInt_t nvar = GetNValues();
+         if (mapIdx<nvar) retval = fColumnValues ? GetColumnValue(mapIdx) : fValues[mapIdx];
+         else             retval = fSpectators[mapIdx-nvar];
       }
    }
 
@@ -264,6 +294,21 @@ Float_t TMVA::Event::GetSpectator( UInt_t ivar) const
 
 const std::vector<Float_t>& TMVA::Event::GetValues() const
 {
+   if (fColumnValues) {
+      // the values are copied out of the columns, once, since the callers keep
+      // the reference; events of a DataSet are read by several threads at a time
+      std::lock_guard<std::mutex> lock( gColumnValuesMutex );
+      if (fVariableArrangement==0) {
+         if (fValues.size() != fNColumnValues) {
+            fValues.resize( fNColumnValues );
+            for (UInt_t ivar=0; ivar<fNColumnValues; ivar++) fValues[ivar] = GetColumnValue(ivar);
+         }
+         return fValues;
+      }
+      fValuesRearranged.clear();
+      for (UInt_t i=0; i< fVariableArrangement->size(); i++) fValuesRearranged.push_back( GetValue(i) );
+      return fValuesRearranged;
+   }
    if (fVariableArrangement==0) {
 
       if (fDynamic) {
@@ -304,7 +349,7 @@ UInt_t TMVA::Event::GetNVariables() const
 {
    // if variables have to arranged (as it is the case for the
    // composite classifier) the number of the variables changes
-   if (fVariableArrangement==0) return fValues.size();
+   if (fVariableArrangement==0) return GetNValues();
    else                         return fVariableArrangement->size();
 }
 
@@ -325,7 +370,7 @@ UInt_t TMVA::Event::GetNSpectators() const
    // composite classifier) the number of the variables changes
 
    if (fVariableArrangement==0) return fSpectators.size();
-   else                         return fValues.size()-fVariableArrangement->size();
+   else                         return GetNValues()-fVariableArrangement->size();
 }
 
 
@@ -334,12 +379,44 @@ UInt_t TMVA::Event::GetNSpectators() const
 
 void TMVA::Event::SetVal( UInt_t ivar, Float_t val ) 
 {
+   DetachColumnView();
    if ((fDynamic ?( (*fValuesDynamic).size() ) : fValues.size())<=ivar)
       (fDynamic ?( (*fValuesDynamic).resize(ivar+1) ) : fValues.resize(ivar+1));
 
    (fDynamic ?( *(*fValuesDynamic)[ivar] ) : fValues[ivar])=val;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// move the values of the variables into the columns of a DataSet: the value of
+/// variable ivar goes to first[ivar*stride], and is read from there until the
+/// values are changed (SetVal, non-const GetValues), which copies them back into
+/// the event. Copies of the event are views onto the same columns, valid as long
+/// as the DataSet keeps them. Targets, spectators, class and weights stay in the
+/// event.
+
+void TMVA::Event::SetColumnView( Float_t* first, Long64_t stride )
+{
+   if (fDynamic) return;
+   DetachColumnView();
+   fNColumnValues = fValues.size();
+   for (UInt_t ivar=0; ivar<fNColumnValues; ivar++) first[ivar*stride] = fValues[ivar];
+   fColumnValues = first;
+   fColumnStride = stride;
+   std::vector<Float_t>().swap( fValues );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// copy the values of a column view into the event, which no longer reads them
+/// from the columns
+
+void TMVA::Event::DetachColumnView()
+{
+   if (fColumnValues==0) return;
+   fValues.resize( fNColumnValues );
+   for (UInt_t ivar=0; ivar<fNColumnValues; ivar++) fValues[ivar] = GetColumnValue(ivar);
+   fColumnValues = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// print method
 
@@ -402,8 +479,8 @@ void TMVA::Event::SetIgnoreNegWeightsInTraining(Bool_t b)
 
 std::ostream& TMVA::operator << ( std::ostream& os, const TMVA::Event& event )
 { 
-   os << "Variables [" << event.fValues.size() << "]:";
-   for (UInt_t ivar=0; ivar<event.fValues.size(); ++ivar)
+   os << "Variables [" << event.GetNValues() << "]:";
+   for (UInt_t ivar=0; ivar<event.GetNValues(); ++ivar)
       os << " " << std::setw(10) << event.GetValue(ivar);
    os << ", targets [" << event.fTargets.size() << "]:";
    for (UInt_t ivar=0; ivar<event.fTargets.size(); ++ivar)
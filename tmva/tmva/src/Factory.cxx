@@ -52,6 +52,11 @@
 #include "TPrincipal.h"
 #include "TMath.h"
 #include "TObjString.h"
+#include "TTaskPool.h"
+
+#include <functional>
+#include <map>
+#include <sstream>
 
 #include "TMVA/Factory.h"
 #include "TMVA/ClassifierFactory.h"
@@ -86,6 +91,58 @@ ClassImp(TMVA::Factory)
 #define RECREATE_METHODS kTRUE
 #define READXML          kTRUE
 
+////////////////////////////////////////////////////////////////////////////////
+/// run task for each of the methods, in parallel on up to numCPU threads
+/// (option NumCPU) when numCPU>1. Each method runs with its own position in
+/// the DataSet (DataSet::UseThreadPosition), in its own directory of the target
+/// file, and its messages are collected (MsgLogger::SetThreadOutput) and printed
+/// in the order of the methods once all are done. MethodCategory runs in the
+/// current thread before the others, as it rearranges the variables of the
+/// events shared by all the methods. The tasks must not write into the target
+/// file, which is not thread safe.
+
+static void RunForMethods( const std::vector<TMVA::IMethod*>& methods, Int_t numCPU,
+                           const std::function<void(TMVA::MethodBase*)>& task )
+{
+   std::vector<TMVA::MethodBase*> parallel;
+   for (UInt_t i=0; i<methods.size(); i++) {
+      TMVA::MethodBase* mva = dynamic_cast<TMVA::MethodBase*>(methods[i]);
+      if (mva == 0) continue;
+      if (numCPU > 1 && mva->GetMethodType() != TMVA::Types::kCategory) parallel.push_back( mva );
+      else task( mva );
+   }
+   if (parallel.empty()) return;
+
+   // the directories of the methods are created here, the tasks only change to them
+   TDirectory::TContext context;
+   for (UInt_t i=0; i<parallel.size(); i++) parallel[i]->BaseDir();
+
+   Bool_t drawProgressBar = TMVA::gConfig().DrawProgressBar();
+   TMVA::gConfig().SetDrawProgressBar( kFALSE );
+   std::vector<std::string> outputs( parallel.size() );
+   {
+      TTaskPool pool( numCPU-1 ); // the current thread runs tasks while waiting
+      TTaskGroup group( &pool );
+      for (UInt_t i=0; i<parallel.size(); i++) {
+         group.Run( [&, i]() {
+            std::ostringstream output;
+            TMVA::MsgLogger::SetThreadOutput( &output );
+            parallel[i]->Data()->UseThreadPosition( kTRUE );
+            parallel[i]->BaseDir()->cd();
+            task( parallel[i] );
+            parallel[i]->Data()->UseThreadPosition( kFALSE );
+            TMVA::MsgLogger::SetThreadOutput( 0 );
+            outputs[i] = output.str();
+         } );
+      }
+      group.Wait();
+   }
+   TMVA::gConfig().SetDrawProgressBar( drawProgressBar );
+
+   for (UInt_t i=0; i<outputs.size(); i++) std::cout << outputs[i];
+   std::cout << std::flush;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// standard constructor
 ///   jobname       : this name will appear in all weight file names produced by the MVAs
@@ -99,6 +156,7 @@ TMVA::Factory::Factory( TString jobName, TFile* theTargetFile, TString theOption
    fDataInputHandler     ( new DataInputHandler ),
    fTransformations      ( "I" ),
    fVerbose              ( kFALSE ),
+   fNumCPU               ( 1 ),
    fJobName              ( jobName ),
    fDataAssignType       ( kAssignEvents ),
    fATreeEvent           ( NULL ),
@@ -136,6 +194,7 @@ TMVA::Factory::Factory( TString jobName, TFile* theTargetFile, TString theOption
    DeclareOptionRef( silent,   "Silent", "Batch mode: boolean silent flag inhibiting any output from TMVA after the creation of the factory class object (default: False)" );
    DeclareOptionRef( drawProgressBar,
                      "DrawProgressBar", "Draw progress bar to display training, testing and evaluation schedule (default: True)" );
+   DeclareOptionRef( fNumCPU, "NumCPU", "Number of threads testing and evaluating the booked methods in parallel (default: 1, i.e. all methods in the current thread)" );
 
    TString analysisType("Auto");
    DeclareOptionRef( analysisType,
@@ -149,6 +208,7 @@ TMVA::Factory::Factory( TString jobName, TFile* theTargetFile, TString theOption
    CheckForUnusedOptions();
 
    if (Verbose()) Log().SetMinType( kVERBOSE );
+   if (fNumCPU < 1) fNumCPU = 1;
 
    // global settings
    gConfig().SetUseColor( color );
@@ -1087,19 +1147,15 @@ void TMVA::Factory::TestAllMethods()
    }
 
    // iterates over all MVAs that have been booked, and calls their testing methods
-   // iterate over methods and test
-   MVector::iterator itrMethod    = fMethods.begin();
-   MVector::iterator itrMethodEnd = fMethods.end();
-   for (; itrMethod != itrMethodEnd; itrMethod++) {
-      Event::SetIsTraining(kFALSE);
-      MethodBase* mva = dynamic_cast<MethodBase*>(*itrMethod);
-      if(mva==0) continue;
+   // iterate over methods and test, in parallel with NumCPU>1
+   Event::SetIsTraining(kFALSE);
+   RunForMethods( fMethods, fNumCPU, []( MethodBase* mva ) {
       Types::EAnalysisType analysisType = mva->GetAnalysisType();
-      Log() << kINFO << "Test method: " << mva->GetMethodName() << " for "
+      mva->Log() << kINFO << "Test method: " << mva->GetMethodName() << " for "
             << (analysisType == Types::kRegression ? "Regression" :
                 (analysisType == Types::kMulticlass ? "Multiclass classification" : "Classification")) << " performance" << Endl;
       mva->AddOutput( Types::kTesting, analysisType );
-   }
+   } );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1234,98 +1290,132 @@ void TMVA::Factory::EvaluateAllMethods( void )
    Bool_t doRegression = kFALSE;
    Bool_t doMulticlass = kFALSE;
 
-   // iterate over methods and evaluate
+   // evaluate the methods, in parallel with NumCPU>1; the figures of merit are
+   // collected, and the histograms written to the target file, afterwards in
+   // the order the methods were booked
+   struct MethodEvaluation {
+      Double_t bias[2], dev[2], rms[2], mInf[2], rho[2];  // regression [testing, training]
+      Double_t biasT[2], devT[2], rmsT[2], mInfT[2];
+      std::vector<Float_t> testEff;                       // multiclass
+      std::vector<std::vector<Float_t> > testPur;
+      Double_t sig, sep, roc;                             // classification
+      Double_t eff01, eff10, eff30, effArea;
+      Double_t eff01err, eff10err, eff30err;
+      Double_t trainEff01, trainEff10, trainEff30;
+   };
+   std::map<MethodBase*,MethodEvaluation> evaluations;
+   for (UInt_t i=0; i<fMethods.size(); i++) {
+      MethodBase* theMethod = dynamic_cast<MethodBase*>(fMethods[i]);
+      if (theMethod) evaluations[theMethod]; // filled by the threads without changing the map
+   }
+
+   Event::SetIsTraining(kFALSE);
+   RunForMethods( fMethods, fNumCPU, [&evaluations]( MethodBase* theMethod ) {
+      MethodEvaluation& e = evaluations[theMethod];
+      if (theMethod->DoRegression()) {
+         theMethod->Log() << kINFO << "Evaluate regression method: " << theMethod->GetMethodName() << Endl;
+         theMethod->TestRegression( e.bias[0], e.biasT[0], e.dev[0], e.devT[0], e.rms[0], e.rmsT[0],
+                                    e.mInf[0], e.mInfT[0], e.rho[0], TMVA::Types::kTesting  );
+         theMethod->TestRegression( e.bias[1], e.biasT[1], e.dev[1], e.devT[1], e.rms[1], e.rmsT[1],
+                                    e.mInf[1], e.mInfT[1], e.rho[1], TMVA::Types::kTraining  );
+      } 
+      else if (theMethod->DoMulticlass()) {
+         theMethod->Log() << kINFO << "Evaluate multiclass classification method: " << theMethod->GetMethodName() << Endl;
+         theMethod->TestMulticlass();
+         e.testEff = theMethod->GetMulticlassEfficiency(e.testPur);
+      } 
+      else {
+         theMethod->Log() << kINFO << "Evaluate classifier: " << theMethod->GetMethodName() << Endl;
+
+         // perform the evaluation
+         theMethod->TestClassification();
+
+         // evaluate the classifier
+         e.sig = theMethod->GetSignificance();
+         e.sep = theMethod->GetSeparation();
+         e.roc = theMethod->GetROCIntegral();
+
+         e.eff01   = theMethod->GetEfficiency("Efficiency:0.01", Types::kTesting, e.eff01err);
+         e.eff10   = theMethod->GetEfficiency("Efficiency:0.10", Types::kTesting, e.eff10err);
+         e.eff30   = theMethod->GetEfficiency("Efficiency:0.30", Types::kTesting, e.eff30err);
+         Double_t err;
+         e.effArea = theMethod->GetEfficiency("",                Types::kTesting, err); // computes the area (average)
+
+         e.trainEff01 = theMethod->GetTrainingEfficiency("Efficiency:0.01"); // the first pass takes longer
+         e.trainEff10 = theMethod->GetTrainingEfficiency("Efficiency:0.10");
+         e.trainEff30 = theMethod->GetTrainingEfficiency("Efficiency:0.30");
+      }
+   } );
+
+   // iterate over methods and collect the evaluation
    MVector::iterator itrMethod    = fMethods.begin();
    MVector::iterator itrMethodEnd = fMethods.end();
    for (; itrMethod != itrMethodEnd; itrMethod++) {
-      Event::SetIsTraining(kFALSE);
       MethodBase* theMethod = dynamic_cast<MethodBase*>(*itrMethod);
       if(theMethod==0) continue;
       if (theMethod->GetMethodType() != Types::kCuts) methodsNoCuts.push_back( *itrMethod );
+      const MethodEvaluation& e = evaluations[theMethod];
 
       if (theMethod->DoRegression()) {
          doRegression = kTRUE;
 
-         Log() << kINFO << "Evaluate regression method: " << theMethod->GetMethodName() << Endl;
-         Double_t bias, dev, rms, mInf;
-         Double_t biasT, devT, rmsT, mInfT;
-         Double_t rho;
-
-         theMethod->TestRegression( bias, biasT, dev, devT, rms, rmsT, mInf, mInfT, rho, TMVA::Types::kTesting  );
-         biastest[0]  .push_back( bias );
-         devtest[0]   .push_back( dev );
-         rmstest[0]   .push_back( rms );
-         minftest[0]  .push_back( mInf );
-         rhotest[0]   .push_back( rho );
-         biastestT[0] .push_back( biasT );
-         devtestT[0]  .push_back( devT );
-         rmstestT[0]  .push_back( rmsT );
-         minftestT[0] .push_back( mInfT );
-
-         theMethod->TestRegression( bias, biasT, dev, devT, rms, rmsT, mInf, mInfT, rho, TMVA::Types::kTraining  );
-         biastrain[0] .push_back( bias );
-         devtrain[0]  .push_back( dev );
-         rmstrain[0]  .push_back( rms );
-         minftrain[0] .push_back( mInf );
-         rhotrain[0]  .push_back( rho );
-         biastrainT[0].push_back( biasT );
-         devtrainT[0] .push_back( devT );
-         rmstrainT[0] .push_back( rmsT );
-         minftrainT[0].push_back( mInfT );
+         biastest[0]  .push_back( e.bias[0] );
+         devtest[0]   .push_back( e.dev[0] );
+         rmstest[0]   .push_back( e.rms[0] );
+         minftest[0]  .push_back( e.mInf[0] );
+         rhotest[0]   .push_back( e.rho[0] );
+         biastestT[0] .push_back( e.biasT[0] );
+         devtestT[0]  .push_back( e.devT[0] );
+         rmstestT[0]  .push_back( e.rmsT[0] );
+         minftestT[0] .push_back( e.mInfT[0] );
+
+         biastrain[0] .push_back( e.bias[1] );
+         devtrain[0]  .push_back( e.dev[1] );
+         rmstrain[0]  .push_back( e.rms[1] );
+         minftrain[0] .push_back( e.mInf[1] );
+         rhotrain[0]  .push_back( e.rho[1] );
+         biastrainT[0].push_back( e.biasT[1] );
+         devtrainT[0] .push_back( e.devT[1] );
+         rmstrainT[0] .push_back( e.rmsT[1] );
+         minftrainT[0].push_back( e.mInfT[1] );
 
          mname[0].push_back( theMethod->GetMethodName() );
          nmeth_used[0]++;
-
-         Log() << kINFO << "Write evaluation histograms to file" << Endl;
-         theMethod->WriteEvaluationHistosToFile(Types::kTesting);
-         theMethod->WriteEvaluationHistosToFile(Types::kTraining);
       } 
       else if (theMethod->DoMulticlass()) {
          doMulticlass = kTRUE;
-         Log() << kINFO << "Evaluate multiclass classification method: " << theMethod->GetMethodName() << Endl;
-         Log() << kINFO << "Write evaluation histograms to file" << Endl;
-         theMethod->WriteEvaluationHistosToFile(Types::kTesting);
-         theMethod->WriteEvaluationHistosToFile(Types::kTraining);
-         
-         theMethod->TestMulticlass();
-         multiclass_testEff.push_back(theMethod->GetMulticlassEfficiency(multiclass_testPur));
+         multiclass_testEff.push_back( e.testEff );
+         multiclass_testPur.insert( multiclass_testPur.end(), e.testPur.begin(), e.testPur.end() );
 
          nmeth_used[0]++;
          mname[0].push_back( theMethod->GetMethodName() );
       } 
       else {
-         
-         Log() << kINFO << "Evaluate classifier: " << theMethod->GetMethodName() << Endl;
          isel = (theMethod->GetMethodTypeName().Contains("Variable")) ? 1 : 0;
-      
-         // perform the evaluation
-         theMethod->TestClassification();
-         
-         // evaluate the classifier
-         mname[isel].push_back( theMethod->GetMethodName() );
-         sig[isel].push_back  ( theMethod->GetSignificance() );
-         sep[isel].push_back  ( theMethod->GetSeparation() );
-         roc[isel].push_back  ( theMethod->GetROCIntegral() );
 
-         Double_t err;
-         eff01[isel].push_back( theMethod->GetEfficiency("Efficiency:0.01", Types::kTesting, err) );
-         eff01err[isel].push_back( err );
-         eff10[isel].push_back( theMethod->GetEfficiency("Efficiency:0.10", Types::kTesting, err) );
-         eff10err[isel].push_back( err );
-         eff30[isel].push_back( theMethod->GetEfficiency("Efficiency:0.30", Types::kTesting, err) );
-         eff30err[isel].push_back( err );
-         effArea[isel].push_back( theMethod->GetEfficiency("",              Types::kTesting, err)  ); // computes the area (average)
-
-         trainEff01[isel].push_back( theMethod->GetTrainingEfficiency("Efficiency:0.01") ); // the first pass takes longer
-         trainEff10[isel].push_back( theMethod->GetTrainingEfficiency("Efficiency:0.10") );
-         trainEff30[isel].push_back( theMethod->GetTrainingEfficiency("Efficiency:0.30") );
+         mname[isel].push_back( theMethod->GetMethodName() );
+         sig[isel].push_back  ( e.sig );
+         sep[isel].push_back  ( e.sep );
+         roc[isel].push_back  ( e.roc );
+
+         eff01[isel].push_back( e.eff01 );
+         eff01err[isel].push_back( e.eff01err );
+         eff10[isel].push_back( e.eff10 );
+         eff10err[isel].push_back( e.eff10err );
+         eff30[isel].push_back( e.eff30 );
+         eff30err[isel].push_back( e.eff30err );
+         effArea[isel].push_back( e.effArea );
+
+         trainEff01[isel].push_back( e.trainEff01 );
+         trainEff10[isel].push_back( e.trainEff10 );
+         trainEff30[isel].push_back( e.trainEff30 );
 
          nmeth_used[isel]++;
-
-         Log() << kINFO << "Write evaluation histograms to file" << Endl;
-         theMethod->WriteEvaluationHistosToFile(Types::kTesting);
-         theMethod->WriteEvaluationHistosToFile(Types::kTraining);
       }
+
+      Log() << kINFO << "Write evaluation histograms of " << theMethod->GetMethodName() << " to file" << Endl;
+      theMethod->WriteEvaluationHistosToFile(Types::kTesting);
+      theMethod->WriteEvaluationHistosToFile(Types::kTraining);
    }
    if (doRegression) {
 
@@ -38,6 +38,7 @@
 //_______________________________________________________________________
 
 #include <vector>
+#include <algorithm>
 #include <cstdlib>
 #include <stdexcept>
 #if __cplusplus > 199711L
@@ -59,6 +60,11 @@
 #include "TMVA/TSynapse.h"
 #include "TMVA/TActivationChooser.h"
 #include "TMVA/TActivationTanh.h"
+#include "TMVA/TActivationSigmoid.h"
+#include "TMVA/TActivationRadial.h"
+#include "TMVA/TActivationIdentity.h"
+#include "TMVA/TActivationReLU.h"
+#include "TMVA/TNeuronInputSum.h"
 #include "TMVA/Types.h"
 #include "TMVA/Tools.h"
 #include "TMVA/TNeuronInputChooser.h"
@@ -222,6 +228,9 @@ void TMVA::MethodANNBase::InitANNBase()
    // these will be set in BuildNetwork()
    fInputLayer = NULL;
    fOutputNeurons.clear();
+   fDenseLayout.clear();
+   fDenseHidden = kDenseNone;
+   fDenseOutput = kDenseNone;
 
    frgen = new TRandom3(fRandomSeed);
 
@@ -322,6 +331,8 @@ void TMVA::MethodANNBase::BuildNetwork( std::vector<Int_t>* layout, std::vector<
 
    if (weights == NULL) InitWeights();
    else                 ForceWeights(weights);
+
+   BuildDenseLayout();
 }
 
 
@@ -434,6 +445,146 @@ void TMVA::MethodANNBase::AddPreLinks(TNeuron* neuron, TObjArray* prevLayer)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set up the dense form of the network. The synapses in fSynapses are, layer
+/// after layer, the row-major matrices of the links from the neurons of a
+/// layer (the bias neuron being the last one) to the neurons of the next
+/// layer, so the weights can be used as they are.
+/// The dense form requires the "sum" neuron input and activation functions
+/// which can be evaluated concurrently; fDenseLayout is left empty otherwise.
+
+void TMVA::MethodANNBase::BuildDenseLayout()
+{
+   fDenseLayout.clear();
+   fDenseHidden = GetDenseActivation( fActivation );
+   fDenseOutput = GetDenseActivation( fOutput );
+   if (fDenseHidden == kDenseNone || fDenseOutput == kDenseNone) return;
+   if (dynamic_cast<TNeuronInputSum*>(fInputCalculator) == 0) return;
+
+   Int_t numLayers = fNetwork->GetEntriesFast();
+   if (numLayers < 2) return;
+
+   std::vector<UInt_t> layout;
+   Int_t numSynapses = 0;
+   for (Int_t i = 0; i < numLayers; i++) {
+      Int_t numNeurons = ((TObjArray*)fNetwork->At(i))->GetEntriesFast();
+      if (i != numLayers-1) numNeurons--; // the bias neuron
+      layout.push_back(numNeurons);
+      if (i > 0) numSynapses += (layout[i-1]+1)*numNeurons;
+   }
+   if (numSynapses != fSynapses->GetEntriesFast()) return;
+
+   fDenseLayout = layout;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// how the dense form evaluates the given activation function: the TFormula
+/// based functions are computed directly, the others do not modify their
+/// state and are called as they are
+
+TMVA::MethodANNBase::EDenseActivation TMVA::MethodANNBase::GetDenseActivation( TActivation* activation )
+{
+   if (dynamic_cast<TActivationSigmoid*>(activation)) return kDenseSigmoid;
+   if (dynamic_cast<TActivationRadial*>(activation))  return kDenseRadial;
+   if (dynamic_cast<TActivationIdentity*>(activation) ||
+       dynamic_cast<TActivationTanh*>(activation) ||
+       dynamic_cast<TActivationReLU*>(activation)) return kDenseEval;
+   return kDenseNone;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// activation function of the neurons of the given layer (> 0) in the dense form
+
+Double_t TMVA::MethodANNBase::DenseActivation( UInt_t layer, Double_t x ) const
+{
+   Bool_t isOutput = (layer == fDenseLayout.size()-1);
+   switch (isOutput ? fDenseOutput : fDenseHidden) {
+   case kDenseSigmoid: return 1.0/(1.0+TMath::Exp(-x));
+   case kDenseRadial:  return TMath::Exp(-x*x/2.0);
+   default:            return (isOutput ? fOutput : fActivation)->Eval(x);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// derivative of the activation function of the given layer (> 0) in the dense form
+
+Double_t TMVA::MethodANNBase::DenseDerivative( UInt_t layer, Double_t x ) const
+{
+   Bool_t isOutput = (layer == fDenseLayout.size()-1);
+   switch (isOutput ? fDenseOutput : fDenseHidden) {
+   case kDenseSigmoid: {
+      Double_t e = TMath::Exp(-x);
+      return e/((1.0+e)*(1.0+e));
+   }
+   case kDenseRadial:  return -x*TMath::Exp(-x*x/2.0);
+   default:            return (isOutput ? fOutput : fActivation)->EvalDerivative(x);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// copy the synapse weights, in the order of fSynapses
+
+void TMVA::MethodANNBase::GetDenseWeights( std::vector<Double_t>& weights ) const
+{
+   Int_t numSynapses = fSynapses->GetEntriesFast();
+   weights.resize(numSynapses);
+   for (Int_t i = 0; i < numSynapses; i++) weights[i] = ((TSynapse*)fSynapses->At(i))->GetWeight();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Propagate a block of events through the dense form of the network.
+/// input holds the input variables event by event, input[iev*nvar+ivar], and
+/// weights the synapse weights in the order of fSynapses. On return, for each
+/// layer l, values[l] and activations[l] hold the input and the output of its
+/// neurons event by event; the rows of activations[l] end with the bias
+/// neuron (1) for all but the output layer. The neuron inputs are summed in
+/// the same order as by TNeuronInputSum.
+
+void TMVA::MethodANNBase::DenseForward( const Double_t* weights, const Double_t* input, UInt_t nEvents,
+                                        std::vector< std::vector<Double_t> >& values,
+                                        std::vector< std::vector<Double_t> >& activations ) const
+{
+   const UInt_t numLayers = fDenseLayout.size();
+   values.resize(numLayers);
+   activations.resize(numLayers);
+
+   UInt_t nPre = fDenseLayout[0];
+   activations[0].resize(nEvents*(nPre+1));
+   for (UInt_t iev = 0; iev < nEvents; iev++) {
+      Double_t* a = &activations[0][iev*(nPre+1)];
+      for (UInt_t j = 0; j < nPre; j++) a[j] = input[iev*nPre+j];
+      a[nPre] = 1.0;
+   }
+
+   const Double_t* w = weights;
+   for (UInt_t l = 1; l < numLayers; l++) {
+      const UInt_t n      = fDenseLayout[l];
+      const UInt_t stride = (l == numLayers-1) ? n : n+1;
+      const std::vector<Double_t>& prev = activations[l-1];
+      std::vector<Double_t>& z = values[l];
+      std::vector<Double_t>& a = activations[l];
+      z.resize(nEvents*n);
+      a.resize(nEvents*stride);
+
+      for (UInt_t iev = 0; iev < nEvents; iev++) {
+         Double_t*       zrow = &z[iev*n];
+         const Double_t* arow = &prev[iev*(nPre+1)];
+         for (UInt_t k = 0; k < n; k++) zrow[k] = 0;
+         for (UInt_t j = 0; j <= nPre; j++) {
+            const Double_t  x    = arow[j];
+            const Double_t* wrow = w + j*n;
+            for (UInt_t k = 0; k < n; k++) zrow[k] += wrow[k]*x;
+         }
+         Double_t* out = &a[iev*stride];
+         for (UInt_t k = 0; k < n; k++) out[k] = DenseActivation(l, zrow[k]);
+         if (stride > n) out[n] = 1.0;
+      }
+
+      w   += (nPre+1)*n;
+      nPre = n;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// initialize the synapse weights randomly
 
@@ -614,6 +765,38 @@ Double_t TMVA::MethodANNBase::GetMvaValue( Double_t* err, Double_t* errUpper )
    return neuron->GetActivationValue();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return in output the MVA values of nEvents events whose input variables
+/// are stored column-wise, input[ivar*nEvents+iev]. The events are propagated
+/// by blocks through the dense form of the network, which is not modified, so
+/// several threads can evaluate the method concurrently. Return kFALSE if
+/// the network has no dense form or if variable transformations are used.
+
+Bool_t TMVA::MethodANNBase::GetMvaValues( const Float_t* input, UInt_t nEvents, Double_t* output ) const
+{
+   if (!HasDenseNetwork() || DoRegression() || DoMulticlass()) return kFALSE;
+   if (GetTransformationHandler().GetNumOfTransformations() > 0) return kFALSE;
+
+   std::vector<Double_t> weights;
+   GetDenseWeights( weights );
+
+   const UInt_t nvar      = fDenseLayout.front();
+   const UInt_t nOut      = fDenseLayout.back();
+   const UInt_t blockSize = 256;
+   std::vector<Double_t> block( blockSize*nvar );
+   std::vector< std::vector<Double_t> > values, activations;
+   for (UInt_t first = 0; first < nEvents; first += blockSize) {
+      const UInt_t n = std::min( blockSize, nEvents-first );
+      for (UInt_t ivar = 0; ivar < nvar; ivar++) {
+         const Float_t* column = input + size_t(ivar)*nEvents + first;
+         for (UInt_t i = 0; i < n; i++) block[i*nvar+ivar] = column[i];
+      }
+      DenseForward( &weights[0], &block[0], n, values, activations );
+      for (UInt_t i = 0; i < n; i++) output[first+i] = activations.back()[i*nOut];
+   }
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// get the regression value generated by the NN
 
@@ -167,6 +167,7 @@ TMVA::MethodBDT::MethodBDT( const TString& jobName,
    , fMinNodeSize(5)
    , fMinNodeSizeS("5%")
    , fNCuts(0)
+   , fPreBinning(kFALSE)
    , fUseFisherCuts(0)        // don't use this initialisation, only here to make  Coverity happy. Is set in DeclarOptions()
    , fMinLinCorrForFisher(.8) // don't use this initialisation, only here to make  Coverity happy. Is set in DeclarOptions()
    , fUseExclusiveVars(0)     // don't use this initialisation, only here to make  Coverity happy. Is set in DeclarOptions()
@@ -221,6 +222,7 @@ TMVA::MethodBDT::MethodBDT( DataSetInfo& theData,
    , fMinNodeSize(5)
    , fMinNodeSizeS("5%")
    , fNCuts(0)
+   , fPreBinning(kFALSE)
    , fUseFisherCuts(0)        // don't use this initialisation, only here to make  Coverity happy. Is set in DeclarOptions()
    , fMinLinCorrForFisher(.8) // don't use this initialisation, only here to make  Coverity happy. Is set in DeclarOptions()
    , fUseExclusiveVars(0)     // don't use this initialisation, only here to make  Coverity happy. Is set in DeclarOptions()
@@ -292,6 +294,8 @@ Bool_t TMVA::MethodBDT::HasAnalysisType( Types::EAnalysisType type, UInt_t numbe
 /// MinNodeSize:     minimum percentage of training events in a leaf node (leaf criteria, stop splitting)
 /// nCuts:           the number of steps in the optimisation of the cut for a node (if < 0, then
 ///                  step size is determined by the events)
+/// PreBinning:      bin the variables once per tree, on the nCuts grid of the whole training
+///                  sample, and cut all the nodes on that grid
 /// UseFisherCuts:   use multivariate splits using the Fisher criterion
 /// UseYesNoLeaf     decide if the classification is done simply by the node type, or the S/B
 ///                  (from the training) in the leaf node
@@ -321,6 +325,7 @@ void TMVA::MethodBDT::DeclareOptions()
    DeclareOptionRef(fMinNodeSizeS=tmp, "MinNodeSize", "Minimum percentage of training events required in a leaf node (default: Classification: 5%, Regression: 0.2%)");
    // MinNodeSize:     minimum percentage of training events in a leaf node (leaf criteria, stop splitting)
    DeclareOptionRef(fNCuts, "nCuts", "Number of grid points in variable range used in finding optimal cut in node splitting");
+   DeclareOptionRef(fPreBinning=kFALSE, "PreBinning", "Bin the variables once per tree on the nCuts grid of the whole training sample, instead of the one of each node, and fill the node histograms from these bins (nCuts>0)");
 
    DeclareOptionRef(fBoostType, "BoostType", "Boosting type for the trees in the forest (note: AdaCost is still experimental)");
 
@@ -657,6 +662,7 @@ void TMVA::MethodBDT::Init( void )
    
 
    fNCuts          = 20;
+   fPreBinning     = kFALSE;
    fPruneMethodS   = "NoPruning";
    fPruneMethod    = DecisionTree::kNoPruning;
    fPruneStrength  = 0;
@@ -687,6 +693,7 @@ void TMVA::MethodBDT::Reset( void )
    fForest.clear();
 
    fBoostWeights.clear();
+   BuildFlatForest();
    if (fMonitorNtuple) fMonitorNtuple->Delete(); fMonitorNtuple=NULL;
    fVariableImportance.clear();
    fResiduals.clear();
@@ -721,6 +728,9 @@ void TMVA::MethodBDT::InitEventSample( void )
       // reset all previously stored/accumulated BOOST weights in the event sample
       for (UInt_t iev=0; iev<fEventSample.size(); iev++) fEventSample[iev]->SetBoostWeight(1.);
    } else {
+      // the copies of the untransformed training events are views onto the columns
+      // of the DataSet (Event::SetColumnView), they only hold their own weights and
+      // targets
       Data()->SetCurrentType(Types::kTraining);
       UInt_t nevents = Data()->GetNTrainingEvents();
 
@@ -1233,6 +1243,7 @@ void TMVA::MethodBDT::Train()
                                                  fRandomisedTrees, fUseNvars, fUsePoissonNvars, fMaxDepth,
                                                  itree*nClasses+i, fNodePurityLimit, itree*nClasses+1));
             fForest.back()->SetNVars(GetNvar());
+            fForest.back()->SetPreBinning(fPreBinning);
             if (fUseFisherCuts) {
                fForest.back()->SetUseFisherCuts();
                fForest.back()->SetMinLinCorrForFisher(fMinLinCorrForFisher); 
@@ -1257,6 +1268,7 @@ void TMVA::MethodBDT::Train()
                                               fRandomisedTrees, fUseNvars, fUsePoissonNvars, fMaxDepth,
                                               itree, fNodePurityLimit, itree));
          fForest.back()->SetNVars(GetNvar());
+         fForest.back()->SetPreBinning(fPreBinning);
          if (fUseFisherCuts) {
             fForest.back()->SetUseFisherCuts();
             fForest.back()->SetMinLinCorrForFisher(fMinLinCorrForFisher); 
@@ -1343,6 +1355,7 @@ void TMVA::MethodBDT::Train()
    fEventSample.clear();
    fValidationSample.clear();
 
+   BuildFlatForest();
 }
 
 
@@ -2263,6 +2276,7 @@ void TMVA::MethodBDT::ReadWeightsFromXML(void* parent) {
       fBoostWeights.push_back(boostWeight);
       ch = gTools().GetNextChild(ch);
    }
+   BuildFlatForest();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2299,6 +2313,7 @@ void  TMVA::MethodBDT::ReadWeightsFromStream( std::istream& istr )
       fForest.back()->Read(istr, GetTrainingTMVAVersionCode());
       fBoostWeights.push_back(boostWeight);
    }
+   BuildFlatForest();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2350,6 +2365,122 @@ Double_t TMVA::MethodBDT::PrivateGetMvaValue(const TMVA::Event* ev, Double_t* er
    return ( norm > std::numeric_limits<double>::epsilon() ) ? myMVA /= norm : 0 ;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return in output the MVA values of nEvents events, the input variables
+/// being stored column-wise: input[ivar*nEvents+iev].
+/// The events are passed through the flattened forest in blocks, tree after
+/// tree, which gives exactly the values of PrivateGetMvaValue. The method is
+/// not modified, hence it can be called concurrently from several threads.
+/// Return kFALSE, without touching output, if the flat forest can not be used:
+/// variable transformations, preselection cuts, multivariate (Fisher) cuts,
+/// regression or multiclass.
+
+Bool_t TMVA::MethodBDT::GetMvaValues( const Float_t* input, UInt_t nEvents, Double_t* output ) const
+{
+   if (fFlatRoots.empty() || fFlatRoots.size() != fForest.size()) return kFALSE;
+   if (DoRegression() || DoMulticlass() || fDoPreselection) return kFALSE;
+   if (GetTransformationHandler().GetNumOfTransformations() > 0) return kFALSE;
+
+   const UInt_t    nTrees   = fFlatRoots.size();
+   const Bool_t    gradBoost = (fBoostType=="Grad");
+   const Float_t*  cut      = &fFlatCut[0];
+   const Int_t*    selector = &fFlatSelector[0];
+   const UInt_t*   children = &fFlatChildren[0];
+
+   Double_t norm = 0;
+   if (!gradBoost) {
+      for (UInt_t itree=0; itree<nTrees; itree++) norm += fBoostWeights[itree];
+   }
+
+   // the block is small enough for the sums to stay in the cache, and large
+   // enough for the nodes of one tree to be reused by many events
+   const UInt_t blockSize = 256;
+   Double_t sum[blockSize];
+   for (UInt_t first=0; first<nEvents; first+=blockSize) {
+      const UInt_t n = std::min(blockSize, nEvents-first);
+      for (UInt_t i=0; i<n; i++) sum[i] = 0;
+
+      for (UInt_t itree=0; itree<nTrees; itree++) {
+         const Double_t boostWeight = gradBoost ? 1. : fBoostWeights[itree];
+         const UInt_t root = fFlatRoots[itree];
+         for (UInt_t i=0; i<n; i++) {
+            const Float_t* ev = input + first + i;
+            UInt_t inode = root;
+            while (selector[inode] >= 0)
+               inode = children[2*inode + (ev[size_t(selector[inode])*nEvents] >= cut[inode])];
+            sum[i] += boostWeight*cut[inode];
+         }
+      }
+
+      for (UInt_t i=0; i<n; i++) {
+         if (gradBoost) output[first+i] = 2.0/(1.0+exp(-2.0*sum[i]))-1;
+         else           output[first+i] = ( norm > std::numeric_limits<double>::epsilon() ) ? sum[i]/norm : 0;
+      }
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the forest into the flat node arrays used by GetMvaValues. The
+/// arrays are left empty if one of the trees can not be flattened.
+
+void TMVA::MethodBDT::BuildFlatForest()
+{
+   fFlatCut.clear();
+   fFlatSelector.clear();
+   fFlatChildren.clear();
+   fFlatRoots.clear();
+
+   // the leaf values returned by CheckEvent in PrivateGetMvaValue
+   Bool_t useYesNoLeaf = (fBoostType!="Grad" && fUseYesNoLeaf);
+
+   for (UInt_t itree=0; itree<fForest.size(); itree++) {
+      fFlatRoots.push_back(fFlatCut.size());
+      if (fForest[itree]->GetRoot() == 0 ||
+          !FlattenNode(fForest[itree]->GetRoot(), fForest[itree], useYesNoLeaf)) {
+         fFlatCut.clear();
+         fFlatSelector.clear();
+         fFlatChildren.clear();
+         fFlatRoots.clear();
+         return;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append node and, recursively, its daughters to the flat forest.
+/// Return kFALSE for the nodes that can not be flattened (Fisher cuts).
+
+Bool_t TMVA::MethodBDT::FlattenNode( const DecisionTreeNode *node, const DecisionTree *dt, Bool_t useYesNoLeaf )
+{
+   UInt_t inode = fFlatCut.size();
+   fFlatCut.push_back(0);
+   fFlatSelector.push_back(-1);
+   fFlatChildren.push_back(0);
+   fFlatChildren.push_back(0);
+
+   if (node->GetNodeType() != 0) { // leaf, same value as DecisionTree::CheckEvent
+      if (dt->DoRegression()) fFlatCut[inode] = node->GetResponse();
+      else if (useYesNoLeaf)  fFlatCut[inode] = node->GetNodeType();
+      else                    fFlatCut[inode] = node->GetPurity();
+      return kTRUE;
+   }
+
+   if (node->GetNFisherCoeff() != 0 || node->GetLeft() == 0 || node->GetRight() == 0) return kFALSE;
+   if (node->GetSelector() < 0 || UInt_t(node->GetSelector()) >= GetNvar()) return kFALSE;
+
+   fFlatCut[inode]      = node->GetCutValue();
+   fFlatSelector[inode] = node->GetSelector();
+
+   // GoesRight is (value >= cut) if the cut type is kTRUE, its negation otherwise
+   const DecisionTreeNode *below = node->GetCutType() ? node->GetLeft()  : node->GetRight();
+   const DecisionTreeNode *above = node->GetCutType() ? node->GetRight() : node->GetLeft();
+   fFlatChildren[2*inode] = fFlatCut.size();
+   if (!FlattenNode(below, dt, useYesNoLeaf)) return kFALSE;
+   fFlatChildren[2*inode+1] = fFlatCut.size();
+   return FlattenNode(above, dt, useYesNoLeaf);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// get the multiclass MVA response for the BDT classifier
@@ -3180,6 +3180,17 @@ const std::vector<TMVA::Event*>& TMVA::MethodBase::GetEventCollection( Types::ET
    return *(fEventCollections.at(idx));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// the columns of the DataSet (DataSet::GetColumn, GetColumnBlock) hold the
+/// untransformed values of all the events, hence they give the same values as
+/// GetEvent(ievt) only if this method has no variable transformation and the
+/// events of the current tree type are not sampled
+
+Bool_t TMVA::MethodBase::UseDataSetColumns() const
+{
+   return GetTransformationHandler().GetNumOfTransformations() == 0 && !Data()->HasSampling();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// calculates the TMVA version string from the training version code on the fly
 
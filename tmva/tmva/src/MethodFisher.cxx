@@ -306,19 +306,46 @@ void TMVA::MethodFisher::GetMean( void )
    for (UInt_t ivar=0; ivar<nvar; ivar++) { sumS[ivar] = sumB[ivar] = 0; }
 
    // compute sample means
-   for (Int_t ievt=0; ievt<Data()->GetNEvents(); ievt++) {
+   if (UseDataSetColumns()) {
+      // untransformed events: sum variable by variable over blocks of columns of the DataSet
+      const Types::ETreeType type = Data()->GetCurrentType();
+      const Long64_t nevents = Data()->GetNEvents();
+      const UInt_t signalClass = DataInfo().GetSignalClassIndex();
+      std::vector<Float_t>  values;
+      std::vector<UInt_t>   classes;
+      std::vector<Double_t> weights;
+
+      for (Long64_t first=0; first<nevents; first+=DataSet::GetColumnBlockSize()) {
+         const UInt_t n = TMath::Min( Long64_t(DataSet::GetColumnBlockSize()), nevents-first );
+         Data()->GetColumnBlock( first, n, values, classes, weights, type );
+         for (UInt_t i=0; i<n; i++) {
+            if (classes[i] == signalClass) fSumOfWeightsS += weights[i];
+            else                           fSumOfWeightsB += weights[i];
+         }
+         for (UInt_t ivar=0; ivar<nvar; ivar++) {
+            const Float_t* x = &values[size_t(ivar)*n];
+            for (UInt_t i=0; i<n; i++) {
+               if (classes[i] == signalClass) sumS[ivar] += x[i]*weights[i];
+               else                           sumB[ivar] += x[i]*weights[i];
+            }
+         }
+      }
+   }
+   else {
+      for (Int_t ievt=0; ievt<Data()->GetNEvents(); ievt++) {
 
-      // read the Training Event into "event"
-      const Event * ev = GetEvent(ievt);
+         // read the Training Event into "event"
+         const Event * ev = GetEvent(ievt);
 
-      // sum of weights
-      Double_t weight = ev->GetWeight();
-      if (DataInfo().IsSignal(ev)) fSumOfWeightsS += weight;
-      else                         fSumOfWeightsB += weight;
+         // sum of weights
+         Double_t weight = ev->GetWeight();
+         if (DataInfo().IsSignal(ev)) fSumOfWeightsS += weight;
+         else                         fSumOfWeightsB += weight;
 
-      Double_t* sum = DataInfo().IsSignal(ev) ? sumS : sumB;
+         Double_t* sum = DataInfo().IsSignal(ev) ? sumS : sumB;
 
-      for (UInt_t ivar=0; ivar<nvar; ivar++) sum[ivar] += ev->GetValue( ivar )*weight;
+         for (UInt_t ivar=0; ivar<nvar; ivar++) sum[ivar] += ev->GetValue( ivar )*weight;
+      }
    }
 
    for (UInt_t ivar=0; ivar<nvar; ivar++) {
@@ -358,25 +385,55 @@ void TMVA::MethodFisher::GetCov_WithinClass( void )
    memset(sumBgd,0,nvar2*sizeof(Double_t));
    
    // 'within class' covariance
-   for (Int_t ievt=0; ievt<Data()->GetNEvents(); ievt++) {
-
-      // read the Training Event into "event"
-      const Event* ev = GetEvent(ievt);
-
-      Double_t weight = ev->GetWeight(); // may ignore events with negative weights
-
-      for (Int_t x=0; x<nvar; x++) xval[x] = ev->GetValue( x );
-      Int_t k=0;
-      for (Int_t x=0; x<nvar; x++) {
-         for (Int_t y=0; y<nvar; y++) {            
-            if (DataInfo().IsSignal(ev)) {
-               Double_t v = ( (xval[x] - (*fMeanMatx)(x, 0))*(xval[y] - (*fMeanMatx)(y, 0)) )*weight;
-               sumSig[k] += v;
-            }else{
-               Double_t v = ( (xval[x] - (*fMeanMatx)(x, 1))*(xval[y] - (*fMeanMatx)(y, 1)) )*weight;
-               sumBgd[k] += v;
+   if (UseDataSetColumns()) {
+      // untransformed events: accumulate each element of the matrices over blocks of columns of the DataSet
+      const Types::ETreeType type = Data()->GetCurrentType();
+      const Long64_t nevents = Data()->GetNEvents();
+      const UInt_t signalClass = DataInfo().GetSignalClassIndex();
+      std::vector<Float_t>  values;
+      std::vector<UInt_t>   classes;
+      std::vector<Double_t> weights;
+
+      for (Long64_t first=0; first<nevents; first+=DataSet::GetColumnBlockSize()) {
+         const UInt_t n = TMath::Min( Long64_t(DataSet::GetColumnBlockSize()), nevents-first );
+         Data()->GetColumnBlock( first, n, values, classes, weights, type );
+         Int_t k=0;
+         for (Int_t x=0; x<nvar; x++) {
+            const Float_t* xcol = &values[size_t(x)*n];
+            for (Int_t y=0; y<nvar; y++) {
+               const Float_t* ycol = &values[size_t(y)*n];
+               const Double_t mxS = (*fMeanMatx)(x, 0), myS = (*fMeanMatx)(y, 0);
+               const Double_t mxB = (*fMeanMatx)(x, 1), myB = (*fMeanMatx)(y, 1);
+               for (UInt_t i=0; i<n; i++) {
+                  if (classes[i] == signalClass) sumSig[k] += ( (xcol[i] - mxS)*(ycol[i] - myS) )*weights[i];
+                  else                           sumBgd[k] += ( (xcol[i] - mxB)*(ycol[i] - myB) )*weights[i];
+               }
+               k++;
+            }
+         }
+      }
+   }
+   else {
+      for (Int_t ievt=0; ievt<Data()->GetNEvents(); ievt++) {
+
+         // read the Training Event into "event"
+         const Event* ev = GetEvent(ievt);
+
+         Double_t weight = ev->GetWeight(); // may ignore events with negative weights
+
+         for (Int_t x=0; x<nvar; x++) xval[x] = ev->GetValue( x );
+         Int_t k=0;
+         for (Int_t x=0; x<nvar; x++) {
+            for (Int_t y=0; y<nvar; y++) {            
+               if (DataInfo().IsSignal(ev)) {
+                  Double_t v = ( (xval[x] - (*fMeanMatx)(x, 0))*(xval[y] - (*fMeanMatx)(y, 0)) )*weight;
+                  sumSig[k] += v;
+               }else{
+                  Double_t v = ( (xval[x] - (*fMeanMatx)(x, 1))*(xval[y] - (*fMeanMatx)(y, 1)) )*weight;
+                  sumBgd[k] += v;
+               }
+               k++;
             }
-            k++;
          }
       }
    }
@@ -247,6 +247,16 @@ void TMVA::MethodKNN::Train()
 
    Log() << kINFO << "Reading " << GetNEvents() << " events" << Endl;
 
+   // untransformed variables are read from the columns of the DataSet
+   std::vector<const Float_t*> columns;
+   if (UseDataSetColumns()) {
+      for (UInt_t ivar = 0; ivar < GetNVariables(); ++ivar) {
+         const Float_t* column = Data()->GetColumn(ivar, Types::kTraining);
+         if (!column) { columns.clear(); break; }
+         columns.push_back(column);
+      }
+   }
+
    for (UInt_t ievt = 0; ievt < GetNEvents(); ++ievt) {
       // read the training event
       const Event*   evt_   = GetEvent(ievt);
@@ -256,7 +266,8 @@ void TMVA::MethodKNN::Train()
       if (IgnoreEventsWithNegWeightsInTraining() && weight <= 0) continue;          
 
       kNN::VarVec vvec(GetNVariables(), 0.0);      
-      for (UInt_t ivar = 0; ivar < evt_ -> GetNVariables(); ++ivar) vvec[ivar] = evt_->GetValue(ivar);
+      if (!columns.empty()) for (UInt_t ivar = 0; ivar < columns.size(); ++ivar) vvec[ivar] = columns[ivar][ievt];
+      else for (UInt_t ivar = 0; ivar < evt_ -> GetNVariables(); ++ivar) vvec[ivar] = evt_->GetValue(ivar);
       
       Short_t event_type = 0;
 
@@ -334,19 +334,43 @@ void TMVA::MethodLikelihood::Train( void )
    for (UInt_t ivar=0; ivar<nvar; ivar++) {xmin[ivar]=1e30; xmax[ivar]=-1e30;}
 
    UInt_t nevents=Data()->GetNEvents();
-   for (UInt_t ievt=0; ievt<nevents; ievt++) {
-      // use the true-event-type's transformation
-      // set the event true event types transformation
-      const Event* origEv = Data()->GetEvent(ievt);
-      if (IgnoreEventsWithNegWeightsInTraining() && origEv->GetWeight()<=0) continue;
-      // loop over classes
-      for (int cls=0;cls<2;cls++){
-         GetTransformationHandler().SetTransformationReferenceClass(cls);
-         const Event* ev = GetTransformationHandler().Transform( origEv );
+
+   // without transformation the events are read variable by variable from blocks of columns of the DataSet
+   const Bool_t useColumns = UseDataSetColumns();
+   const Types::ETreeType type = Data()->GetCurrentType();
+   std::vector<Float_t>  values;
+   std::vector<UInt_t>   classes;
+   std::vector<Double_t> weights;
+
+   if (useColumns) {
+      for (UInt_t first=0; first<nevents; first+=DataSet::GetColumnBlockSize()) {
+         const UInt_t n = TMath::Min( DataSet::GetColumnBlockSize(), nevents-first );
+         Data()->GetColumnBlock( first, n, values, classes, weights, type );
          for (UInt_t ivar=0; ivar<nvar; ivar++) {
-            Float_t value  = ev->GetValue(ivar);
-            if (value < xmin[ivar]) xmin[ivar] = value;
-            if (value > xmax[ivar]) xmax[ivar] = value;
+            const Float_t* x = &values[size_t(ivar)*n];
+            for (UInt_t i=0; i<n; i++) {
+               if (IgnoreEventsWithNegWeightsInTraining() && weights[i]<=0) continue;
+               if (x[i] < xmin[ivar]) xmin[ivar] = x[i];
+               if (x[i] > xmax[ivar]) xmax[ivar] = x[i];
+            }
+         }
+      }
+   }
+   else {
+      for (UInt_t ievt=0; ievt<nevents; ievt++) {
+         // use the true-event-type's transformation
+         // set the event true event types transformation
+         const Event* origEv = Data()->GetEvent(ievt);
+         if (IgnoreEventsWithNegWeightsInTraining() && origEv->GetWeight()<=0) continue;
+         // loop over classes
+         for (int cls=0;cls<2;cls++){
+            GetTransformationHandler().SetTransformationReferenceClass(cls);
+            const Event* ev = GetTransformationHandler().Transform( origEv );
+            for (UInt_t ivar=0; ivar<nvar; ivar++) {
+               Float_t value  = ev->GetValue(ivar);
+               if (value < xmin[ivar]) xmin[ivar] = value;
+               if (value > xmax[ivar]) xmax[ivar] = value;
+            }
          }
       }
    }
@@ -386,38 +410,56 @@ void TMVA::MethodLikelihood::Train( void )
    // ----- fill the reference histograms
    Log() << kINFO << "Filling reference histograms" << Endl;
 
-   // event loop
-   for (Int_t ievt=0; ievt<Data()->GetNEvents(); ievt++) {
+   // fill one value of the variable ivar in the reference histogram of its class
+   auto fillValue = [&]( UInt_t ivar, Double_t value, Float_t weight, Bool_t isSignal ) {
+      // verify limits
+      if (value >= xmax[ivar]) value = xmax[ivar] - 1.0e-10;
+      else if (value < xmin[ivar]) value = xmin[ivar] + 1.0e-10;
+      // inserting check if there are events in overflow or underflow
+      if (value >=(*fHistSig)[ivar]->GetXaxis()->GetXmax() ||
+          value <(*fHistSig)[ivar]->GetXaxis()->GetXmin()){
+         Log()<<kWARNING
+              <<"error in filling likelihood reference histograms var="
+              <<(*fInputVars)[ivar]
+              << ", xmin="<<(*fHistSig)[ivar]->GetXaxis()->GetXmin()
+              << ", value="<<value
+              << ", xmax="<<(*fHistSig)[ivar]->GetXaxis()->GetXmax()
+              << Endl;
+      }
+      if (isSignal) (*fHistSig)[ivar]->Fill( value, weight );
+      else          (*fHistBgd)[ivar]->Fill( value, weight );
+   };
+
+   if (useColumns) {
+      const UInt_t signalClass = DataInfo().GetSignalClassIndex();
+      for (UInt_t first=0; first<nevents; first+=DataSet::GetColumnBlockSize()) {
+         const UInt_t n = TMath::Min( DataSet::GetColumnBlockSize(), nevents-first );
+         Data()->GetColumnBlock( first, n, values, classes, weights, type );
+         for (UInt_t ivar=0; ivar<nvar; ivar++) {
+            const Float_t* x = &values[size_t(ivar)*n];
+            for (UInt_t i=0; i<n; i++) {
+               if (IgnoreEventsWithNegWeightsInTraining() && weights[i]<=0) continue;
+               fillValue( ivar, x[i], weights[i], classes[i] == signalClass );
+            }
+         }
+      }
+   }
+   else {
+      // event loop
+      for (UInt_t ievt=0; ievt<nevents; ievt++) {
 
-      // use the true-event-type's transformation
-      // set the event true event types transformation
-      const Event* origEv = Data()->GetEvent(ievt);
-      if (IgnoreEventsWithNegWeightsInTraining() && origEv->GetWeight()<=0) continue;
-      GetTransformationHandler().SetTransformationReferenceClass( origEv->GetClass() );
-      const Event* ev = GetTransformationHandler().Transform( origEv );
+         // use the true-event-type's transformation
+         // set the event true event types transformation
+         const Event* origEv = Data()->GetEvent(ievt);
+         if (IgnoreEventsWithNegWeightsInTraining() && origEv->GetWeight()<=0) continue;
+         GetTransformationHandler().SetTransformationReferenceClass( origEv->GetClass() );
+         const Event* ev = GetTransformationHandler().Transform( origEv );
 
-      // the event weight
-      Float_t weight = ev->GetWeight();
+         // the event weight
+         Float_t weight = ev->GetWeight();
 
-      // fill variable vector
-      for (UInt_t ivar=0; ivar<GetNvar(); ivar++) {
-         Double_t value  = ev->GetValue(ivar);
-         // verify limits
-         if (value >= xmax[ivar]) value = xmax[ivar] - 1.0e-10;
-         else if (value < xmin[ivar]) value = xmin[ivar] + 1.0e-10;
-         // inserting check if there are events in overflow or underflow
-         if (value >=(*fHistSig)[ivar]->GetXaxis()->GetXmax() ||
-             value <(*fHistSig)[ivar]->GetXaxis()->GetXmin()){
-            Log()<<kWARNING
-                 <<"error in filling likelihood reference histograms var="
-                 <<(*fInputVars)[ivar]
-                 << ", xmin="<<(*fHistSig)[ivar]->GetXaxis()->GetXmin()
-                 << ", value="<<value
-                 << ", xmax="<<(*fHistSig)[ivar]->GetXaxis()->GetXmax()
-                 << Endl;
-         }
-         if (DataInfo().IsSignal(ev)) (*fHistSig)[ivar]->Fill( value, weight );
-         else                (*fHistBgd)[ivar]->Fill( value, weight );
+         // fill variable vector
+         for (UInt_t ivar=0; ivar<GetNvar(); ivar++) fillValue( ivar, ev->GetValue(ivar), weight, DataInfo().IsSignal(ev) );
       }
    }
 
@@ -43,6 +43,8 @@
 #include "TString.h"
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <thread>
 #include "TTree.h"
 #include "Riostream.h"
 #include "TFitter.h"
@@ -90,6 +92,7 @@ TMVA::MethodMLP::MethodMLP( const TString& jobName,
      fResetStep(0), fLearnRate(0.0), fDecayRate(0.0),
      fBPMode(kSequential), fBpModeS("None"),
      fBatchSize(0), fTestRate(0), fEpochMon(false),
+     fDenseBackend(kFALSE), fNThreads(1), fDenseType(-1),
      fGA_nsteps(0), fGA_preCalc(0), fGA_SC_steps(0),
      fGA_SC_rate(0), fGA_SC_factor(0.0),
      fDeviationsFromTargets(0),
@@ -113,6 +116,7 @@ TMVA::MethodMLP::MethodMLP( DataSetInfo& theData,
      fResetStep(0), fLearnRate(0.0), fDecayRate(0.0),
      fBPMode(kSequential), fBpModeS("None"),
      fBatchSize(0), fTestRate(0), fEpochMon(false),
+     fDenseBackend(kFALSE), fNThreads(1), fDenseType(-1),
      fGA_nsteps(0), fGA_preCalc(0), fGA_SC_steps(0),
      fGA_SC_rate(0), fGA_SC_factor(0.0),
      fDeviationsFromTargets(0),
@@ -169,6 +173,10 @@ void TMVA::MethodMLP::Init()
 ///
 /// BatchSize       <int>        Batch size: number of events/batch, only set if in Batch Mode,
 ///                                          -1 for BatchSize=number_of_events
+///
+/// DenseBackend    <bool>       Compute the error and its gradient (BFGS, and BP in batch mode)
+///                              by blocks of events with the weight matrices of the network
+/// NThreads        <int>        Number of threads sharing the blocks of events in the dense backend
 
 void TMVA::MethodMLP::DeclareOptions()
 {
@@ -201,6 +209,11 @@ void TMVA::MethodMLP::DeclareOptions()
    DeclareOptionRef(fBatchSize=-1, "BatchSize",
                     "Batch size: number of events/batch, only set if in Batch Mode, -1 for BatchSize=number_of_events");
 
+   DeclareOptionRef(fDenseBackend=kFALSE, "DenseBackend",
+                    "Compute the error and its gradient (BFGS, and BP in batch mode) by blocks of events with the weight matrices of the network");
+   DeclareOptionRef(fNThreads=1, "NThreads",
+                    "Number of threads sharing the blocks of events with DenseBackend; the training does not depend on it");
+
    DeclareOptionRef(fImprovement=1e-30, "ConvergenceImprove",
                     "Minimum improvement which counts as improvement (<0 means automatic convergence check is turned off)");
 
@@ -248,6 +261,14 @@ void TMVA::MethodMLP::ProcessOptions()
       Int_t numEvents = Data()->GetNEvents();
       if (fBatchSize < 1 || fBatchSize > numEvents) fBatchSize = numEvents;
    }
+
+   if (fNThreads < 1) {
+      Log() << kWARNING << "NThreads=" << fNThreads << " is not valid, I will use one thread" << Endl;
+      fNThreads = 1;
+   }
+   if (fNThreads > 1 && !fDenseBackend) {
+      Log() << kWARNING << "NThreads is only used with DenseBackend, I will use one thread" << Endl;
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -429,6 +450,14 @@ void TMVA::MethodMLP::Train(Int_t nEpochs)
    if (nSynapses>nEvents)
       Log()<<kWARNING<<"ANN too complicated: #events="<<nEvents<<"\t#synapses="<<nSynapses<<Endl;
 
+   if (fDenseBackend && !HasDenseNetwork()) {
+      Log() << kWARNING << "The network has no dense form (neuron input \"" << fNeuronInputType
+            << "\", activation \"" << fNeuronType << "\"), DenseBackend is not used" << Endl;
+   }
+
+   // the events of the dense backend are gathered once per training
+   ClearDenseEvents();
+
 #ifdef MethodMLP_UseMinuit__
    if (useMinuit) MinuitMinimize();
 #else
@@ -437,6 +466,8 @@ void TMVA::MethodMLP::Train(Int_t nEpochs)
    else                               BackPropagationMinimize(nEpochs);
 #endif
 
+   ClearDenseEvents();
+
    float trainE = CalculateEstimator( Types::kTraining, 0 ) ; // estimator for training sample  //zjh
    float testE  = CalculateEstimator( Types::kTesting,  0 ) ; // estimator for test sample //zjh
    if (fUseRegulator){
@@ -665,6 +696,21 @@ void TMVA::MethodMLP::ComputeDEDw()
       synapse->SetDEDw( 0.0 );
    }
 
+   if (UseDenseBackend()) {
+      std::vector<Int_t> used;
+      GatherDenseEvents( used );
+      std::vector<Double_t> weights, dEdw;
+      GetDenseWeights( weights );
+      DenseErrorAndGradient( weights, used.empty() ? 0 : &used[0], used.size(), &dEdw );
+      for (Int_t i=0;i<nSynapses;i++) {
+         TSynapse *synapse = (TSynapse*)fSynapses->At(i);
+         Double_t DEDw = dEdw[i];
+         if (fUseRegulator) DEDw+=fPriorDev[i];
+         synapse->SetDEDw( DEDw / used.size() );
+      }
+      return;
+   }
+
    Int_t nEvents = GetNEvents();
    Int_t nPosEvents = nEvents;
    for (Int_t i=0;i<nEvents;i++) {
@@ -932,29 +978,38 @@ Double_t TMVA::MethodMLP::GetError()
    UInt_t ntgts = GetNTargets();
    Double_t Result = 0.;
 
-   for (Int_t i=0;i<nEvents;i++) {
-      const Event* ev = GetEvent(i);
-
-       if ((ev->GetWeight() < 0) && IgnoreEventsWithNegWeightsInTraining()
-          &&  (Data()->GetCurrentType() == Types::kTraining)){
-         continue;
-      }
-      SimulateEvent( ev );
+   if (UseDenseBackend()) {
+      std::vector<Int_t> used;
+      GatherDenseEvents( used );
+      std::vector<Double_t> weights;
+      GetDenseWeights( weights );
+      Result = DenseErrorAndGradient( weights, used.empty() ? 0 : &used[0], used.size(), 0 );
+   }
+   else {
+      for (Int_t i=0;i<nEvents;i++) {
+         const Event* ev = GetEvent(i);
 
-      Double_t error = 0.;
-      if (DoRegression()) {
-         for (UInt_t itgt = 0; itgt < ntgts; itgt++) {
-            error += GetMSEErr( ev, itgt );	//zjh
+          if ((ev->GetWeight() < 0) && IgnoreEventsWithNegWeightsInTraining()
+             &&  (Data()->GetCurrentType() == Types::kTraining)){
+            continue;
          }
-      } else if ( DoMulticlass() ){
-         for( UInt_t icls = 0, iclsEnd = DataInfo().GetNClasses(); icls < iclsEnd; icls++ ){
-            error += GetMSEErr( ev, icls );
+         SimulateEvent( ev );
+
+         Double_t error = 0.;
+         if (DoRegression()) {
+            for (UInt_t itgt = 0; itgt < ntgts; itgt++) {
+               error += GetMSEErr( ev, itgt );	//zjh
+            }
+         } else if ( DoMulticlass() ){
+            for( UInt_t icls = 0, iclsEnd = DataInfo().GetNClasses(); icls < iclsEnd; icls++ ){
+               error += GetMSEErr( ev, icls );
+            }
+         } else {
+            if (fEstimator==kMSE) error = GetMSEErr( ev );  //zjh
+            else if (fEstimator==kCE) error= GetCEErr( ev ); //zjh
          }
-      } else {
-         if (fEstimator==kMSE) error = GetMSEErr( ev );  //zjh
-         else if (fEstimator==kCE) error= GetCEErr( ev ); //zjh
+         Result += error * ev->GetWeight();
       }
-      Result += error * ev->GetWeight();
    }
    if (fUseRegulator) Result+=fPrior;  //zjh
    if (Result<0) Log()<<kWARNING<<"\nNegative Error!!! :"<<Result-fPrior<<"+"<<fPrior<<Endl;
@@ -1104,6 +1159,29 @@ void TMVA::MethodMLP::TrainOneEpoch()
    for (Int_t i = 0; i < nEvents; i++) index[i] = i;
    Shuffle(index, nEvents);
 
+   if (fBPMode == kBatch && UseDenseBackend()) {
+      // same batches as below, the gradient of each batch being computed at
+      // once; the deltas of the last, incomplete, batch are kept in the
+      // synapses and applied with the first batch of the next epoch
+      std::vector<Int_t> used, rows;
+      GatherDenseEvents( used, &rows );
+
+      std::vector<Double_t> weights;
+      GetDenseWeights( weights );
+      std::vector<Int_t> batch;
+      for (Int_t i = 0; i < nEvents; i++) {
+         if (rows[index[i]] < 0) continue;
+         batch.push_back(rows[index[i]]);
+         if ((i+1)%fBatchSize == 0) {
+            AdjustSynapseWeightsDense( weights, batch, kTRUE );
+            batch.clear();
+         }
+      }
+      if (!batch.empty()) AdjustSynapseWeightsDense( weights, batch, kFALSE );
+      delete[] index;
+      return;
+   }
+
    // loop over all training events
    for (Int_t i = 0; i < nEvents; i++) {
 
@@ -1134,6 +1212,223 @@ void TMVA::MethodMLP::TrainOneEpoch()
    delete[] index;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill used with the rows, in fDenseInput, fDenseTarget and fDenseWeight, of
+/// the current events taken into account in the training (as in ComputeDEDw),
+/// and rows, if given, with the row of each current event, -1 for the events
+/// not taken into account.
+/// The input variables, desired outputs and weights of all the events of the
+/// current tree type are copied into these arrays the first time, after the
+/// variable transformations, and kept until ClearDenseEvents: the current
+/// events, a sample of them if the sampling is used, are looked up there.
+
+void TMVA::MethodMLP::GatherDenseEvents( std::vector<Int_t>& used, std::vector<Int_t>* rows )
+{
+   const Types::ETreeType type = Data()->GetCurrentType();
+
+   if (fDenseType != Int_t(type)) {
+      const UInt_t nvar = fDenseLayout.front();
+      const UInt_t nOut = fDenseLayout.back();
+      const std::vector<Event*>& events = Data()->GetEventCollection( type );
+      const UInt_t nAll = events.size();
+      fDenseInput.resize( size_t(nAll)*nvar );
+      fDenseTarget.resize( size_t(nAll)*nOut );
+      fDenseWeight.resize( nAll );
+      fDenseRow.clear();
+
+      for (UInt_t i = 0; i < nAll; i++) {
+         const Event* ev = GetEvent( events[i] );
+         for (UInt_t ivar = 0; ivar < nvar; ivar++) fDenseInput[size_t(i)*nvar+ivar] = ev->GetValue(ivar);
+         for (UInt_t k = 0; k < nOut; k++) {
+            Double_t desired;
+            if      (DoRegression()) desired = ev->GetTarget(k);
+            else if (DoMulticlass()) desired = ( ev->GetClass() == k ? 1.0 : 0.0 );
+            else                     desired = GetDesiredOutput( ev );
+            fDenseTarget[size_t(i)*nOut+k] = desired;
+         }
+         fDenseWeight[i] = ev->GetWeight();
+         fDenseRow[events[i]] = i;
+      }
+      fDenseType = type;
+   }
+
+   const Bool_t ignoreNegWeights = IgnoreEventsWithNegWeightsInTraining() && (type == Types::kTraining);
+   Int_t nEvents = GetNEvents();
+   used.clear();
+   if (rows) rows->assign( nEvents, -1 );
+   for (Int_t i = 0; i < nEvents; i++) {
+      Int_t row = fDenseRow.find( Data()->GetEvent(i) )->second;
+      if (fDenseWeight[row] < 0 && ignoreNegWeights) continue;
+      used.push_back(row);
+      if (rows) (*rows)[i] = row;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// release the events gathered for the dense backend
+
+void TMVA::MethodMLP::ClearDenseEvents()
+{
+   fDenseType = -1;
+   std::vector<Double_t>().swap( fDenseInput );
+   std::vector<Double_t>().swap( fDenseTarget );
+   std::vector<Double_t>().swap( fDenseWeight );
+   fDenseRow.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the error of GetError (without the regulator) for the gathered
+/// events index[0], ..., index[n-1], and fill dEdw, if given, with the sum
+/// of the synapse deltas of SimulateEvent for these events, i.e. the
+/// gradient of the error.
+/// The events are split in at most 64 chunks, processed on up to fNThreads
+/// threads by blocks of 128 events: the layers of each block are computed with
+/// matrix products over the whole block. The sums of the chunks are added in
+/// the chunk order, so the result does not depend on the number of threads.
+
+Double_t TMVA::MethodMLP::DenseErrorAndGradient( const std::vector<Double_t>& weights, const Int_t* index, UInt_t n,
+                                                 std::vector<Double_t>* dEdw )
+{
+   const UInt_t nWeights  = weights.size();
+   const UInt_t numLayers = fDenseLayout.size();
+   const UInt_t nvar      = fDenseLayout.front();
+   const UInt_t nOut      = fDenseLayout.back();
+   const UInt_t blockSize = 128;
+   const UInt_t maxChunks = 64;
+   const UInt_t nChunks   = std::max( 1u, std::min( maxChunks, (n+blockSize-1)/blockSize ) );
+   const Bool_t crossEntropy = !DoRegression() && !DoMulticlass() && fEstimator==kCE;
+
+   // offset of the weight matrix between layer l and layer l+1
+   std::vector<UInt_t> offset( numLayers, 0 );
+   for (UInt_t l = 1; l < numLayers; l++) offset[l] = offset[l-1] + (fDenseLayout[l-1]+1)*fDenseLayout[l];
+
+   std::vector<Double_t> chunkError( nChunks, 0. );
+   std::vector< std::vector<Double_t> > chunkGrad( dEdw ? nChunks : 0 );
+
+   auto processChunks = [&](UInt_t firstChunk, UInt_t step) {
+      std::vector<Double_t> input( blockSize*nvar );
+      std::vector< std::vector<Double_t> > values, activations, deltas( numLayers );
+      for (UInt_t ichunk = firstChunk; ichunk < nChunks; ichunk += step) {
+         const UInt_t begin = UInt_t( ULong64_t(n)*ichunk/nChunks );
+         const UInt_t end   = UInt_t( ULong64_t(n)*(ichunk+1)/nChunks );
+         Double_t* grad = 0;
+         if (dEdw) {
+            chunkGrad[ichunk].assign( nWeights, 0. );
+            grad = &chunkGrad[ichunk][0];
+         }
+         for (UInt_t first = begin; first < end; first += blockSize) {
+            const UInt_t nb = std::min( blockSize, end-first );
+            for (UInt_t i = 0; i < nb; i++) {
+               const Double_t* x = &fDenseInput[size_t(index[first+i])*nvar];
+               std::copy( x, x+nvar, &input[i*nvar] );
+            }
+            DenseForward( &weights[0], &input[0], nb, values, activations );
+
+            // error of the events and deltas of the output neurons (SimulateEvent)
+            std::vector<Double_t>& dOut = deltas[numLayers-1];
+            dOut.resize( nb*nOut );
+            for (UInt_t i = 0; i < nb; i++) {
+               const Int_t     iev    = index[first+i];
+               const Double_t  w      = fDenseWeight[iev];
+               const Double_t* target = &fDenseTarget[size_t(iev)*nOut];
+               Double_t error = 0;
+               for (UInt_t k = 0; k < nOut; k++) {
+                  const Double_t y = activations[numLayers-1][i*nOut+k];
+                  Double_t dE;
+                  if (crossEntropy) {
+                     error += -(target[k]*TMath::Log(y)+(1-target[k])*TMath::Log(1-y));
+                     dE     = -w/(y-1+target[k]);
+                  }
+                  else {
+                     error += 0.5*(y-target[k])*(y-target[k]);
+                     dE     = (y-target[k])*w;
+                  }
+                  dOut[i*nOut+k] = dE*DenseDerivative( numLayers-1, values[numLayers-1][i*nOut+k] );
+               }
+               chunkError[ichunk] += error*w;
+            }
+            if (!grad) continue;
+
+            // back propagation, layer by layer
+            for (UInt_t l = numLayers-1; l > 0; l--) {
+               const UInt_t nl   = fDenseLayout[l];
+               const UInt_t nPre = fDenseLayout[l-1];
+               const Double_t* W = &weights[offset[l-1]];
+               Double_t*       G = grad + offset[l-1];
+               const std::vector<Double_t>& a = activations[l-1];
+               const std::vector<Double_t>& d = deltas[l];
+               for (UInt_t i = 0; i < nb; i++) {
+                  const Double_t* arow = &a[i*(nPre+1)];
+                  const Double_t* drow = &d[i*nl];
+                  for (UInt_t j = 0; j <= nPre; j++) {
+                     const Double_t x    = arow[j];
+                     Double_t*      grow = G + j*nl;
+                     for (UInt_t k = 0; k < nl; k++) grow[k] += drow[k]*x;
+                  }
+               }
+               if (l == 1) break; // the input neurons have no delta
+
+               std::vector<Double_t>& dPre = deltas[l-1];
+               dPre.resize( nb*nPre );
+               for (UInt_t i = 0; i < nb; i++) {
+                  const Double_t* drow = &d[i*nl];
+                  for (UInt_t j = 0; j < nPre; j++) {
+                     const Double_t* wrow = W + j*nl;
+                     Double_t error = 0;
+                     for (UInt_t k = 0; k < nl; k++) error += wrow[k]*drow[k];
+                     dPre[i*nPre+j] = error*DenseDerivative( l-1, values[l-1][i*nPre+j] );
+                  }
+               }
+            }
+         }
+      }
+   };
+
+   const UInt_t nThreads = std::min( UInt_t(fNThreads), nChunks );
+   if (nThreads <= 1) {
+      processChunks(0, 1);
+   }
+   else {
+      std::vector<std::thread> threads;
+      for (UInt_t ithread=1; ithread < nThreads; ithread++)
+         threads.push_back(std::thread(processChunks, ithread, nThreads));
+      processChunks(0, nThreads);
+      for (UInt_t ithread=0; ithread < threads.size(); ithread++) threads[ithread].join();
+   }
+
+   Double_t error = 0;
+   for (UInt_t ichunk = 0; ichunk < nChunks; ichunk++) error += chunkError[ichunk];
+   if (dEdw) {
+      dEdw->assign( nWeights, 0. );
+      for (UInt_t ichunk = 0; ichunk < nChunks; ichunk++) {
+         for (UInt_t i = 0; i < nWeights; i++) (*dEdw)[i] += chunkGrad[ichunk][i];
+      }
+   }
+   return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// add the gradient of a batch of gathered events to the error fields of the
+/// synapses, as TSynapse::CalculateDelta does for each event in batch mode,
+/// and, if adjust is set, adjust the synapse weights with TSynapse::AdjustWeight;
+/// weights is kept equal to the synapse weights
+
+void TMVA::MethodMLP::AdjustSynapseWeightsDense( std::vector<Double_t>& weights, const std::vector<Int_t>& batch,
+                                                 Bool_t adjust )
+{
+   std::vector<Double_t> dEdw;
+   DenseErrorAndGradient( weights, &batch[0], batch.size(), &dEdw );
+
+   Int_t numSynapses = fSynapses->GetEntriesFast();
+   for (Int_t i = 0; i < numSynapses; i++) {
+      TSynapse* synapse = (TSynapse*)fSynapses->At(i);
+      synapse->AddDelta( dEdw[i], batch.size() );
+      if (!adjust) continue;
+      synapse->AdjustWeight();
+      weights[i] = synapse->GetWeight();
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Input:
 ///   index: the array to shuffle
@@ -43,6 +43,7 @@
 #include <memory>
 
 // ROOT include(s):
+#include "ThreadLocalStorage.h"
 
 ClassImp(TMVA::MsgLogger)
 
@@ -65,8 +66,22 @@ static std::auto_ptr<const std::map<TMVA::EMsgType, std::string> > gOwnTypeMap;
 static std::auto_ptr<const std::map<TMVA::EMsgType, std::string> > gOwnColorMap;
  
 
+namespace {
+   // output of the loggers used by the calling thread, see SetThreadOutput
+   TTHREAD_TLS(std::ostream*) gThreadOutput = 0;
+}
+
 void   TMVA::MsgLogger::InhibitOutput() { fgInhibitOutput = kTRUE;  }
 void   TMVA::MsgLogger::EnableOutput()  { fgInhibitOutput = kFALSE; }
+
+////////////////////////////////////////////////////////////////////////////////
+/// the messages written by the calling thread go to out, e.g. to print the
+/// output of the methods tested in parallel by the Factory one method after
+/// the other; with out=0 they go to std::cout again. Fatal errors are always
+/// written to std::cout.
+
+void   TMVA::MsgLogger::SetThreadOutput( std::ostream* out ) { gThreadOutput = out; }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// constructor
 
@@ -209,20 +224,21 @@ void TMVA::MsgLogger::WriteMsg( EMsgType type, const std::string& line ) const
    if ( (type < fMinType || fgInhibitOutput) && type!=kFATAL ) return; // no output
 
    std::map<EMsgType, std::string>::const_iterator stype;
+   std::ostream& out = (gThreadOutput != 0 && type != kFATAL) ? *gThreadOutput : std::cout;
 
    if ((stype = fgTypeMap.load()->find( type )) != fgTypeMap.load()->end()) {
       if (!gConfig().IsSilent() || type==kFATAL) {
          if (gConfig().UseColor()) {
             // no text for INFO or VERBOSE
             if (type == kINFO || type == kVERBOSE)
-               std::cout << fgPrefix << line << std::endl; // no color for info
+               out << fgPrefix << line << std::endl; // no color for info
             else
- 	       std::cout << fgColorMap.load()->find( type )->second << fgPrefix << "<"
-                         << stype->second << "> " << line  << "\033[0m" << std::endl;
+ 	       out << fgColorMap.load()->find( type )->second << fgPrefix << "<"
+                   << stype->second << "> " << line  << "\033[0m" << std::endl;
          }
          else {
-            if (type == kINFO) std::cout << fgPrefix << line << std::endl;
-            else               std::cout << fgPrefix << "<" << stype->second << "> " << line << std::endl;
+            if (type == kINFO) out << fgPrefix << line << std::endl;
+            else               out << fgPrefix << "<" << stype->second << "> " << line << std::endl;
          }
       }
    }
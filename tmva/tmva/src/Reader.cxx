@@ -86,6 +86,19 @@
 //    delete reader;
 //  ---------------------------------------------------------------------
 //
+//  Blocks of events can be evaluated at once by passing their variables
+//  column-wise, values[ivar*nEvents+iev], to
+//
+//    reader->EvaluateMVA( values, nEvents, "BDT method", mvaValues );
+//
+//  The BDT is then evaluated from a flat copy of its forest without
+//  modifying the Reader, so that several threads can evaluate blocks at the
+//  same time. The other methods, and all the single event evaluations, modify
+//  the method and are run by one thread at a time. The evaluation of the
+//  variables set with AddVariable, EvaluateMVA( "BDT method" ), reads them
+//  through the addresses given to the Reader: these are shared by all the
+//  threads, which then have to pass the values to EvaluateMVA instead.
+//
 //  An example application of the Reader can be found in TMVA/macros/TMVApplication.C.
 //_______________________________________________________________________
 
@@ -483,6 +496,8 @@ Double_t TMVA::Reader::EvaluateMVA( const std::vector<Float_t>& inputVec, const
    MethodBase* meth = dynamic_cast<TMVA::MethodBase*>(imeth);
    if(meth==0) return 0;
 
+   std::lock_guard<std::recursive_mutex> lock(fEvaluateMutex);
+
 //   Event* tmpEvent=new Event(inputVec, 2); // ToDo resolve magic 2 issue
    Event* tmpEvent=new Event(inputVec, DataInfo().GetNVariables()); // is this the solution?
    for (UInt_t i=0; i<inputVec.size(); i++){
@@ -510,6 +525,7 @@ Double_t TMVA::Reader::EvaluateMVA( const std::vector<Float_t>& inputVec, const
 Double_t TMVA::Reader::EvaluateMVA( const std::vector<Double_t>& inputVec, const TString& methodTag, Double_t aux )
 {
    // performs a copy to float values which are internally used by all methods
+   std::lock_guard<std::recursive_mutex> lock(fEvaluateMutex);
    if(fTmpEvalVec.size() != inputVec.size())
       fTmpEvalVec.resize(inputVec.size());
 
@@ -541,6 +557,8 @@ Double_t TMVA::Reader::EvaluateMVA( const TString& methodTag, Double_t aux )
    if(kl==0)
       Log() << kFATAL << methodTag << " is not a method" << Endl;
 
+   std::lock_guard<std::recursive_mutex> lock(fEvaluateMutex);
+
    // check for NaN in event data:  (note: in the factory, this check was done already at the creation of the datasets, hence
    // it is not again checked in each of these subsequet calls..
    const Event* ev = kl->GetEvent();
@@ -553,11 +571,67 @@ Double_t TMVA::Reader::EvaluateMVA( const TString& methodTag, Double_t aux )
    return this->EvaluateMVA( kl, aux );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the MVA of nEvents events and store the values in output.
+/// The input variables are stored column-wise: input[ivar*nEvents+iev] is the
+/// value of the variable ivar of the event iev. As for a single event, the
+/// events with a NaN variable get the value -999.
+/// The methods providing a batch evaluation (MethodBase::GetMvaValues) are
+/// evaluated without modifying the Reader or the method, hence concurrently
+/// if several threads share the Reader; the other methods are evaluated event
+/// by event, one thread at a time, as the single event evaluations. No error
+/// is calculated.
+/// The parameter aux is obligatory for the cuts method where it represents the efficiency cutoff
+
+void TMVA::Reader::EvaluateMVA( const Float_t* input, UInt_t nEvents, const TString& methodTag,
+                                Double_t* output, Double_t aux ) const
+{
+   MethodBase* meth = 0;
+   std::map<TString, IMethod*>::const_iterator it = fMethodMap.find( methodTag );
+   if (it != fMethodMap.end()) meth = dynamic_cast<TMVA::MethodBase*>(it->second);
+
+   const UInt_t nvar = DataInfo().GetNVariables();
+
+   if (meth == 0) {
+      Log() << kFATAL << "<EvaluateMVA> unknown classifier \"" << methodTag << "\" in map" << Endl;
+      return;
+   }
+
+   if (!meth->GetMvaValues( input, nEvents, output )) {
+      std::lock_guard<std::recursive_mutex> lock(fEvaluateMutex);
+      if (meth->GetMethodType() == TMVA::Types::kCuts) {
+         TMVA::MethodCuts* mc = dynamic_cast<TMVA::MethodCuts*>(meth);
+         if(mc)
+            mc->SetTestSignalEfficiency( aux );
+      }
+      std::vector<Float_t> values(nvar);
+      for (UInt_t iev=0; iev<nEvents; iev++) {
+         Bool_t isNaN = kFALSE;
+         for (UInt_t ivar=0; ivar<nvar; ivar++) {
+            values[ivar] = input[size_t(ivar)*nEvents+iev];
+            if (TMath::IsNaN(values[ivar])) isNaN = kTRUE;
+         }
+         if (isNaN) continue; // set below
+         Event ev(values, nvar);
+         output[iev] = meth->GetMvaValue( &ev );
+      }
+   }
+
+   for (UInt_t ivar=0; ivar<nvar; ivar++) {
+      const Float_t* column = input + size_t(ivar)*nEvents;
+      for (UInt_t iev=0; iev<nEvents; iev++) {
+         if (TMath::IsNaN(column[iev])) output[iev] = -999;
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// evaluates the MVA
 
 Double_t TMVA::Reader::EvaluateMVA( MethodBase* method, Double_t aux )
 {
+   std::lock_guard<std::recursive_mutex> lock(fEvaluateMutex);
+
    // the aux value is only needed for MethodCuts: it sets the
    // required signal efficiency
    if (method->GetMethodType() == TMVA::Types::kCuts) {
@@ -48,6 +48,7 @@ class TDirectory;
 class TFile;
 class TClonesArray;
 class TTreeCloner;
+class TTaskGroup;
 
    const Int_t kDoNotProcess = BIT(10); // Active bit for branches
    const Int_t kIsClone      = BIT(11); // to indicate a TBranchClones
@@ -116,12 +117,14 @@ protected:
    void     Init(const char *name, const char *leaflist, Int_t compress);
 
    TBasket *GetFreshBasket();
+   Bool_t   QueueWriteBasket(TBasket* basket);
    Int_t    WriteBasket(TBasket* basket, Int_t where);
 
    TString  GetRealFileName() const;
 
 private:
    Int_t FillEntryBuffer(TBasket* basket,TBuffer* buf, Int_t& lnew);
+   Int_t GetBulkEntries(Long64_t entry, TBuffer &user_buf, Bool_t deserialize);
    TBranch(const TBranch&);             // not implemented
    TBranch& operator=(const TBranch&);  // not implemented
 
@@ -134,6 +137,7 @@ public:
    virtual void      AddBasket(TBasket &b, Bool_t ondisk, Long64_t startEntry);
    virtual void      AddLastBasket(Long64_t startEntry);
    virtual void      Browse(TBrowser *b);
+           void      CompressBaskets(TTaskGroup &group);
    virtual void      DeleteBaskets(Option_t* option="");
    virtual void      DropBaskets(Option_t *option = "");
            void      ExpandBasketArrays();
@@ -156,6 +160,8 @@ public:
            Int_t     GetCompressionSettings() const;
    TDirectory       *GetDirectory() const {return fDirectory;}
    virtual Int_t     GetEntry(Long64_t entry=0, Int_t getall = 0);
+           Int_t     GetEntriesSerialized(Long64_t entry, TBuffer &user_buf);
+           Int_t     GetEntriesDeserialized(Long64_t entry, TBuffer &user_buf);
    virtual Int_t     GetEntryExport(Long64_t entry, Int_t getall, TClonesArray *list, Int_t n);
            Int_t     GetEntryOffsetLen() const { return fEntryOffsetLen; }
            Int_t     GetEvent(Long64_t entry=0) {return GetEntry(entry);}
@@ -90,6 +90,7 @@ class TTreeCache;
 class TTreeCloner;
 class TFileMergeInfo;
 class TVirtualPerfStats;
+class TTreeBasketQueue;
 
 class TTree : public TNamed, public TAttLine, public TAttFill, public TAttMarker {
 
@@ -145,6 +146,9 @@ protected:
    TBuffer       *fTransientBuffer;   //! Pointer to the current transient buffer.
    Bool_t         fCacheDoAutoInit;   //! true if cache auto creation or resize check is needed
    Bool_t         fCacheUserSet;      //! true if the cache setting was explicitly given by user
+   Bool_t         fParallelCompression; //! true if the baskets are compressed on the global TTaskPool
+   Bool_t         fAsyncWriting;      //! true if the baskets are written by the writer thread of the file
+   TTreeBasketQueue *fBasketQueue;    //! baskets filled up by Fill and being compressed on the global TTaskPool
 
    static Int_t     fgBranchStyle;      //  Old/New branch style
    static Long64_t  fgMaxTreeSize;      //  Maximum size of a file containg a Tree
@@ -355,6 +359,7 @@ public:
    virtual Long64_t        Draw(const char* varexp, const char* selection, Option_t* option = "", Long64_t nentries = 1000000000, Long64_t firstentry = 0); // *MENU*
    virtual void            DropBaskets();
    virtual void            DropBuffers(Int_t nbytes);
+           void            DropQueuedBaskets(TBranch *branch) const;
    virtual Int_t           Fill();
    virtual TBranch        *FindBranch(const char* name);
    virtual TLeaf          *FindLeaf(const char* name);
@@ -417,6 +422,8 @@ public:
    TObject                *GetNotify() const { return fNotify; }
    TVirtualTreePlayer     *GetPlayer();
    virtual Int_t           GetPacketSize() const { return fPacketSize; }
+           Bool_t          GetParallelCompression() const { return fParallelCompression; }
+           Bool_t          GetAsyncWriting() const { return fAsyncWriting; }
    virtual TVirtualPerfStats *GetPerfStats() const { return fPerfStats; }
    virtual Long64_t        GetReadEntry()  const { return fReadEntry; }
    virtual Long64_t        GetReadEvent()  const { return fReadEntry; }
@@ -482,6 +489,7 @@ public:
 #endif
    virtual Long64_t        Project(const char* hname, const char* varexp, const char* selection = "", Option_t* option = "", Long64_t nentries = 1000000000, Long64_t firstentry = 0);
    virtual TSQLResult     *Query(const char* varexp = "", const char* selection = "", Option_t* option = "", Long64_t nentries = 1000000000, Long64_t firstentry = 0);
+           Bool_t          QueueBasket(TBranch *branch, TBasket *basket, Int_t where, TFile *file);
    virtual Long64_t        ReadFile(const char* filename, const char* branchDescriptor = "", char delimiter = ' ');
    virtual Long64_t        ReadStream(std::istream& inputStream, const char* branchDescriptor = "", char delimiter = ' ');
    virtual void            Refresh();
@@ -539,6 +547,8 @@ public:
    virtual void            SetName(const char* name); // *MENU*
    virtual void            SetNotify(TObject* obj) { fNotify = obj; }
    virtual void            SetObject(const char* name, const char* title);
+   virtual void            SetParallelCompression(Bool_t opt=kTRUE);
+   virtual void            SetAsyncWriting(Bool_t opt=kTRUE);
    virtual void            SetParallelUnzip(Bool_t opt=kTRUE, Float_t RelSize=-1);
    virtual void            SetPerfStats(TVirtualPerfStats* perf);
    virtual void            SetScanField(Int_t n = 50) { fScanField = n; } // *MENU*
@@ -553,6 +563,7 @@ public:
    void                    UseCurrentStyle();
    virtual Int_t           Write(const char *name=0, Int_t option=0, Int_t bufsize=0);
    virtual Int_t           Write(const char *name=0, Int_t option=0, Int_t bufsize=0) const;
+           Int_t           WriteQueuedBaskets(Bool_t wait = kTRUE) const;
 
 
    ClassDef(TTree,19)  //Tree descriptor (the main ROOT I/O class)
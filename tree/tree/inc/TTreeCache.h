@@ -27,6 +27,9 @@
 #ifndef ROOT_TObjArray
 #include "TObjArray.h"
 #endif
+#ifndef ROOT_TString
+#include "TString.h"
+#endif
 
 class TTree;
 class TBranch;
@@ -61,6 +64,11 @@ protected:
    EPrefillType    fPrefillType; // Whether a prefilling is enabled (and if applicable which type)
    static  Int_t   fgLearnEntries; // number of entries used for learning mode
    Bool_t          fAutoCreated; //! true if cache was automatically created
+   TString         fProfileDir;  //! directory of the learning profiles, empty if they are not used
+   Bool_t          fProfileTried;//! true once the learning profile was looked for, or if the user selected the branches
+   Bool_t          fProfileLoaded;//! true if the branches were loaded from the learning profile, the branches it lacks are still added
+
+   TString              GetProfileName() const;
 
 private:
    TTreeCache(const TTreeCache &);            //this class cannot be copied
@@ -79,19 +87,24 @@ public:
    virtual void         Enable() {fEnabled = kTRUE;}
    const TObjArray     *GetCachedBranches() const { return fBranches; }
    EPrefillType         GetConfiguredPrefillType() const;
+   TString              GetConfiguredProfileDir() const;
    Double_t             GetEfficiency() const;
    Double_t             GetEfficiencyRel() const;
    virtual Int_t        GetEntryMin() const {return fEntryMin;}
    virtual Int_t        GetEntryMax() const {return fEntryMax;}
    static Int_t         GetLearnEntries();
    virtual EPrefillType GetLearnPrefill() const {return fPrefillType;}
+   const char          *GetProfileDir() const {return fProfileDir;}
    TTree               *GetTree() const {return fTree;}
    Bool_t               IsAutoCreated() const {return fAutoCreated;}
    virtual Bool_t       IsEnabled() const {return fEnabled;}
    virtual Bool_t       IsLearning() const {return fIsLearning;}
+   Bool_t               IsProfileLoaded() const {return fProfileLoaded;}
 
    virtual Bool_t       FillBuffer();
    virtual void         LearnPrefill();
+   virtual Bool_t       LoadProfile();
+   virtual Bool_t       SaveProfile() const;
 
    virtual void         Print(Option_t *option="") const;
    virtual Int_t        ReadBuffer(char *buf, Long64_t pos, Int_t len);
@@ -103,6 +116,7 @@ public:
    virtual void         SetEntryRange(Long64_t emin,   Long64_t emax);
    virtual void         SetFile(TFile *file, TFile::ECacheAction action=TFile::kDisconnect);
    virtual void         SetLearnPrefill(EPrefillType type = kNoPrefill);
+   void                 SetProfileDir(const char *dir) {fProfileDir = dir;}
    static void          SetLearnEntries(Int_t n = 10);
    void                 StartLearningPhase();
    virtual void         StopLearningPhase();
@@ -33,10 +33,10 @@
 
 class TTree;
 class TBranch;
-class TThread;
 class TCondition;
 class TBasket;
 class TMutex;
+class TTaskGroup;
 
 class TTreeCacheUnzip : public TTreeCache {
 public:
@@ -47,20 +47,17 @@ public:
 protected:
 
    // Members for paral. managing
-   TThread    *fUnzipThread[10];
-   Bool_t      fActiveThread;          // Used to terminate gracefully the unzippers
-   TCondition *fUnzipStartCondition;   // Used to signal the threads to start.
-   TCondition *fUnzipDoneCondition;    // Used to wait for an unzip tour to finish. Gives the Async feel.
+   TTaskGroup *fUnzipTasks;            //! Unzip tasks submitted to the global TTaskPool
+   TCondition *fUnzipDoneCondition;    // Signaled each time a block is unzipped.
    Bool_t      fParallel;              // Indicate if we want to activate the parallelism (for this instance)
    Bool_t      fAsyncReading;
-   TMutex     *fMutexList;             // Mutex to protect the various lists. Used by the condvars.
-   TMutex     *fIOMutex;
+   TMutex     *fMutexList;             // Mutex protecting the unzip lists and the state of the cache buffer. Used by the condvar.
+   Bool_t      fUnzipScheduled;        //! True once the unzip tasks of the current cycle are submitted
 
    Int_t       fCycle;
    static TTreeCacheUnzip::EParUnzipMode fgParallel;  // Indicate if we want to activate the parallelism
 
    Int_t       fLastReadPos;
-   Int_t       fBlocksToGo;
 
    // Unzipping related members
    Int_t      *fUnzipLen;         //! [fNseek] Length of the unzipped buffers
@@ -78,8 +75,10 @@ protected:
    Int_t       fNFound;           //! number of blocks that were found in the cache
    Int_t       fNStalls;          //! number of hits which caused a stall
    Int_t       fNMissed;          //! number of blocks that were not found in the cache and were unzipped
+   Long64_t    fNUnzipBytes;      //! number of bytes unzipped by the tasks
+   Double_t    fUnzipWaitTime;    //! real time (s) spent waiting for blocks being unzipped
 
-   std::queue<Int_t>       fActiveBlks; // The blocks which are active now
+   std::queue<Int_t>       fDeferredBlks; // The blocks whose unzipping was postponed, the unzip buffer being full
 
 private:
    TTreeCacheUnzip(const TTreeCacheUnzip &);            //this class cannot be copied
@@ -90,8 +89,10 @@ private:
 
    // Private methods
    void  Init();
-   Int_t StartThreadUnzip(Int_t nthreads);
-   Int_t StopThreadUnzip();
+   void  ScheduleAll();
+   void  ScheduleUnzip(Int_t index);
+   void  ScheduleDeferred();
+   void  UnzipBlock(Int_t index, Long64_t pos, Int_t len, Int_t cycle);
 
 public:
    TTreeCacheUnzip();
@@ -110,12 +111,6 @@ public:
    static Bool_t        IsParallelUnzip();
    static Int_t         SetParallelUnzip(TTreeCacheUnzip::EParUnzipMode option = TTreeCacheUnzip::kEnable);
 
-   Bool_t               IsActiveThread();
-   Bool_t               IsQueueEmpty();
-
-   void                 WaitUnzipStartSignal();
-   void                 SendUnzipStartSignal(Bool_t broadcast);
-
    // Unzipping related methods
    Int_t          GetRecordHeader(char *buf, Int_t maxbytes, Int_t &nbytes, Int_t &objlen, Int_t &keylen);
    virtual void   ResetCache();
@@ -124,17 +119,17 @@ public:
    void           SetUnzipBufferSize(Long64_t bufferSize);
    static void    SetUnzipRelBufferSize(Float_t relbufferSize);
    Int_t          UnzipBuffer(char **dest, char *src);
-   Int_t          UnzipCache(Int_t &startindex, Int_t &locbuffsz, char *&locbuff);
 
    // Methods to get stats
-   Int_t  GetNUnzip() { return fNUnzip; }
-   Int_t  GetNFound() { return fNFound; }
-   Int_t  GetNMissed(){ return fNMissed; }
+   Int_t    GetNUnzip() { return fNUnzip; }
+   Int_t    GetNFound() { return fNFound; }
+   Int_t    GetNStalls() { return fNStalls; }
+   Int_t    GetNMissed(){ return fNMissed; }
+   Long64_t GetNUnzipBytes() { return fNUnzipBytes; }
+   Double_t GetUnzipWaitTime() { return fUnzipWaitTime; }
 
    void Print(Option_t* option = "") const;
 
-   // static members
-   static void* UnzipLoop(void *arg);
    ClassDef(TTreeCacheUnzip,0)  //Specialization of TTreeCache for parallel unzipping
 };
 
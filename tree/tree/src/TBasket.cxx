@@ -47,7 +47,7 @@ See picture in TTree.
 ////////////////////////////////////////////////////////////////////////////////
 /// Default contructor.
 
-TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1)
 {
    fDisplacement  = 0;
    fEntryOffset   = 0;
@@ -64,7 +64,7 @@ TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLa
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor used during reading.
 
-TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1)
 {
    fDisplacement  = 0;
    fEntryOffset   = 0;
@@ -82,7 +82,7 @@ TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0
 /// Basket normal constructor, used during writing.
 
 TBasket::TBasket(const char *name, const char *title, TBranch *branch) :
-   TKey(branch->GetDirectory()),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+   TKey(branch->GetDirectory()),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1)
 {
    SetName(name);
    SetTitle(title);
@@ -392,7 +392,11 @@ static inline TBuffer* R__InitializeReadBasketBuffer(TBuffer* bufferRef, Int_t l
    if (R__likely(bufferRef)) {
       bufferRef->SetReadMode();
       Int_t curBufferSize = bufferRef->BufferSize();
-      if (curBufferSize < len) {
+      if (R__unlikely(!bufferRef->TestBit(TBuffer::kIsOwner))) {
+         // The buffer is borrowed (from the unzip cache or a memory mapped
+         // file) and can not be reused, allocate our own.
+         bufferRef->SetBuffer(new char[len], len, kTRUE);
+      } else if (curBufferSize < len) {
          // Experience shows that giving 5% "wiggle-room" decreases churn.
          bufferRef->Expand(Int_t(len*1.05));
       }
@@ -447,7 +451,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
    if (pf) {
       Int_t res = -1;
       Bool_t free = kTRUE;
-      char *buffer;
+      char *buffer = 0;
       res = pf->GetUnzipBuffer(&buffer, pos, len, &free);
       if (R__unlikely(res >= 0)) {
          len = ReadBasketBuffersUnzip(buffer, res, free, file);
@@ -458,6 +462,35 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
    }
 
+   // With a memory mapped file the basket is read straight from the mapped
+   // pages: it is unzipped from there, or used in place if not compressed.
+   rawCompressedBuffer = file->GetMappedBuffer(pos, len);
+   if (rawCompressedBuffer) {
+      fBranch->GetTree()->IncrementTotalBuffers(-fBufferSize);
+      {
+         TBufferFile mappedBuffer(TBuffer::kRead, len, rawCompressedBuffer, kFALSE);
+         mappedBuffer.SetParent(file);
+         Streamer(mappedBuffer);
+      }
+      if (IsZombie()) {
+         return 1;
+      }
+      oldCase = OLD_CASE_EXPRESSION;
+      if (fObjlen > fNbytes-fKeylen || oldCase) {
+         goto Unzip;
+      }
+      if (fBufferRef) {
+         fBufferRef->SetBuffer(rawCompressedBuffer, len, kFALSE);
+         fBufferRef->SetReadMode();
+         fBufferRef->Reset();
+      } else {
+         fBufferRef = new TBufferFile(TBuffer::kRead, len, rawCompressedBuffer, kFALSE);
+      }
+      fBufferRef->SetParent(file);
+      fBuffer = rawCompressedBuffer;
+      goto AfterBuffer;
+   }
+
    // Determine which buffer to use, so that we can avoid a memcpy in case of
    // the basket was not compressed.
    TBuffer* readBufferRef;
@@ -536,6 +569,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
    }
 
+Unzip:
    // Initialize buffer to hold the uncompressed data
    // Note that in previous versions we didn't allocate buffers until we verified
    // the zip headers; this is no longer beforehand as the buffer lifetime is scoped
@@ -694,11 +728,17 @@ void TBasket::Reset()
       fLastWriteBufferSize = newSize;
    }
    */
-   if (newSize != -1) {
+   if (R__unlikely(!fBufferRef->TestBit(TBuffer::kIsOwner))) {
+      // The buffer is borrowed (from the unzip cache or a memory mapped file),
+      // we need our own to write in.
+      if (newSize == -1) newSize = curSize;
+      fBufferRef->SetBuffer(new char[newSize], newSize, kTRUE);
+   } else if (newSize != -1) {
       fBufferRef->Expand(newSize,kFALSE);     // Expand without copying the existing data.
    }
 
    TKey::Reset();
+   fCompressedSize = -1;
 
    Int_t newNevBufSize = fBranch->GetEntryOffsetLen();
    if (newNevBufSize==0) {
@@ -949,6 +989,75 @@ Int_t TBasket::WriteBuffer()
       return nBytes>0 ? fKeylen+nout : -1;
    }
 
+   if (fCompressedSize < 0 && CompressBuffer(file, fBranch->GetWriteBasket()) < 0) {
+      return -1;
+   }
+   Int_t nout = fCompressedSize;
+   fCompressedSize = -1;
+
+   Create(nout,file);
+   fBufferRef->SetBufferOffset(0);
+
+   Streamer(*fBufferRef);         //write key itself again
+   if (fBuffer != fBufferRef->Buffer()) {
+      // The payload was compressed, copy the key in front of it.
+      memcpy(fBuffer,fBufferRef->Buffer(),fKeylen);
+   }
+
+   Int_t nBytes;
+   Int_t nsize = fNbytes;
+   if (fLeft > 0) nsize += sizeof(Int_t);
+   if (fBranch->GetTree()->GetAsyncWriting() && !file->WriteBufferAsync(fBuffer, fSeekKey, nsize)) {
+      // Queued for the writer thread of the file (see TTree::SetAsyncWriting).
+      nBytes = nsize;
+   } else {
+      nBytes = WriteFileKeepBuffer();
+   }
+   fHeaderOnly = kFALSE;
+   if (fOwnsCompressedBuffer) {
+      // The private buffer allocated by a concurrent CompressBuffer is no
+      // longer needed (WriteBufferAsync keeps its own copy), go back to the
+      // buffer shared by the baskets of the TTree.
+      delete fCompressedBufferRef;
+      fCompressedBufferRef = fBranch->GetTree()->GetTransientBuffer(fBufferSize);
+      fOwnsCompressedBuffer = kFALSE;
+      fBuffer = fBufferRef->Buffer();
+   }
+   return nBytes>0 ? fKeylen+nout : -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Prepare the content of this basket for writing: transfer the entry
+/// offsets at the end of the buffer and compress the payload.
+///
+/// This is the CPU intensive part of WriteBuffer. It does not modify the
+/// file nor the branch and can therefore be executed in a separate thread
+/// (see TTree::SetParallelCompression) for several baskets at once; the
+/// next call to WriteBuffer then only allocates the space on file and
+/// writes the basket.
+///
+/// The cycle of the key is set to the basket number, which the caller passes
+/// since the write basket of the branch may move on in the meantime.
+///
+/// If privateBuffer is true, the compressed data is stored in a buffer owned
+/// by this basket rather than in the transient buffer shared by all the
+/// baskets of the TTree; this is required when several baskets of the same
+/// TTree are compressed concurrently. WriteBuffer releases it.
+///
+/// Returns the size of the (possibly) compressed payload or -1 in case of
+/// error. Calling this function again before WriteBuffer is a no-op.
+
+Int_t TBasket::CompressBuffer(TFile *file, Int_t cycle, Bool_t privateBuffer)
+{
+   if (fCompressedSize >= 0) {
+      return fCompressedSize;
+   }
+   if (privateBuffer && !fOwnsCompressedBuffer) {
+      // The buffer shared with the other baskets of the TTree can not be
+      // used when several baskets are compressed at the same time.
+      fCompressedBufferRef = 0;
+   }
+
    // Transfer fEntryOffset table at the end of fBuffer.
    fLast = fBufferRef->Length();
    if (fEntryOffset) {
@@ -971,9 +1080,12 @@ Int_t TBasket::WriteBuffer()
    fObjlen    = lbuf - fKeylen;
 
    fHeaderOnly = kTRUE;
-   fCycle = fBranch->GetWriteBasket();
+   fCycle = cycle;
    Int_t cxlevel = fBranch->GetCompressionLevel();
    Int_t cxAlgorithm = fBranch->GetCompressionAlgorithm();
+   // By default the payload is written uncompressed.
+   fBuffer = fBufferRef->Buffer();
+   nout = fObjlen;
    if (cxlevel > 0) {
       Int_t nbuffers = 1 + (fObjlen - 1) / kMAXZIPBUF;
       Int_t buflen = fKeylen + fObjlen + 9 * nbuffers + 28; //add 28 bytes in case object is placed in a deleted gap
@@ -983,9 +1095,9 @@ Int_t TBasket::WriteBuffer()
          return -1;
       }
       fCompressedBufferRef->SetWriteMode();
-      fBuffer = fCompressedBufferRef->Buffer();
+      char *zipbuf = fCompressedBufferRef->Buffer();
       char *objbuf = fBufferRef->Buffer() + fKeylen;
-      char *bufcur = &fBuffer[fKeylen];
+      char *bufcur = &zipbuf[fKeylen];
       noutot = 0;
       nzip   = 0;
       for (Int_t i = 0; i < nbuffers; ++i) {
@@ -998,19 +1110,15 @@ Int_t TBasket::WriteBuffer()
          // when the buffer contains random data, it may happen that the compressed
          // buffer is larger than the input. In this case, we write the original uncompressed buffer
          if (nout == 0 || nout >= fObjlen) {
-            nout = fObjlen;
             // We used to delete fBuffer here, we no longer want to since
             // the buffer (held by fCompressedBufferRef) might be re-used later.
-            fBuffer = fBufferRef->Buffer();
-            Create(fObjlen,file);
-            fBufferRef->SetBufferOffset(0);
-
-            Streamer(*fBufferRef);         //write key itself again
-            if ((nout+fKeylen)>buflen) {
-               Warning("WriteBuffer","Possible memory corruption due to compression algorithm, wrote %d bytes past the end of a block of %d bytes. fNbytes=%d, fObjLen=%d, fKeylen=%d",
-                  (nout+fKeylen-buflen),buflen,fNbytes,fObjlen,fKeylen);
+            noutot = fObjlen;
+            if ((noutot+fKeylen)>buflen) {
+               Warning("WriteBuffer","Possible memory corruption due to compression algorithm, wrote %d bytes past the end of a block of %d bytes. fObjLen=%d, fKeylen=%d",
+                  (noutot+fKeylen-buflen),buflen,fObjlen,fKeylen);
             }
-            goto WriteFile;
+            zipbuf = 0;
+            break;
          }
          bufcur += nout;
          noutot += nout;
@@ -1018,23 +1126,10 @@ Int_t TBasket::WriteBuffer()
          nzip   += kMAXZIPBUF;
       }
       nout = noutot;
-      Create(noutot,file);
-      fBufferRef->SetBufferOffset(0);
-
-      Streamer(*fBufferRef);         //write key itself again
-      memcpy(fBuffer,fBufferRef->Buffer(),fKeylen);
-   } else {
-      fBuffer = fBufferRef->Buffer();
-      Create(fObjlen,file);
-      fBufferRef->SetBufferOffset(0);
-
-      Streamer(*fBufferRef);         //write key itself again
-      nout = fObjlen;
+      if (zipbuf) fBuffer = zipbuf;
    }
 
-WriteFile:
-   Int_t nBytes = WriteFileKeepBuffer();
-   fHeaderOnly = kFALSE;
-   return nBytes>0 ? fKeylen+nout : -1;
+   fCompressedSize = nout;
+   return nout;
 }
 
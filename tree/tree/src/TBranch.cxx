@@ -15,6 +15,7 @@
 #include "TBasket.h"
 #include "TBranchBrowsable.h"
 #include "TBrowser.h"
+#include "Bytes.h"
 #include "TClass.h"
 #include "TBufferFile.h"
 #include "TClonesArray.h"
@@ -33,6 +34,7 @@
 #include "TROOT.h"
 #include "TSystem.h"
 #include "TMath.h"
+#include "TTaskPool.h"
 #include "TTree.h"
 #include "TTreeCache.h"
 #include "TTreeCacheUnzip.h"
@@ -281,6 +283,8 @@ void TBranch::Init(const char* name, const char* leaflist, Int_t compress)
       if (bfile) {
          fCompress = bfile->GetCompressionSettings();
       }
+   } else {
+      fCompress = ROOT::CheckCompressionSettings(fCompress);
    }
 
    fBasketBytes = new Int_t[fMaxBaskets];
@@ -409,6 +413,10 @@ void TBranch::Init(const char* name, const char* leaflist, Int_t compress)
 
 TBranch::~TBranch()
 {
+   if (fTree) {
+      fTree->DropQueuedBaskets(this);
+   }
+
    delete fBrowsables;
    fBrowsables = 0;
 
@@ -782,6 +790,9 @@ Int_t TBranch::Fill()
       if (fTree->TestBit(TTree::kCircular)) {
          return nbytes;
       }
+      if (QueueWriteBasket(basket)) {
+         return nbytes;
+      }
       Int_t nout = WriteBasket(basket,fWriteBasket);
       return (nout >= 0) ? nbytes : -1;
    }
@@ -987,6 +998,49 @@ TLeaf* TBranch::FindLeaf(const char* searchname)
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Submit to group the compression of the baskets of this branch, and of its
+/// sub-branches, which are about to be written by FlushBaskets.
+///
+/// The baskets are only compressed (see TBasket::CompressBuffer); the space on
+/// file is allocated and the baskets are written by the subsequent call to
+/// FlushBaskets, in the same order as in the serial case.
+
+void TBranch::CompressBaskets(TTaskGroup &group)
+{
+   const Int_t kWrite = 1;
+
+   if (fDirectory && fBaskets.GetEntries()
+       && GetCompressionLevel() > 0
+       && GetCompressionAlgorithm() != ROOT::kOldCompressionAlgo) {
+      // The old compression algorithm relies on global state and can not
+      // be run concurrently.
+      TFile *file = GetFile(kWrite);
+      if (file && file->IsWritable()) {
+         Int_t maxbasket = fWriteBasket + 1;
+         for(Int_t i=0; i != maxbasket; ++i) {
+            TBasket *basket = (TBasket*)fBaskets.UncheckedAt(i);
+            if (!basket || !basket->GetNevBuf() || fBasketSeek[i] != 0
+                || basket->GetBufferRef()->TestBit(TBufferFile::kNotDecompressed)) {
+               continue;
+            }
+            if (basket->GetBufferRef()->IsReading()) {
+               basket->SetWriteMode();
+            }
+            group.Run([basket, file, i]() { basket->CompressBuffer(file, i, kTRUE); });
+         }
+      }
+   }
+
+   Int_t len = fBranches.GetEntriesFast();
+   for (Int_t i = 0; i < len; ++i) {
+      TBranch* branch = (TBranch*) fBranches.UncheckedAt(i);
+      if (branch) {
+         branch->CompressBaskets(group);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Flush to disk all the baskets of this branch and any of subbranches.
 /// Return the number of bytes written or -1 in case of write error.
@@ -996,6 +1050,11 @@ Int_t TBranch::FlushBaskets()
    UInt_t nerror = 0;
    Int_t nbytes = 0;
 
+   // Write first the baskets still being compressed concurrently.
+   if (fTree && fTree->WriteQueuedBaskets() < 0) {
+      ++nerror;
+   }
+
    Int_t maxbasket = fWriteBasket + 1;
    // The following protection is not necessary since we should always
    // have fWriteBasket < fBasket.GetSize()
@@ -1089,6 +1148,12 @@ TBasket* TBranch::GetBasket(Int_t basketnumber)
       // reference to an existing basket in memory ?
    if (basketnumber <0 || basketnumber > fWriteBasket) return 0;
    TBasket *basket = (TBasket*)fBaskets.UncheckedAt(basketnumber);
+   if (basket && basketnumber < fWriteBasket && fBasketSeek[basketnumber] == 0) {
+      // The basket might still be compressed concurrently (see
+      // QueueWriteBasket), write it to be able to read it back.
+      fTree->WriteQueuedBaskets();
+      basket = (TBasket*)fBaskets.UncheckedAt(basketnumber);
+   }
    if (basket) return basket;
    if (basketnumber == fWriteBasket) return 0;
 
@@ -1108,6 +1173,10 @@ TBasket* TBranch::GetBasket(Int_t basketnumber)
    TFileCacheRead *pf = file->GetCacheRead(fTree);
    if (pf){
       if (pf->IsLearning()) pf->AddBranch(this);
+      else if (TTreeCache *tpf = dynamic_cast<TTreeCache*>(pf)) {
+         // Read a branch missing from the learning profile through the cache too.
+         if (tpf->IsProfileLoaded()) tpf->AddBranch(this);
+      }
       if (fSkipZip) pf->SetSkipZip();
    }
 
@@ -1282,6 +1351,128 @@ Int_t TBranch::GetEntry(Long64_t entry, Int_t getall)
    return buf->Length() - bufbegin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Copy into user_buf, in a single call, the values of all the entries from
+/// entry to the end of the basket containing it, as stored in the file
+/// (i.e. in network byte order). See GetEntriesDeserialized.
+///
+/// Returns the number of entries copied, or -1 if the branch does not
+/// support bulk reading or the entry could not be read.
+
+Int_t TBranch::GetEntriesSerialized(Long64_t entry, TBuffer &user_buf)
+{
+   return GetBulkEntries(entry, user_buf, kFALSE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy into user_buf, in a single call, the values of all the entries from
+/// entry to the end of the basket containing it, converted to the host byte
+/// order. On return user_buf.Buffer() points to a contiguous array of the
+/// basic type of the leaf, which can be processed without any further
+/// deserialization:
+/// ~~~ {.cpp}
+///    TBufferFile buf(TBuffer::kWrite, 32*1024);
+///    Long64_t entry = 0;
+///    while (entry < branch->GetEntries()) {
+///       Int_t n = branch->GetEntriesDeserialized(entry, buf);
+///       if (n <= 0) break;
+///       const Float_t *values = (const Float_t*)buf.Buffer();
+///       for (Int_t i = 0; i < n; ++i) sum += values[i];
+///       entry += n;
+///    }
+/// ~~~
+/// The byte swapping is done while copying the basket content, using the
+/// vectorized net2hostcpy routines of Bytes.h, so the basket itself is left
+/// untouched for subsequent calls to GetEntry.
+///
+/// Bulk reading is only supported for branches with a single leaf of a
+/// basic type (TLeafB, TLeafS, TLeafI, TLeafL, TLeafF, TLeafD or TLeafO) of
+/// fixed size, i.e. without a leaf count.
+///
+/// Returns the number of entries copied, or -1 if the branch does not
+/// support bulk reading or the entry could not be read.
+
+Int_t TBranch::GetEntriesDeserialized(Long64_t entry, TBuffer &user_buf)
+{
+   return GetBulkEntries(entry, user_buf, kTRUE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Implementation of GetEntriesSerialized and GetEntriesDeserialized.
+
+Int_t TBranch::GetBulkEntries(Long64_t entry, TBuffer &user_buf, Bool_t deserialize)
+{
+   if (fNleaves != 1) return -1;
+   TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(0);
+   TClass *cl = leaf->IsA();
+   if (cl != TLeafB::Class() && cl != TLeafS::Class() && cl != TLeafI::Class() &&
+       cl != TLeafL::Class() && cl != TLeafF::Class() && cl != TLeafD::Class() &&
+       cl != TLeafO::Class()) {
+      return -1;
+   }
+   if (leaf->GetLeafCount()) return -1;
+   if ((entry < fFirstEntry) || (entry >= fEntryNumber)) return -1;
+
+   // Find the basket containing this entry, as GetEntry does.
+   fReadEntry = entry;
+   if ((entry < fFirstBasketEntry) || (entry >= fNextBasketEntry)) {
+      fReadBasket = TMath::BinarySearch(fWriteBasket + 1, fBasketEntry, entry);
+      if (fReadBasket < 0) {
+         fNextBasketEntry = -1;
+         Error("GetBulkEntries", "In the branch %s, no basket contains the entry %lld\n", GetName(), entry);
+         return -1;
+      }
+      if (fReadBasket == fWriteBasket) {
+         fNextBasketEntry = fEntryNumber;
+      } else {
+         fNextBasketEntry = fBasketEntry[fReadBasket+1];
+      }
+      fFirstBasketEntry = fBasketEntry[fReadBasket];
+      fCurrentBasket = 0;
+   }
+   TBasket *basket = fCurrentBasket;
+   if (!basket) {
+      basket = GetBasket(fReadBasket);
+      if (!basket) {
+         fFirstBasketEntry = -1;
+         fNextBasketEntry = -1;
+         return -1;
+      }
+      fCurrentBasket = basket;
+   }
+   basket->PrepareBasket(entry);
+   TBuffer *buf = basket->GetBufferRef();
+   if (!buf) return -1;
+   if (R__unlikely(!buf->IsReading())) {
+      basket->SetReadMode();
+   }
+   if (basket->GetEntryOffset()) return -1;
+
+   Int_t lentype = leaf->GetLenType();
+   Int_t nentries = fNextBasketEntry - entry;
+   Int_t len = nentries * basket->GetNevBufSize();
+   Int_t nvalues = len / lentype;
+   const char *src = buf->Buffer() + basket->GetKeylen() + (entry - fFirstBasketEntry) * basket->GetNevBufSize();
+
+   if (user_buf.BufferSize() < len) {
+      user_buf.Expand(len, kFALSE);
+   }
+   char *dst = user_buf.Buffer();
+   if (!deserialize || lentype == 1) {
+      memcpy(dst, src, len);
+   } else if (lentype == 2) {
+      net2hostcpy16(dst, src, nvalues);
+   } else if (lentype == 4) {
+      net2hostcpy32(dst, src, nvalues);
+   } else if (lentype == 8) {
+      net2hostcpy64(dst, src, nvalues);
+   } else {
+      return -1;
+   }
+   user_buf.SetBufferOffset(0);
+   return nentries;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read all leaves of an entry and export buffers to real objects in a TClonesArray list.
 ///
@@ -1922,6 +2113,10 @@ void TBranch::Refresh(TBranch* b)
 
 void TBranch::Reset(Option_t*)
 {
+   if (fTree) {
+      fTree->DropQueuedBaskets(this);
+   }
+
    fReadBasket = 0;
    fReadEntry = -1;
    fFirstBasketEntry = -1;
@@ -1963,6 +2158,10 @@ void TBranch::Reset(Option_t*)
 
 void TBranch::ResetAfterMerge(TFileMergeInfo *)
 {
+   if (fTree) {
+      fTree->DropQueuedBaskets(this);
+   }
+
    fReadBasket       = 0;
    fReadEntry        = -1;
    fFirstBasketEntry = -1;
@@ -2129,6 +2328,9 @@ void TBranch::SetBufferAddress(TBuffer* buf)
 void TBranch::SetCompressionAlgorithm(Int_t algorithm)
 {
    if (algorithm < 0 || algorithm >= ROOT::kUndefinedCompressionAlgorithm) algorithm = 0;
+   if (!ROOT::IsCompressionAlgorithmAvailable((ROOT::ECompressionAlgorithm)algorithm)) {
+      algorithm = ROOT::CheckCompressionSettings(100 * algorithm) / 100;
+   }
    if (fCompress < 0) {
       fCompress = 100 * algorithm + 1;
    } else {
@@ -2170,6 +2372,7 @@ void TBranch::SetCompressionLevel(Int_t level)
 
 void TBranch::SetCompressionSettings(Int_t settings)
 {
+   settings = ROOT::CheckCompressionSettings(settings);
    fCompress = settings;
 
    Int_t nb = fBranches.GetEntriesFast();
@@ -2550,6 +2753,55 @@ void TBranch::Streamer(TBuffer& b)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Hand the full write basket over to the TTree, which compresses it on the
+/// global TTaskPool while the next entries are filled and writes it as soon
+/// as it is compressed (see TTree::SetParallelCompression).
+/// Return false if the basket must be written right away by WriteBasket.
+
+Bool_t TBranch::QueueWriteBasket(TBasket* basket)
+{
+   const Int_t kWrite = 1;
+
+   if (!fTree->GetParallelCompression() || fSkipZip
+       || GetCompressionLevel() <= 0
+       || GetCompressionAlgorithm() == ROOT::kOldCompressionAlgo
+       || basket->GetBufferRef()->TestBit(TBufferFile::kNotDecompressed)) {
+      return kFALSE;
+   }
+   TFile *file = GetFile(kWrite);
+   if (!file || !file->IsWritable()) {
+      return kFALSE;
+   }
+
+   Int_t nevbuf = basket->GetNevBuf();
+   if (fEntryOffsetLen > 10 &&  (4*nevbuf) < fEntryOffsetLen ) {
+      // Make sure that the fEntryOffset array does not stay large unnecessarily.
+      fEntryOffsetLen = nevbuf < 3 ? 10 : 4*nevbuf; // assume some fluctuations.
+   } else if (fEntryOffsetLen && nevbuf > fEntryOffsetLen) {
+      // Increase the array ...
+      fEntryOffsetLen = 2*nevbuf; // assume some fluctuations.
+   }
+
+   if (!fTree->QueueBasket(this, basket, fWriteBasket, file)) {
+      return kFALSE;
+   }
+
+   // The basket stays in fBaskets until it is written; the next call to Fill
+   // creates a new write basket.
+   if (basket == fCurrentBasket) {
+      fCurrentBasket    = 0;
+      fFirstBasketEntry = -1;
+      fNextBasketEntry  = -1;
+   }
+   ++fWriteBasket;
+   if (fWriteBasket >= fMaxBaskets) {
+      ExpandBasketArrays();
+   }
+   fBasketEntry[fWriteBasket] = fEntryNumber;
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Write the current basket to disk and return the number of bytes
 /// written to the file.
@@ -355,6 +355,7 @@ We encourage you to use TTree::AddFriend rather than adding a branch manually.
 #include "TStreamerInfo.h"
 #include "TStyle.h"
 #include "TSystem.h"
+#include "TTaskPool.h"
 #include "TTreeCloner.h"
 #include "TTreeCache.h"
 #include "TTreeCacheUnzip.h"
@@ -369,6 +370,7 @@ We encourage you to use TTree::AddFriend rather than adding a branch manually.
 #include "TFileMergeInfo.h"
 
 #include <cstddef>
+#include <deque>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -380,6 +382,48 @@ Long64_t TTree::fgMaxTreeSize = 100000000000LL;
 
 ClassImp(TTree)
 
+////////////////////////////////////////////////////////////////////////////////
+/// Baskets filled up by TTree::Fill which are compressed on the global
+/// TTaskPool (see TTree::SetParallelCompression). The filling thread writes
+/// them, in the order in which they were queued, once they are compressed.
+
+class TTreeBasketQueue {
+public:
+   struct TEntry {
+      TBranch *fBranch;      // branch owning the basket
+      Int_t    fWhere;       // basket number in the branch
+      Bool_t   fCompressed;  // true once the basket is compressed, protected by fMutex
+   };
+
+   std::deque<TEntry> fEntries;    // queued baskets, oldest first
+   TTaskGroup        *fTasks;      // compression tasks, 0 when nothing is queued
+   TMutex             fMutex;      // protects TEntry::fCompressed
+   TCondition         fCompressed; // signaled when a basket is compressed
+
+   TTreeBasketQueue() : fTasks(0), fCompressed(&fMutex) {}
+   ~TTreeBasketQueue() { delete fTasks; }
+
+   Bool_t IsFrontCompressed()
+   {
+      TLockGuard lock(&fMutex);
+      return fEntries.front().fCompressed;
+   }
+
+   void WaitFront()
+   {
+      // Help with the queued tasks rather than idling: the filling thread
+      // might itself be one of the workers of the pool.
+      while (!IsFrontCompressed()) {
+         if (!fTasks->GetPool()->RunPending(fTasks)) {
+            TLockGuard lock(&fMutex);
+            while (!fEntries.front().fCompressed) {
+               fCompressed.Wait();
+            }
+         }
+      }
+   }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -663,6 +707,9 @@ TTree::TTree()
 , fTransientBuffer(0)
 , fCacheDoAutoInit(kTRUE)
 , fCacheUserSet(kFALSE)
+, fParallelCompression(kFALSE)
+, fAsyncWriting(kFALSE)
+, fBasketQueue(0)
 {
    fMaxEntries = 1000000000;
    fMaxEntries *= 1000;
@@ -739,6 +786,9 @@ TTree::TTree(const char* name, const char* title, Int_t splitlevel /* = 99 */)
 , fTransientBuffer(0)
 , fCacheDoAutoInit(kTRUE)
 , fCacheUserSet(kFALSE)
+, fParallelCompression(kFALSE)
+, fAsyncWriting(kFALSE)
+, fBasketQueue(0)
 {
    // TAttLine state.
    SetLineColor(gStyle->GetHistLineColor());
@@ -813,6 +863,10 @@ TTree::~TTree()
          CopyAddresses(clone,kTRUE);
       }
    }
+   // The baskets still being compressed are dropped, as are the current
+   // baskets of the branches, unless FlushBaskets was called.
+   delete fBasketQueue;
+   fBasketQueue = 0;
    // Get rid of our branches, note that this will also release
    // any memory allocated by TBranchElement::SetAddress().
    fBranches.Delete();
@@ -4229,6 +4283,10 @@ void TTree::DropBuffers(Int_t)
          if ((j == branch->GetReadBasket()) || (j == branch->GetWriteBasket())) {
             continue;
          }
+         if (!branch->GetBasketSeek(j)) {
+            // Not written yet, see SetParallelCompression.
+            continue;
+         }
          TBasket* basket = (TBasket*)branch->GetListOfBaskets()->UncheckedAt(j);
          if (basket) {
             ndrop += basket->DropBuffers();
@@ -4240,6 +4298,31 @@ void TTree::DropBuffers(Int_t)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Forget the baskets of branch queued for compression (see QueueBasket),
+/// once the compression of all the queued baskets is done. Called before
+/// the baskets of the branch are deleted.
+
+void TTree::DropQueuedBaskets(TBranch *branch) const
+{
+   TTreeBasketQueue *queue = fBasketQueue;
+   if (!queue || queue->fEntries.empty()) {
+      return;
+   }
+   queue->fTasks->Wait();
+   std::deque<TTreeBasketQueue::TEntry> kept;
+   for (UInt_t i = 0; i < queue->fEntries.size(); ++i) {
+      if (queue->fEntries[i].fBranch != branch) {
+         kept.push_back(queue->fEntries[i]);
+      }
+   }
+   queue->fEntries.swap(kept);
+   if (queue->fEntries.empty()) {
+      delete queue->fTasks;
+      queue->fTasks = 0;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill all branches.
 ///
@@ -4330,6 +4413,10 @@ Int_t TTree::Fill()
    if (fBranchRef) {
       fBranchRef->Fill();
    }
+   // Write the queued baskets which are already compressed.
+   if (fBasketQueue && WriteQueuedBaskets(kFALSE) < 0) {
+      ++nerror;
+   }
    ++fEntries;
    if (fEntries > fMaxEntries) {
       KeepCircular();
@@ -4710,6 +4797,10 @@ Int_t TTree::Fit(const char* funcname, const char* varexp, const char* selection
 ////////////////////////////////////////////////////////////////////////////////
 /// Write to disk all the basket that have not yet been individually written.
 ///
+/// If parallel compression is enabled (see SetParallelCompression), the
+/// baskets queued by Fill are written first, then the current baskets are
+/// compressed concurrently and written in order.
+///
 /// Return the number of bytes written or -1 in case of write error.
 
 Int_t TTree::FlushBaskets() const
@@ -4717,8 +4808,26 @@ Int_t TTree::FlushBaskets() const
    if (!fDirectory) return 0;
    Int_t nbytes = 0;
    Int_t nerror = 0;
+   Int_t nqueued = WriteQueuedBaskets();
+   if (nqueued < 0) {
+      ++nerror;
+   } else {
+      nbytes += nqueued;
+   }
    TObjArray *lb = const_cast<TTree*>(this)->GetListOfBranches();
    Int_t nb = lb->GetEntriesFast();
+   if (fParallelCompression) {
+      TTaskGroup group;
+      if (group.IsParallel()) {
+         // Compress all the baskets concurrently, they are then written
+         // in order by the loop below.
+         for (Int_t j = 0; j < nb; j++) {
+            TBranch* branch = (TBranch*) lb->UncheckedAt(j);
+            if (branch) branch->CompressBaskets(group);
+         }
+         group.Wait();
+      }
+   }
    for (Int_t j = 0; j < nb; j++) {
       TBranch* branch = (TBranch*) lb->UncheckedAt(j);
       if (branch) {
@@ -6732,6 +6841,50 @@ TSQLResult* TTree::Query(const char* varexp, const char* selection, Option_t* op
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Queue the full basket number where of branch for compression on the
+/// global TTaskPool (see SetParallelCompression). It is written by Fill,
+/// FlushBaskets or WriteQueuedBaskets once compressed.
+///
+/// Return false if the global pool is disabled, in which case the caller
+/// writes the basket itself.
+
+Bool_t TTree::QueueBasket(TBranch *branch, TBasket *basket, Int_t where, TFile *file)
+{
+   if (!fBasketQueue) {
+      fBasketQueue = new TTreeBasketQueue();
+   }
+   TTreeBasketQueue *queue = fBasketQueue;
+
+   // Bound the memory used by the queued baskets.
+   while (queue->fTasks && queue->fEntries.size() >= 4 * queue->fTasks->GetPool()->GetPoolSize()) {
+      queue->WaitFront();
+      WriteQueuedBaskets(kFALSE);
+   }
+
+   if (!queue->fTasks) {
+      queue->fTasks = new TTaskGroup();
+      if (!queue->fTasks->IsParallel()) {
+         delete queue->fTasks;
+         queue->fTasks = 0;
+         return kFALSE;
+      }
+   }
+
+   queue->fEntries.push_back(TTreeBasketQueue::TEntry());
+   TTreeBasketQueue::TEntry *entry = &queue->fEntries.back();
+   entry->fBranch = branch;
+   entry->fWhere = where;
+   entry->fCompressed = kFALSE;
+   queue->fTasks->Run([queue, entry, basket, file, where]() {
+      basket->CompressBuffer(file, where, kTRUE);
+      TLockGuard lock(&queue->fMutex);
+      entry->fCompressed = kTRUE;
+      queue->fCompressed.Broadcast();
+   });
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create or simply read branches from filename.
 ///
@@ -8298,6 +8451,62 @@ void TTree::SetObject(const char* name, const char* title)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable the parallel compression of the baskets.
+///
+/// When enabled, a basket filling up in Fill is handed over to the threads
+/// of the global TTaskPool for compression while the next entries are
+/// filled into a new basket; Fill writes it, in the filling thread, as soon
+/// as it is compressed. The baskets flushed together by FlushBaskets (in
+/// particular at each AutoFlush, i.e. at the end of each cluster, and by
+/// AutoSave and Write) are compressed concurrently as well. The number of
+/// baskets waiting for compression is bounded by four times the size of the
+/// pool. The entries and baskets in the file are the same as in the serial
+/// case, only the order of the baskets on file may differ.
+///
+/// The global pool must be enabled for this to have any effect, e.g.
+///
+///     TTaskPool::SetGlobalPoolSize(8);
+///     tree->SetParallelCompression();
+///
+/// Disabling the parallel compression writes the baskets still queued.
+
+void TTree::SetParallelCompression(Bool_t opt)
+{
+   if (!opt) {
+      WriteQueuedBaskets();
+   }
+   fParallelCompression = opt;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable the asynchronous writing of the baskets.
+///
+/// When enabled, the baskets are still compressed and their space allocated
+/// on file by the filling thread, but instead of being written with a
+/// synchronous system call they are queued (key header and payload) for a
+/// writer thread owned by the file (see TFile::WriteBufferAsync). Fill,
+/// AutoFlush and AutoSave then no longer wait for the disk.
+///
+/// The memory used by the queue is bounded by TFile::SetAsyncWriteSize
+/// (64 MB by default); when it is full the filling thread waits for the
+/// writer thread. All the queued baskets are on disk once the file is
+/// flushed or closed. This is only supported for local files and is
+/// ignored for the other TFile implementations.
+///
+/// Combined with SetParallelCompression, e.g.
+///
+///     TTaskPool::SetGlobalPoolSize(8);
+///     tree->SetParallelCompression();
+///     tree->SetAsyncWriting();
+///
+/// the filling thread only serializes the entries into the baskets.
+
+void TTree::SetAsyncWriting(Bool_t opt)
+{
+   fAsyncWriting = opt;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Enable or disable parallel unzipping of Tree buffers.
 
@@ -8756,6 +8965,45 @@ Int_t TTree::Write(const char *name, Int_t option, Int_t bufsize)
    return ((const TTree*)this)->Write(name, option, bufsize);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Write the baskets queued by QueueBasket, in the order in which they were
+/// queued. If wait is false, stop at the first basket whose compression is
+/// not done yet.
+///
+/// Return the number of bytes written or -1 in case of write error.
+
+Int_t TTree::WriteQueuedBaskets(Bool_t wait) const
+{
+   TTreeBasketQueue *queue = fBasketQueue;
+   if (!queue || queue->fEntries.empty()) {
+      return 0;
+   }
+   Int_t nbytes = 0;
+   Int_t nerror = 0;
+   while (!queue->fEntries.empty()) {
+      if (wait) {
+         queue->WaitFront();
+      } else if (!queue->IsFrontCompressed()) {
+         break;
+      }
+      TTreeBasketQueue::TEntry entry = queue->fEntries.front();
+      queue->fEntries.pop_front();
+      Int_t nwrite = entry.fBranch->FlushOneBasket(entry.fWhere);
+      if (nwrite < 0) {
+         Error("WriteQueuedBaskets", "Failed writing basket %d of branch %s", entry.fWhere, entry.fBranch->GetName());
+         ++nerror;
+      } else {
+         nbytes += nwrite;
+      }
+   }
+   if (queue->fEntries.empty()) {
+      // Release the pool, the next basket uses the current global pool.
+      delete queue->fTasks;
+      queue->fTasks = 0;
+   }
+   return nerror ? -1 : nbytes;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// \class TTreeFriendLeafIter
 ///
@@ -211,6 +211,28 @@ branches that will be used very rarely.
        ... here you process your entry
     }
 
+### 4. with a learning profile
+
+When the same files are processed again and again with the same analysis
+code, the learning phase can be skipped: if TTreeCache.ProfileDir (or the
+environment variable ROOT_TTREECACHE_PROFILEDIR) is set to a local directory,
+the branches learned for a tree are saved at the end of the learning phase
+in a small text file of that directory, named after the UUID of the file
+and the name of the tree (see TTreeCache::SaveProfile). The next time the
+tree of the same file is read, the branches are loaded from this profile as
+soon as the first basket is requested (see TTreeCache::LoadProfile) and the
+cache is filled with the first cluster right away, instead of reading the
+baskets one by one for the learning entries. This matters in particular for
+remote files, where each of these reads is a round trip. The branches read
+by the job but missing from the profile are added to the cache when their
+first basket is read, and the profile is updated with them.
+
+    # in $HOME/.rootrc
+    TTreeCache.ProfileDir: $(HOME)/.root/cacheprofiles
+
+The profile is not used if the branches of the cache are selected explicitly
+(AddBranchToCache, DropBranchFromCache, StopCacheLearningPhase).
+
 ## SPECIAL CASES WHERE TreeCache should not be activated
 
 When reading only a small fraction of all entries such that not all branch
@@ -238,6 +260,8 @@ of effective system reads for a given file with a code like
 #include "TFriendElement.h"
 #include "TFile.h"
 #include <limits.h>
+#include <fstream>
+#include <string>
 
 Int_t TTreeCache::fgLearnEntries = 100;
 
@@ -269,7 +293,10 @@ TTreeCache::TTreeCache() : TFileCacheRead(),
    fReadDirectionSet(kFALSE),
    fEnabled(kTRUE),
    fPrefillType(GetConfiguredPrefillType()),
-   fAutoCreated(kFALSE)
+   fAutoCreated(kFALSE),
+   fProfileDir(GetConfiguredProfileDir()),
+   fProfileTried(kFALSE),
+   fProfileLoaded(kFALSE)
 {
 }
 
@@ -299,7 +326,10 @@ TTreeCache::TTreeCache(TTree *tree, Int_t buffersize) : TFileCacheRead(tree->Get
    fReadDirectionSet(kFALSE),
    fEnabled(kTRUE),
    fPrefillType(GetConfiguredPrefillType()),
-   fAutoCreated(kFALSE)
+   fAutoCreated(kFALSE),
+   fProfileDir(GetConfiguredProfileDir()),
+   fProfileTried(kFALSE),
+   fProfileLoaded(kFALSE)
 {
    fEntryNext = fEntryMin + fgLearnEntries;
    Int_t nleaves = tree->GetListOfLeaves()->GetEntries();
@@ -328,13 +358,23 @@ TTreeCache::~TTreeCache()
 
 Int_t TTreeCache::AddBranch(TBranch *b, Bool_t subbranches /*= kFALSE*/)
 {
-   if (!fIsLearning) {
+   // Once the branches are loaded from the learning profile, those missing
+   // from the profile are still added when they are first read.
+   if (!fIsLearning && !fProfileLoaded) {
       return -1;
    }
 
    // Reject branch that are not from the cached tree.
    if (!b || fTree->GetTree() != b->GetTree()) return -1;
 
+   // Is this the first branch requested while learning? If the branches were
+   // learned for this tree before, use them right away (see LoadProfile); b
+   // is added below if the profile lacks it.
+   if (fNbranches == 0 && !fIsManual && !fProfileTried) {
+      fProfileTried = kTRUE;
+      LoadProfile();
+   }
+
    // Is this the first addition of a branch (and we are learning and we are in
    // the expected TTree), then prefill the cache.  (We expect that in future
    // release the Prefill-ing will be the default so we test for that inside the
@@ -352,6 +392,8 @@ Int_t TTreeCache::AddBranch(TBranch *b, Bool_t subbranches /*= kFALSE*/)
       fBrNames->Add(new TObjString(b->GetName()));
       fNbranches++;
       if (gDebug > 0) printf("Entry: %lld, registering branch: %s\n",b->GetTree()->GetReadEntry(),b->GetName());
+      // The profile lacked this branch, record it for the next jobs.
+      if (fProfileLoaded) SaveProfile();
    }
 
    // process subbranches
@@ -388,6 +430,9 @@ Int_t TTreeCache::AddBranch(const char *bname, Bool_t subbranches /*= kFALSE*/)
    TBranch *branch, *bcount;
    TLeaf *leaf, *leafcount;
 
+   // The user knows the branches to cache, do not use a learning profile.
+   fProfileTried = kTRUE;
+
    Int_t i;
    Int_t nleaves = (fTree->GetListOfLeaves())->GetEntriesFast();
    TRegexp re(bname,kTRUE);
@@ -528,6 +573,9 @@ Int_t TTreeCache::DropBranch(const char *bname, Bool_t subbranches /*= kFALSE*/)
    TBranch *branch, *bcount;
    TLeaf *leaf, *leafcount;
 
+   // The user knows the branches to cache, do not use a learning profile.
+   fProfileTried = kTRUE;
+
    Int_t i;
    Int_t nleaves = (fTree->GetListOfLeaves())->GetEntriesFast();
    TRegexp re(bname,kTRUE);
@@ -900,6 +948,10 @@ Bool_t TTreeCache::FillBuffer()
          fFirstTime = kFALSE;
       }
    }
+   if (fIsLearning && !fIsManual) {
+      // The branches were learned from the entries read, remember them.
+      SaveProfile();
+   }
    fIsLearning = kFALSE;
    return kTRUE;
 }
@@ -923,6 +975,39 @@ TTreeCache::EPrefillType TTreeCache::GetConfiguredPrefillType() const
    return static_cast<TTreeCache::EPrefillType>(s);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the directory of the learning profiles from the environment
+/// variable ROOT_TTREECACHE_PROFILEDIR or the resource TTreeCache.ProfileDir.
+/// The profiles are not used if the returned string is empty (the default).
+
+TString TTreeCache::GetConfiguredProfileDir() const
+{
+   TString dir;
+   const char *stcp;
+   if (!(stcp = gSystem->Getenv("ROOT_TTREECACHE_PROFILEDIR")) || !*stcp) {
+      dir = gEnv->GetValue("TTreeCache.ProfileDir", "");
+   } else {
+      dir = stcp;
+   }
+   gSystem->ExpandPathName(dir);
+   return dir;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the file containing the learning profile of the
+/// current tree and file, i.e. <profile dir>/<file UUID>_<tree name>.txt,
+/// or an empty string if the profiles are not used.
+
+TString TTreeCache::GetProfileName() const
+{
+   TString name;
+   if (fProfileDir.IsNull() || !fFile || !fTree) return name;
+   TString treename = fTree->GetTree() ? fTree->GetTree()->GetName() : fTree->GetName();
+   treename.ReplaceAll("/", "_");
+   name.Form("%s/%s_%s.txt", fProfileDir.Data(), fFile->GetUUID().AsString(), treename.Data());
+   return name;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Give the total efficiency of the cache... defined as the ratio
 /// of blocks found in the cache vs. the number of blocks prefetched
@@ -1207,6 +1292,7 @@ void TTreeCache::StartLearningPhase()
 {
    fIsLearning = kTRUE;
    fIsManual = kFALSE;
+   fProfileLoaded = kFALSE;
    fNbranches  = 0;
    if (fBrNames) fBrNames->Delete();
    fIsTransferred = kFALSE;
@@ -1251,8 +1337,10 @@ void TTreeCache::UpdateBranches(TTree *tree)
    fEntryCurrent = -1;
 
    if (fBrNames->GetEntries() == 0 && fIsLearning) {
-      // We still need to learn.
+      // We still need to learn, possibly from the profile of the new file.
       fEntryNext = fEntryMin + fgLearnEntries;
+      fProfileTried = fIsManual;
+      fProfileLoaded = kFALSE;
    } else {
       // We learnt from a previous file.
       fIsLearning = kFALSE;
@@ -1272,6 +1360,94 @@ void TTreeCache::UpdateBranches(TTree *tree)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Load the branches saved by SaveProfile for the current tree and file, if
+/// any, and stop the learning phase: the next read fills the cache with all
+/// these branches. This is done automatically when the first basket is read
+/// during the learning phase, if a profile directory is set (see
+/// SetProfileDir) and the branches were not selected explicitly. Unlike with
+/// StopLearningPhase, the branches missing from the profile are still added
+/// to the cache by AddBranch.
+/// Return kTRUE if the profile was found and contained at least one branch
+/// of the tree.
+
+Bool_t TTreeCache::LoadProfile()
+{
+   TString filename = GetProfileName();
+   if (filename.IsNull() || !fIsLearning) return kFALSE;
+   std::ifstream in(filename.Data());
+   if (!in.is_open()) return kFALSE;
+
+   std::string line;
+   Int_t nbranches = 0;
+   while (std::getline(in, line)) {
+      if (line.compare(0, 7, "branch ") != 0) continue;
+      TBranch *b = fTree->GetBranch(line.c_str() + 7);
+      if (!b || fTree->GetTree() != b->GetTree()) continue;
+      Bool_t isNew = kTRUE;
+      for (Int_t i = 0; i < fNbranches; i++) {
+         if (fBranches->UncheckedAt(i) == b) {isNew = kFALSE; break;}
+      }
+      if (!isNew) continue;
+      fBranches->AddAtAndExpand(b, fNbranches);
+      fBrNames->Add(new TObjString(b->GetName()));
+      fNbranches++;
+      nbranches++;
+   }
+   if (!nbranches) return kFALSE;
+
+   if (gDebug > 0)
+      Info("LoadProfile", "%d branches of the cache loaded from %s", nbranches, filename.Data());
+   fEntryNext = -1; // Force the filling of the cache at the next read.
+   // Unlike a selection by the user, the set of branches can still grow.
+   Bool_t manual = fIsManual;
+   StopLearningPhase();
+   fIsManual = manual;
+   fProfileLoaded = kTRUE;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Save the branches in the cache, one per line, to the learning profile of
+/// the current tree and file (see GetProfileName). This is done automatically
+/// at the end of the learning phase if a profile directory is set (see
+/// SetProfileDir); the directory is created if needed.
+/// Return kTRUE if the profile was written.
+
+Bool_t TTreeCache::SaveProfile() const
+{
+   TString filename = GetProfileName();
+   if (filename.IsNull() || fNbranches <= 0) return kFALSE;
+   if (gSystem->AccessPathName(fProfileDir) && gSystem->mkdir(fProfileDir, kTRUE)) {
+      Warning("SaveProfile", "cannot create the directory %s", fProfileDir.Data());
+      return kFALSE;
+   }
+
+   // Several jobs might save the same profile at the same time: write a
+   // private file and rename it.
+   TString tmpname;
+   tmpname.Form("%s.%d", filename.Data(), gSystem->GetPid());
+   {
+      std::ofstream out(tmpname.Data());
+      if (!out.is_open()) {
+         Warning("SaveProfile", "cannot write the learning profile %s", tmpname.Data());
+         return kFALSE;
+      }
+      out << "# TTreeCache learning profile for tree " << fTree->GetName()
+          << " in file " << fFile->GetName() << std::endl;
+      for (Int_t i = 0; i < fNbranches; i++) {
+         out << "branch " << ((TBranch*)fBranches->UncheckedAt(i))->GetName() << std::endl;
+      }
+   }
+   if (gSystem->Rename(tmpname, filename)) {
+      gSystem->Unlink(tmpname);
+      return kFALSE;
+   }
+   if (gDebug > 0)
+      Info("SaveProfile", "%d branches of the cache saved in %s", fNbranches, filename.Data());
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Perform an initial prefetch, attempting to read as much of the learning
 /// phase baskets for all branches at once
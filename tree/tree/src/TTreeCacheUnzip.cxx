@@ -20,9 +20,12 @@ Core TTree-related code borrowed from the previous version
 ## Parallel Unzipping
 
 TTreeCache has been specialised in order to let additional threads
-free to unzip in advance its content. In this implementation we
-support up to 10 threads, but right now it makes more sense to
-limit their number to 1-2
+free to unzip in advance its content. The unzipping is done by the
+tasks of the process wide TTaskPool, which must be enabled with
+TTaskPool::SetGlobalPoolSize: as soon as the baskets of a cluster
+are transferred into the cache buffer, one unzip task per basket is
+submitted to the pool. The tasks and the reader access the cache
+buffer under the same lock.
 
 The application reading data is carefully synchronized, in order to:
  - if the block it wants is not unzipped, it self-unzips it without
@@ -34,10 +37,16 @@ The application reading data is carefully synchronized, in order to:
 This is supposed to cancel a part of the unzipping latency, at the
 expenses of cpu time.
 
-The default parameters are the same of the prev version, i.e. 20%
+The default parameters are the same of the prev version, i.e. 50%
 of the TTreeCache cache size. To change it use
 TTreeCache::SetUnzipBufferSize(Long64_t bufferSize)
-where bufferSize must be passed in bytes.
+where bufferSize must be passed in bytes. When the unzipped blocks
+not yet consumed exceed this size, the remaining tasks are postponed
+until the application reads some of them.
+
+The number of blocks unzipped in advance, of stalls and misses, the
+unzipped bytes and the time spent waiting for a block are reported
+by Print().
 */
 
 #include "TTreeCacheUnzip.h"
@@ -48,12 +57,14 @@ where bufferSize must be passed in bytes.
 #include "TVirtualMutex.h"
 #include "TThread.h"
 #include "TCondition.h"
+#include "TTaskPool.h"
+#include "TStopwatch.h"
+#include "TSystem.h"
 #include "TMath.h"
 #include "Bytes.h"
 
 #include "TEnv.h"
 
-#define THREADCNT 2
 extern "C" void R__unzip(Int_t *nin, UChar_t *bufin, Int_t *lout, char *bufout, Int_t *nout);
 extern "C" int R__unzip_header(Int_t *nin, UChar_t *bufin, Int_t *lout);
 
@@ -66,15 +77,19 @@ Double_t TTreeCacheUnzip::fgRelBuffSize = .5;
 
 ClassImp(TTreeCacheUnzip)
 
+
+// Status of the blocks in fUnzipStatus
+enum EUnzipState { kUntouched = 0, kProgress = 1, kFinished = 2 };
+
 ////////////////////////////////////////////////////////////////////////////////
 
 TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache(),
 
-   fActiveThread(kFALSE),
+   fUnzipTasks(0),
    fAsyncReading(kFALSE),
+   fUnzipScheduled(kFALSE),
    fCycle(0),
    fLastReadPos(0),
-   fBlocksToGo(0),
    fUnzipLen(0),
    fUnzipChunks(0),
    fUnzipStatus(0),
@@ -84,7 +99,9 @@ TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache(),
    fNUnzip(0),
    fNFound(0),
    fNStalls(0),
-   fNMissed(0)
+   fNMissed(0),
+   fNUnzipBytes(0),
+   fUnzipWaitTime(0)
 
 {
    // Default Constructor.
@@ -96,11 +113,11 @@ TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache(),
 /// Constructor.
 
 TTreeCacheUnzip::TTreeCacheUnzip(TTree *tree, Int_t buffersize) : TTreeCache(tree,buffersize),
-   fActiveThread(kFALSE),
+   fUnzipTasks(0),
    fAsyncReading(kFALSE),
+   fUnzipScheduled(kFALSE),
    fCycle(0),
    fLastReadPos(0),
-   fBlocksToGo(0),
    fUnzipLen(0),
    fUnzipChunks(0),
    fUnzipStatus(0),
@@ -110,7 +127,9 @@ TTreeCacheUnzip::TTreeCacheUnzip(TTree *tree, Int_t buffersize) : TTreeCache(tre
    fNUnzip(0),
    fNFound(0),
    fNStalls(0),
-   fNMissed(0)
+   fNMissed(0),
+   fNUnzipBytes(0),
+   fUnzipWaitTime(0)
 {
    Init();
 }
@@ -121,9 +140,7 @@ TTreeCacheUnzip::TTreeCacheUnzip(TTree *tree, Int_t buffersize) : TTreeCache(tre
 void TTreeCacheUnzip::Init()
 {
    fMutexList        = new TMutex(kTRUE);
-   fIOMutex          = new TMutex(kTRUE);
 
-   fUnzipStartCondition   = new TCondition(fMutexList);
    fUnzipDoneCondition   = new TCondition(fMutexList);
 
    fTotalUnzipBytes = 0;
@@ -131,26 +148,27 @@ void TTreeCacheUnzip::Init()
    fCompBuffer = new char[16384];
    fCompBufferSize = 16384;
 
-   if (fgParallel == kDisable) {
-      fParallel = kFALSE;
-   }
-   else if(fgParallel == kEnable || fgParallel == kForce) {
-      SysInfo_t info;
-      gSystem->GetSysInfo(&info);
-
+   fParallel = kFALSE;
+   if (fgParallel == kEnable || fgParallel == kForce) {
+      // The blocks are unzipped by the tasks of the global pool, if the
+      // implicit parallelism is enabled.
       fUnzipBufferSize = Long64_t(fgRelBuffSize * GetBufferSize());
 
-      if(gDebug > 0)
-         Info("TTreeCacheUnzip", "Enabling Parallel Unzipping");
-
-      fParallel = kTRUE;
-
-      for (Int_t i = 0; i < 10; i++) fUnzipThread[i] = 0;
+      fUnzipTasks = new TTaskGroup();
+      if (fUnzipTasks->IsParallel()) {
+         if(gDebug > 0)
+            Info("TTreeCacheUnzip", "Enabling Parallel Unzipping");
 
-      StartThreadUnzip(THREADCNT);
+         fParallel = kTRUE;
+      } else {
+         if(gDebug > 0)
+            Info("TTreeCacheUnzip", "The global TTaskPool is disabled, unzipping sequentially");
 
+         delete fUnzipTasks;
+         fUnzipTasks = 0;
+      }
    }
-   else {
+   else if (fgParallel != kDisable) {
       Warning("TTreeCacheUnzip", "Parallel Option unknown");
    }
 
@@ -167,21 +185,19 @@ void TTreeCacheUnzip::Init()
 
 TTreeCacheUnzip::~TTreeCacheUnzip()
 {
+   // Invalidate the unzip tasks still queued, then wait for the running ones.
    ResetCache();
-
-   if (IsActiveThread())
-      StopThreadUnzip();
+   delete fUnzipTasks;
 
    delete [] fUnzipLen;
 
-   delete fUnzipStartCondition;
    delete fUnzipDoneCondition;
 
    delete fMutexList;
-   delete fIOMutex;
 
    delete [] fUnzipStatus;
    delete [] fUnzipChunks;
+   delete [] fCompBuffer;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -292,11 +308,15 @@ Bool_t TTreeCacheUnzip::FillBuffer()
          if (gDebug > 0) printf("Entry: %lld, registering baskets branch %s, fEntryNext=%lld, fNseek=%d, fNtot=%d\n",entry,((TBranch*)fBranches->UncheckedAt(i))->GetName(),fEntryNext,fNseek,fNtot);
       }
 
-      // Now fix the size of the status arrays
+      // Now fix the size of the status arrays. This also cancels the
+      // unzip tasks of the previous cluster: they check the cycle under
+      // fMutexList before touching the cache buffer.
       ResetCache();
 
       fIsLearning = kFALSE;
 
+      // The unzip tasks are submitted by GetUnzipBuffer once the reader
+      // has transferred the baskets into the cache buffer.
    }
 
    return kTRUE;
@@ -382,62 +402,15 @@ Bool_t TTreeCacheUnzip::IsParallelUnzip()
    return kFALSE;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-/// This indicates if the thread is active in this moment...
-/// this variable is very important because if we change it from true to
-/// false the thread will stop... ( see StopThreadTreeCacheUnzip() )
-
-Bool_t TTreeCacheUnzip::IsActiveThread()
-{
-   R__LOCKGUARD(fMutexList);
-
-   return fActiveThread;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// It says if the queue is empty... useful to see if we have to process it.
-
-Bool_t TTreeCacheUnzip::IsQueueEmpty()
-{
-   R__LOCKGUARD(fMutexList);
-
-   if ( fIsLearning )
-      return kTRUE;
-
-   return kFALSE;
-}
-
-void TTreeCacheUnzip::WaitUnzipStartSignal()
-{
-   // Here the threads sleep waiting for some blocks to unzip
-
-   fUnzipStartCondition->TimedWaitRelative(2000);
-
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// This will send the signal corresponfing to the queue... normally used
-/// when we want to start processing the list of buffers.
-
-void TTreeCacheUnzip::SendUnzipStartSignal(Bool_t broadcast)
-{
-   if (gDebug > 0) Info("SendSignal", " fUnzipCondition->Signal()");
-
-   if (broadcast)
-      fUnzipStartCondition->Broadcast();
-   else
-      fUnzipStartCondition->Signal();
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 /// Static function that (de)activates multithreading unzipping
 ///
 /// The possible options are:
-///  - kEnable _Enable_ it, which causes an automatic detection and launches the
-///    additional thread if the number of cores in the machine is greater than
-///    one
-///  - kDisable _Disable_ will not activate the additional thread.
-///  - kForce _Force_ will start the additional thread even if there is only one
+///  - kEnable _Enable_ it, which causes an automatic detection and starts the
+///    global TTaskPool, if it is not running yet, when the number of cores in
+///    the machine is greater than one
+///  - kDisable _Disable_ will not unzip in parallel.
+///  - kForce _Force_ will start the global TTaskPool even if there is only one
 ///    core. the default will be taken as kEnable.
 ///
 /// Returns 0 if there was an error, 1 otherwise.
@@ -451,137 +424,6 @@ Int_t TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::EParUnzipMode option)
    return 0;
 }
 
-class TTreeCacheUnzipData {
-public:
-   TTreeCacheUnzip *fInstance;
-   Int_t            fCount;
-};
-
-////////////////////////////////////////////////////////////////////////////////
-/// The Thread is only a part of the TTreeCache but it is the part that
-/// waits for info in the queue and process it... unfortunatly, a Thread is
-/// not an object an we have to deal with it in the old C-Style way
-/// Returns 0 if the thread was initialized or 1 if it was already running
-
-Int_t TTreeCacheUnzip::StartThreadUnzip(Int_t nthreads)
-{
-   Int_t nt = nthreads;
-   if (nt > 10) nt = 10;
-
-   if (gDebug > 0)
-      Info("StartThreadUnzip", "Going to start %d threads.", nt);
-
-   for (Int_t i = 0; i < nt; i++) {
-      if (!fUnzipThread[i]) {
-         TString nm("UnzipLoop");
-         nm += i;
-
-         if (gDebug > 0)
-            Info("StartThreadUnzip", "Going to start thread '%s'", nm.Data());
-
-         TTreeCacheUnzipData *d = new TTreeCacheUnzipData;
-         d->fInstance = this;
-         d->fCount = i;
-
-         fUnzipThread[i] = new TThread(nm.Data(), UnzipLoop, (void*)d);
-         if (!fUnzipThread[i])
-            Error("TTreeCacheUnzip::StartThreadUnzip", " Unable to create new thread.");
-
-         fUnzipThread[i]->Run();
-
-         // There is at least one active thread
-         fActiveThread=kTRUE;
-
-      }
-   }
-
-   return (fActiveThread == kTRUE);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// To stop the thread we only need to change the value of the variable
-/// fActiveThread to false and the loop will stop (of course, we will have)
-/// to do the cleaning after that.
-///
-/// Note: The syncronization part is important here or we will try to delete
-///       teh object while it's still processing the queue
-
-Int_t TTreeCacheUnzip::StopThreadUnzip()
-{
-   fActiveThread = kFALSE;
-
-   for (Int_t i = 0; i < 1; i++) {
-      if(fUnzipThread[i]){
-
-         SendUnzipStartSignal(kTRUE);
-
-         if (fUnzipThread[i]->Exists()) {
-            fUnzipThread[i]->Join();
-            delete fUnzipThread[i];
-         }
-      }
-
-   }
-
-   return 1;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// This is a static function.
-///
-/// This is the call that will be executed in the Thread generated by
-/// StartThreadTreeCacheUnzip... what we want to do is to inflate the next
-/// series of buffers leaving them in the second cache.
-///
-/// Returns 0 when it finishes
-
-void* TTreeCacheUnzip::UnzipLoop(void *arg)
-{
-   TTreeCacheUnzipData *d = (TTreeCacheUnzipData *)arg;
-   TTreeCacheUnzip *unzipMng = d->fInstance;
-
-   TThread::SetCancelOn();
-   TThread::SetCancelDeferred();
-
-   Int_t thrnum = d->fCount;
-   Int_t startindex = thrnum;
-   Int_t locbuffsz = 16384;
-   char *locbuff = new char[16384];
-   Int_t res = 0;
-   Int_t myCycle = 0;
-
-   while( unzipMng->IsActiveThread() ) {
-      res = 1;
-
-      {
-         R__LOCKGUARD(unzipMng->fMutexList);
-         if (myCycle != unzipMng->fCycle) startindex = thrnum;
-         myCycle = unzipMng->fCycle;
-         if (unzipMng->fNseek) startindex = startindex % unzipMng->fNseek;
-         else startindex = -1;
-      }
-
-      if (startindex >= 0)
-         res = unzipMng->UnzipCache(startindex, locbuffsz, locbuff);
-
-      {
-         R__LOCKGUARD(unzipMng->fMutexList);
-
-         if(!unzipMng->IsActiveThread()) break;
-
-         if ((res == 1) || (!unzipMng->fIsTransferred)) {
-            unzipMng->WaitUnzipStartSignal();
-            startindex = unzipMng->fLastReadPos+3+thrnum;
-         }
-      }
-
-   }
-
-   delete d;
-   delete [] locbuff;
-   return (void *)0;
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 //                                                                            //
 // From now on we have the methods concerning the unzipping part of the cache //
@@ -634,10 +476,11 @@ Int_t TTreeCacheUnzip::GetRecordHeader(char *buf, Int_t maxbytes, Int_t &nbytes,
 /// Note: This method is completely different from TTreeCache::ResetCache(),
 /// in that method we were cleaning the prefetching buffer while here we
 /// delete the information about the unzipped buffers
+/// The unzip tasks of the previous cycle which are still queued or running
+/// notice the change of cycle and drop their result.
 
 void TTreeCacheUnzip::ResetCache()
 {
-   {
    R__LOCKGUARD(fMutexList);
 
    if (gDebug > 0)
@@ -645,17 +488,18 @@ void TTreeCacheUnzip::ResetCache()
 
    // Reset all the lists and wipe all the chunks
    fCycle++;
+   fUnzipScheduled = kFALSE;
    for (Int_t i = 0; i < fNseekMax; i++) {
       if (fUnzipLen) fUnzipLen[i] = 0;
       if (fUnzipChunks) {
          if (fUnzipChunks[i]) delete [] fUnzipChunks[i];
          fUnzipChunks[i] = 0;
       }
-      if (fUnzipStatus) fUnzipStatus[i] = 0;
+      if (fUnzipStatus) fUnzipStatus[i] = kUntouched;
 
    }
 
-   while (fActiveBlks.size()) fActiveBlks.pop();
+   while (fDeferredBlks.size()) fDeferredBlks.pop();
 
    if(fNseekMax < fNseek){
       if (gDebug > 0)
@@ -683,11 +527,9 @@ void TTreeCacheUnzip::ResetCache()
 
    fLastReadPos = 0;
    fTotalUnzipBytes = 0;
-   fBlocksToGo = fNseek;
-   }
-
-   SendUnzipStartSignal(kTRUE);
 
+   // Wake up a reader waiting for a block of the previous cycle
+   fUnzipDoneCondition->Broadcast();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -699,6 +541,8 @@ void TTreeCacheUnzip::ResetCache()
 /// Note!! : If *buf == 0 we will allocate the buffer and it will be the
 /// responsability of the caller to free it... it is useful for example
 /// to pass it to the creator of TBuffer
+/// If the block is being unzipped by a task, we wait for this block only;
+/// if no task started on it yet, we unzip it ourselves.
 
 Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_t *free)
 {
@@ -717,10 +561,7 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
       // Also, here we prefer not to trigger the (re)population of the chunks in the TFileCacheRead. That is
       // better to be done in the main thread.
 
-      // And now loc is the position of the chunk in the array of the sorted chunks
-      Int_t myCycle = fCycle;
-
-      if (fParallel && !fIsLearning) {
+      if (fParallel && !fIsLearning && fIsTransferred) {
 
          if(fNseekMax < fNseek){
             if (gDebug > 0)
@@ -752,120 +593,68 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
             fNseekMax  = fNseek;
          }
 
+         // And now loc is the position of the chunk in the array of the sorted chunks
          loc = (Int_t)TMath::BinarySearch(fNseek,fSeekSort,pos);
-         if ( (fCycle == myCycle) && (loc >= 0) && (loc < fNseek) && (pos == fSeekSort[loc]) ) {
+         if ( (loc >= 0) && (loc < fNseek) && (pos == fSeekSort[loc]) ) {
 
             // The buffer is, at minimum, in the file cache. We must know its index in the requests list
             // In order to get its info
             Int_t seekidx = fSeekIndex[loc];
+            Int_t myCycle = fCycle;
+            Bool_t stalled = kFALSE;
 
             fLastReadPos = seekidx;
 
-            do {
+            // If a task is unzipping the block, we wait for this one only.
+            if (fUnzipStatus[seekidx] == kProgress) {
+               TStopwatch timer;
+               while (fUnzipStatus[seekidx] == kProgress && myCycle == fCycle) {
+                  fUnzipDoneCondition->Wait();
+               }
+               fUnzipWaitTime += timer.RealTime();
+               stalled = kTRUE;
+            }
+
+            if ( (myCycle == fCycle) && (fUnzipStatus[seekidx] == kFinished) && (fUnzipChunks[seekidx]) && (fUnzipLen[seekidx] > 0) ) {
 
                // If the block is ready we get it immediately.
                // And also we don't have to alloc the blks. This is supposed to be
                // the main thread of the app.
-               if ((fUnzipStatus[seekidx] == 2) && (fUnzipChunks[seekidx]) && (fUnzipLen[seekidx] > 0)) {
-
-                  //if (gDebug > 0)
-                  //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheHIT Block wanted: %d  len:%d req_len:%d fNseek:%d", seekidx, fUnzipLen[seekidx], len,  fNseek);
-
-                  if(!(*buf)) {
-                     *buf = fUnzipChunks[seekidx];
-                     fUnzipChunks[seekidx] = 0;
-                     fTotalUnzipBytes -= fUnzipLen[seekidx];
-                     SendUnzipStartSignal(kFALSE);
-                     *free = kTRUE;
-                  }
-                  else {
-                     memcpy(*buf, fUnzipChunks[seekidx], fUnzipLen[seekidx]);
-                     delete fUnzipChunks[seekidx];
-                     fTotalUnzipBytes -= fUnzipLen[seekidx];
-                     fUnzipChunks[seekidx] = 0;
-                     SendUnzipStartSignal(kFALSE);
-                     *free = kFALSE;
-                  }
-
-                  fNFound++;
-
-                  return fUnzipLen[seekidx];
-               }
-
-               // If the status of the unzipped chunk is pending
-               // we wait on the condvar, hoping that the next signal is the good one
-               if ( fUnzipStatus[seekidx] == 1 ) {
-                  //fMutexList->UnLock();
-                  fUnzipDoneCondition->TimedWaitRelative(200);
-                  //fMutexList->Lock();
-
-                  if ( myCycle != fCycle ) {
-                     if (gDebug > 0)
-                        Info("GetUnzipBuffer", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                             IsActiveThread(), fNseek, fIsLearning);
-
-                     fLastReadPos = 0;
-
-                     seekidx = -1;
-                     break;
-                  }
-
-               }
-
-            } while ( fUnzipStatus[seekidx] == 1 );
-
-            //if (gDebug > 0)
-            //   Info("GetUnzipBuffer", "------- Block wanted: %d  status: %d len: %d chunk: %llx ", seekidx, fUnzipStatus[seekidx], fUnzipLen[seekidx], fUnzipChunks[seekidx]);
-
-            // Here the block is not pending. It could be done or aborted or not yet being processed.
-            if ( (seekidx >= 0) && (fUnzipStatus[seekidx] == 2) && (fUnzipChunks[seekidx]) && (fUnzipLen[seekidx] > 0) ) {
-
-               //if (gDebug > 0)
-               //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheLateHIT Block wanted: %d  len:%d fNseek:%d", seekidx, fUnzipLen[seekidx], fNseek);
-
+               Int_t unzipLen = fUnzipLen[seekidx];
                if(!(*buf)) {
                   *buf = fUnzipChunks[seekidx];
-                  fUnzipChunks[seekidx] = 0;
-                  fTotalUnzipBytes -= fUnzipLen[seekidx];
-                  SendUnzipStartSignal(kFALSE);
                   *free = kTRUE;
                }
                else {
-                  memcpy(*buf, fUnzipChunks[seekidx], fUnzipLen[seekidx]);
-                  delete fUnzipChunks[seekidx];
-                  fTotalUnzipBytes -= fUnzipLen[seekidx];
-                  fUnzipChunks[seekidx] = 0;
-                  SendUnzipStartSignal(kFALSE);
+                  memcpy(*buf, fUnzipChunks[seekidx], unzipLen);
+                  delete [] fUnzipChunks[seekidx];
                   *free = kFALSE;
                }
+               fUnzipChunks[seekidx] = 0;
+               fTotalUnzipBytes -= unzipLen;
 
-               fNStalls++;
+               // There is room again for the postponed blocks.
+               ScheduleDeferred();
 
-               return fUnzipLen[seekidx];
-            }
-            else {
-               // This is a complete miss. We want to avoid the threads
-               // to try unzipping this block in the future.
-               fUnzipStatus[seekidx] = 2;
-               fUnzipChunks[seekidx] = 0;
+               if (stalled) fNStalls++;
+               else fNFound++;
 
-               if ((fTotalUnzipBytes < fUnzipBufferSize) && fBlocksToGo)
-                  SendUnzipStartSignal(kFALSE);
+               return unzipLen;
+            }
 
-               //if (gDebug > 0)
-               //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheMISS Block wanted: %d  len:%d fNseek:%d", seekidx, len, fNseek);
+            // This is a miss: the block was not unzipped (yet, or at all)
+            // by the tasks. We avoid the tasks to try unzipping this block
+            // in the future and unzip it ourselves.
+            if (myCycle == fCycle) {
+               fUnzipStatus[seekidx] = kFinished;
+               fUnzipChunks[seekidx] = 0;
             }
 
          } else {
             loc = -1;
-            //fLastReadPos = 0;
             fIsTransferred = kFALSE;
          }
 
-      } else {
-         // We need to reset it for new transferences...
-         //ResetCache();
-         //TFileCacheRead::Prefetch(0,0);
       }
 
    } // scope of the lock!
@@ -883,19 +672,24 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
    }
 
    {
-      R__LOCKGUARD(fIOMutex);
+      R__LOCKGUARD(fMutexList);
       // Here we know that the async unzip of the wanted chunk
       // was not done for some reason. We continue.
 
       res = 0;
       if (!ReadBufferExt(fCompBuffer, pos, len, loc)) {
-         //Info("GetUnzipBuffer", "++++++++++++++++++++ CacheMISS %d %d", loc, fNseek);
          fFile->Seek(pos);
          res = fFile->ReadBuffer(fCompBuffer, len);
       }
 
       if (res) res = -1;
 
+      // The first read of a cluster transfers its baskets into the cache
+      // buffer, the tasks can now unzip them.
+      if (fParallel && !fIsLearning && fIsTransferred && !fUnzipScheduled) {
+         ScheduleAll();
+      }
+
    } // scope of the lock!
 
    if (!res) {
@@ -1033,219 +827,144 @@ Int_t TTreeCacheUnzip::UnzipBuffer(char **dest, char *src)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// This inflates all the buffers in the cache.. passing the data to a new
-/// buffer that will only wait there to be read...
-/// We can not inflate all the buffers in the cache so we will try to do
-/// it until the cache gets full... there is a member called fUnzipBufferSize which will
-/// tell us the max size we can allocate for this cache.
-///
-/// note that we will  unzip in the order they were put into the cache not
-/// the order of the transference so it has to be read in that order or the
-/// pre-unzipping will be useless.
-///
-/// startindex is used as start index to check for blks to be unzipped
-///
-/// returns 0 in normal conditions or -1 if error, 1 if it would like to sleep
-///
-/// This func is supposed to compete among an indefinite number of threads to get a chunk to inflate
-/// in order to accommodate multiple unzippers
-/// Since everything is so async, we cannot use a fixed buffer, we are forced to keep
-/// the individual chunks as separate blocks, whose summed size does not exceed the maximum
-/// allowed. The pointers are kept globally in the array fUnzipChunks
+/// Submit to the pool the tasks unzipping the blocks of the current cycle.
+/// Must be called with fMutexList held, once the blocks are transferred.
 
-Int_t TTreeCacheUnzip::UnzipCache(Int_t &startindex, Int_t &locbuffsz, char *&locbuff)
+void TTreeCacheUnzip::ScheduleAll()
 {
-   Int_t myCycle;
-   const Int_t hlen=128;
-   Int_t objlen=0, keylen=0;
-   Int_t nbytes=0;
-   Int_t readbuf = 0;
-
-   Int_t idxtounzip = -1;
-   Long64_t rdoffs = 0;
-   Int_t rdlen = 0;
-   {
-      R__LOCKGUARD(fMutexList);
+   fUnzipScheduled = kTRUE;
+   for (Int_t i = 0; i < fNseek; i++) {
+      if (fUnzipStatus[i] == kUntouched) ScheduleUnzip(i);
+   }
+}
 
-      if (!IsActiveThread() || !fNseek || fIsLearning || !fIsTransferred) {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-         return 1;
-      }
+////////////////////////////////////////////////////////////////////////////////
+/// Submit to the pool the task unzipping the block index of the current
+/// cycle. Must be called with fMutexList held.
+/// The small blocks are not worth a task; they are unzipped when read.
 
-      // To synchronize with the 'paging'
-      myCycle = fCycle;
-
-      // Try to look for a blk to unzip
-      idxtounzip = -1;
-      rdoffs = 0;
-      rdlen = 0;
-      if (fTotalUnzipBytes < fUnzipBufferSize) {
-
-         if (fBlocksToGo > 0) {
-            for (Int_t ii=0; ii < fNseek; ii++) {
-               Int_t reqi = (startindex+ii) % fNseek;
-               if (!fUnzipStatus[reqi] && (fSeekLen[reqi] > 256)   ) {
-                  // We found a chunk which is not unzipped nor pending
-                  fUnzipStatus[reqi] = 1; // Set it as pending
-                  idxtounzip = reqi;
-
-                  rdoffs = fSeek[idxtounzip];
-                  rdlen = fSeekLen[idxtounzip];
-                  break;
-               }
-            }
-            if (idxtounzip < 0) fBlocksToGo = 0;
-         }
-      }
+void TTreeCacheUnzip::ScheduleUnzip(Int_t index)
+{
+   if (fSeekLen[index] <= 256) return;
+
+   TTreeCacheUnzip *cache = this;
+   Long64_t pos = fSeek[index];
+   Int_t len = fSeekLen[index];
+   Int_t cycle = fCycle;
+   fUnzipTasks->Run([cache, index, pos, len, cycle]() {
+      cache->UnzipBlock(index, pos, len, cycle);
+   });
+}
 
-   } // lock scope
+////////////////////////////////////////////////////////////////////////////////
+/// Resubmit the blocks which were postponed because the unzipped blocks
+/// exceeded fUnzipBufferSize, as long as there is room for them.
+/// Must be called with fMutexList held.
 
-   if (idxtounzip < 0) {
-      if (gDebug > 0)
-         Info("UnzipCache", "Nothing to do... startindex:%d fTotalUnzipBytes:%lld fUnzipBufferSize:%lld fNseek:%d",
-              startindex, fTotalUnzipBytes, fUnzipBufferSize, fNseek );
-      return 1;
+void TTreeCacheUnzip::ScheduleDeferred()
+{
+   while (!fDeferredBlks.empty() && fTotalUnzipBytes < fUnzipBufferSize) {
+      Int_t index = fDeferredBlks.front();
+      fDeferredBlks.pop();
+      if (fUnzipStatus[index] == kUntouched) ScheduleUnzip(index);
    }
+}
 
-   // And here we have a new blk to unzip
-   startindex = idxtounzip+THREADCNT;
-
-   if (!IsActiveThread() || !fNseek || fIsLearning ) {
-      if (gDebug > 0)
-         Info("UnzipCache", "Sudden Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-              IsActiveThread(), fNseek, fIsLearning);
-      return 1;
-   }
+////////////////////////////////////////////////////////////////////////////////
+/// The unzip task: inflate the block index of the cycle cycle, whose
+/// compressed record is at pos and of length len, passing the data to a new
+/// buffer that will only wait there to be read.
+///
+/// The task gives up if the cache moved on to another cycle, if the reader
+/// already took the block over or if the cache buffer is not transferred,
+/// and postpones the block if the unzipped blocks exceed fUnzipBufferSize.
+/// The compressed record is copied out of the cache buffer in the same
+/// critical section as these checks, so that FillBuffer can not refill the
+/// buffer meanwhile.
+/// Since everything is so async, we cannot use a fixed buffer, we are forced to keep
+/// the individual chunks as separate blocks, whose summed size does not exceed the maximum
+/// allowed. The pointers are kept globally in the array fUnzipChunks
 
+void TTreeCacheUnzip::UnzipBlock(Int_t index, Long64_t pos, Int_t len, Int_t cycle)
+{
+   char *compressed = 0;
    Int_t loc = -1;
-
-   // Prepare a static tmp buf of adequate size
-   if(locbuffsz < rdlen) {
-      if (locbuff) delete [] locbuff;
-      locbuffsz = rdlen;
-      locbuff = new char[locbuffsz];
-      //memset(locbuff, 0, locbuffsz);
-   } else
-      if(locbuffsz > rdlen*3) {
-         if (locbuff) delete [] locbuff;
-         locbuffsz = rdlen*2;
-         locbuff = new char[locbuffsz];
-         //memset(locbuff, 0, locbuffsz);
-      }
-
-      if (gDebug > 0)
-      Info("UnzipCache", "Going to unzip block %d", idxtounzip);
-
-      readbuf = ReadBufferExt(locbuff, rdoffs, rdlen, loc);
-
+   Int_t readbuf = 0;
    {
       R__LOCKGUARD(fMutexList);
 
-      if ( (myCycle != fCycle) || !fIsTransferred )  {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-         fUnzipDoneCondition->Signal();
-
-         startindex = 0;
-         return 1;
-      }
+      if (cycle != fCycle || !fIsTransferred || fUnzipStatus[index] != kUntouched) return;
 
-      if (readbuf <= 0) {
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-         if (gDebug > 0)
-            Info("UnzipCache", "Block %d not done. rdoffs=%lld rdlen=%d readbuf=%d", idxtounzip, rdoffs, rdlen, readbuf);
-         return -1;
+      if (fTotalUnzipBytes >= fUnzipBufferSize) {
+         fDeferredBlks.push(index);
+         return;
       }
+      fUnzipStatus[index] = kProgress;
 
-      GetRecordHeader(locbuff, hlen, nbytes, objlen, keylen);
-
-      Int_t len = (objlen > nbytes-keylen)? keylen+objlen : nbytes;
-
-      // If the single unzipped chunk is really too big, reset it to not processable
-      // I.e. mark it as done but set the pointer to 0
-      // This block will be unzipped synchronously in the main thread
-      if (len > 4*fUnzipBufferSize) {
-
-         //if (gDebug > 0)
-            Info("UnzipCache", "Block %d is too big, skipping.", idxtounzip);
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-
-         fUnzipDoneCondition->Signal();
-         return 0;
-      }
+      if (gDebug > 0)
+         Info("UnzipBlock", "Going to unzip block %d", index);
 
-   } // Scope of the lock
+      compressed = new char[len];
+      readbuf = TTreeCache::ReadBufferExt(compressed, pos, len, loc);
+   }
 
-   // Unzip it into a new blk
    char *ptr = 0;
    Int_t loclen = 0;
-
-   loclen = UnzipBuffer(&ptr, locbuff);
-
-   if ((loclen > 0) && (loclen == objlen+keylen)) {
-      R__LOCKGUARD(fMutexList);
-
-      if ( (myCycle != fCycle)  || !fIsTransferred) {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-         delete [] ptr;
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-
-         startindex = 0;
-         fUnzipDoneCondition->Signal();
-         return 1;
+   if (readbuf > 0) {
+      const Int_t hlen=128;
+      Int_t objlen=0, keylen=0;
+      Int_t nbytes=0;
+      GetRecordHeader(compressed, hlen, nbytes, objlen, keylen);
+
+      // If the single unzipped chunk is really too big, leave it to the
+      // reader, which will unzip it synchronously.
+      Int_t unzipLen = (objlen > nbytes-keylen)? keylen+objlen : nbytes;
+      if (unzipLen <= 4*fUnzipBufferSize) {
+         loclen = UnzipBuffer(&ptr, compressed);
+         if (loclen != objlen+keylen) {
+            Info("UnzipBlock", "loclen:%d objlen:%d loc:%d readbuf:%d", loclen, objlen, loc, readbuf);
+            delete [] ptr;
+            ptr = 0;
+         }
+      } else if (gDebug > 0) {
+         Info("UnzipBlock", "Block %d is too big, skipping.", index);
       }
+   } else if (gDebug > 0) {
+      Info("UnzipBlock", "Block %d not done. pos=%lld len=%d readbuf=%d", index, pos, len, readbuf);
+   }
+   delete [] compressed;
 
-      fUnzipStatus[idxtounzip] = 2; // Set it as done
-      fUnzipChunks[idxtounzip] = ptr;
-      fUnzipLen[idxtounzip] = loclen;
-      fTotalUnzipBytes += loclen;
-
-      fActiveBlks.push(idxtounzip);
-
-      if (gDebug > 0)
-         Info("UnzipCache", "reqi:%d, rdoffs:%lld, rdlen: %d, loclen:%d",
-              idxtounzip, rdoffs, rdlen, loclen);
+   R__LOCKGUARD(fMutexList);
 
-      fNUnzip++;
-   }
-   else {
-      R__LOCKGUARD(fMutexList);
-      Info("argh", "loclen:%d objlen:%d loc:%d readbuf:%d", loclen, objlen, loc, readbuf);
-      fUnzipStatus[idxtounzip] = 2; // Set it as done
-      fUnzipChunks[idxtounzip] = 0;
-      fUnzipLen[idxtounzip] = 0;
+   if (cycle != fCycle) {
+      // The status arrays were reset meanwhile: drop the result.
+      delete [] ptr;
+   } else {
+      fUnzipStatus[index] = kFinished;
+      fUnzipChunks[index] = ptr;
+      fUnzipLen[index] = ptr ? loclen : 0;
+      if (ptr) {
+         fTotalUnzipBytes += loclen;
+         fNUnzipBytes += loclen;
+         fNUnzip++;
+      }
    }
 
-   fUnzipDoneCondition->Signal();
-
-   delete [] ptr;
-   return 0;
+   fUnzipDoneCondition->Broadcast();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Print the statistics of the cache.
+
 void  TTreeCacheUnzip::Print(Option_t* option) const {
 
    printf("******TreeCacheUnzip statistics for file: %s ******\n",fFile->GetName());
    printf("Max allowed mem for pending buffers: %lld\n", fUnzipBufferSize);
    printf("Number of blocks unzipped by threads: %d\n", fNUnzip);
+   printf("Number of bytes unzipped by threads: %lld\n", fNUnzipBytes);
    printf("Number of hits: %d\n", fNFound);
    printf("Number of stalls: %d\n", fNStalls);
+   printf("Time spent waiting for blocks: %.3f s\n", fUnzipWaitTime);
    printf("Number of misses: %d\n", fNMissed);
 
    TTreeCache::Print(option);
@@ -1254,7 +973,7 @@ void  TTreeCacheUnzip::Print(Option_t* option) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t TTreeCacheUnzip::ReadBufferExt(char *buf, Long64_t pos, Int_t len, Int_t &loc) {
-   R__LOCKGUARD(fIOMutex);
+   R__LOCKGUARD(fMutexList);
    return TTreeCache::ReadBufferExt(buf, pos, len, loc);
 
 }
@@ -0,0 +1,89 @@
+// @(#)root/treeplayer:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTreeProcessor
+#define ROOT_TTreeProcessor
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TTreeProcessor                                                       //
+//                                                                      //
+// Process a TTree or a TChain on all the cores of the local machine.   //
+// The entries are split along the cluster boundaries of the trees and  //
+// each cluster is processed by a task of the global TTaskPool, with    //
+// its own TFile and TTree.                                             //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TString
+#include "TString.h"
+#endif
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class TFile;
+class TMutex;
+class TSelector;
+class TTree;
+class TTreeReader;
+
+class TTreeProcessor {
+
+public:
+   typedef std::function<void(TTreeReader &)> Function_t;
+
+private:
+   struct TTreeView {
+      TFile     *fFile;        // file opened for this view
+      TTree     *fTree;        // the tree in fFile
+      TSelector *fSelector;    // copy of the selector processing this view, if any
+   };
+
+   struct TRange {
+      UInt_t     fFile;        // index of the file in fFileNames and fTreeNames
+      Long64_t   fBegin;       // first entry of the cluster
+      Long64_t   fEnd;         // entry after the last entry of the cluster
+   };
+
+   std::vector<std::string>  fTreeNames;  // name of the tree in each file, including its directory
+   std::vector<std::string>  fFileNames;  // files containing the tree
+   TTree                    *fTree;       // tree or chain given to the constructor, 0 otherwise
+   std::vector<std::vector<TTreeView*> > fFreeViews; // views not used by a task, for each file
+   std::vector<TTreeView*>   fViews;      // all the views
+   TMutex                   *fMutex;      // protects fFreeViews and fViews
+   TSelector                *fSelector;   // selector being processed, 0 when processing a function
+   TString                   fOption;     // option of the selector being processed
+
+   TTreeProcessor(const TTreeProcessor&);            // not implemented
+   TTreeProcessor& operator=(const TTreeProcessor&); // not implemented
+
+   TTreeView *AcquireView(UInt_t file);
+   TTreeView *OpenView(UInt_t file);
+   void       ReleaseView(UInt_t file, TTreeView *view);
+   void       DeleteViews();
+   Bool_t     MakeRanges(std::vector<TRange> &ranges);
+
+public:
+   TTreeProcessor(const char *treename, const char *filename);
+   TTreeProcessor(const char *treename, const std::vector<std::string> &filenames);
+   TTreeProcessor(TTree &tree);
+   virtual ~TTreeProcessor();
+
+   const char *GetTreeName(UInt_t file = 0) const { return file < fTreeNames.size() ? fTreeNames[file].c_str() : ""; }
+   const std::vector<std::string> &GetFileNames() const { return fFileNames; }
+
+   void       Process(Function_t func);
+   Long64_t   Process(TSelector *selector, Option_t *option = "");
+};
+
+#endif
@@ -136,7 +136,9 @@ public:
    TTreeReader():
       fDirectory(0),
       fEntryStatus(kEntryNoTree),
-      fDirector(0)
+      fDirector(0),
+      fBeginEntry(0),
+      fEndEntry(-1)
    {}
 
    TTreeReader(TTree* tree);
@@ -151,9 +153,14 @@ public:
 
    Bool_t IsChain() const { return TestBit(kBitIsChain); }
 
-   Bool_t Next() { return SetEntry(GetCurrentEntry() + 1) == kEntryValid; }
+   Bool_t Next() {
+      Long64_t entry = GetCurrentEntry() + 1;
+      if (entry < fBeginEntry) entry = fBeginEntry;
+      return SetEntry(entry) == kEntryValid;
+   }
    EEntryStatus SetEntry(Long64_t entry) { return SetEntryBase(entry, kFALSE); }
    EEntryStatus SetLocalEntry(Long64_t entry) { return SetEntryBase(entry, kTRUE); }
+   void SetEntriesRange(Long64_t beginEntry, Long64_t endEntry);
 
    EEntryStatus GetEntryStatus() const { return fEntryStatus; }
 
@@ -162,8 +169,8 @@ public:
    Long64_t GetCurrentEntry() const;
 
    Iterator_t begin() {
-      // Return an iterator to the 0th TTree entry.
-      return Iterator_t(*this, 0);
+      // Return an iterator to the first TTree entry of the range (0 by default).
+      return Iterator_t(*this, fBeginEntry);
    }
    Iterator_t end() const { return Iterator_t(); }
 
@@ -190,6 +197,8 @@ private:
    ROOT::TBranchProxyDirector* fDirector; // proxying director, owned
    std::deque<ROOT::TTreeReaderValueBase*> fValues; // readers that use our director
    THashTable   fProxies; //attached ROOT::TNamedBranchProxies; owned
+   Long64_t fBeginEntry; // first entry read by Next()
+   Long64_t fEndEntry; // entry after the last one that can be read; -1 means up to the end
 
    friend class ROOT::TTreeReaderValueBase;
    friend class ROOT::TTreeReaderArrayBase;
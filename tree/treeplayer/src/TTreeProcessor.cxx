@@ -0,0 +1,394 @@
+// @(#)root/treeplayer:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TTreeProcessor
+
+Process a TTree or a TChain on all the cores of the local machine,
+without the startup cost of PROOF-Lite.
+
+The entries are split along the cluster boundaries of the trees (see
+TTree::GetClusterIterator) and each cluster is processed by a task of
+the global TTaskPool. A task never shares its TFile and TTree with a
+concurrently running task: each task picks a "view" of the file (a
+TFile and the TTree read from it) not used by any other task, opening
+a new one if needed. The views are reused by the following tasks, so
+that at most one view per thread is opened for each file.
+
+The global pool must be enabled with TTaskPool::SetGlobalPoolSize;
+otherwise the clusters are processed one after the other by the calling
+thread.
+
+Two ways of processing the entries are supported:
+
+ - a function called for each cluster with a TTreeReader restricted to
+   the entries of the cluster. It is called concurrently from several
+   threads, so it must synchronize its access to shared results:
+~~~ {.cpp}
+   TH1F hpx("hpx", "px", 100, -4, 4);
+   TMutex mutex;
+   TTreeProcessor processor("ntuple", "hsimple.root");
+   processor.Process([&](TTreeReader &reader) {
+      TTreeReaderValue<Float_t> px(reader, "px");
+      TH1F local("local", "px", 100, -4, 4);
+      local.SetDirectory(0);
+      while (reader.Next()) local.Fill(*px);
+      TLockGuard lock(&mutex);
+      hpx.Add(&local);
+   });
+~~~
+ - a TSelector. Each view processes its entries with its own copy of the
+   selector, created with the default constructor of the selector class
+   and initialized with SlaveBegin. Once all the entries are processed,
+   the copies are terminated with SlaveTerminate and their output lists
+   are merged, with the Merge(TCollection*) method of the objects, into
+   the output list of the selector, whose Terminate is then called. As
+   with PROOF, the objects to be merged must be created in SlaveBegin and
+   added to fOutput.
+
+The objects created while processing the entries are not attached to
+any directory (gDirectory is 0 in the tasks).
+*/
+
+#include "TTreeProcessor.h"
+
+#include "TChain.h"
+#include "TChainElement.h"
+#include "TClass.h"
+#include "TDirectory.h"
+#include "TError.h"
+#include "TFile.h"
+#include "TList.h"
+#include "TMutex.h"
+#include "TSelector.h"
+#include "TTaskPool.h"
+#include "TTree.h"
+#include "TTreeReader.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the tree treename (which can include a directory, e.g. "dir/T")
+/// of the file filename.
+
+TTreeProcessor::TTreeProcessor(const char *treename, const char *filename) :
+   fTree(0), fMutex(new TMutex()), fSelector(0)
+{
+   fTreeNames.push_back(treename);
+   fFileNames.push_back(filename);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the tree treename of all the files filenames.
+
+TTreeProcessor::TTreeProcessor(const char *treename, const std::vector<std::string> &filenames) :
+   fTreeNames(filenames.size(), treename), fFileNames(filenames), fTree(0), fMutex(new TMutex()), fSelector(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the files and the tree of the TChain or of the TTree tree.
+/// The tree itself is not used to read the entries: each task reads its
+/// own copy from the files, the tree is only passed to TSelector::Begin.
+/// Friends and entry lists are ignored.
+
+TTreeProcessor::TTreeProcessor(TTree &tree) : fTree(&tree), fMutex(new TMutex()), fSelector(0)
+{
+   if (TChain *chain = dynamic_cast<TChain*>(&tree)) {
+      TIter next(chain->GetListOfFiles());
+      while (TChainElement *element = (TChainElement*)next()) {
+         // The name of the element is the one of the tree in its file.
+         fTreeNames.push_back(element->GetName());
+         fFileNames.push_back(element->GetTitle());
+      }
+      return;
+   }
+
+   TFile *file = tree.GetCurrentFile();
+   TDirectory *dir = tree.GetDirectory();
+   if (!file || !dir) {
+      ::Error("TTreeProcessor::TTreeProcessor", "the tree %s is not read from a file", tree.GetName());
+      return;
+   }
+   fFileNames.push_back(file->GetName());
+
+   // Path of the tree in the file
+   TString path = dir->GetPath();
+   Ssiz_t colon = path.Index(":/");
+   TString subdir = colon == kNPOS ? TString() : TString(path(colon+2, path.Length()));
+   if (subdir.Length()) fTreeNames.push_back((subdir + "/" + tree.GetName()).Data());
+   else fTreeNames.push_back(tree.GetName());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TTreeProcessor::~TTreeProcessor()
+{
+   DeleteViews();
+   delete fMutex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a view of the file number file not used by any other task,
+/// opening a new one if needed. When processing a selector, the view
+/// gets its own initialized copy of the selector. Return 0 if the file
+/// or the tree cannot be read.
+
+TTreeProcessor::TTreeView *TTreeProcessor::AcquireView(UInt_t file)
+{
+   TTreeView *view = 0;
+   {
+      TLockGuard lock(fMutex);
+      if (!fFreeViews[file].empty()) {
+         view = fFreeViews[file].back();
+         fFreeViews[file].pop_back();
+      }
+   }
+   if (!view) {
+      view = OpenView(file);
+      if (!view) return 0;
+   }
+
+   if (fSelector && !view->fSelector) {
+      // The outputs created by SlaveBegin must not be attached to a file.
+      TDirectory::TContext ctxt((TDirectory*)0);
+      TSelector *selector = (TSelector*)fSelector->IsA()->New();
+      selector->SetOption(fOption);
+      selector->SetInputList(fSelector->GetInputList());
+      view->fTree->SetNotify(selector);
+      selector->SlaveBegin(view->fTree);
+      if (selector->Version() >= 2)
+         selector->Init(view->fTree);
+      selector->Notify();
+      view->fSelector = selector;
+   }
+   return view;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Open a new view of the file number file. Return 0 if the file or the
+/// tree cannot be read.
+
+TTreeProcessor::TTreeView *TTreeProcessor::OpenView(UInt_t file)
+{
+   TFile *f = 0;
+   {
+      TDirectory::TContext ctxt;
+      f = TFile::Open(fFileNames[file].c_str());
+   }
+   if (!f || f->IsZombie()) {
+      ::Error("TTreeProcessor::Process", "cannot open the file %s", fFileNames[file].c_str());
+      delete f;
+      return 0;
+   }
+   TTree *tree = 0;
+   f->GetObject(fTreeNames[file].c_str(), tree);
+   if (!tree) {
+      ::Error("TTreeProcessor::Process", "cannot find the tree %s in the file %s",
+              fTreeNames[file].c_str(), fFileNames[file].c_str());
+      delete f;
+      return 0;
+   }
+
+   TTreeView *view = new TTreeView;
+   view->fFile = f;
+   view->fTree = tree;
+   view->fSelector = 0;
+
+   TLockGuard lock(fMutex);
+   fViews.push_back(view);
+   return view;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make the view available to the other tasks.
+
+void TTreeProcessor::ReleaseView(UInt_t file, TTreeView *view)
+{
+   TLockGuard lock(fMutex);
+   fFreeViews[file].push_back(view);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Close all the views and delete the copies of the selector.
+
+void TTreeProcessor::DeleteViews()
+{
+   for (UInt_t i = 0; i < fViews.size(); ++i) {
+      delete fViews[i]->fSelector;
+      delete fViews[i]->fFile;
+      delete fViews[i];
+   }
+   fViews.clear();
+   fFreeViews.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill ranges with the clusters of all the files. Return false if a file
+/// or its tree cannot be read.
+
+Bool_t TTreeProcessor::MakeRanges(std::vector<TRange> &ranges)
+{
+   fFreeViews.assign(fFileNames.size(), std::vector<TTreeView*>());
+   for (UInt_t i = 0; i < fFileNames.size(); ++i) {
+      TTreeView *view = AcquireView(i);
+      if (!view) return kFALSE;
+
+      Long64_t nentries = view->fTree->GetEntries();
+      TTree::TClusterIterator clusters = view->fTree->GetClusterIterator(0);
+      Long64_t begin;
+      while ((begin = clusters()) < nentries) {
+         TRange range;
+         range.fFile = i;
+         range.fBegin = begin;
+         range.fEnd = clusters.GetNextEntry();
+         ranges.push_back(range);
+      }
+      ReleaseView(i, view);
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call func for each cluster, with a TTreeReader on a tree not used by any
+/// other task and restricted to the entries of the cluster. func is called
+/// concurrently from the threads of the global pool.
+
+void TTreeProcessor::Process(Function_t func)
+{
+   std::vector<TRange> ranges;
+   if (MakeRanges(ranges)) {
+      TTaskGroup group;
+      for (UInt_t i = 0; i < ranges.size(); ++i) {
+         const TRange range = ranges[i];
+         group.Run([this, range, &func]() {
+            TDirectory::TContext ctxt((TDirectory*)0);
+            TTreeView *view = AcquireView(range.fFile);
+            if (!view) return;
+            {
+               TTreeReader reader(view->fTree);
+               reader.SetEntriesRange(range.fBegin, range.fEnd);
+               func(reader);
+            }
+            ReleaseView(range.fFile, view);
+         });
+      }
+      group.Wait();
+   }
+   DeleteViews();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process all the entries with copies of selector and merge their outputs
+/// in the output list of selector (see the class description).
+/// The function returns the status of the selector, or -1 in case of error
+/// or if the processing was aborted.
+
+Long64_t TTreeProcessor::Process(TSelector *selector, Option_t *option)
+{
+   std::vector<TRange> ranges;
+   Bool_t ok = MakeRanges(ranges);
+
+   // As TTree::Process, pass the processed tree to Begin: the tree or chain
+   // given to the constructor, else the tree of the first file.
+   TTree *tree = fTree;
+   if (!tree && !fViews.empty()) tree = fViews[0]->fTree;
+   selector->SetOption(option);
+   selector->Begin(tree);
+
+   // From now on, the views get their copy of the selector.
+   fSelector = selector;
+   fOption = option;
+
+   if (ok) {
+      TTaskGroup group;
+      for (UInt_t i = 0; i < ranges.size(); ++i) {
+         const TRange range = ranges[i];
+         group.Run([this, range]() {
+            {
+               TLockGuard lock(fMutex);
+               if (fSelector->GetAbort() == TSelector::kAbortProcess) return;
+            }
+            TDirectory::TContext ctxt((TDirectory*)0);
+            TTreeView *view = AcquireView(range.fFile);
+            if (!view) return;
+
+            TSelector *copy = view->fSelector;
+            Bool_t useCutFill = copy->Version() == 0;
+            for (Long64_t entry = range.fBegin; entry < range.fEnd; ++entry) {
+               if (view->fTree->LoadTree(entry) < 0) break;
+               if (useCutFill) {
+                  if (copy->ProcessCut(entry))
+                     copy->ProcessFill(entry);
+               } else {
+                  copy->Process(entry);
+               }
+               if (copy->GetAbort() != TSelector::kContinue) break;
+            }
+            if (copy->GetAbort() == TSelector::kAbortFile) {
+               // Only the rest of the cluster is skipped.
+               copy->ResetAbort();
+            } else if (copy->GetAbort() == TSelector::kAbortProcess) {
+               TLockGuard lock(fMutex);
+               fSelector->Abort("processing aborted by one of the tasks");
+            }
+            ReleaseView(range.fFile, view);
+         });
+      }
+      group.Wait();
+   }
+
+   // Terminate the copies and merge their outputs.
+   std::vector<TList*> outputs;
+   for (UInt_t i = 0; i < fViews.size(); ++i) {
+      TSelector *copy = fViews[i]->fSelector;
+      if (!copy) continue;
+      copy->SlaveTerminate();
+      copy->ResetAbort();
+      if (copy->GetOutputList()) outputs.push_back(copy->GetOutputList());
+   }
+   TList *output = selector->GetOutputList();
+   for (UInt_t i = 0; i < outputs.size(); ++i) {
+      std::vector<TObject*> moved;
+      TIter next(outputs[i]);
+      while (TObject *obj = next()) {
+         // Already merged with the same object of a previous copy
+         if (output->FindObject(obj->GetName())) continue;
+
+         TList others;
+         for (UInt_t j = i + 1; j < outputs.size(); ++j) {
+            if (TObject *other = outputs[j]->FindObject(obj->GetName())) others.Add(other);
+         }
+         if (others.GetSize()) {
+            ROOT::MergeFunc_t merge = obj->IsA()->GetMerge();
+            if (merge) {
+               merge(obj, &others, 0);
+            } else {
+               ::Warning("TTreeProcessor::Process", "cannot merge %s of class %s, only the output of one task is kept",
+                         obj->GetName(), obj->ClassName());
+            }
+         }
+         moved.push_back(obj);
+      }
+      for (UInt_t j = 0; j < moved.size(); ++j) {
+         outputs[i]->Remove(moved[j]);
+         output->Add(moved[j]);
+      }
+   }
+   fSelector = 0;
+
+   Long64_t res = -1;
+   if (ok && selector->GetAbort() != TSelector::kAbortProcess &&
+       (selector->Version() != 0 || selector->GetStatus() != -1)) {
+      selector->Terminate();
+      res = selector->GetStatus();
+   }
+   // The tree passed to Begin may be the one of a view.
+   DeleteViews();
+   return res;
+}
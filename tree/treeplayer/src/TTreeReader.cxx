@@ -204,7 +204,9 @@ TTreeReader::TTreeReader(TTree* tree):
    fTree(tree),
    fDirectory(0),
    fEntryStatus(kEntryNotLoaded),
-   fDirector(0)
+   fDirector(0),
+   fBeginEntry(0),
+   fEndEntry(-1)
 {
    Initialize();
 }
@@ -218,7 +220,9 @@ TTreeReader::TTreeReader(const char* keyname, TDirectory* dir /*= NULL*/):
    fTree(0),
    fDirectory(dir),
    fEntryStatus(kEntryNotLoaded),
-   fDirector(0)
+   fDirector(0),
+   fBeginEntry(0),
+   fEndEntry(-1)
 {
    if (!fDirectory) fDirectory = gDirectory;
    fDirectory->GetObject(keyname, fTree);
@@ -276,6 +280,11 @@ TTreeReader::EEntryStatus TTreeReader::SetEntryBase(Long64_t entry, Bool_t local
 
    TTree* prevTree = fDirector->GetTree();
 
+   if (!local && fEndEntry >= 0 && entry >= fEndEntry) {
+      fEntryStatus = kEntryNotFound;
+      return fEntryStatus;
+   }
+
    int loadResult;
    if (!local){
       Int_t treeNumInChain = fTree->GetTreeNumber();
@@ -312,6 +321,18 @@ TTreeReader::EEntryStatus TTreeReader::SetEntryBase(Long64_t entry, Bool_t local
    return fEntryStatus;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Restrict the entries read to [beginEntry, endEntry): Next() and the
+/// iteration start at beginEntry, and reading endEntry or beyond returns
+/// kEntryNotFound. endEntry = -1 means up to the end of the tree.
+/// For chains, the entry numbers are global ones.
+
+void TTreeReader::SetEntriesRange(Long64_t beginEntry, Long64_t endEntry)
+{
+   fBeginEntry = beginEntry;
+   fEndEntry = endEntry;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set (or update) the which tree to reader from. tree can be
 /// a TTree or a TChain.